@@ -0,0 +1,22 @@
+varying vec4 Color;
+varying vec2 TexCoord;
+
+#ifdef ALU_FRAGMENT
+$UNIFORMS$
+#endif
+
+void main(void)
+{
+#ifdef ALU_FRAGMENT
+$DECLARATIONS$
+    for (int i = 0; i < Iterations; i++) {
+$BODY$
+    }
+
+    vec4 result = vec4(0.0);
+$RESULT$
+    gl_FragColor = fract(Color + result);
+#else
+    gl_FragColor = fract(Color);
+#endif
+}
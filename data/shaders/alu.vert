@@ -0,0 +1,28 @@
+attribute vec3 position;
+
+varying vec4 Color;
+varying vec2 TexCoord;
+
+#ifdef ALU_VERTEX
+$UNIFORMS$
+#endif
+
+void main(void)
+{
+    TexCoord = position.xy * 0.5 + 0.5;
+
+#ifdef ALU_VERTEX
+$DECLARATIONS$
+    for (int i = 0; i < Iterations; i++) {
+$BODY$
+    }
+
+    vec4 result = vec4(0.0);
+$RESULT$
+    Color = result;
+#else
+    Color = vec4(0.0);
+#endif
+
+    gl_Position = vec4(position, 1.0);
+}
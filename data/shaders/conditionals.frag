@@ -1,9 +1,33 @@
 varying vec4 dummy;
 
+#ifdef DIVERGENCE_PATTERN
+#if defined(GL_ES) && defined(GL_FRAGMENT_PRECISION_HIGH)
+#define DIVERGENCE_HIGHP highp
+#else
+#define DIVERGENCE_HIGHP
+#endif
+
+// Hash without sine, so that large cell coordinates still hash to
+// well-spread values where highp is unavailable
+float
+divergence_hash(DIVERGENCE_HIGHP vec2 p)
+{
+    DIVERGENCE_HIGHP vec3 p3 = fract(vec3(p.xyx) * 0.1031);
+    p3 += dot(p3, p3.yzx + 33.33);
+    return fract((p3.x + p3.y) * p3.z);
+}
+#endif
+
 void main(void)
 {
     float d = fract(gl_FragCoord.x * gl_FragCoord.y * 0.0001);
 
+#ifdef DIVERGENCE_PATTERN
+    // The branch taken by the divergent steps, from a screen-space pattern
+    DIVERGENCE_HIGHP vec2 cell = floor(gl_FragCoord.xy / DIVERGENCE_BLOCK_SIZE);
+    bool branch = DIVERGENCE_PATTERN;
+#endif
+
 $MAIN$
 
     gl_FragColor = vec4(d, d, d, 1.0);
@@ -0,0 +1,38 @@
+// Writes GBUFFER_ATTACHMENTS render targets:
+//  0: albedo (rgb), specular intensity (a)
+//  1: normal, shininess
+//  2: emissive (rgb), ambient occlusion (a)
+//  3: motion vector (rg), material id (b)
+varying vec3 vertex_normal;
+varying vec3 object_position;
+
+vec2 encode_octahedral(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.xy;
+    if (n.z < 0.0)
+        e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return e;
+}
+
+void main(void)
+{
+    vec3 normal = normalize(vertex_normal);
+
+    // A procedural material, so that the G-buffer contents vary over the model
+    float band = step(0.5, fract(object_position.y * ModelScale));
+    vec3 albedo = mix(vec3(0.8, 0.7, 0.5), vec3(0.3, 0.5, 0.8), band);
+
+    gl_FragData[0] = vec4(albedo, 0.5 + 0.5 * band);
+#ifdef PACKED_NORMALS
+    gl_FragData[1] = vec4(encode_octahedral(normal) * 0.5 + 0.5, 0.25, 0.0);
+#else
+    gl_FragData[1] = vec4(normal * 0.5 + 0.5, 0.25);
+#endif
+#if GBUFFER_ATTACHMENTS > 2
+    gl_FragData[2] = vec4(albedo * 0.05 * band, 1.0 - 0.5 * band);
+#endif
+#if GBUFFER_ATTACHMENTS > 3
+    gl_FragData[3] = vec4(0.5, 0.5, band, 1.0);
+#endif
+}
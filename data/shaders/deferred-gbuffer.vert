@@ -0,0 +1,15 @@
+attribute vec3 position;
+attribute vec3 normal;
+
+uniform mat4 ModelViewProjectionMatrix;
+uniform mat4 NormalMatrix;
+
+varying vec3 vertex_normal;
+varying vec3 object_position;
+
+void main(void)
+{
+    vertex_normal = normalize(vec3(NormalMatrix * vec4(normal, 1.0)));
+    object_position = position;
+    gl_Position = ModelViewProjectionMatrix * vec4(position, 1.0);
+}
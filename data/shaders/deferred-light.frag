@@ -0,0 +1,80 @@
+// Reads the GBUFFER_ATTACHMENTS render targets and the depth written by
+// deferred-gbuffer.frag
+uniform highp sampler2D GBuffer0;
+uniform highp sampler2D GBuffer1;
+#if GBUFFER_ATTACHMENTS > 2
+uniform highp sampler2D GBuffer2;
+#endif
+#if GBUFFER_ATTACHMENTS > 3
+uniform highp sampler2D GBuffer3;
+#endif
+uniform highp sampler2D GBufferDepth;
+uniform highp mat4 InverseProjectionMatrix;
+uniform highp vec2 ScreenSize;
+uniform highp vec4 LightSphere;
+uniform vec3 LightColor;
+
+vec3 decode_octahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+void main(void)
+{
+    highp ivec2 texel = ivec2(gl_FragCoord.xy);
+    highp float depth = texelFetch(GBufferDepth, texel, 0).r;
+
+    // Nothing was drawn here
+    if (depth == 1.0)
+        discard;
+
+    vec4 g0 = texelFetch(GBuffer0, texel, 0);
+    vec4 g1 = texelFetch(GBuffer1, texel, 0);
+    vec3 albedo = g0.rgb;
+
+#ifdef AMBIENT_PASS
+    vec3 color = albedo * 0.1;
+#if GBUFFER_ATTACHMENTS > 2
+    vec4 g2 = texelFetch(GBuffer2, texel, 0);
+    color = color * g2.a + g2.rgb;
+#endif
+#if GBUFFER_ATTACHMENTS > 3
+    vec4 g3 = texelFetch(GBuffer3, texel, 0);
+    color *= 0.9 + 0.1 * g3.b;
+#endif
+#else
+#ifdef PACKED_NORMALS
+    vec3 normal = decode_octahedral(g1.rg * 2.0 - 1.0);
+    float shininess = g1.b * 128.0;
+#else
+    vec3 normal = normalize(g1.rgb * 2.0 - 1.0);
+    float shininess = g1.a * 128.0;
+#endif
+
+    // Reconstruct the view space position from the depth
+    highp vec4 ndc = vec4(gl_FragCoord.xy / ScreenSize * 2.0 - 1.0,
+                          depth * 2.0 - 1.0, 1.0);
+    highp vec4 position = InverseProjectionMatrix * ndc;
+    position /= position.w;
+
+    highp vec3 light_vector = LightSphere.xyz - position.xyz;
+    highp float distance = length(light_vector);
+    vec3 light_direction = light_vector / distance;
+    float attenuation = max(1.0 - distance / LightSphere.w, 0.0);
+    attenuation *= attenuation;
+
+    vec3 half_vector = normalize(light_direction - normalize(position.xyz));
+    float diffuse = max(dot(normal, light_direction), 0.0);
+    float specular = g0.a * pow(max(dot(normal, half_vector), 0.0), shininess);
+
+    vec3 color = LightColor * (albedo * diffuse + specular) * attenuation;
+#if GBUFFER_ATTACHMENTS > 2
+    color *= texelFetch(GBuffer2, texel, 0).a;
+#endif
+#endif
+
+    gl_FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,15 @@
+attribute vec3 position;
+
+uniform mat4 ProjectionMatrix;
+uniform vec4 LightSphere;
+
+void main(void)
+{
+#ifdef AMBIENT_PASS
+    // A full screen quad
+    gl_Position = vec4(position.xy, 0.0, 1.0);
+#else
+    // A unit sphere scaled to the light volume, which is in view space
+    gl_Position = ProjectionMatrix * vec4(LightSphere.xyz + position * LightSphere.w, 1.0);
+#endif
+}
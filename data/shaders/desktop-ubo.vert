@@ -0,0 +1,12 @@
+uniform vec4 QuadVertices[4];
+
+varying vec2 TextureCoord;
+
+void main(void)
+{
+    vec4 vertex = QuadVertices[gl_VertexID];
+
+    gl_Position = vec4(vertex.xy, 0.0, 1.0);
+
+    TextureCoord = vertex.zw;
+}
@@ -0,0 +1,32 @@
+#ifdef EXTERNAL
+uniform samplerExternalOES Texture0;
+#else
+uniform sampler2D Texture0;
+uniform sampler2D Texture1;
+uniform sampler2D Texture2;
+#endif
+
+varying vec2 TexCoord;
+
+void main(void)
+{
+#if defined(FORMAT_NV12) || defined(FORMAT_YUV420)
+    float y = texture2D(Texture0, TexCoord).r;
+#if defined(FORMAT_NV12) && defined(RG_PLANES)
+    vec2 uv = texture2D(Texture1, TexCoord).rg;
+#elif defined(FORMAT_NV12)
+    vec2 uv = texture2D(Texture1, TexCoord).ra;
+#else
+    vec2 uv = vec2(texture2D(Texture1, TexCoord).r, texture2D(Texture2, TexCoord).r);
+#endif
+    // BT.601, narrow range
+    y = 1.164 * (y - 0.0625);
+    uv -= 0.5;
+    gl_FragColor = vec4(y + 1.596 * uv.y,
+                        y - 0.391 * uv.x - 0.813 * uv.y,
+                        y + 2.018 * uv.x,
+                        1.0);
+#else
+    gl_FragColor = texture2D(Texture0, TexCoord);
+#endif
+}
@@ -0,0 +1,10 @@
+attribute vec3 position;
+
+varying vec2 TexCoord;
+
+void main(void)
+{
+    // The first row of a frame is its top row
+    TexCoord = vec2(position.x * 0.5 + 0.5, 0.5 - position.y * 0.5);
+    gl_Position = vec4(position, 1.0);
+}
@@ -0,0 +1,12 @@
+uniform sampler2D Texture0;
+
+varying vec2 TextureCoord;
+varying vec4 Color;
+
+void main(void)
+{
+    // Negative texcoords mark solid (untextured) quads
+    float solid = step(TextureCoord.x, -0.5);
+    vec4 texel = texture2D(Texture0, TextureCoord);
+    gl_FragColor = Color * mix(texel, vec4(1.0), solid);
+}
@@ -0,0 +1,13 @@
+attribute vec2 position;
+attribute vec2 texcoord;
+attribute vec4 color;
+
+varying vec2 TextureCoord;
+varying vec4 Color;
+
+void main(void)
+{
+    TextureCoord = texcoord;
+    Color = color;
+    gl_Position = vec4(position, 0.0, 1.0);
+}
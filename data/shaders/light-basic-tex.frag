@@ -5,7 +5,11 @@ varying vec2 TextureCoord;
 
 void main(void)
 {
+#ifdef LOD_BIAS
+    vec4 texel = texture2D(MaterialTexture0, TextureCoord, LOD_BIAS);
+#else
     vec4 texel = texture2D(MaterialTexture0, TextureCoord);
+#endif
     gl_FragColor = texel * Color;
 }
 
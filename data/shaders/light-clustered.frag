@@ -0,0 +1,46 @@
+// Compiled as GLSL ES 3.00 (GLSL 1.40 on desktop GL)
+uniform highp sampler2D LightTiles;
+uniform highp sampler2D LightIndices;
+uniform highp sampler2D Lights;
+
+varying vec3 vertex_normal;
+varying vec4 vertex_position;
+
+void main(void)
+{
+    // The width of the index and light textures in texels
+    const int TextureWidth = 1024;
+    const int TileSize = $TILE_SIZE$;
+    const vec4 lightAmbient = vec4(0.1, 0.1, 0.1, 1.0);
+
+    highp ivec2 tile = ivec2(gl_FragCoord.xy) / TileSize;
+    highp vec4 tile_data = texelFetch(LightTiles, tile, 0);
+    highp int first = int(tile_data.x);
+    highp int count = int(tile_data.y);
+
+    highp vec3 position = vertex_position.xyz / vertex_position.w;
+    vec3 normal = normalize(vertex_normal);
+    vec3 diffuse = vec3(0.0);
+
+    for (highp int i = first; i < first + count; i++) {
+        highp int texel = i / 4;
+        highp int light = int(texelFetch(LightIndices,
+                                         ivec2(texel % TextureWidth, texel / TextureWidth),
+                                         0)[i % 4]);
+
+        // Each light is a position/radius texel followed by a color texel
+        highp ivec2 light_texel = ivec2(2 * (light % (TextureWidth / 2)),
+                                        light / (TextureWidth / 2));
+        highp vec4 light_sphere = texelFetch(Lights, light_texel, 0);
+        vec3 light_color = texelFetch(Lights, light_texel + ivec2(1, 0), 0).rgb;
+
+        highp vec3 light_vector = light_sphere.xyz - position;
+        highp float distance = length(light_vector);
+        float attenuation = max(1.0 - distance / light_sphere.w, 0.0);
+        float diffuse_term = max(dot(normal, light_vector / distance), 0.0);
+
+        diffuse += light_color * diffuse_term * attenuation * attenuation;
+    }
+
+    gl_FragColor = lightAmbient + vec4(diffuse, 0.0) * MaterialDiffuse;
+}
@@ -0,0 +1,10 @@
+uniform sampler2D Texture;
+uniform vec4 Color;
+uniform float TextureWeight;
+
+varying vec2 TexCoord;
+
+void main(void)
+{
+    gl_FragColor = mix(Color, texture2D(Texture, TexCoord), TextureWeight);
+}
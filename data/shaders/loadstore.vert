@@ -0,0 +1,12 @@
+attribute vec3 position;
+
+uniform mat4 Transform;
+uniform float TextureScale;
+
+varying vec2 TexCoord;
+
+void main(void)
+{
+    TexCoord = position.xy * TextureScale + 0.5;
+    gl_Position = Transform * vec4(position, 1.0);
+}
@@ -0,0 +1,19 @@
+attribute vec3 position;
+attribute vec3 normal;
+
+uniform mat4 ModelViewProjectionMatrix;
+uniform mat4 NormalMatrix;
+uniform vec4 MaterialColor;
+
+varying vec4 Color;
+
+void main(void)
+{
+    vec3 N = normalize(vec3(NormalMatrix * vec4(normal, 1.0)));
+    vec3 L = normalize(vec3(0.3, 0.6, 1.0));
+
+    float diffuse = 0.25 + 0.75 * max(dot(N, L), 0.0);
+    Color = vec4(diffuse * MaterialColor.rgb, MaterialColor.a);
+
+    gl_Position = ModelViewProjectionMatrix * vec4(position, 1.0);
+}
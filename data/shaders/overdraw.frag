@@ -0,0 +1,25 @@
+uniform vec4 Color;
+
+varying vec2 TexCoord;
+
+void main(void)
+{
+    vec3 color = Color.rgb;
+    vec2 p = TexCoord;
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        p = fract(p * 1.37 + color.gb);
+        color = mix(color, vec3(p, 1.0 - p.x), 0.1);
+    }
+
+#ifdef DISCARD
+    // Color.a is never negative, but the compiler can't know that
+    if (Color.a < 0.0)
+        discard;
+#endif
+#ifdef FRAG_DEPTH
+    gl_FragDepth = gl_FragCoord.z;
+#endif
+
+    gl_FragColor = vec4(color, 1.0);
+}
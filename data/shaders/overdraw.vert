@@ -0,0 +1,11 @@
+attribute vec3 position;
+
+uniform float Depth;
+
+varying vec2 TexCoord;
+
+void main(void)
+{
+    TexCoord = position.xy * 0.5 + 0.5;
+    gl_Position = vec4(position.xy, Depth, 1.0);
+}
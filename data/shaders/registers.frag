@@ -0,0 +1,16 @@
+uniform sampler2D Texture;
+uniform vec4 Seed;
+
+varying vec2 TexCoord;
+
+void main(void)
+{
+$DECLARATIONS$
+    for (int i = 0; i < ITERATIONS; i++) {
+$BODY$
+    }
+
+    vec4 result = vec4(0.0);
+$RESULT$
+    gl_FragColor = fract(result);
+}
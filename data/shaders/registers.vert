@@ -0,0 +1,9 @@
+attribute vec3 position;
+
+varying vec2 TexCoord;
+
+void main(void)
+{
+    TexCoord = position.xy * 0.5 + 0.5;
+    gl_Position = vec4(position, 1.0);
+}
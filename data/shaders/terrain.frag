@@ -42,19 +42,25 @@ uniform float fogFar;
 #endif
 #endif
 
+#ifdef LOD_BIAS
+#define textureOverlay(sampler, uv) texture2D(sampler, uv, LOD_BIAS)
+#else
+#define textureOverlay(sampler, uv) texture2D(sampler, uv)
+#endif
+
 void main() {
     gl_FragColor = vec4( vec3( 1.0 ), uOpacity );
     vec3 specularTex = vec3( 1.0 );
     vec2 uvOverlay = uRepeatOverlay * vUv + uOffset;
-    vec3 normalTex = texture2D( tDetail, uvOverlay ).xyz * 2.0 - 1.0;
+    vec3 normalTex = textureOverlay( tDetail, uvOverlay ).xyz * 2.0 - 1.0;
     normalTex.xy *= uNormalScale;
     normalTex = normalize( normalTex );
 
-    vec4 colDiffuse1 = texture2D( tDiffuse1, uvOverlay );
-    vec4 colDiffuse2 = texture2D( tDiffuse2, uvOverlay );
+    vec4 colDiffuse1 = textureOverlay( tDiffuse1, uvOverlay );
+    vec4 colDiffuse2 = textureOverlay( tDiffuse2, uvOverlay );
     gl_FragColor = gl_FragColor * mix ( colDiffuse1, colDiffuse2, 1.0 - texture2D( tDisplacement, vUv) );
 
-    specularTex = texture2D( tSpecular, uvOverlay ).xyz;
+    specularTex = textureOverlay( tSpecular, uvOverlay ).xyz;
 
     mat3 tbn= mat3( vTangent, vBinormal, vNormal );
     vec3 finalNormal = tbn * normalTex;
@@ -0,0 +1,43 @@
+uniform sampler2D Texture;
+uniform vec4 Transform;
+uniform vec2 TextureSize;
+uniform vec2 WindowOffset;
+
+varying vec2 PixelCoord;
+
+#ifdef PATTERN_RANDOM
+/*
+ * Hashes a pixel position and fetch index to a coordinate in [0, 1)^2.
+ * It uses no sin(), whose large arguments lose the hash to precision.
+ */
+vec2 hash(vec3 p)
+{
+    p = fract(p * vec3(0.1031, 0.1030, 0.0973));
+    p += dot(p, p.yzx + 33.33);
+    return fract((p.xx + p.yz) * p.zy);
+}
+#endif
+
+void main(void)
+{
+    mat2 transform = mat2(Transform.xy, Transform.zw);
+    vec4 sum = vec4(0.0);
+#ifdef PATTERN_DEPENDENT
+    vec2 coord = transform * PixelCoord / TextureSize;
+#endif
+
+    for (int i = 0; i < FETCHES; i++) {
+#if defined(PATTERN_RANDOM)
+        vec2 coord = hash(vec3(PixelCoord, float(i)));
+#elif !defined(PATTERN_DEPENDENT)
+        vec2 coord = (transform * PixelCoord + float(i) * WindowOffset) / TextureSize;
+#endif
+        vec4 texel = texture2D(Texture, coord);
+#ifdef PATTERN_DEPENDENT
+        coord = fract(coord + texel.xy + texel.zw / 255.0);
+#endif
+        sum += texel;
+    }
+
+    gl_FragColor = sum / float(FETCHES);
+}
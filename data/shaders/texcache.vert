@@ -0,0 +1,11 @@
+attribute vec3 position;
+
+uniform vec2 Viewport;
+
+varying vec2 PixelCoord;
+
+void main(void)
+{
+    PixelCoord = (position.xy * 0.5 + 0.5) * Viewport;
+    gl_Position = vec4(position, 1.0);
+}
@@ -0,0 +1,11 @@
+attribute vec3 position;
+
+uniform vec2 TexScale;
+
+varying vec2 TexCoord;
+
+void main(void)
+{
+    TexCoord = (position.xy * 0.5 + 0.5) * TexScale;
+    gl_Position = vec4(position, 1.0);
+}
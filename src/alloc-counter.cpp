@@ -0,0 +1,252 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "alloc-counter.h"
+
+#if GLMARK2_ALLOC_COUNTER
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <dlfcn.h>
+#include <execinfo.h>
+
+/*
+ * Only the thread that draws counts its allocations, so the flag is
+ * per-thread and the count needs no synchronization.
+ */
+static thread_local bool counting = false;
+static unsigned long long allocations = 0;
+
+static bool
+in_cxx_runtime(const Dl_info &info)
+{
+    return info.dli_fname && (std::strstr(info.dli_fname, "libstdc++") ||
+                              std::strstr(info.dli_fname, "libc++"));
+}
+
+/*
+ * The GL driver runs in this process, and a driver written in C++ allocates
+ * through this operator new too, e.g. when it compiles a shader variant on
+ * first use.  Only the allocations requested by glmark2 code, directly or
+ * through the C++ runtime library, are counted.
+ */
+static bool
+requested_by_glmark2(void *caller)
+{
+    static void *executable_base = 0;
+    Dl_info info;
+
+    if (!executable_base) {
+        if (!dladdr(reinterpret_cast<void *>(&requested_by_glmark2), &info))
+            return true;
+        executable_base = info.dli_fbase;
+    }
+
+    /*
+     * Callers outside the runtime library are classified by their address
+     * alone, so remember them: the driver allocates a lot while compiling.
+     */
+    static void *known_callers[256];
+    static bool known_results[256];
+    unsigned int slot = (reinterpret_cast<uintptr_t>(caller) >> 4) % 256;
+
+    if (known_callers[slot] == caller)
+        return known_results[slot];
+
+    if (!dladdr(caller, &info))
+        return false;
+    if (!in_cxx_runtime(info)) {
+        known_callers[slot] = caller;
+        known_results[slot] = info.dli_fbase == executable_base;
+        return known_results[slot];
+    }
+
+    /* Find the code that called into the runtime library */
+    void *frames[32];
+    int n = backtrace(frames, 32);
+    int i = 0;
+
+    while (i < n && frames[i] != caller)
+        i++;
+
+    for (; i < n; i++) {
+        if (!dladdr(frames[i], &info))
+            return false;
+        if (!in_cxx_runtime(info))
+            return info.dli_fbase == executable_base;
+    }
+
+    return false;
+}
+
+static void *
+allocate(std::size_t size, void *caller)
+{
+    if (counting) {
+        counting = false;
+        if (requested_by_glmark2(caller))
+            allocations++;
+        counting = true;
+    }
+
+    if (size == 0)
+        size = 1;
+
+    void *ptr;
+    while (!(ptr = std::malloc(size))) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+
+    return ptr;
+}
+
+void *
+operator new(std::size_t size)
+{
+    return allocate(size, __builtin_return_address(0));
+}
+
+void *
+operator new[](std::size_t size)
+{
+    return allocate(size, __builtin_return_address(0));
+}
+
+void *
+operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try {
+        return allocate(size, __builtin_return_address(0));
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+void *
+operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    try {
+        return allocate(size, __builtin_return_address(0));
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+bool
+AllocCounter::available()
+{
+    return true;
+}
+
+void
+AllocCounter::start()
+{
+    counting = true;
+}
+
+void
+AllocCounter::stop()
+{
+    counting = false;
+}
+
+unsigned long long
+AllocCounter::count()
+{
+    return allocations;
+}
+
+void
+AllocCounter::reset()
+{
+    allocations = 0;
+}
+
+#else
+
+bool
+AllocCounter::available()
+{
+    return false;
+}
+
+void
+AllocCounter::start()
+{
+}
+
+void
+AllocCounter::stop()
+{
+}
+
+unsigned long long
+AllocCounter::count()
+{
+    return 0;
+}
+
+void
+AllocCounter::reset()
+{
+}
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_ALLOC_COUNTER_H_
+#define GLMARK2_ALLOC_COUNTER_H_
+
+/**
+ * Counts the heap allocations made while drawing.
+ *
+ * When glmark2 is configured with --enable-alloc-counter, the global
+ * operator new is replaced with one that counts the allocations made by
+ * the thread that called ::start(), until it calls ::stop().  Allocations
+ * made by the GL driver, and by other threads, are not counted.
+ */
+class AllocCounter
+{
+public:
+    /**
+     * Whether allocations can be counted in this build.
+     */
+    static bool available();
+
+    /**
+     * Starts counting the allocations of the calling thread.
+     */
+    static void start();
+
+    /**
+     * Stops counting the allocations of the calling thread.
+     */
+    static void stop();
+
+    /**
+     * Gets the number of allocations counted since the last ::reset().
+     */
+    static unsigned long long count();
+
+    /**
+     * Sets the count to zero.
+     */
+    static void reset();
+};
+
+#endif
@@ -20,12 +20,129 @@
  *  Alexandros Frantzis
  */
 #include <fstream>
+#include <sstream>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <algorithm>
 #include "benchmark-collection.h"
 #include "default-benchmarks.h"
 #include "options.h"
 #include "log.h"
 #include "util.h"
 
+/*
+ * The state of benchmark file parsing.
+ *
+ * Variables are shared between a file and the files it includes, in both
+ * directions, but not with the other files given on the command line.  The
+ * section defaults and tags are local to the file (and section) they are
+ * specified in.
+ */
+struct BenchmarkFileState
+{
+    std::map<std::string, std::string> variables;
+    std::vector<Benchmark::OptionPair> defaults;
+    std::vector<std::string> tags;
+};
+
+static const unsigned int max_include_depth = 16;
+
+static std::string
+trim(const std::string &s)
+{
+    static const char *whitespace = " \t\r\n";
+    std::string::size_type first = s.find_first_not_of(whitespace);
+
+    if (first == std::string::npos)
+        return "";
+
+    return s.substr(first, s.find_last_not_of(whitespace) - first + 1);
+}
+
+/**
+ * Replaces ${NAME} references with the value of the variable NAME, or, if
+ * no such variable has been set, the value of the environment variable NAME.
+ */
+static std::string
+expand_variables(const std::string &s, const BenchmarkFileState &state,
+                 const std::string &location)
+{
+    std::string result;
+    std::string::size_type pos = 0;
+    std::string::size_type start;
+
+    while ((start = s.find("${", pos)) != std::string::npos) {
+        std::string::size_type end = s.find('}', start);
+        if (end == std::string::npos)
+            break;
+
+        result += s.substr(pos, start - pos);
+
+        const std::string name(s.substr(start + 2, end - start - 2));
+        std::map<std::string, std::string>::const_iterator iter =
+            state.variables.find(name);
+
+        if (iter != state.variables.end()) {
+            result += iter->second;
+        }
+        else if (const char *env = getenv(name.c_str())) {
+            result += env;
+        }
+        else {
+            Log::info("Warning: %s: undefined variable '%s'\n",
+                      location.c_str(), name.c_str());
+        }
+
+        pos = end + 1;
+    }
+
+    result += s.substr(pos);
+
+    return result;
+}
+
+/**
+ * Parses an option string of the form [:]opt1=val1:opt2=val2...
+ */
+static void
+parse_options(const std::string &s, std::vector<Benchmark::OptionPair> &options,
+              const std::string &location)
+{
+    std::vector<std::string> elems;
+
+    Util::split(s, ':', elems, Util::SplitModeNormal);
+
+    for (std::vector<std::string>::const_iterator iter = elems.begin();
+         iter != elems.end();
+         iter++)
+    {
+        if (iter->empty())
+            continue;
+
+        std::string::size_type eq = iter->find('=');
+        if (eq != std::string::npos) {
+            options.push_back(Benchmark::OptionPair(iter->substr(0, eq),
+                                                    iter->substr(eq + 1)));
+        }
+        else {
+            Log::info("Warning: %s: ignoring invalid option string '%s'\n",
+                      location.c_str(), iter->c_str());
+        }
+    }
+}
+
+static std::string
+resolve_path(const std::string &path, const std::string &including_file)
+{
+    std::string::size_type slash = including_file.rfind('/');
+
+    if (path.empty() || path[0] == '/' || slash == std::string::npos)
+        return path;
+
+    return including_file.substr(0, slash + 1) + path;
+}
+
 BenchmarkCollection::~BenchmarkCollection()
 {
     Util::dispose_pointer_vector(benchmarks_);
@@ -57,8 +174,12 @@ BenchmarkCollection::populate_from_options()
     if (!Options::benchmark_files.empty())
         add_benchmarks_from_files();
 
-    if (!benchmarks_contain_normal_scenes())
-        add(DefaultBenchmarks::get());
+    if (!benchmarks_contain_normal_scenes()) {
+        if (!Options::benchmark_tags.empty())
+            Log::info("Warning: no benchmarks match the specified tags\n");
+        else
+            add(DefaultBenchmarks::get());
+    }
 }
 
 bool
@@ -84,22 +205,187 @@ BenchmarkCollection::add_benchmarks_from_files()
          iter != Options::benchmark_files.end();
          iter++)
     {
-        std::ifstream ifs(iter->c_str());
+        BenchmarkFileState state;
+        add_benchmarks_from_file(*iter, state, 0);
+    }
+}
 
-        if (!ifs.fail()) {
-            std::string line;
+/**
+ * Adds the benchmarks described in a benchmark file.
+ *
+ * Each line of a benchmark file is one of:
+ *
+ *   # comment
+ *   include FILE           (relative to the including file)
+ *   set NAME VALUE         (referenced as ${NAME} in any following line)
+ *   [SECTION]              (starts a section tagged with SECTION)
+ *   defaults OPTIONS       (options for the benchmarks in the section)
+ *   tags TAG...            (tags for the benchmarks in the section)
+ *   BENCHMARK [*N] [@TAG]...
+ *
+ * where BENCHMARK is a benchmark description, N (at least 1) is the number of
+ * times to repeat the benchmark and TAG a tag for this benchmark only.
+ */
+void
+BenchmarkCollection::add_benchmarks_from_file(const std::string &filename,
+                                              BenchmarkFileState &state,
+                                              unsigned int depth)
+{
+    if (depth > max_include_depth) {
+        Log::error("Too many nested includes in benchmark file %s\n",
+                   filename.c_str());
+        return;
+    }
+
+    std::ifstream ifs(filename.c_str());
+
+    if (ifs.fail()) {
+        Log::error("Cannot open benchmark file %s\n", filename.c_str());
+        return;
+    }
+
+    std::string line;
+    unsigned int line_number = 0;
+
+    while (getline(ifs, line)) {
+        line_number++;
+
+        std::stringstream location;
+        location << filename << ":" << line_number;
+
+        line = trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        line = trim(expand_variables(line, state, location.str()));
 
-            while (getline(ifs, line)) {
-                if (!line.empty())
-                    benchmarks_.push_back(new Benchmark(line));
+        std::stringstream ss(line);
+        std::string keyword;
+        std::string rest;
+
+        ss >> keyword;
+        getline(ss, rest);
+        rest = trim(rest);
+
+        if (line[0] == '[' && line[line.size() - 1] == ']') {
+            state.defaults.clear();
+            state.tags.clear();
+            state.tags.push_back(trim(line.substr(1, line.size() - 2)));
+        }
+        else if (keyword == "include" && !rest.empty()) {
+            /* The included file gets its own copy of the section state */
+            std::vector<Benchmark::OptionPair> defaults(state.defaults);
+            std::vector<std::string> tags(state.tags);
+
+            add_benchmarks_from_file(resolve_path(rest, filename), state,
+                                     depth + 1);
+
+            state.defaults = defaults;
+            state.tags = tags;
+        }
+        else if (keyword == "set" && !rest.empty()) {
+            std::stringstream value_ss(rest);
+            std::string name;
+            std::string value;
+
+            value_ss >> name;
+            getline(value_ss, value);
+            state.variables[name] = trim(value);
+        }
+        else if (keyword == "defaults" && !rest.empty()) {
+            parse_options(rest, state.defaults, location.str());
+        }
+        else if (keyword == "tags" && !rest.empty()) {
+            std::stringstream tags_ss(rest);
+            std::string tag;
+
+            while (tags_ss >> tag)
+                state.tags.push_back(tag);
+        }
+        else {
+            add_benchmark_from_line(line, state, location.str());
+        }
+    }
+}
+
+void
+BenchmarkCollection::add_benchmark_from_line(const std::string &line,
+                                             const BenchmarkFileState &state,
+                                             const std::string &location)
+{
+    std::string description(line);
+    std::vector<std::string> tags(state.tags);
+    unsigned int repeat = 1;
+
+    /* Parse the trailing repeat count and tags */
+    std::string::size_type pos;
+    while ((pos = description.find_last_of(" \t")) != std::string::npos) {
+        const std::string token(description.substr(pos + 1));
+
+        if (token.size() > 1 && token[0] == '@') {
+            tags.push_back(token.substr(1));
+        }
+        else if (token[0] == '*') {
+            const std::string count(token.substr(1));
+            errno = 0;
+            unsigned long n = std::strtoul(count.c_str(), 0, 10);
+
+            if (count.empty() ||
+                count.find_first_not_of("0123456789") != std::string::npos ||
+                errno || n == 0 || n > UINT_MAX)
+            {
+                Log::error("%s: invalid repeat count '%s'\n",
+                           location.c_str(), token.c_str());
+                return;
             }
+
+            repeat = n;
         }
         else {
-            Log::error("Cannot open benchmark file %s\n",
-                       iter->c_str());
+            break;
+        }
+
+        description = trim(description.substr(0, pos));
+    }
+
+    Benchmark parsed(description);
+
+    /* Select benchmarks by tag, if requested (option-setting ones are kept) */
+    if (!Options::benchmark_tags.empty() && !parsed.scene().name().empty()) {
+        bool selected = false;
+
+        for (std::vector<std::string>::const_iterator iter = tags.begin();
+             iter != tags.end() && !selected;
+             iter++)
+        {
+            selected = std::find(Options::benchmark_tags.begin(),
+                                 Options::benchmark_tags.end(),
+                                 *iter) != Options::benchmark_tags.end();
         }
 
+        if (!selected)
+            return;
+    }
+
+    /*
+     * Apply the section defaults the scene accepts, before the options
+     * of the benchmark itself so that the latter take precedence.
+     */
+    std::vector<Benchmark::OptionPair> options;
+    const std::map<std::string, Scene::Option> &scene_options(parsed.scene().options());
+
+    for (std::vector<Benchmark::OptionPair>::const_iterator iter = state.defaults.begin();
+         iter != state.defaults.end();
+         iter++)
+    {
+        if (scene_options.find(iter->first) != scene_options.end())
+            options.push_back(*iter);
     }
+
+    options.insert(options.end(), parsed.options().begin(), parsed.options().end());
+
+    for (unsigned int i = 0; i < repeat; i++)
+        benchmarks_.push_back(new Benchmark(parsed.scene(), options));
 }
 
 bool
@@ -26,6 +26,8 @@
 #include <string>
 #include "benchmark.h"
 
+struct BenchmarkFileState;
+
 class BenchmarkCollection
 {
 public:
@@ -51,6 +53,12 @@ public:
 
 private:
     void add_benchmarks_from_files();
+    void add_benchmarks_from_file(const std::string &filename,
+                                  BenchmarkFileState &state,
+                                  unsigned int depth);
+    void add_benchmark_from_line(const std::string &line,
+                                 const BenchmarkFileState &state,
+                                 const std::string &location);
     bool benchmarks_contain_normal_scenes();
 
     std::vector<Benchmark *> benchmarks_;
@@ -0,0 +1,245 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark-planner.h"
+#include "main-loop.h"
+#include "log.h"
+#include "util.h"
+
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+/* The longest duration of the initial run of each benchmark */
+static const double max_initial_duration = 1.0;
+/* The shortest duration of any run */
+static const double min_run_duration = 0.1;
+/* The z-value for a 95% confidence interval */
+static const double z_95 = 1.96;
+
+double
+BenchmarkPlanner::Entry::mean() const
+{
+    return frames > 0 ? sum / frames : 0.0;
+}
+
+/**
+ * Gets the half-width of the 95% confidence interval of the mean frame
+ * time, relative to the mean.
+ */
+double
+BenchmarkPlanner::Entry::relative_ci() const
+{
+    if (frames < 2 || sum <= 0.0)
+        return HUGE_VAL;
+
+    double variance = (sum_sq - sum * sum / frames) / (frames - 1);
+    if (variance < 0.0)
+        variance = 0.0;
+
+    return z_95 * std::sqrt(variance / frames) / mean();
+}
+
+BenchmarkPlanner::BenchmarkPlanner(Canvas &canvas,
+                                   const std::vector<Benchmark *> &benchmarks) :
+    canvas_(canvas)
+{
+    /*
+     * Option-setting benchmarks are run before each run of the benchmarks
+     * that follow them.
+     */
+    std::vector<Benchmark *> prefix;
+
+    for (std::vector<Benchmark *>::const_iterator iter = benchmarks.begin();
+         iter != benchmarks.end();
+         iter++)
+    {
+        if ((*iter)->scene().name().empty()) {
+            prefix.push_back(*iter);
+        }
+        else {
+            entries_.push_back(Entry(*iter));
+            entries_.back().prefix = prefix;
+        }
+    }
+}
+
+BenchmarkPlanner::~BenchmarkPlanner()
+{
+}
+
+/**
+ * Runs a benchmark once for the specified duration and accumulates its
+ * frame time statistics.
+ *
+ * @return false if the user requested to quit
+ */
+bool
+BenchmarkPlanner::run_entry(Entry &entry, double duration, bool decoration)
+{
+    std::vector<Benchmark::OptionPair> options(entry.benchmark->options());
+    std::stringstream ss;
+
+    ss << duration;
+    options.push_back(Benchmark::OptionPair("duration", ss.str()));
+
+    Benchmark benchmark(entry.benchmark->scene(), options);
+
+    slice_ = entry.prefix;
+    slice_.push_back(&benchmark);
+
+    MainLoop *loop;
+    if (decoration)
+        loop = new MainLoopDecoration(canvas_, slice_);
+    else
+        loop = new MainLoop(canvas_, slice_);
+
+    while (loop->step());
+
+    bool succeeded = loop->score() > 0;
+    delete loop;
+
+    Scene &scene = benchmark.scene();
+    if (succeeded && scene.frames() > 0) {
+        double sum;
+        double sum_sq;
+
+        scene.frame_time_sums(sum, sum_sq);
+        entry.frames += scene.frames();
+        entry.sum += sum;
+        entry.sum_sq += sum_sq;
+    }
+    else {
+        entry.failed = true;
+    }
+
+    entry.runs++;
+
+    return !canvas_.should_quit();
+}
+
+void
+BenchmarkPlanner::run(double budget)
+{
+    if (entries_.empty())
+        return;
+
+    uint64_t start = Util::get_timestamp_us();
+    bool decoration = false;
+
+    for (std::vector<Entry>::const_iterator iter = entries_.begin();
+         iter != entries_.end();
+         iter++)
+    {
+        decoration = decoration || iter->benchmark->needs_decoration();
+    }
+
+    /* Use at most half of the budget for the initial runs */
+    double run_duration = std::max(min_run_duration,
+                                   std::min(max_initial_duration,
+                                            budget / (2.0 * entries_.size())));
+
+    for (std::vector<Entry>::iterator iter = entries_.begin();
+         iter != entries_.end();
+         iter++)
+    {
+        if (!run_entry(*iter, run_duration, decoration)) {
+            log_results();
+            return;
+        }
+    }
+
+    /* Spend the rest on the benchmarks with the least precise results */
+    while ((Util::get_timestamp_us() - start) / 1000000.0 + run_duration <= budget) {
+        Entry *widest = 0;
+
+        for (std::vector<Entry>::iterator iter = entries_.begin();
+             iter != entries_.end();
+             iter++)
+        {
+            if (!iter->failed &&
+                (!widest || iter->relative_ci() > widest->relative_ci()))
+            {
+                widest = &(*iter);
+            }
+        }
+
+        if (!widest || !run_entry(*widest, run_duration, decoration))
+            break;
+    }
+
+    log_results();
+}
+
+unsigned int
+BenchmarkPlanner::score()
+{
+    double score = 0.0;
+    unsigned int count = 0;
+
+    for (std::vector<Entry>::const_iterator iter = entries_.begin();
+         iter != entries_.end();
+         iter++)
+    {
+        if (!iter->failed && iter->frames > 0) {
+            score += 1.0 / iter->mean();
+            count++;
+        }
+    }
+
+    return count ? static_cast<unsigned int>(score / count) : 0;
+}
+
+void
+BenchmarkPlanner::log_results()
+{
+    Log::info("=======================================================\n");
+    Log::info("    Time budget precision (95%% confidence interval)\n");
+    Log::info("=======================================================\n");
+
+    for (std::vector<Entry>::const_iterator iter = entries_.begin();
+         iter != entries_.end();
+         iter++)
+    {
+        std::stringstream ss;
+        const std::vector<Benchmark::OptionPair> &options(iter->benchmark->options());
+
+        ss << "[" << iter->benchmark->scene().name() << "] ";
+        for (std::vector<Benchmark::OptionPair>::const_iterator opt = options.begin();
+             opt != options.end();
+             opt++)
+        {
+            ss << (opt == options.begin() ? "" : ":")
+               << opt->first << "=" << opt->second;
+        }
+        if (options.empty())
+            ss << "<default>";
+
+        if (iter->failed || iter->frames == 0) {
+            Log::info("%s: Failed\n", ss.str().c_str());
+        }
+        else {
+            Log::info("%s: FPS: %u FrameTime: %.3f ms +/- %.2f%% (%u runs, %u frames)\n",
+                      ss.str().c_str(),
+                      static_cast<unsigned int>(1.0 / iter->mean()),
+                      iter->mean() * 1000.0,
+                      iter->relative_ci() * 100.0,
+                      iter->runs, iter->frames);
+        }
+    }
+}
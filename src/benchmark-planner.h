@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_BENCHMARK_PLANNER_H_
+#define GLMARK2_BENCHMARK_PLANNER_H_
+
+#include "canvas.h"
+#include "benchmark.h"
+
+#include <vector>
+
+/**
+ * Runs a set of benchmarks within a total wall-clock time budget.
+ *
+ * Every benchmark is first run for a short minimum duration.  The rest of
+ * the budget is then spent, one short run at a time, on the benchmark whose
+ * frame time has the widest confidence interval relative to its mean.
+ */
+class BenchmarkPlanner
+{
+public:
+    BenchmarkPlanner(Canvas &canvas, const std::vector<Benchmark *> &benchmarks);
+    ~BenchmarkPlanner();
+
+    /**
+     * Runs the benchmarks.
+     *
+     * @param budget the total time budget in seconds
+     */
+    void run(double budget);
+
+    /**
+     * Gets the benchmarking score.
+     */
+    unsigned int score();
+
+private:
+    struct Entry
+    {
+        Entry(Benchmark *b) :
+            benchmark(b), frames(0), sum(0), sum_sq(0), runs(0), failed(false) {}
+
+        double mean() const;
+        double relative_ci() const;
+
+        Benchmark *benchmark;
+        std::vector<Benchmark *> prefix;
+        unsigned int frames;
+        double sum;
+        double sum_sq;
+        unsigned int runs;
+        bool failed;
+    };
+
+    bool run_entry(Entry &entry, double duration, bool decoration);
+    void log_results();
+
+    Canvas &canvas_;
+    std::vector<Entry> entries_;
+    std::vector<Benchmark *> slice_;
+};
+
+#endif
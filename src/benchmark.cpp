@@ -128,6 +128,7 @@ Benchmark::needs_decoration() const
          iter++)
     {
         if ((iter->first == "show-fps" && iter->second == "true") ||
+            (iter->first == "show-hud" && iter->second == "true") ||
             (iter->first == "title" && !iter->second.empty()))
         {
             return true;
@@ -78,6 +78,13 @@ public:
      */
     Scene &scene() const { return scene_; }
 
+    /**
+     * Gets the option values of the benchmark.
+     *
+     * @return the option values
+     */
+    const std::vector<OptionPair> &options() const { return options_; }
+
     /**
      * Sets up the Scene associated with the benchmark.
      *
@@ -171,6 +171,8 @@ CanvasAndroid::resize(int width, int height)
 void
 CanvasAndroid::init_gl_extensions()
 {
+    GLExtensions::init_capabilities();
+
     /*
      * Parse the extensions we care about from the extension string.
      * Don't even bother to get function pointers until we know the
@@ -188,4 +190,81 @@ CanvasAndroid::init_gl_extensions()
         GLExtensions::UnmapBuffer =
             reinterpret_cast<PFNGLUNMAPBUFFEROESPROC>(eglGetProcAddress("glUnmapBufferOES"));
     }
+
+    bool timer_query = extString.find("GL_EXT_disjoint_timer_query") != std::string::npos;
+    if (timer_query ||
+        extString.find("GL_EXT_occlusion_query_boolean") != std::string::npos)
+    {
+        GLExtensions::GenQueries =
+            reinterpret_cast<PFNGLGENQUERIESEXTPROC>(eglGetProcAddress("glGenQueriesEXT"));
+        GLExtensions::DeleteQueries =
+            reinterpret_cast<PFNGLDELETEQUERIESEXTPROC>(eglGetProcAddress("glDeleteQueriesEXT"));
+        GLExtensions::BeginQuery =
+            reinterpret_cast<PFNGLBEGINQUERYEXTPROC>(eglGetProcAddress("glBeginQueryEXT"));
+        GLExtensions::EndQuery =
+            reinterpret_cast<PFNGLENDQUERYEXTPROC>(eglGetProcAddress("glEndQueryEXT"));
+        GLExtensions::GetQueryObjectuiv =
+            reinterpret_cast<PFNGLGETQUERYOBJECTUIVEXTPROC>(eglGetProcAddress("glGetQueryObjectuivEXT"));
+    }
+    else if (GLExtensions::version(3, 0)) {
+        GLExtensions::GenQueries =
+            reinterpret_cast<PFNGLGENQUERIESEXTPROC>(eglGetProcAddress("glGenQueries"));
+        GLExtensions::DeleteQueries =
+            reinterpret_cast<PFNGLDELETEQUERIESEXTPROC>(eglGetProcAddress("glDeleteQueries"));
+        GLExtensions::BeginQuery =
+            reinterpret_cast<PFNGLBEGINQUERYEXTPROC>(eglGetProcAddress("glBeginQuery"));
+        GLExtensions::EndQuery =
+            reinterpret_cast<PFNGLENDQUERYEXTPROC>(eglGetProcAddress("glEndQuery"));
+        GLExtensions::GetQueryObjectuiv =
+            reinterpret_cast<PFNGLGETQUERYOBJECTUIVEXTPROC>(eglGetProcAddress("glGetQueryObjectuiv"));
+    }
+    if (timer_query) {
+        GLExtensions::GetQueryObjectui64v =
+            reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(eglGetProcAddress("glGetQueryObjectui64vEXT"));
+    }
+    if (GLExtensions::support(GLExtensions::UniformBufferObjects)) {
+        GLExtensions::BindBufferRange =
+            reinterpret_cast<void (*)(GLenum, GLuint, GLuint, GLintptr, GLsizeiptr)>(
+                eglGetProcAddress("glBindBufferRange"));
+        GLExtensions::GetUniformBlockIndex =
+            reinterpret_cast<GLuint (*)(GLuint, const GLchar *)>(
+                eglGetProcAddress("glGetUniformBlockIndex"));
+        GLExtensions::UniformBlockBinding =
+            reinterpret_cast<void (*)(GLuint, GLuint, GLuint)>(
+                eglGetProcAddress("glUniformBlockBinding"));
+    }
+    if (GLExtensions::version(3, 0)) {
+        GLExtensions::DrawBuffers =
+            reinterpret_cast<void (*)(GLsizei, const GLenum *)>(
+                eglGetProcAddress("glDrawBuffers"));
+    }
+    else if (GLExtensions::support("GL_EXT_draw_buffers")) {
+        GLExtensions::DrawBuffers =
+            reinterpret_cast<void (*)(GLsizei, const GLenum *)>(
+                eglGetProcAddress("glDrawBuffersEXT"));
+    }
+    if (GLExtensions::version(3, 0)) {
+        GLExtensions::InvalidateFramebuffer =
+            reinterpret_cast<void (*)(GLenum, GLsizei, const GLenum *)>(
+                eglGetProcAddress("glInvalidateFramebuffer"));
+    }
+    else if (GLExtensions::support("GL_EXT_discard_framebuffer")) {
+        GLExtensions::InvalidateFramebuffer =
+            reinterpret_cast<void (*)(GLenum, GLsizei, const GLenum *)>(
+                eglGetProcAddress("glDiscardFramebufferEXT"));
+    }
+    if (GLExtensions::support(GLExtensions::SyncObjects)) {
+        GLExtensions::FenceSync =
+            reinterpret_cast<GLsync (*)(GLenum, GLbitfield)>(
+                eglGetProcAddress("glFenceSync"));
+        GLExtensions::DeleteSync =
+            reinterpret_cast<void (*)(GLsync)>(
+                eglGetProcAddress("glDeleteSync"));
+        GLExtensions::ClientWaitSync =
+            reinterpret_cast<GLenum (*)(GLsync, GLbitfield, GLuint64)>(
+                eglGetProcAddress("glClientWaitSync"));
+        GLExtensions::WaitSync =
+            reinterpret_cast<void (*)(GLsync, GLbitfield, GLuint64)>(
+                eglGetProcAddress("glWaitSync"));
+    }
 }
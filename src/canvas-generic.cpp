@@ -23,6 +23,7 @@
 #include "canvas-generic.h"
 #include "native-state.h"
 #include "gl-state.h"
+#include "gl-memory.h"
 #include "log.h"
 #include "options.h"
 #include "util.h"
@@ -183,7 +184,33 @@ CanvasGeneric::resize(int width, int height)
 unsigned int
 CanvasGeneric::fbo()
 {
-    return fbo_;
+    return fbos_.empty() ? 0 : fbos_[current_surface_];
+}
+
+void
+CanvasGeneric::select_surface(unsigned int index)
+{
+    if (index >= surfaces_ || index == current_surface_)
+        return;
+
+    if (offscreen_)
+        glBindFramebuffer(GL_FRAMEBUFFER, fbos_[index]);
+    else if (!gl_state_.select_surface(index))
+        return;
+
+    current_surface_ = index;
+}
+
+GLSharedContext *
+CanvasGeneric::create_shared_context()
+{
+    return gl_state_.create_shared_context();
+}
+
+GLImage *
+CanvasGeneric::import_dma_buf(const GLDmaBuf &buf)
+{
+    return gl_state_.import_dma_buf(buf);
 }
 
 
@@ -250,19 +277,24 @@ CanvasGeneric::resize_no_viewport(int width, int height)
 
     native_window_ = native_state_.window(cur_properties);
 
+    /* The other surfaces get windows with the same properties */
+    if (!offscreen_ && surfaces_ > 1 &&
+        !native_state_.create_extra_windows(surfaces_ - 1))
+    {
+        Log::error("Error: Couldn't create %u native windows!\n", surfaces_);
+        return false;
+    }
+
     width_ = cur_properties.width;
     height_ = cur_properties.height;
 
-    if (color_renderbuffer_) {
-        glBindRenderbuffer(GL_RENDERBUFFER, color_renderbuffer_);
-        glRenderbufferStorage(GL_RENDERBUFFER, gl_color_format_,
-                              width_, height_);
-    }
-
-    if (depth_renderbuffer_) {
-        glBindRenderbuffer(GL_RENDERBUFFER, depth_renderbuffer_);
-        glRenderbufferStorage(GL_RENDERBUFFER, gl_depth_format_,
-                              width_, height_);
+    for (size_t i = 0; i < fbos_.size(); i++) {
+        glBindRenderbuffer(GL_RENDERBUFFER, color_renderbuffers_[i]);
+        GLMemory::renderbuffer_storage(GL_RENDERBUFFER, gl_color_format_,
+                                       width_, height_);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth_renderbuffers_[i]);
+        GLMemory::renderbuffer_storage(GL_RENDERBUFFER, gl_depth_format_,
+                                       width_, height_);
     }
 
     projection_ = LibMatrix::Mat4::perspective(60.0, width_ / static_cast<float>(height_),
@@ -283,11 +315,23 @@ CanvasGeneric::do_make_current()
 
     gl_state_.init_gl_extensions();
 
+    current_surface_ = 0;
+
     if (offscreen_) {
         if (!ensure_fbo())
             return false;
 
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbos_[0]);
+    }
+    else if (surfaces_ > 1) {
+        std::vector<void*> windows;
+        for (unsigned int i = 0; i < surfaces_ - 1; i++)
+            windows.push_back(native_state_.extra_window(i));
+
+        if (!gl_state_.init_extra_surfaces(&windows[0], windows.size())) {
+            Log::error("CanvasGeneric: Couldn't create %u surfaces\n", surfaces_);
+            return false;
+        }
     }
 
     return true;
@@ -378,29 +422,40 @@ CanvasGeneric::ensure_gl_formats()
 bool
 CanvasGeneric::ensure_fbo()
 {
-    if (!fbo_) {
+    if (fbos_.empty()) {
         if (!ensure_gl_formats())
             return false;
 
-        /* Create a texture for the color attachment  */
-        glGenRenderbuffers(1, &color_renderbuffer_);
-        glBindRenderbuffer(GL_RENDERBUFFER, color_renderbuffer_);
-        glRenderbufferStorage(GL_RENDERBUFFER, gl_color_format_,
-                              width_, height_);
-
-        /* Create a renderbuffer for the depth attachment */
-        glGenRenderbuffers(1, &depth_renderbuffer_);
-        glBindRenderbuffer(GL_RENDERBUFFER, depth_renderbuffer_);
-        glRenderbufferStorage(GL_RENDERBUFFER, gl_depth_format_,
-                              width_, height_);
-
-        /* Create a FBO and set it up */
-        glGenFramebuffers(1, &fbo_);
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                                  GL_RENDERBUFFER, color_renderbuffer_);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-                                  GL_RENDERBUFFER, depth_renderbuffer_);
+        /* Create one FBO for each surface */
+        for (unsigned int i = 0; i < surfaces_; i++) {
+            GLuint color_renderbuffer;
+            GLuint depth_renderbuffer;
+            GLuint fbo;
+
+            /* Create a texture for the color attachment  */
+            glGenRenderbuffers(1, &color_renderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, color_renderbuffer);
+            GLMemory::renderbuffer_storage(GL_RENDERBUFFER, gl_color_format_,
+                                           width_, height_);
+
+            /* Create a renderbuffer for the depth attachment */
+            glGenRenderbuffers(1, &depth_renderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, depth_renderbuffer);
+            GLMemory::renderbuffer_storage(GL_RENDERBUFFER, gl_depth_format_,
+                                           width_, height_);
+
+            /* Create a FBO and set it up */
+            glGenFramebuffers(1, &fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                      GL_RENDERBUFFER, color_renderbuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                      GL_RENDERBUFFER, depth_renderbuffer);
+
+            color_renderbuffers_.push_back(color_renderbuffer);
+            depth_renderbuffers_.push_back(depth_renderbuffer);
+            fbos_.push_back(fbo);
+        }
     }
 
     return true;
@@ -409,18 +464,17 @@ CanvasGeneric::ensure_fbo()
 void
 CanvasGeneric::release_fbo()
 {
-    if (fbo_) {
-        glDeleteFramebuffers(1, &fbo_);
-        fbo_ = 0;
-    }
-    if (color_renderbuffer_) {
-        glDeleteRenderbuffers(1, &color_renderbuffer_);
-        color_renderbuffer_ = 0;
-    }
-    if (depth_renderbuffer_) {
-        glDeleteRenderbuffers(1, &depth_renderbuffer_);
-        depth_renderbuffer_ = 0;
+    if (!fbos_.empty()) {
+        glDeleteFramebuffers(fbos_.size(), &fbos_[0]);
+        GLMemory::delete_renderbuffers(color_renderbuffers_.size(),
+                                       &color_renderbuffers_[0]);
+        GLMemory::delete_renderbuffers(depth_renderbuffers_.size(),
+                                       &depth_renderbuffers_[0]);
+        fbos_.clear();
+        color_renderbuffers_.clear();
+        depth_renderbuffers_.clear();
     }
+    current_surface_ = 0;
 
     gl_color_format_ = 0;
     gl_depth_format_ = 0;
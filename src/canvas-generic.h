@@ -25,6 +25,8 @@
 
 #include "canvas.h"
 
+#include <vector>
+
 class GLState;
 class NativeState;
 
@@ -38,8 +40,7 @@ public:
                   int width, int height)
         : Canvas(width, height),
           native_state_(native_state), gl_state_(gl_state),
-          gl_color_format_(0), gl_depth_format_(0),
-          color_renderbuffer_(0), depth_renderbuffer_(0), fbo_(0) {}
+          gl_color_format_(0), gl_depth_format_(0), current_surface_(0) {}
 
     bool init();
     bool reset();
@@ -52,6 +53,9 @@ public:
     bool should_quit();
     void resize(int width, int height);
     unsigned int fbo();
+    void select_surface(unsigned int index);
+    GLSharedContext *create_shared_context();
+    GLImage *import_dma_buf(const GLDmaBuf &buf);
 
 private:
     bool supports_gl2();
@@ -67,9 +71,11 @@ private:
     void* native_window_;
     GLenum gl_color_format_;
     GLenum gl_depth_format_;
-    GLuint color_renderbuffer_;
-    GLuint depth_renderbuffer_;
-    GLuint fbo_;
+    /* The off-screen surfaces, one for each surface of the canvas */
+    std::vector<GLuint> color_renderbuffers_;
+    std::vector<GLuint> depth_renderbuffers_;
+    std::vector<GLuint> fbos_;
+    unsigned int current_surface_;
 };
 
 #endif /* GLMARK2_CANVAS_GENERIC_H_ */
@@ -34,6 +34,10 @@
 #include <stdio.h>
 #include <cmath>
 
+class GLSharedContext;
+class GLImage;
+struct GLDmaBuf;
+
 /**
  * Abstraction for a GL rendering target.
  */
@@ -199,6 +203,37 @@ public:
      */
     virtual unsigned int fbo() { return 0; }
 
+    /**
+     * Makes one of the surfaces of the canvas the target of the following
+     * clear(), drawing and update().
+     *
+     * @param index the index of the surface, less than surfaces()
+     */
+    virtual void select_surface(unsigned int index) { static_cast<void>(index); }
+
+    /**
+     * Creates a GL context that shares objects with the context of the
+     * canvas, for use by another thread.
+     *
+     * @return the context, owned by the caller, or 0 if the canvas
+     *         cannot create one
+     */
+    virtual GLSharedContext *create_shared_context() { return 0; }
+
+    /**
+     * Imports a dma-buf as an image that textures can sample.
+     *
+     * @param buf the format and planes of the dma-buf
+     *
+     * @return the image, owned by the caller, or 0 if the canvas cannot
+     *         import the dma-buf
+     */
+    virtual GLImage *import_dma_buf(const GLDmaBuf &buf)
+    {
+        static_cast<void>(buf);
+        return 0;
+    }
+
     /**
      * Gets a dummy canvas object.
      *
@@ -247,14 +282,28 @@ public:
      */
     void visual_config(GLVisualConfig &config) { visual_config_ = config; }
 
+    /**
+     * Sets the number of surfaces of the canvas, all of the same size,
+     * which are drawn and presented in turn in each frame.
+     *
+     * This takes effect after the next init()/reset().
+     */
+    void surfaces(unsigned int count) { surfaces_ = count; }
+
+    /**
+     * Gets the number of surfaces of the canvas.
+     */
+    unsigned int surfaces() { return surfaces_; }
+
 protected:
     Canvas(int width, int height) :
-        width_(width), height_(height), offscreen_(false) {}
+        width_(width), height_(height), offscreen_(false), surfaces_(1) {}
 
     int width_;
     int height_;
     LibMatrix::mat4 projection_;
     bool offscreen_;
+    unsigned int surfaces_;
     GLVisualConfig visual_config_;
 };
 
@@ -46,6 +46,7 @@ private:
         benchmarks.push_back("texture:texture-filter=nearest");
         benchmarks.push_back("texture:texture-filter=linear");
         benchmarks.push_back("texture:texture-filter=mipmap");
+        benchmarks.push_back("texture:texture-filter=mipmap:anisotropy=sweep");
         benchmarks.push_back("shading:shading=gouraud");
         benchmarks.push_back("shading:shading=blinn-phong-inf");
         benchmarks.push_back("shading:shading=phong");
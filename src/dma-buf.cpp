@@ -0,0 +1,164 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "dma-buf.h"
+#include "log.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/udmabuf.h>)
+#define GLMARK2_HAVE_UDMABUF 1
+#endif
+#endif
+
+#if GLMARK2_HAVE_UDMABUF
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/dma-buf.h>
+#include <linux/udmabuf.h>
+
+static const char *udmabuf_path = "/dev/udmabuf";
+
+bool
+DmaBuf::available()
+{
+    return access(udmabuf_path, R_OK | W_OK) == 0;
+}
+
+bool
+DmaBuf::allocate(size_t size)
+{
+    release();
+
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    size = (size + page_size - 1) / page_size * page_size;
+
+    int dev_fd = open(udmabuf_path, O_RDWR | O_CLOEXEC);
+    if (dev_fd < 0) {
+        Log::error("DmaBuf: failed to open %s: %s\n", udmabuf_path, strerror(errno));
+        return false;
+    }
+
+    /* udmabuf only accepts memfds that cannot shrink */
+    memfd_ = memfd_create("glmark2-dma-buf", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd_ < 0 ||
+        ftruncate(memfd_, size) < 0 ||
+        fcntl(memfd_, F_ADD_SEALS, F_SEAL_SHRINK) < 0)
+    {
+        Log::error("DmaBuf: failed to create a memfd: %s\n", strerror(errno));
+        close(dev_fd);
+        release();
+        return false;
+    }
+
+    struct udmabuf_create create;
+    memset(&create, 0, sizeof(create));
+    create.memfd = memfd_;
+    create.flags = UDMABUF_FLAGS_CLOEXEC;
+    create.offset = 0;
+    create.size = size;
+
+    fd_ = ioctl(dev_fd, UDMABUF_CREATE, &create);
+    close(dev_fd);
+
+    if (fd_ < 0) {
+        Log::error("DmaBuf: UDMABUF_CREATE failed: %s\n", strerror(errno));
+        release();
+        return false;
+    }
+
+    void *data = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+        Log::error("DmaBuf: failed to map the buffer: %s\n", strerror(errno));
+        release();
+        return false;
+    }
+
+    data_ = static_cast<unsigned char *>(data);
+    size_ = size;
+
+    return true;
+}
+
+void
+DmaBuf::release()
+{
+    if (data_)
+        munmap(data_, size_);
+    if (fd_ >= 0)
+        close(fd_);
+    if (memfd_ >= 0)
+        close(memfd_);
+
+    memfd_ = -1;
+    fd_ = -1;
+    data_ = 0;
+    size_ = 0;
+}
+
+void
+DmaBuf::begin_cpu_access()
+{
+    struct dma_buf_sync sync;
+    sync.flags = DMA_BUF_SYNC_START | DMA_BUF_SYNC_WRITE;
+    ioctl(fd_, DMA_BUF_IOCTL_SYNC, &sync);
+}
+
+void
+DmaBuf::end_cpu_access()
+{
+    struct dma_buf_sync sync;
+    sync.flags = DMA_BUF_SYNC_END | DMA_BUF_SYNC_WRITE;
+    ioctl(fd_, DMA_BUF_IOCTL_SYNC, &sync);
+}
+
+#else
+
+bool
+DmaBuf::available()
+{
+    return false;
+}
+
+bool
+DmaBuf::allocate(size_t size)
+{
+    static_cast<void>(size);
+    Log::error("DmaBuf: udmabuf is not supported on this platform\n");
+    return false;
+}
+
+void
+DmaBuf::release()
+{
+}
+
+void
+DmaBuf::begin_cpu_access()
+{
+}
+
+void
+DmaBuf::end_cpu_access()
+{
+}
+
+#endif
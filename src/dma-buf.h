@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_DMA_BUF_H_
+#define GLMARK2_DMA_BUF_H_
+
+#include <cstddef>
+
+/**
+ * A dma-buf backed by CPU memory, allocated through udmabuf from a sealed
+ * memfd.
+ *
+ * The buffer is mapped for CPU access, which must be bracketed by
+ * begin_cpu_access() and end_cpu_access() so that the exporter keeps the
+ * caches coherent with the devices that import it.
+ */
+class DmaBuf
+{
+public:
+    /* The DRM fourcc codes of the formats that scenes stream */
+    static const unsigned int FourccABGR8888 = 0x34324241; /* 'AB24' */
+    static const unsigned int FourccNV12 = 0x3231564E;     /* 'NV12' */
+    static const unsigned int FourccYUV420 = 0x32315559;   /* 'YU12' */
+
+    DmaBuf() : memfd_(-1), fd_(-1), data_(0), size_(0) {}
+    ~DmaBuf() { release(); }
+
+    /**
+     * Whether dma-bufs can be allocated, that is whether the udmabuf
+     * device is accessible.
+     */
+    static bool available();
+
+    /**
+     * Allocates and maps the buffer, releasing any previous one.
+     *
+     * @param size the size in bytes, rounded up to whole pages
+     *
+     * @return whether the allocation succeeded
+     */
+    bool allocate(size_t size);
+
+    /**
+     * Unmaps and closes the buffer.
+     */
+    void release();
+
+    void begin_cpu_access();
+    void end_cpu_access();
+
+    /** The dma-buf file descriptor, to import the buffer with */
+    int fd() const { return fd_; }
+    unsigned char *data() { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    DmaBuf(const DmaBuf &);
+    DmaBuf &operator=(const DmaBuf &);
+
+    int memfd_;
+    int fd_;
+    unsigned char *data_;
+    size_t size_;
+};
+
+#endif /* GLMARK2_DMA_BUF_H_ */
@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "frame-pacing.h"
+
+#include <cmath>
+
+void
+FramePacing::reset()
+{
+    last_us_ = 0;
+    intervals_ = 0;
+    sum_us_ = 0.0;
+    sum_sq_us_ = 0.0;
+    max_us_ = 0.0;
+}
+
+void
+FramePacing::add(uint64_t timestamp_us)
+{
+    if (last_us_ != 0) {
+        double interval_us = static_cast<double>(timestamp_us - last_us_);
+
+        intervals_++;
+        sum_us_ += interval_us;
+        sum_sq_us_ += interval_us * interval_us;
+        if (interval_us > max_us_)
+            max_us_ = interval_us;
+    }
+
+    last_us_ = timestamp_us;
+}
+
+double
+FramePacing::mean_ms() const
+{
+    if (intervals_ == 0)
+        return 0.0;
+
+    return sum_us_ / intervals_ / 1000.0;
+}
+
+double
+FramePacing::stddev_ms() const
+{
+    if (intervals_ == 0)
+        return 0.0;
+
+    double mean_us = sum_us_ / intervals_;
+    double variance = sum_sq_us_ / intervals_ - mean_us * mean_us;
+
+    return variance > 0.0 ? std::sqrt(variance) / 1000.0 : 0.0;
+}
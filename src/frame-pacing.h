@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_FRAME_PACING_H_
+#define GLMARK2_FRAME_PACING_H_
+
+#include <stdint.h>
+
+/**
+ * Statistics of the intervals between presentations.
+ *
+ * Only running sums are kept, so recording a presentation does not
+ * allocate.
+ */
+class FramePacing
+{
+public:
+    FramePacing() { reset(); }
+
+    /**
+     * Forgets all recorded presentations.
+     */
+    void reset();
+
+    /**
+     * Records a presentation.
+     *
+     * @param timestamp_us the time of the presentation in microseconds
+     */
+    void add(uint64_t timestamp_us);
+
+    /**
+     * Gets the number of intervals, one less than the presentations.
+     */
+    unsigned int intervals() const { return intervals_; }
+
+    /**
+     * Gets the mean interval in milliseconds.
+     */
+    double mean_ms() const;
+
+    /**
+     * Gets the standard deviation of the intervals in milliseconds.
+     */
+    double stddev_ms() const;
+
+    /**
+     * Gets the longest interval in milliseconds.
+     */
+    double max_ms() const { return max_us_ / 1000.0; }
+
+private:
+    uint64_t last_us_;
+    unsigned int intervals_;
+    double sum_us_;
+    double sum_sq_us_;
+    double max_us_;
+};
+
+#endif
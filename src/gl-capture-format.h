@@ -0,0 +1,117 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_GL_CAPTURE_FORMAT_H_
+#define GLMARK2_GL_CAPTURE_FORMAT_H_
+
+#include <stdint.h>
+
+/*
+ * The format of GL command stream recordings.
+ *
+ * A recording consists of a header followed by a stream of commands. Each
+ * command is an opcode byte followed by its arguments in native byte order.
+ * Blobs (payloads, strings) are stored as a 64-bit size followed by the
+ * data, which starts at an 8-byte aligned offset, so that it can be used in
+ * place during replay.
+ */
+namespace GLCaptureFormat
+{
+
+static const char magic[8] = {'G', 'L', 'M', 'K', 'C', 'A', 'P', '\0'};
+static const uint32_t version = 2;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t default_fbo;
+    uint32_t width;
+    uint32_t height;
+};
+
+enum Op {
+    OpEndSetup,
+    OpEndFrame,
+    OpActiveTexture,
+    OpAttachShader,
+    OpBindBuffer,
+    OpBindFramebuffer,
+    OpBindRenderbuffer,
+    OpBindTexture,
+    OpBlendFunc,
+    OpBlendFuncSeparate,
+    OpBufferData,
+    OpBufferSubData,
+    OpClear,
+    OpClearColor,
+    OpClearDepth,
+    OpClientAttrib,
+    OpColorMask,
+    OpCompileShader,
+    OpCreateProgram,
+    OpCreateShader,
+    OpCullFace,
+    OpDeleteBuffers,
+    OpDeleteFramebuffers,
+    OpDeleteProgram,
+    OpDeleteRenderbuffers,
+    OpDeleteShader,
+    OpDeleteTextures,
+    OpDepthFunc,
+    OpDepthMask,
+    OpDisable,
+    OpDisableVertexAttribArray,
+    OpDrawArrays,
+    OpDrawElements,
+    OpDrawElementsClient,
+    OpEnable,
+    OpEnableVertexAttribArray,
+    OpFinish,
+    OpFramebufferRenderbuffer,
+    OpFramebufferTexture2D,
+    OpGenBuffers,
+    OpGenFramebuffers,
+    OpGenRenderbuffers,
+    OpGenTextures,
+    OpGenerateMipmap,
+    OpGetAttribLocation,
+    OpGetUniformLocation,
+    OpLinkProgram,
+    OpPixelStorei,
+    OpRenderbufferStorage,
+    OpShaderSource,
+    OpTexImage2D,
+    OpTexParameterf,
+    OpTexParameteri,
+    OpTexSubImage2D,
+    OpUniform1f,
+    OpUniform1i,
+    OpUniform2fv,
+    OpUniform3fv,
+    OpUniform4fv,
+    OpUniformMatrix2fv,
+    OpUniformMatrix3fv,
+    OpUniformMatrix4fv,
+    OpUseProgram,
+    OpVertexAttribPointer,
+    OpViewport
+};
+
+}
+
+#endif
@@ -0,0 +1,1035 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define GLMARK2_GL_CAPTURE_IMPL
+#include "gl-headers.h"
+#include "gl-capture-format.h"
+#include "gl-memory.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace GLCaptureFormat;
+
+bool GLCapture::active_ = false;
+
+namespace GLCapturePrivate
+{
+
+/* A client-side vertex attribute array */
+struct ClientAttrib {
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    GLsizei stride;
+    const void *pointer;
+    bool enabled;
+};
+
+std::string filename;
+Header header;
+std::vector<unsigned char> stream;
+unsigned int frames_left = 0;
+
+GLuint array_buffer = 0;
+GLuint element_array_buffer = 0;
+GLint unpack_alignment = 4;
+std::map<GLuint, ClientAttrib> client_attribs;
+
+/*
+ * Shadow copies of buffer contents, used to capture updates made through
+ * mapped buffers and to find the vertex range of indexed draws.
+ */
+std::map<GLuint, std::vector<unsigned char> > shadows;
+std::vector<unsigned char> map_snapshot;
+GLuint mapped_buffer = 0;
+void *(*real_map_buffer)(GLenum target, GLenum access) = 0;
+GLboolean (*real_unmap_buffer)(GLenum target) = 0;
+
+template <typename T> void
+put(const T &v)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(&v);
+    stream.insert(stream.end(), p, p + sizeof(T));
+}
+
+void
+put_op(Op op)
+{
+    put<uint8_t>(op);
+}
+
+void
+put_blob(const void *data, uint64_t size)
+{
+    put<uint64_t>(size);
+    while (stream.size() % 8)
+        stream.push_back(0);
+
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+    stream.insert(stream.end(), p, p + size);
+}
+
+void
+put_string(const std::string &s)
+{
+    put_blob(s.c_str(), s.size() + 1);
+}
+
+void
+put_names(GLsizei n, const GLuint *names)
+{
+    put<int32_t>(n);
+    for (GLsizei i = 0; i < n; i++)
+        put<uint32_t>(names[i]);
+}
+
+unsigned int
+type_size(GLenum type)
+{
+    switch (type) {
+        case GL_BYTE:
+        case GL_UNSIGNED_BYTE:
+            return 1;
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+            return 2;
+        default:
+            return 4;
+    }
+}
+
+GLuint
+bound_buffer(GLenum target)
+{
+    return target == GL_ELEMENT_ARRAY_BUFFER ? element_array_buffer :
+                                               array_buffer;
+}
+
+/**
+ * Gets the size of the client memory read by a texture upload, whose rows
+ * are aligned to the current GL_UNPACK_ALIGNMENT.
+ */
+size_t
+image_size(GLsizei width, GLsizei height, GLenum format, GLenum type)
+{
+    size_t row_size = width * GLMemory::bytes_per_pixel(format, type);
+    size_t align = unpack_alignment;
+    size_t stride = (row_size + align - 1) / align * align;
+
+    return stride * (height - 1) + row_size;
+}
+
+/**
+ * Gets the highest index referenced by an indexed draw.
+ */
+GLuint
+max_index(GLsizei count, GLenum type, const void *indices)
+{
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(indices);
+
+    if (element_array_buffer) {
+        std::vector<unsigned char> &shadow = shadows[element_array_buffer];
+        size_t offset = reinterpret_cast<uintptr_t>(indices);
+        if (offset + count * type_size(type) > shadow.size())
+            return 0;
+        data = &shadow[offset];
+    }
+
+    GLuint max = 0;
+    for (GLsizei i = 0; i < count; i++) {
+        GLuint index;
+        if (type == GL_UNSIGNED_BYTE)
+            index = data[i];
+        else if (type == GL_UNSIGNED_SHORT)
+            index = reinterpret_cast<const GLushort *>(data)[i];
+        else
+            index = reinterpret_cast<const GLuint *>(data)[i];
+        max = std::max(max, index);
+    }
+
+    return max;
+}
+
+/**
+ * Records the data of all enabled client-side arrays needed to draw
+ * vertices [0, nvertices).
+ */
+void
+put_client_attribs(GLuint nvertices)
+{
+    for (std::map<GLuint, ClientAttrib>::const_iterator iter = client_attribs.begin();
+         iter != client_attribs.end();
+         iter++)
+    {
+        const ClientAttrib &attrib = iter->second;
+        if (!attrib.enabled || nvertices == 0)
+            continue;
+
+        size_t element_size = attrib.size * type_size(attrib.type);
+        size_t stride = attrib.stride ? attrib.stride : element_size;
+
+        put_op(OpClientAttrib);
+        put<uint32_t>(iter->first);
+        put<int32_t>(attrib.size);
+        put<uint32_t>(attrib.type);
+        put<uint8_t>(attrib.normalized);
+        put<int32_t>(attrib.stride);
+        put_blob(attrib.pointer, stride * (nvertices - 1) + element_size);
+    }
+}
+
+void
+update_shadow(GLuint buffer, size_t offset, size_t size, const void *data)
+{
+    std::vector<unsigned char> &shadow = shadows[buffer];
+
+    if (offset + size > shadow.size())
+        shadow.resize(offset + size);
+    if (data)
+        std::memcpy(&shadow[offset], data, size);
+}
+
+void *
+map_buffer(GLenum target, GLenum access)
+{
+    GLuint buffer = bound_buffer(target);
+    std::map<GLuint, std::vector<unsigned char> >::iterator iter =
+        shadows.find(buffer);
+
+    /* Buffers with unknown contents can't be captured reliably */
+    if (iter == shadows.end() || iter->second.empty()) {
+        Log::debug("GLCapture: mapping buffer %u with unknown contents\n",
+                   buffer);
+        mapped_buffer = 0;
+        return real_map_buffer(target, access);
+    }
+
+    mapped_buffer = buffer;
+    map_snapshot = iter->second;
+
+    return &iter->second[0];
+}
+
+GLboolean
+unmap_buffer(GLenum target)
+{
+    if (!mapped_buffer)
+        return real_unmap_buffer(target);
+
+    std::vector<unsigned char> &shadow = shadows[mapped_buffer];
+    mapped_buffer = 0;
+
+    /* Only upload and record the range that actually changed */
+    size_t first = 0;
+    size_t last = shadow.size();
+    while (first < last && shadow[first] == map_snapshot[first])
+        first++;
+    while (last > first && shadow[last - 1] == map_snapshot[last - 1])
+        last--;
+
+    if (first == last)
+        return GL_TRUE;
+
+    void *dest = real_map_buffer(target, GL_WRITE_ONLY);
+    if (!dest)
+        return GL_FALSE;
+    std::memcpy(static_cast<unsigned char *>(dest) + first, &shadow[first],
+                last - first);
+    GLboolean ret = real_unmap_buffer(target);
+
+    put_op(OpBufferSubData);
+    put<uint32_t>(target);
+    put<uint64_t>(first);
+    put_blob(&shadow[first], last - first);
+
+    return ret;
+}
+
+}
+
+using namespace GLCapturePrivate;
+
+void
+GLCapture::start(const std::string &filename, unsigned int frames,
+                 GLuint default_fbo, int width, int height)
+{
+    GLCapturePrivate::filename = filename;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.default_fbo = default_fbo;
+    header.width = width;
+    header.height = height;
+    stream.clear();
+    frames_left = frames;
+    array_buffer = 0;
+    element_array_buffer = 0;
+    client_attribs.clear();
+    shadows.clear();
+
+    /* Start the replay with the unpack alignment in effect */
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpack_alignment);
+    put_op(OpPixelStorei);
+    put<uint32_t>(GL_UNPACK_ALIGNMENT);
+    put<int32_t>(unpack_alignment);
+
+    real_map_buffer = GLExtensions::MapBuffer;
+    real_unmap_buffer = GLExtensions::UnmapBuffer;
+    if (real_map_buffer && real_unmap_buffer) {
+        GLExtensions::MapBuffer = map_buffer;
+        GLExtensions::UnmapBuffer = unmap_buffer;
+    }
+
+    active_ = true;
+}
+
+void
+GLCapture::end_setup()
+{
+    if (!active_)
+        return;
+
+    put_op(OpEndSetup);
+}
+
+void
+GLCapture::end_frame()
+{
+    if (!active_)
+        return;
+
+    put_op(OpEndFrame);
+
+    if (frames_left > 0 && --frames_left == 0)
+        stop();
+}
+
+void
+GLCapture::stop()
+{
+    if (!active_)
+        return;
+
+    active_ = false;
+    GLExtensions::MapBuffer = real_map_buffer;
+    GLExtensions::UnmapBuffer = real_unmap_buffer;
+
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    if (out) {
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(&stream[0]), stream.size());
+    }
+
+    if (out) {
+        Log::info("Recorded GL command stream to %s (%zu bytes)\n",
+                  filename.c_str(), sizeof(header) + stream.size());
+    }
+    else {
+        Log::error("Failed to write GL command stream to %s\n",
+                   filename.c_str());
+    }
+
+    std::vector<unsigned char>().swap(stream);
+    shadows.clear();
+    client_attribs.clear();
+}
+
+void
+GLCapture::ActiveTexture(GLenum texture)
+{
+    glActiveTexture(texture);
+    put_op(OpActiveTexture);
+    put<uint32_t>(texture);
+}
+
+void
+GLCapture::AttachShader(GLuint program, GLuint shader)
+{
+    glAttachShader(program, shader);
+    put_op(OpAttachShader);
+    put<uint32_t>(program);
+    put<uint32_t>(shader);
+}
+
+void
+GLCapture::BindBuffer(GLenum target, GLuint buffer)
+{
+    glBindBuffer(target, buffer);
+    if (target == GL_ELEMENT_ARRAY_BUFFER)
+        element_array_buffer = buffer;
+    else if (target == GL_ARRAY_BUFFER)
+        array_buffer = buffer;
+    put_op(OpBindBuffer);
+    put<uint32_t>(target);
+    put<uint32_t>(buffer);
+}
+
+void
+GLCapture::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    glBindFramebuffer(target, framebuffer);
+    put_op(OpBindFramebuffer);
+    put<uint32_t>(target);
+    put<uint32_t>(framebuffer);
+}
+
+void
+GLCapture::BindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    glBindRenderbuffer(target, renderbuffer);
+    put_op(OpBindRenderbuffer);
+    put<uint32_t>(target);
+    put<uint32_t>(renderbuffer);
+}
+
+void
+GLCapture::BindTexture(GLenum target, GLuint texture)
+{
+    glBindTexture(target, texture);
+    put_op(OpBindTexture);
+    put<uint32_t>(target);
+    put<uint32_t>(texture);
+}
+
+void
+GLCapture::BlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    glBlendFunc(sfactor, dfactor);
+    put_op(OpBlendFunc);
+    put<uint32_t>(sfactor);
+    put<uint32_t>(dfactor);
+}
+
+void
+GLCapture::BlendFuncSeparate(GLenum src_rgb, GLenum dst_rgb,
+                             GLenum src_alpha, GLenum dst_alpha)
+{
+    glBlendFuncSeparate(src_rgb, dst_rgb, src_alpha, dst_alpha);
+    put_op(OpBlendFuncSeparate);
+    put<uint32_t>(src_rgb);
+    put<uint32_t>(dst_rgb);
+    put<uint32_t>(src_alpha);
+    put<uint32_t>(dst_alpha);
+}
+
+void
+GLCapture::BufferData(GLenum target, GLsizeiptr size, const void *data,
+                      GLenum usage)
+{
+    glBufferData(target, size, data, usage);
+
+    GLuint buffer = bound_buffer(target);
+    shadows[buffer].assign(size, 0);
+    update_shadow(buffer, 0, size, data);
+
+    put_op(OpBufferData);
+    put<uint32_t>(target);
+    put<uint32_t>(usage);
+    put<uint64_t>(size);
+    put<uint8_t>(data != 0);
+    if (data)
+        put_blob(data, size);
+}
+
+void
+GLCapture::BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size,
+                         const void *data)
+{
+    glBufferSubData(target, offset, size, data);
+    update_shadow(bound_buffer(target), offset, size, data);
+
+    put_op(OpBufferSubData);
+    put<uint32_t>(target);
+    put<uint64_t>(offset);
+    put_blob(data, size);
+}
+
+void
+GLCapture::Clear(GLbitfield mask)
+{
+    glClear(mask);
+    put_op(OpClear);
+    put<uint32_t>(mask);
+}
+
+void
+GLCapture::ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    glClearColor(red, green, blue, alpha);
+    put_op(OpClearColor);
+    put<float>(red);
+    put<float>(green);
+    put<float>(blue);
+    put<float>(alpha);
+}
+
+void
+GLCapture::ClearDepthf(GLfloat depth)
+{
+    glClearDepthf(depth);
+    put_op(OpClearDepth);
+    put<float>(depth);
+}
+
+#if GLMARK2_USE_GL
+void
+GLCapture::ClearDepth(GLclampd depth)
+{
+    glClearDepth(depth);
+    put_op(OpClearDepth);
+    put<float>(depth);
+}
+#endif
+
+void
+GLCapture::ColorMask(GLboolean red, GLboolean green, GLboolean blue,
+                     GLboolean alpha)
+{
+    glColorMask(red, green, blue, alpha);
+    put_op(OpColorMask);
+    put<uint8_t>(red);
+    put<uint8_t>(green);
+    put<uint8_t>(blue);
+    put<uint8_t>(alpha);
+}
+
+void
+GLCapture::CompileShader(GLuint shader)
+{
+    glCompileShader(shader);
+    put_op(OpCompileShader);
+    put<uint32_t>(shader);
+}
+
+GLuint
+GLCapture::CreateProgram()
+{
+    GLuint program = glCreateProgram();
+    put_op(OpCreateProgram);
+    put<uint32_t>(program);
+    return program;
+}
+
+GLuint
+GLCapture::CreateShader(GLenum type)
+{
+    GLuint shader = glCreateShader(type);
+    put_op(OpCreateShader);
+    put<uint32_t>(type);
+    put<uint32_t>(shader);
+    return shader;
+}
+
+void
+GLCapture::CullFace(GLenum mode)
+{
+    glCullFace(mode);
+    put_op(OpCullFace);
+    put<uint32_t>(mode);
+}
+
+void
+GLCapture::DeleteBuffers(GLsizei n, const GLuint *buffers)
+{
+    for (GLsizei i = 0; i < n; i++)
+        shadows.erase(buffers[i]);
+    glDeleteBuffers(n, buffers);
+    put_op(OpDeleteBuffers);
+    put_names(n, buffers);
+}
+
+void
+GLCapture::DeleteFramebuffers(GLsizei n, const GLuint *framebuffers)
+{
+    glDeleteFramebuffers(n, framebuffers);
+    put_op(OpDeleteFramebuffers);
+    put_names(n, framebuffers);
+}
+
+void
+GLCapture::DeleteProgram(GLuint program)
+{
+    glDeleteProgram(program);
+    put_op(OpDeleteProgram);
+    put<uint32_t>(program);
+}
+
+void
+GLCapture::DeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers)
+{
+    glDeleteRenderbuffers(n, renderbuffers);
+    put_op(OpDeleteRenderbuffers);
+    put_names(n, renderbuffers);
+}
+
+void
+GLCapture::DeleteShader(GLuint shader)
+{
+    glDeleteShader(shader);
+    put_op(OpDeleteShader);
+    put<uint32_t>(shader);
+}
+
+void
+GLCapture::DeleteTextures(GLsizei n, const GLuint *textures)
+{
+    glDeleteTextures(n, textures);
+    put_op(OpDeleteTextures);
+    put_names(n, textures);
+}
+
+void
+GLCapture::DepthFunc(GLenum func)
+{
+    glDepthFunc(func);
+    put_op(OpDepthFunc);
+    put<uint32_t>(func);
+}
+
+void
+GLCapture::DepthMask(GLboolean flag)
+{
+    glDepthMask(flag);
+    put_op(OpDepthMask);
+    put<uint8_t>(flag);
+}
+
+void
+GLCapture::Disable(GLenum cap)
+{
+    glDisable(cap);
+    put_op(OpDisable);
+    put<uint32_t>(cap);
+}
+
+void
+GLCapture::DisableVertexAttribArray(GLuint index)
+{
+    glDisableVertexAttribArray(index);
+    std::map<GLuint, ClientAttrib>::iterator iter = client_attribs.find(index);
+    if (iter != client_attribs.end())
+        iter->second.enabled = false;
+    put_op(OpDisableVertexAttribArray);
+    put<uint32_t>(index);
+}
+
+void
+GLCapture::DrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    glDrawArrays(mode, first, count);
+    put_client_attribs(first + count);
+    put_op(OpDrawArrays);
+    put<uint32_t>(mode);
+    put<int32_t>(first);
+    put<int32_t>(count);
+}
+
+void
+GLCapture::DrawElements(GLenum mode, GLsizei count, GLenum type,
+                        const void *indices)
+{
+    glDrawElements(mode, count, type, indices);
+
+    if (!client_attribs.empty())
+        put_client_attribs(max_index(count, type, indices) + 1);
+
+    if (element_array_buffer) {
+        put_op(OpDrawElements);
+        put<uint32_t>(mode);
+        put<int32_t>(count);
+        put<uint32_t>(type);
+        put<uint64_t>(reinterpret_cast<uintptr_t>(indices));
+    }
+    else {
+        put_op(OpDrawElementsClient);
+        put<uint32_t>(mode);
+        put<int32_t>(count);
+        put<uint32_t>(type);
+        put_blob(indices, count * type_size(type));
+    }
+}
+
+void
+GLCapture::Enable(GLenum cap)
+{
+    glEnable(cap);
+    put_op(OpEnable);
+    put<uint32_t>(cap);
+}
+
+void
+GLCapture::EnableVertexAttribArray(GLuint index)
+{
+    glEnableVertexAttribArray(index);
+    std::map<GLuint, ClientAttrib>::iterator iter = client_attribs.find(index);
+    if (iter != client_attribs.end())
+        iter->second.enabled = true;
+    put_op(OpEnableVertexAttribArray);
+    put<uint32_t>(index);
+}
+
+void
+GLCapture::Finish()
+{
+    glFinish();
+    put_op(OpFinish);
+}
+
+void
+GLCapture::FramebufferRenderbuffer(GLenum target, GLenum attachment,
+                                   GLenum renderbuffertarget,
+                                   GLuint renderbuffer)
+{
+    glFramebufferRenderbuffer(target, attachment, renderbuffertarget,
+                              renderbuffer);
+    put_op(OpFramebufferRenderbuffer);
+    put<uint32_t>(target);
+    put<uint32_t>(attachment);
+    put<uint32_t>(renderbuffertarget);
+    put<uint32_t>(renderbuffer);
+}
+
+void
+GLCapture::FramebufferTexture2D(GLenum target, GLenum attachment,
+                                GLenum textarget, GLuint texture, GLint level)
+{
+    glFramebufferTexture2D(target, attachment, textarget, texture, level);
+    put_op(OpFramebufferTexture2D);
+    put<uint32_t>(target);
+    put<uint32_t>(attachment);
+    put<uint32_t>(textarget);
+    put<uint32_t>(texture);
+    put<int32_t>(level);
+}
+
+void
+GLCapture::GenBuffers(GLsizei n, GLuint *buffers)
+{
+    glGenBuffers(n, buffers);
+    put_op(OpGenBuffers);
+    put_names(n, buffers);
+}
+
+void
+GLCapture::GenFramebuffers(GLsizei n, GLuint *framebuffers)
+{
+    glGenFramebuffers(n, framebuffers);
+    put_op(OpGenFramebuffers);
+    put_names(n, framebuffers);
+}
+
+void
+GLCapture::GenRenderbuffers(GLsizei n, GLuint *renderbuffers)
+{
+    glGenRenderbuffers(n, renderbuffers);
+    put_op(OpGenRenderbuffers);
+    put_names(n, renderbuffers);
+}
+
+void
+GLCapture::GenTextures(GLsizei n, GLuint *textures)
+{
+    glGenTextures(n, textures);
+    put_op(OpGenTextures);
+    put_names(n, textures);
+}
+
+void
+GLCapture::GenerateMipmap(GLenum target)
+{
+    glGenerateMipmap(target);
+    put_op(OpGenerateMipmap);
+    put<uint32_t>(target);
+}
+
+GLint
+GLCapture::GetAttribLocation(GLuint program, const GLchar *name)
+{
+    GLint location = glGetAttribLocation(program, name);
+    put_op(OpGetAttribLocation);
+    put<uint32_t>(program);
+    put_string(name);
+    put<int32_t>(location);
+    return location;
+}
+
+GLint
+GLCapture::GetUniformLocation(GLuint program, const GLchar *name)
+{
+    GLint location = glGetUniformLocation(program, name);
+    put_op(OpGetUniformLocation);
+    put<uint32_t>(program);
+    put_string(name);
+    put<int32_t>(location);
+    return location;
+}
+
+void
+GLCapture::LinkProgram(GLuint program)
+{
+    glLinkProgram(program);
+    put_op(OpLinkProgram);
+    put<uint32_t>(program);
+}
+
+void
+GLCapture::PixelStorei(GLenum pname, GLint param)
+{
+    glPixelStorei(pname, param);
+    if (pname == GL_UNPACK_ALIGNMENT)
+        unpack_alignment = param;
+    put_op(OpPixelStorei);
+    put<uint32_t>(pname);
+    put<int32_t>(param);
+}
+
+void
+GLCapture::RenderbufferStorage(GLenum target, GLenum internalformat,
+                               GLsizei width, GLsizei height)
+{
+    glRenderbufferStorage(target, internalformat, width, height);
+    put_op(OpRenderbufferStorage);
+    put<uint32_t>(target);
+    put<uint32_t>(internalformat);
+    put<int32_t>(width);
+    put<int32_t>(height);
+}
+
+void
+GLCapture::ShaderSource(GLuint shader, GLsizei count,
+                        const GLchar *const *string, const GLint *length)
+{
+    glShaderSource(shader, count, string, length);
+
+    /* Record all the source strings as a single string */
+    std::string source;
+    for (GLsizei i = 0; i < count; i++) {
+        if (length && length[i] >= 0)
+            source.append(string[i], length[i]);
+        else
+            source.append(string[i]);
+    }
+
+    put_op(OpShaderSource);
+    put<uint32_t>(shader);
+    put_string(source);
+}
+
+void
+GLCapture::TexImage2D(GLenum target, GLint level, GLint internalformat,
+                      GLsizei width, GLsizei height, GLint border,
+                      GLenum format, GLenum type, const void *pixels)
+{
+    glTexImage2D(target, level, internalformat, width, height, border,
+                 format, type, pixels);
+
+    put_op(OpTexImage2D);
+    put<uint32_t>(target);
+    put<int32_t>(level);
+    put<int32_t>(internalformat);
+    put<int32_t>(width);
+    put<int32_t>(height);
+    put<int32_t>(border);
+    put<uint32_t>(format);
+    put<uint32_t>(type);
+    put<uint8_t>(pixels != 0);
+
+    if (pixels && width > 0 && height > 0)
+        put_blob(pixels, image_size(width, height, format, type));
+}
+
+void
+GLCapture::TexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+    glTexParameterf(target, pname, param);
+    put_op(OpTexParameterf);
+    put<uint32_t>(target);
+    put<uint32_t>(pname);
+    put<float>(param);
+}
+
+void
+GLCapture::TexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    glTexParameteri(target, pname, param);
+    put_op(OpTexParameteri);
+    put<uint32_t>(target);
+    put<uint32_t>(pname);
+    put<int32_t>(param);
+}
+
+void
+GLCapture::TexSubImage2D(GLenum target, GLint level, GLint xoffset,
+                         GLint yoffset, GLsizei width, GLsizei height,
+                         GLenum format, GLenum type, const void *pixels)
+{
+    glTexSubImage2D(target, level, xoffset, yoffset, width, height,
+                    format, type, pixels);
+
+    put_op(OpTexSubImage2D);
+    put<uint32_t>(target);
+    put<int32_t>(level);
+    put<int32_t>(xoffset);
+    put<int32_t>(yoffset);
+    put<int32_t>(width);
+    put<int32_t>(height);
+    put<uint32_t>(format);
+    put<uint32_t>(type);
+
+    if (width > 0 && height > 0)
+        put_blob(pixels, image_size(width, height, format, type));
+}
+
+void
+GLCapture::Uniform1f(GLint location, GLfloat v0)
+{
+    glUniform1f(location, v0);
+    put_op(OpUniform1f);
+    put<int32_t>(location);
+    put<float>(v0);
+}
+
+void
+GLCapture::Uniform1i(GLint location, GLint v0)
+{
+    glUniform1i(location, v0);
+    put_op(OpUniform1i);
+    put<int32_t>(location);
+    put<int32_t>(v0);
+}
+
+void
+GLCapture::Uniform2fv(GLint location, GLsizei count, const GLfloat *value)
+{
+    glUniform2fv(location, count, value);
+    put_op(OpUniform2fv);
+    put<int32_t>(location);
+    put<int32_t>(count);
+    put_blob(value, 2 * count * sizeof(GLfloat));
+}
+
+void
+GLCapture::Uniform3fv(GLint location, GLsizei count, const GLfloat *value)
+{
+    glUniform3fv(location, count, value);
+    put_op(OpUniform3fv);
+    put<int32_t>(location);
+    put<int32_t>(count);
+    put_blob(value, 3 * count * sizeof(GLfloat));
+}
+
+void
+GLCapture::Uniform4fv(GLint location, GLsizei count, const GLfloat *value)
+{
+    glUniform4fv(location, count, value);
+    put_op(OpUniform4fv);
+    put<int32_t>(location);
+    put<int32_t>(count);
+    put_blob(value, 4 * count * sizeof(GLfloat));
+}
+
+void
+GLCapture::UniformMatrix2fv(GLint location, GLsizei count,
+                            GLboolean transpose, const GLfloat *value)
+{
+    glUniformMatrix2fv(location, count, transpose, value);
+    put_op(OpUniformMatrix2fv);
+    put<int32_t>(location);
+    put<int32_t>(count);
+    put<uint8_t>(transpose);
+    put_blob(value, 4 * count * sizeof(GLfloat));
+}
+
+void
+GLCapture::UniformMatrix3fv(GLint location, GLsizei count,
+                            GLboolean transpose, const GLfloat *value)
+{
+    glUniformMatrix3fv(location, count, transpose, value);
+    put_op(OpUniformMatrix3fv);
+    put<int32_t>(location);
+    put<int32_t>(count);
+    put<uint8_t>(transpose);
+    put_blob(value, 9 * count * sizeof(GLfloat));
+}
+
+void
+GLCapture::UniformMatrix4fv(GLint location, GLsizei count,
+                            GLboolean transpose, const GLfloat *value)
+{
+    glUniformMatrix4fv(location, count, transpose, value);
+    put_op(OpUniformMatrix4fv);
+    put<int32_t>(location);
+    put<int32_t>(count);
+    put<uint8_t>(transpose);
+    put_blob(value, 16 * count * sizeof(GLfloat));
+}
+
+void
+GLCapture::UseProgram(GLuint program)
+{
+    glUseProgram(program);
+    put_op(OpUseProgram);
+    put<uint32_t>(program);
+}
+
+void
+GLCapture::VertexAttribPointer(GLuint index, GLint size, GLenum type,
+                               GLboolean normalized, GLsizei stride,
+                               const void *pointer)
+{
+    glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+
+    /*
+     * Client-side arrays are recorded at draw time, when the range of
+     * vertices that is used is known.
+     */
+    if (!array_buffer) {
+        GLint enabled = 0;
+        glGetVertexAttribiv(index, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+        ClientAttrib attrib = {size, type, normalized, stride, pointer,
+                               enabled != 0};
+        client_attribs[index] = attrib;
+        return;
+    }
+
+    client_attribs.erase(index);
+
+    put_op(OpVertexAttribPointer);
+    put<uint32_t>(index);
+    put<int32_t>(size);
+    put<uint32_t>(type);
+    put<uint8_t>(normalized);
+    put<int32_t>(stride);
+    put<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+}
+
+void
+GLCapture::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    glViewport(x, y, width, height);
+    put_op(OpViewport);
+    put<int32_t>(x);
+    put<int32_t>(y);
+    put<int32_t>(width);
+    put<int32_t>(height);
+}
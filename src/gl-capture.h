@@ -0,0 +1,249 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_GL_CAPTURE_H_
+#define GLMARK2_GL_CAPTURE_H_
+
+/*
+ * This header is included by gl-headers.h and should not be included
+ * directly.
+ */
+
+/**
+ * Records the GL command stream to a file.
+ *
+ * While a capture is active, the GL entry points used by glmark2 are routed
+ * through the methods of this class, which record each call along with any
+ * data it consumes (buffer and texture payloads, shader sources, client-side
+ * arrays) and then forward it to GL.  Queries are not recorded, except for
+ * those whose results are used by later calls (object names and uniform and
+ * attribute locations), so that they can be remapped on replay.
+ *
+ * Vertex array objects, glFlush(), sync objects and query objects are not
+ * recorded.  Scenes that use them refuse to run while a capture is active
+ * (see Scene::require_no_capture()), and GPU timers are not supported then.
+ * The one exception is the vertex array object that core profile contexts
+ * bind when they are initialized, which the replaying context binds in the
+ * same way.
+ *
+ * The recording consists of a setup part, followed by a number of frames.
+ * See GLReplay for playing back a recording.
+ */
+class GLCapture
+{
+public:
+    /**
+     * Starts recording.
+     *
+     * @param filename the file to save the recording to
+     * @param frames the number of frames to record
+     * @param default_fbo the FBO used as the default framebuffer
+     * @param width the width of the default framebuffer
+     * @param height the height of the default framebuffer
+     */
+    static void start(const std::string &filename, unsigned int frames,
+                      GLuint default_fbo, int width, int height);
+
+    /**
+     * Marks the end of the setup part of the recording.
+     */
+    static void end_setup();
+
+    /**
+     * Marks the end of a frame.
+     *
+     * When the requested number of frames has been recorded, the recording
+     * is saved and the capture is stopped.
+     */
+    static void end_frame();
+
+    /**
+     * Stops the capture and saves the recording.
+     */
+    static void stop();
+
+    static bool active() { return active_; }
+
+    static void ActiveTexture(GLenum texture);
+    static void AttachShader(GLuint program, GLuint shader);
+    static void BindBuffer(GLenum target, GLuint buffer);
+    static void BindFramebuffer(GLenum target, GLuint framebuffer);
+    static void BindRenderbuffer(GLenum target, GLuint renderbuffer);
+    static void BindTexture(GLenum target, GLuint texture);
+    static void BlendFunc(GLenum sfactor, GLenum dfactor);
+    static void BlendFuncSeparate(GLenum src_rgb, GLenum dst_rgb,
+                                  GLenum src_alpha, GLenum dst_alpha);
+    static void BufferData(GLenum target, GLsizeiptr size, const void *data,
+                           GLenum usage);
+    static void BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size,
+                              const void *data);
+    static void Clear(GLbitfield mask);
+    static void ClearColor(GLfloat red, GLfloat green, GLfloat blue,
+                           GLfloat alpha);
+    static void ClearDepthf(GLfloat depth);
+#if GLMARK2_USE_GL
+    static void ClearDepth(GLclampd depth);
+#endif
+    static void ColorMask(GLboolean red, GLboolean green, GLboolean blue,
+                          GLboolean alpha);
+    static void CompileShader(GLuint shader);
+    static GLuint CreateProgram();
+    static GLuint CreateShader(GLenum type);
+    static void CullFace(GLenum mode);
+    static void DeleteBuffers(GLsizei n, const GLuint *buffers);
+    static void DeleteFramebuffers(GLsizei n, const GLuint *framebuffers);
+    static void DeleteProgram(GLuint program);
+    static void DeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers);
+    static void DeleteShader(GLuint shader);
+    static void DeleteTextures(GLsizei n, const GLuint *textures);
+    static void DepthFunc(GLenum func);
+    static void DepthMask(GLboolean flag);
+    static void Disable(GLenum cap);
+    static void DisableVertexAttribArray(GLuint index);
+    static void DrawArrays(GLenum mode, GLint first, GLsizei count);
+    static void DrawElements(GLenum mode, GLsizei count, GLenum type,
+                             const void *indices);
+    static void Enable(GLenum cap);
+    static void EnableVertexAttribArray(GLuint index);
+    static void Finish();
+    static void FramebufferRenderbuffer(GLenum target, GLenum attachment,
+                                        GLenum renderbuffertarget,
+                                        GLuint renderbuffer);
+    static void FramebufferTexture2D(GLenum target, GLenum attachment,
+                                     GLenum textarget, GLuint texture,
+                                     GLint level);
+    static void GenBuffers(GLsizei n, GLuint *buffers);
+    static void GenFramebuffers(GLsizei n, GLuint *framebuffers);
+    static void GenRenderbuffers(GLsizei n, GLuint *renderbuffers);
+    static void GenTextures(GLsizei n, GLuint *textures);
+    static void GenerateMipmap(GLenum target);
+    static GLint GetAttribLocation(GLuint program, const GLchar *name);
+    static GLint GetUniformLocation(GLuint program, const GLchar *name);
+    static void LinkProgram(GLuint program);
+    static void PixelStorei(GLenum pname, GLint param);
+    static void RenderbufferStorage(GLenum target, GLenum internalformat,
+                                    GLsizei width, GLsizei height);
+    static void ShaderSource(GLuint shader, GLsizei count,
+                             const GLchar *const *string, const GLint *length);
+    static void TexImage2D(GLenum target, GLint level, GLint internalformat,
+                           GLsizei width, GLsizei height, GLint border,
+                           GLenum format, GLenum type, const void *pixels);
+    static void TexParameterf(GLenum target, GLenum pname, GLfloat param);
+    static void TexParameteri(GLenum target, GLenum pname, GLint param);
+    static void TexSubImage2D(GLenum target, GLint level, GLint xoffset,
+                              GLint yoffset, GLsizei width, GLsizei height,
+                              GLenum format, GLenum type, const void *pixels);
+    static void Uniform1f(GLint location, GLfloat v0);
+    static void Uniform1i(GLint location, GLint v0);
+    static void Uniform2fv(GLint location, GLsizei count, const GLfloat *value);
+    static void Uniform3fv(GLint location, GLsizei count, const GLfloat *value);
+    static void Uniform4fv(GLint location, GLsizei count, const GLfloat *value);
+    static void UniformMatrix2fv(GLint location, GLsizei count,
+                                 GLboolean transpose, const GLfloat *value);
+    static void UniformMatrix3fv(GLint location, GLsizei count,
+                                 GLboolean transpose, const GLfloat *value);
+    static void UniformMatrix4fv(GLint location, GLsizei count,
+                                 GLboolean transpose, const GLfloat *value);
+    static void UseProgram(GLuint program);
+    static void VertexAttribPointer(GLuint index, GLint size, GLenum type,
+                                    GLboolean normalized, GLsizei stride,
+                                    const void *pointer);
+    static void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+private:
+    static bool active_;
+};
+
+/*
+ * Route the GL calls through GLCapture while a capture is active. The
+ * capture implementation itself defines GLMARK2_GL_CAPTURE_IMPL to get
+ * direct access to GL.
+ */
+#ifndef GLMARK2_GL_CAPTURE_IMPL
+#define GLMARK2_GL_CAPTURE(func, ...) \
+    (GLCapture::active() ? GLCapture::func(__VA_ARGS__) : gl##func(__VA_ARGS__))
+
+#define glActiveTexture(...) GLMARK2_GL_CAPTURE(ActiveTexture, __VA_ARGS__)
+#define glAttachShader(...) GLMARK2_GL_CAPTURE(AttachShader, __VA_ARGS__)
+#define glBindBuffer(...) GLMARK2_GL_CAPTURE(BindBuffer, __VA_ARGS__)
+#define glBindFramebuffer(...) GLMARK2_GL_CAPTURE(BindFramebuffer, __VA_ARGS__)
+#define glBindRenderbuffer(...) GLMARK2_GL_CAPTURE(BindRenderbuffer, __VA_ARGS__)
+#define glBindTexture(...) GLMARK2_GL_CAPTURE(BindTexture, __VA_ARGS__)
+#define glBlendFunc(...) GLMARK2_GL_CAPTURE(BlendFunc, __VA_ARGS__)
+#define glBlendFuncSeparate(...) GLMARK2_GL_CAPTURE(BlendFuncSeparate, __VA_ARGS__)
+#define glBufferData(...) GLMARK2_GL_CAPTURE(BufferData, __VA_ARGS__)
+#define glBufferSubData(...) GLMARK2_GL_CAPTURE(BufferSubData, __VA_ARGS__)
+#define glClear(...) GLMARK2_GL_CAPTURE(Clear, __VA_ARGS__)
+#define glClearColor(...) GLMARK2_GL_CAPTURE(ClearColor, __VA_ARGS__)
+#define glClearDepthf(...) GLMARK2_GL_CAPTURE(ClearDepthf, __VA_ARGS__)
+#if GLMARK2_USE_GL
+#define glClearDepth(...) GLMARK2_GL_CAPTURE(ClearDepth, __VA_ARGS__)
+#endif
+#define glColorMask(...) GLMARK2_GL_CAPTURE(ColorMask, __VA_ARGS__)
+#define glCompileShader(...) GLMARK2_GL_CAPTURE(CompileShader, __VA_ARGS__)
+#define glCreateProgram() \
+    (GLCapture::active() ? GLCapture::CreateProgram() : glCreateProgram())
+#define glCreateShader(...) GLMARK2_GL_CAPTURE(CreateShader, __VA_ARGS__)
+#define glCullFace(...) GLMARK2_GL_CAPTURE(CullFace, __VA_ARGS__)
+#define glDeleteBuffers(...) GLMARK2_GL_CAPTURE(DeleteBuffers, __VA_ARGS__)
+#define glDeleteFramebuffers(...) GLMARK2_GL_CAPTURE(DeleteFramebuffers, __VA_ARGS__)
+#define glDeleteProgram(...) GLMARK2_GL_CAPTURE(DeleteProgram, __VA_ARGS__)
+#define glDeleteRenderbuffers(...) GLMARK2_GL_CAPTURE(DeleteRenderbuffers, __VA_ARGS__)
+#define glDeleteShader(...) GLMARK2_GL_CAPTURE(DeleteShader, __VA_ARGS__)
+#define glDeleteTextures(...) GLMARK2_GL_CAPTURE(DeleteTextures, __VA_ARGS__)
+#define glDepthFunc(...) GLMARK2_GL_CAPTURE(DepthFunc, __VA_ARGS__)
+#define glDepthMask(...) GLMARK2_GL_CAPTURE(DepthMask, __VA_ARGS__)
+#define glDisable(...) GLMARK2_GL_CAPTURE(Disable, __VA_ARGS__)
+#define glDisableVertexAttribArray(...) GLMARK2_GL_CAPTURE(DisableVertexAttribArray, __VA_ARGS__)
+#define glDrawArrays(...) GLMARK2_GL_CAPTURE(DrawArrays, __VA_ARGS__)
+#define glDrawElements(...) GLMARK2_GL_CAPTURE(DrawElements, __VA_ARGS__)
+#define glEnable(...) GLMARK2_GL_CAPTURE(Enable, __VA_ARGS__)
+#define glEnableVertexAttribArray(...) GLMARK2_GL_CAPTURE(EnableVertexAttribArray, __VA_ARGS__)
+#define glFinish() \
+    (GLCapture::active() ? GLCapture::Finish() : glFinish())
+#define glFramebufferRenderbuffer(...) GLMARK2_GL_CAPTURE(FramebufferRenderbuffer, __VA_ARGS__)
+#define glFramebufferTexture2D(...) GLMARK2_GL_CAPTURE(FramebufferTexture2D, __VA_ARGS__)
+#define glGenBuffers(...) GLMARK2_GL_CAPTURE(GenBuffers, __VA_ARGS__)
+#define glGenFramebuffers(...) GLMARK2_GL_CAPTURE(GenFramebuffers, __VA_ARGS__)
+#define glGenRenderbuffers(...) GLMARK2_GL_CAPTURE(GenRenderbuffers, __VA_ARGS__)
+#define glGenTextures(...) GLMARK2_GL_CAPTURE(GenTextures, __VA_ARGS__)
+#define glGenerateMipmap(...) GLMARK2_GL_CAPTURE(GenerateMipmap, __VA_ARGS__)
+#define glGetAttribLocation(...) GLMARK2_GL_CAPTURE(GetAttribLocation, __VA_ARGS__)
+#define glGetUniformLocation(...) GLMARK2_GL_CAPTURE(GetUniformLocation, __VA_ARGS__)
+#define glLinkProgram(...) GLMARK2_GL_CAPTURE(LinkProgram, __VA_ARGS__)
+#define glPixelStorei(...) GLMARK2_GL_CAPTURE(PixelStorei, __VA_ARGS__)
+#define glRenderbufferStorage(...) GLMARK2_GL_CAPTURE(RenderbufferStorage, __VA_ARGS__)
+#define glShaderSource(...) GLMARK2_GL_CAPTURE(ShaderSource, __VA_ARGS__)
+#define glTexImage2D(...) GLMARK2_GL_CAPTURE(TexImage2D, __VA_ARGS__)
+#define glTexParameterf(...) GLMARK2_GL_CAPTURE(TexParameterf, __VA_ARGS__)
+#define glTexParameteri(...) GLMARK2_GL_CAPTURE(TexParameteri, __VA_ARGS__)
+#define glTexSubImage2D(...) GLMARK2_GL_CAPTURE(TexSubImage2D, __VA_ARGS__)
+#define glUniform1f(...) GLMARK2_GL_CAPTURE(Uniform1f, __VA_ARGS__)
+#define glUniform1i(...) GLMARK2_GL_CAPTURE(Uniform1i, __VA_ARGS__)
+#define glUniform2fv(...) GLMARK2_GL_CAPTURE(Uniform2fv, __VA_ARGS__)
+#define glUniform3fv(...) GLMARK2_GL_CAPTURE(Uniform3fv, __VA_ARGS__)
+#define glUniform4fv(...) GLMARK2_GL_CAPTURE(Uniform4fv, __VA_ARGS__)
+#define glUniformMatrix2fv(...) GLMARK2_GL_CAPTURE(UniformMatrix2fv, __VA_ARGS__)
+#define glUniformMatrix3fv(...) GLMARK2_GL_CAPTURE(UniformMatrix3fv, __VA_ARGS__)
+#define glUniformMatrix4fv(...) GLMARK2_GL_CAPTURE(UniformMatrix4fv, __VA_ARGS__)
+#define glUseProgram(...) GLMARK2_GL_CAPTURE(UseProgram, __VA_ARGS__)
+#define glVertexAttribPointer(...) GLMARK2_GL_CAPTURE(VertexAttribPointer, __VA_ARGS__)
+#define glViewport(...) GLMARK2_GL_CAPTURE(Viewport, __VA_ARGS__)
+#endif
+
+#endif
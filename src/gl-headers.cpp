@@ -21,26 +21,240 @@
  */
 #include "gl-headers.h"
 
+#include <cstdio>
+#include <cstring>
+
+unsigned int GLExtensions::major_version = 0;
+unsigned int GLExtensions::minor_version = 0;
+bool GLExtensions::core_profile = false;
+float GLExtensions::max_anisotropy = 1.0;
+
 void* (*GLExtensions::MapBuffer) (GLenum target, GLenum access) = 0;
 GLboolean (*GLExtensions::UnmapBuffer) (GLenum target) = 0;
+void (*GLExtensions::GenQueries) (GLsizei n, GLuint *ids) = 0;
+void (*GLExtensions::DeleteQueries) (GLsizei n, const GLuint *ids) = 0;
+void (*GLExtensions::BeginQuery) (GLenum target, GLuint id) = 0;
+void (*GLExtensions::EndQuery) (GLenum target) = 0;
+void (*GLExtensions::GetQueryObjectuiv) (GLuint id, GLenum pname, GLuint *params) = 0;
+void (*GLExtensions::GetQueryObjectui64v) (GLuint id, GLenum pname, GLuint64 *params) = 0;
+void (*GLExtensions::BindBufferRange) (GLenum target, GLuint index, GLuint buffer,
+                                       GLintptr offset, GLsizeiptr size) = 0;
+GLuint (*GLExtensions::GetUniformBlockIndex) (GLuint program, const GLchar *name) = 0;
+void (*GLExtensions::UniformBlockBinding) (GLuint program, GLuint index, GLuint binding) = 0;
+
+void (*GLExtensions::DrawBuffers) (GLsizei n, const GLenum *bufs) = 0;
+void (*GLExtensions::InvalidateFramebuffer) (GLenum target, GLsizei num_attachments,
+                                             const GLenum *attachments) = 0;
+
+GLsync (*GLExtensions::FenceSync) (GLenum condition, GLbitfield flags) = 0;
+void (*GLExtensions::DeleteSync) (GLsync sync) = 0;
+GLenum (*GLExtensions::ClientWaitSync) (GLsync sync, GLbitfield flags, GLuint64 timeout) = 0;
+void (*GLExtensions::WaitSync) (GLsync sync, GLbitfield flags, GLuint64 timeout) = 0;
+
+void
+GLExtensions::init_capabilities()
+{
+    const char *version_string =
+        reinterpret_cast<const char *>(glGetString(GL_VERSION));
+
+    major_version = 0;
+    minor_version = 0;
+    core_profile = false;
+    max_anisotropy = 1.0;
+
+    if (!version_string)
+        return;
+
+    /* GLES version strings are of the form "OpenGL ES N.M ..." */
+    const char *es_prefix = strstr(version_string, "OpenGL ES ");
+    if (es_prefix)
+        version_string = es_prefix + strlen("OpenGL ES ");
+
+    if (sscanf(version_string, "%u.%u", &major_version, &minor_version) != 2) {
+        major_version = 0;
+        minor_version = 0;
+    }
+
+#if GLMARK2_USE_GL
+    if (version(3, 2)) {
+        GLint profile_mask = 0;
+        glGetIntegerv(GL_CONTEXT_PROFILE_MASK, &profile_mask);
+        core_profile = (profile_mask & GL_CONTEXT_CORE_PROFILE_BIT) != 0;
+    }
+
+    /*
+     * Core profile contexts have no default vertex array object, so bind
+     * one for the lifetime of the context.
+     */
+    if (core_profile) {
+        GLuint vao;
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+    }
+#endif
+
+    if (support(AnisotropicFiltering)) {
+        GLfloat max = 1.0;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &max);
+        max_anisotropy = max;
+    }
+}
 
 bool
 GLExtensions::support(const std::string &ext)
 {
-    std::string ext_string;
+    return support(ext.c_str());
+}
+
+bool
+GLExtensions::support(const char *ext)
+{
+    /* Search the extensions in place, so that queries don't allocate */
+    const size_t ext_size = strlen(ext);
+
+    if (ext_size == 0)
+        return false;
+
+#if GLMARK2_USE_GL
+    /* The GL_EXTENSIONS string is not available in core profile contexts */
+    if (core_profile) {
+        GLint num_exts = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &num_exts);
+        for (GLint i = 0; i < num_exts; i++) {
+            const char *e = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+            if (e && !strcmp(e, ext))
+                return true;
+        }
+        return false;
+    }
+#endif
+
     const char* exts = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
-    if (exts) {
-        ext_string = exts;
+    if (!exts)
+        return false;
+
+    const char *pos = exts;
+
+    /* Skip matches that are only a prefix of another extension name */
+    while ((pos = strstr(pos, ext)) != NULL) {
+        char c = pos[ext_size];
+        if ((c == ' ' || c == '\0') && (pos == exts || pos[-1] == ' '))
+            return true;
+        pos += ext_size;
     }
 
-    const size_t ext_size = ext.size();
-    size_t pos = 0;
+    return false;
+}
 
-    while ((pos = ext_string.find(ext, pos)) != std::string::npos) {
-        char c = ext_string[pos + ext_size];
-        if (c == ' ' || c == '\0')
-            break;
+bool
+GLExtensions::support(Capability cap)
+{
+#if GLMARK2_USE_GLESv2
+    switch (cap) {
+        case UniformBufferObjects:
+        case Instancing:
+        case SyncObjects:
+        case TransformFeedback:
+            return version(3, 0);
+        case MultipleRenderTargets:
+            return version(3, 0) || support("GL_EXT_draw_buffers");
+        case ComputeShaders:
+            return version(3, 1);
+        case FloatTextures:
+            return version(3, 0);
+        case HalfFloatRenderTargets:
+            /* GLES2 also needs half float textures to render to */
+            if (!version(3, 0)) {
+                return support("GL_EXT_color_buffer_half_float") &&
+                       support("GL_OES_texture_half_float");
+            }
+            return support("GL_EXT_color_buffer_half_float") ||
+                   support("GL_EXT_color_buffer_float");
+        case FramebufferInvalidation:
+            return version(3, 0) || support("GL_EXT_discard_framebuffer");
+        case OcclusionQueries:
+            return version(3, 0) || support("GL_EXT_occlusion_query_boolean");
+        case FragmentDepth:
+            return support("GL_EXT_frag_depth");
+        case AnisotropicFiltering:
+            return support("GL_EXT_texture_filter_anisotropic");
+        case ClientArrays:
+            return true;
+    }
+#elif GLMARK2_USE_GL
+    switch (cap) {
+        case UniformBufferObjects:
+            /*
+             * The uniform block shaders are GLSL 1.40, which contexts
+             * exposing only GL_ARB_uniform_buffer_object may lack.
+             */
+            return version(3, 1);
+        case Instancing:
+            return version(3, 1) || support("GL_ARB_draw_instanced");
+        case MultipleRenderTargets:
+            return true;
+        case SyncObjects:
+            return version(3, 2) || support("GL_ARB_sync");
+        case TransformFeedback:
+            return version(3, 0);
+        case ComputeShaders:
+            return version(4, 3) || support("GL_ARB_compute_shader");
+        case FloatTextures:
+        case HalfFloatRenderTargets:
+            return version(3, 0) || support("GL_ARB_texture_float");
+        case FramebufferInvalidation:
+            return version(4, 3) || support("GL_ARB_invalidate_subdata");
+        case OcclusionQueries:
+        case FragmentDepth:
+            return true;
+        case AnisotropicFiltering:
+            return version(4, 6) ||
+                   support("GL_ARB_texture_filter_anisotropic") ||
+                   support("GL_EXT_texture_filter_anisotropic");
+        case ClientArrays:
+            return !core_profile;
     }
+#endif
+    return false;
+}
 
-    return pos != std::string::npos;
+bool
+GLExtensions::version(unsigned int major, unsigned int minor)
+{
+    return major_version > major ||
+           (major_version == major && minor_version >= minor);
+}
+
+const char *
+GLExtensions::capability_name(Capability cap)
+{
+    switch (cap) {
+        case UniformBufferObjects:
+            return "uniform buffer objects";
+        case Instancing:
+            return "instanced rendering";
+        case MultipleRenderTargets:
+            return "multiple render targets";
+        case SyncObjects:
+            return "sync objects";
+        case TransformFeedback:
+            return "transform feedback";
+        case ComputeShaders:
+            return "compute shaders";
+        case FloatTextures:
+            return "floating point textures";
+        case HalfFloatRenderTargets:
+            return "half float render targets";
+        case FramebufferInvalidation:
+            return "framebuffer invalidation";
+        case OcclusionQueries:
+            return "occlusion queries";
+        case FragmentDepth:
+            return "fragment depth output";
+        case AnisotropicFiltering:
+            return "anisotropic filtering";
+        case ClientArrays:
+            return "client-side vertex arrays";
+    }
+    return "unknown";
 }
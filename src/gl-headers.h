@@ -48,6 +48,74 @@
 #ifndef GL_RGB8
 #define GL_RGB8 GL_RGB8_OES
 #endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+#endif
+#ifndef GL_SAMPLES_PASSED
+#define GL_SAMPLES_PASSED 0x8914
+#endif
+#ifndef GL_ANY_SAMPLES_PASSED
+#define GL_ANY_SAMPLES_PASSED 0x8C2F
+#endif
+#ifndef GL_GPU_DISJOINT
+#define GL_GPU_DISJOINT 0x8FBB
+#endif
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER 0x8A11
+#endif
+#ifndef GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8A34
+#endif
+#ifndef GL_INVALID_INDEX
+#define GL_INVALID_INDEX 0xFFFFFFFFu
+#endif
+#ifndef GL_RGBA32F
+#define GL_RGBA32F 0x8814
+#endif
+#ifndef GL_RGBA16F
+#define GL_RGBA16F 0x881A
+#endif
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B
+#endif
+#ifndef GL_HALF_FLOAT_OES
+#define GL_HALF_FLOAT_OES 0x8D61
+#endif
+#ifndef GL_RED
+#define GL_RED 0x1903
+#endif
+#ifndef GL_RG
+#define GL_RG 0x8227
+#endif
+#ifndef GL_TEXTURE_MAX_ANISOTROPY_EXT
+#define GL_TEXTURE_MAX_ANISOTROPY_EXT 0x84FE
+#endif
+#ifndef GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT
+#define GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT 0x84FF
+#endif
+#ifndef GL_COLOR_ATTACHMENT1
+#define GL_COLOR_ATTACHMENT1 0x8CE1
+#define GL_COLOR_ATTACHMENT2 0x8CE2
+#define GL_COLOR_ATTACHMENT3 0x8CE3
+#endif
+#ifndef GL_TEXTURE_EXTERNAL_OES
+#define GL_TEXTURE_EXTERNAL_OES 0x8D65
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
 #endif
 
 #include <string>
@@ -57,15 +125,116 @@
  * in either GL2.0 or GLES2.0.
  */
 struct GLExtensions {
+    /**
+     * Features that are core in later GL and GLES versions, or are
+     * available through extensions.
+     */
+    enum Capability {
+        UniformBufferObjects,
+        Instancing,
+        MultipleRenderTargets,
+        SyncObjects,
+        TransformFeedback,
+        ComputeShaders,
+        FloatTextures,
+        HalfFloatRenderTargets,
+        FramebufferInvalidation,
+        OcclusionQueries,
+        FragmentDepth,
+        AnisotropicFiltering,
+        ClientArrays
+    };
+
+    /**
+     * Queries the version and profile of the current context.
+     *
+     * This must be called after a context has been made current, before
+     * any of the capability queries.
+     */
+    static void init_capabilities();
+
     /**
      * Whether the current context has support for a GL extension.
      *
      * @return true if the extension is supported
      */
     static bool support(const std::string &ext);
+    static bool support(const char *ext);
+
+    /**
+     * Whether the current context has support for a capability.
+     *
+     * @return true if the capability is supported
+     */
+    static bool support(Capability cap);
+
+    /**
+     * Whether the version of the current context is at least major.minor.
+     *
+     * This is the GLES version for GLES builds, and the GL version otherwise.
+     */
+    static bool version(unsigned int major, unsigned int minor);
+
+    /**
+     * Gets a human readable name for a capability.
+     */
+    static const char *capability_name(Capability cap);
+
+    static unsigned int major_version;
+    static unsigned int minor_version;
+    static bool core_profile;
+
+    /**
+     * The maximum degree of anisotropic filtering, or 1 if anisotropic
+     * filtering is not supported.
+     */
+    static float max_anisotropy;
 
     static void* (*MapBuffer) (GLenum target, GLenum access);
     static GLboolean (*UnmapBuffer) (GLenum target);
+
+    /*
+     * Query objects (GL 1.5, GL_EXT_occlusion_query_boolean or
+     * GL_EXT_disjoint_timer_query on GLES2).  GetQueryObjectui64v is only
+     * set if timer queries are available.
+     */
+    static void (*GenQueries) (GLsizei n, GLuint *ids);
+    static void (*DeleteQueries) (GLsizei n, const GLuint *ids);
+    static void (*BeginQuery) (GLenum target, GLuint id);
+    static void (*EndQuery) (GLenum target);
+    static void (*GetQueryObjectuiv) (GLuint id, GLenum pname, GLuint *params);
+    static void (*GetQueryObjectui64v) (GLuint id, GLenum pname, GLuint64 *params);
+
+    /*
+     * Uniform buffer objects (GL 3.1, GL_ARB_uniform_buffer_object or
+     * GLES 3.0).
+     */
+    static void (*BindBufferRange) (GLenum target, GLuint index, GLuint buffer,
+                                    GLintptr offset, GLsizeiptr size);
+    static GLuint (*GetUniformBlockIndex) (GLuint program, const GLchar *name);
+    static void (*UniformBlockBinding) (GLuint program, GLuint index, GLuint binding);
+
+    /*
+     * Multiple render targets (GL 2.0, GLES 3.0 or GL_EXT_draw_buffers).
+     */
+    static void (*DrawBuffers) (GLsizei n, const GLenum *bufs);
+
+    /*
+     * Framebuffer invalidation (GL 4.3, GL_ARB_invalidate_subdata, GLES 3.0
+     * or GL_EXT_discard_framebuffer).
+     */
+    static void (*InvalidateFramebuffer) (GLenum target, GLsizei num_attachments,
+                                          const GLenum *attachments);
+
+    /*
+     * Sync objects (GL 3.2, GL_ARB_sync or GLES 3.0).
+     */
+    static GLsync (*FenceSync) (GLenum condition, GLbitfield flags);
+    static void (*DeleteSync) (GLsync sync);
+    static GLenum (*ClientWaitSync) (GLsync sync, GLbitfield flags, GLuint64 timeout);
+    static void (*WaitSync) (GLsync sync, GLbitfield flags, GLuint64 timeout);
 };
 
+#include "gl-capture.h"
+
 #endif
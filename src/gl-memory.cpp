@@ -0,0 +1,458 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "gl-memory.h"
+
+#include "log.h"
+
+#include <map>
+#include <algorithm>
+
+#ifndef GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX
+#define GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX 0x9049
+#endif
+#ifndef GL_TEXTURE_FREE_MEMORY_ATI
+#define GL_TEXTURE_FREE_MEMORY_ATI 0x87FC
+#endif
+#ifndef GL_UNIFORM_BUFFER_BINDING
+#define GL_UNIFORM_BUFFER_BINDING 0x8A28
+#endif
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_PIXEL_PACK_BUFFER_BINDING
+#define GL_PIXEL_PACK_BUFFER_BINDING 0x88ED
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER_BINDING
+#define GL_PIXEL_UNPACK_BUFFER_BINDING 0x88EF
+#endif
+#ifndef GL_COPY_READ_BUFFER
+#define GL_COPY_READ_BUFFER 0x8F36
+#endif
+#ifndef GL_COPY_WRITE_BUFFER
+#define GL_COPY_WRITE_BUFFER 0x8F37
+#endif
+#ifndef GL_TRANSFORM_FEEDBACK_BUFFER
+#define GL_TRANSFORM_FEEDBACK_BUFFER 0x8C8E
+#endif
+#ifndef GL_TRANSFORM_FEEDBACK_BUFFER_BINDING
+#define GL_TRANSFORM_FEEDBACK_BUFFER_BINDING 0x8C8F
+#endif
+
+namespace GLMemoryPrivate
+{
+
+struct Level {
+    GLsizei width;
+    GLsizei height;
+    unsigned int bpp;
+
+    size_t bytes() const
+    {
+        return static_cast<size_t>(width) * height * bpp;
+    }
+};
+
+/* Texture levels keyed by (face, level) */
+typedef std::map<unsigned int, Level> LevelMap;
+
+std::map<GLuint, LevelMap> textures;
+std::map<GLuint, size_t> renderbuffers;
+std::map<GLuint, size_t> buffers;
+size_t live_bytes = 0;
+size_t peak_bytes = 0;
+GLint driver_available_kb = -1;
+
+static const unsigned int max_levels = 32;
+
+void
+update_live(size_t old_bytes, size_t new_bytes)
+{
+    live_bytes = live_bytes - old_bytes + new_bytes;
+    peak_bytes = std::max(peak_bytes, live_bytes);
+}
+
+GLuint
+bound_object(GLenum binding)
+{
+    GLint name = 0;
+    glGetIntegerv(binding, &name);
+    return name;
+}
+
+GLenum
+texture_binding(GLenum target)
+{
+    if (target == GL_TEXTURE_2D)
+        return GL_TEXTURE_BINDING_2D;
+    else
+        return GL_TEXTURE_BINDING_CUBE_MAP;
+}
+
+GLenum
+buffer_binding(GLenum target)
+{
+    switch (target) {
+        case GL_ARRAY_BUFFER:
+            return GL_ARRAY_BUFFER_BINDING;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return GL_ELEMENT_ARRAY_BUFFER_BINDING;
+        case GL_UNIFORM_BUFFER:
+            return GL_UNIFORM_BUFFER_BINDING;
+        case GL_PIXEL_PACK_BUFFER:
+            return GL_PIXEL_PACK_BUFFER_BINDING;
+        case GL_PIXEL_UNPACK_BUFFER:
+            return GL_PIXEL_UNPACK_BUFFER_BINDING;
+        case GL_TRANSFORM_FEEDBACK_BUFFER:
+            return GL_TRANSFORM_FEEDBACK_BUFFER_BINDING;
+        /* The copy targets are their own binding queries */
+        case GL_COPY_READ_BUFFER:
+        case GL_COPY_WRITE_BUFFER:
+            return target;
+        default:
+            return GL_NONE;
+    }
+}
+
+unsigned int
+texture_face(GLenum target)
+{
+    if (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X &&
+        target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z)
+    {
+        return target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
+    }
+
+    return 0;
+}
+
+void
+set_level(LevelMap &levels, unsigned int face, unsigned int level,
+          const Level &l)
+{
+    unsigned int key = face * max_levels + level;
+    LevelMap::iterator iter = levels.find(key);
+    size_t old_bytes = 0;
+
+    if (iter != levels.end())
+        old_bytes = iter->second.bytes();
+
+    levels[key] = l;
+    update_live(old_bytes, l.bytes());
+}
+
+template <typename T> void
+forget(std::map<GLuint, T> &objects, GLuint name,
+       size_t (*bytes)(const T &))
+{
+    typename std::map<GLuint, T>::iterator iter = objects.find(name);
+
+    if (iter != objects.end()) {
+        update_live(bytes(iter->second), 0);
+        objects.erase(iter);
+    }
+}
+
+size_t
+object_bytes(const size_t &bytes)
+{
+    return bytes;
+}
+
+size_t
+texture_bytes(const LevelMap &levels)
+{
+    size_t bytes = 0;
+
+    for (LevelMap::const_iterator iter = levels.begin();
+         iter != levels.end();
+         iter++)
+    {
+        bytes += iter->second.bytes();
+    }
+
+    return bytes;
+}
+
+bool
+driver_available(GLint &kb)
+{
+    if (GLExtensions::support("GL_NVX_gpu_memory_info")) {
+        glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &kb);
+        return true;
+    }
+    else if (GLExtensions::support("GL_ATI_meminfo")) {
+        GLint info[4] = {0, 0, 0, 0};
+        glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, info);
+        kb = info[0];
+        return true;
+    }
+
+    return false;
+}
+
+}
+
+void
+GLMemory::tex_image_2d(GLenum target, GLint level, GLint internal_format,
+                       GLsizei width, GLsizei height, GLint border,
+                       GLenum format, GLenum type, const GLvoid *pixels)
+{
+    using namespace GLMemoryPrivate;
+
+    glTexImage2D(target, level, internal_format, width, height, border,
+                 format, type, pixels);
+
+    GLuint name = bound_object(texture_binding(target));
+    if (name == 0 || level < 0 || level >= static_cast<GLint>(max_levels))
+        return;
+
+    Level l = {width, height, bytes_per_pixel(internal_format, type)};
+    set_level(textures[name], texture_face(target), level, l);
+}
+
+void
+GLMemory::generate_mipmap(GLenum target)
+{
+    using namespace GLMemoryPrivate;
+
+    glGenerateMipmap(target);
+
+    GLuint name = bound_object(texture_binding(target));
+    std::map<GLuint, LevelMap>::iterator iter = textures.find(name);
+    if (name == 0 || iter == textures.end())
+        return;
+
+    LevelMap &levels = iter->second;
+    unsigned int nfaces = target == GL_TEXTURE_2D ? 1 : 6;
+
+    /* Fill in the whole mip chain from the base level of each face */
+    for (unsigned int face = 0; face < nfaces; face++) {
+        LevelMap::const_iterator base = levels.find(face * max_levels);
+        if (base == levels.end())
+            continue;
+
+        Level l = base->second;
+        for (unsigned int level = 1;
+             level < max_levels && (l.width > 1 || l.height > 1);
+             level++)
+        {
+            l.width = std::max(l.width / 2, 1);
+            l.height = std::max(l.height / 2, 1);
+            set_level(levels, face, level, l);
+        }
+    }
+}
+
+void
+GLMemory::renderbuffer_storage(GLenum target, GLenum internal_format,
+                               GLsizei width, GLsizei height)
+{
+    using namespace GLMemoryPrivate;
+
+    glRenderbufferStorage(target, internal_format, width, height);
+
+    GLuint name = bound_object(GL_RENDERBUFFER_BINDING);
+    if (name == 0)
+        return;
+
+    size_t &bytes = renderbuffers[name];
+    size_t old_bytes = bytes;
+    bytes = static_cast<size_t>(width) * height *
+            bytes_per_pixel(internal_format, GL_NONE);
+    update_live(old_bytes, bytes);
+}
+
+void
+GLMemory::buffer_data(GLenum target, GLsizeiptr size, const GLvoid *data,
+                      GLenum usage)
+{
+    using namespace GLMemoryPrivate;
+
+    glBufferData(target, size, data, usage);
+
+    GLenum binding = buffer_binding(target);
+    if (binding == GL_NONE) {
+        Log::debug("GLMemory: untracked buffer target 0x%x\n", target);
+        return;
+    }
+
+    GLuint name = bound_object(binding);
+    if (name == 0)
+        return;
+
+    size_t &bytes = buffers[name];
+    size_t old_bytes = bytes;
+    bytes = size;
+    update_live(old_bytes, bytes);
+}
+
+void
+GLMemory::delete_textures(GLsizei n, const GLuint *textures)
+{
+    for (GLsizei i = 0; i < n; i++) {
+        GLMemoryPrivate::forget(GLMemoryPrivate::textures, textures[i],
+                                GLMemoryPrivate::texture_bytes);
+    }
+
+    glDeleteTextures(n, textures);
+}
+
+void
+GLMemory::delete_renderbuffers(GLsizei n, const GLuint *renderbuffers)
+{
+    for (GLsizei i = 0; i < n; i++) {
+        GLMemoryPrivate::forget(GLMemoryPrivate::renderbuffers, renderbuffers[i],
+                                GLMemoryPrivate::object_bytes);
+    }
+
+    glDeleteRenderbuffers(n, renderbuffers);
+}
+
+void
+GLMemory::delete_buffers(GLsizei n, const GLuint *buffers)
+{
+    for (GLsizei i = 0; i < n; i++) {
+        GLMemoryPrivate::forget(GLMemoryPrivate::buffers, buffers[i],
+                                GLMemoryPrivate::object_bytes);
+    }
+
+    glDeleteBuffers(n, buffers);
+}
+
+void
+GLMemory::clear()
+{
+    GLMemoryPrivate::textures.clear();
+    GLMemoryPrivate::renderbuffers.clear();
+    GLMemoryPrivate::buffers.clear();
+    GLMemoryPrivate::live_bytes = 0;
+    GLMemoryPrivate::peak_bytes = 0;
+}
+
+void
+GLMemory::reset_peak()
+{
+    GLMemoryPrivate::peak_bytes = GLMemoryPrivate::live_bytes;
+    if (!GLMemoryPrivate::driver_available(GLMemoryPrivate::driver_available_kb))
+        GLMemoryPrivate::driver_available_kb = -1;
+}
+
+size_t
+GLMemory::live_bytes()
+{
+    return GLMemoryPrivate::live_bytes;
+}
+
+size_t
+GLMemory::peak_bytes()
+{
+    return GLMemoryPrivate::peak_bytes;
+}
+
+bool
+GLMemory::driver_used_bytes(long long &bytes)
+{
+    using namespace GLMemoryPrivate;
+
+    GLint available_kb = 0;
+
+    if (driver_available_kb < 0 || !driver_available(available_kb))
+        return false;
+
+    bytes = (static_cast<long long>(driver_available_kb) - available_kb) * 1024;
+    return true;
+}
+
+unsigned int
+GLMemory::bytes_per_pixel(GLenum format, GLenum type)
+{
+    /* Sized formats */
+    switch (format) {
+        case GL_RGBA4:
+        case GL_RGB5_A1:
+        case GL_RGB565:
+        case GL_DEPTH_COMPONENT16:
+            return 2;
+        case GL_RGB8:
+            return 3;
+        case GL_RGBA8:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32:
+            return 4;
+        case GL_STENCIL_INDEX8:
+            return 1;
+        case GL_RGBA16F:
+            return 8;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            break;
+    }
+
+    /* Packed types */
+    switch (type) {
+        case GL_UNSIGNED_SHORT_5_6_5:
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+            return 2;
+        default:
+            break;
+    }
+
+    unsigned int components;
+    switch (format) {
+        case GL_ALPHA:
+        case GL_LUMINANCE:
+        case GL_RED:
+        case GL_DEPTH_COMPONENT:
+            components = 1;
+            break;
+        case GL_LUMINANCE_ALPHA:
+        case GL_RG:
+            components = 2;
+            break;
+        case GL_RGB:
+            components = 3;
+            break;
+        default:
+            components = 4;
+            break;
+    }
+
+    unsigned int component_size;
+    switch (type) {
+        case GL_UNSIGNED_SHORT:
+        case GL_HALF_FLOAT:
+        case GL_HALF_FLOAT_OES:
+            component_size = 2;
+            break;
+        case GL_UNSIGNED_INT:
+        case GL_FLOAT:
+            component_size = 4;
+            break;
+        default:
+            component_size = 1;
+            break;
+    }
+
+    return components * component_size;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_GL_MEMORY_H_
+#define GLMARK2_GL_MEMORY_H_
+
+#include "gl-headers.h"
+#include <stddef.h>
+
+/**
+ * Tracks the memory used by GL objects.
+ *
+ * The allocation methods wrap the corresponding GL calls and estimate the
+ * storage needed from the format, size and number of mip levels of the
+ * object bound to the given target.  The estimates do not account for
+ * driver-specific padding or compression.
+ *
+ * The tracked state is not synchronized, so GLMemory must only be used
+ * from the thread that owns the GL context.
+ */
+class GLMemory
+{
+public:
+    static void tex_image_2d(GLenum target, GLint level, GLint internal_format,
+                             GLsizei width, GLsizei height, GLint border,
+                             GLenum format, GLenum type, const GLvoid *pixels);
+    static void generate_mipmap(GLenum target);
+    static void renderbuffer_storage(GLenum target, GLenum internal_format,
+                                     GLsizei width, GLsizei height);
+    static void buffer_data(GLenum target, GLsizeiptr size, const GLvoid *data,
+                            GLenum usage);
+
+    static void delete_textures(GLsizei n, const GLuint *textures);
+    static void delete_renderbuffers(GLsizei n, const GLuint *renderbuffers);
+    static void delete_buffers(GLsizei n, const GLuint *buffers);
+
+    /**
+     * Forgets about all tracked objects.
+     *
+     * Must be called when the GL context is destroyed.
+     */
+    static void clear();
+
+    /**
+     * Starts a new measurement period, setting the peak to the current
+     * live total and sampling the driver-reported available memory.
+     */
+    static void reset_peak();
+
+    /**
+     * Gets the estimated size of all live objects in bytes.
+     */
+    static size_t live_bytes();
+
+    /**
+     * Gets the highest live total since the last reset_peak() in bytes.
+     */
+    static size_t peak_bytes();
+
+    /**
+     * Gets the memory used since the last reset_peak() as reported by the
+     * driver (GL_NVX_gpu_memory_info or GL_ATI_meminfo).
+     *
+     * @param bytes the used memory
+     *
+     * @return whether the driver reports memory usage
+     */
+    static bool driver_used_bytes(long long &bytes);
+
+    /**
+     * Estimates the size of a pixel with the given format and type.
+     */
+    static unsigned int bytes_per_pixel(GLenum format, GLenum type);
+};
+
+#endif
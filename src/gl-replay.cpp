@@ -0,0 +1,852 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define GLMARK2_GL_CAPTURE_IMPL
+#include "gl-replay.h"
+#include "gl-headers.h"
+#include "gl-capture-format.h"
+#include "log.h"
+#include "util.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+using namespace GLCaptureFormat;
+
+/**
+ * Maps the object names of a recording to the names used during replay.
+ *
+ * Names that were not created during the recording map to themselves.
+ */
+class NameMap
+{
+public:
+    NameMap() : kept_(0) {}
+
+    GLuint operator()(GLuint name) const
+    {
+        return name < names_.size() && names_[name] ? names_[name] : name;
+    }
+
+    void set(GLuint name, GLuint new_name)
+    {
+        alias(name, new_name);
+        created_.push_back(new_name);
+    }
+
+    /**
+     * Maps a name to an object that was not created by the recording.
+     */
+    void alias(GLuint name, GLuint new_name)
+    {
+        if (name >= names_.size())
+            names_.resize(name + 1, 0);
+        names_[name] = new_name;
+    }
+
+    /**
+     * Forgets about a deleted object.
+     */
+    void forget(GLuint name)
+    {
+        GLuint new_name = (*this)(name);
+        std::vector<GLuint>::iterator iter =
+            std::find(created_.begin(), created_.end(), new_name);
+
+        if (iter != created_.end()) {
+            if (static_cast<size_t>(iter - created_.begin()) < kept_)
+                kept_--;
+            created_.erase(iter);
+        }
+        if (name < names_.size())
+            names_[name] = 0;
+    }
+
+    /**
+     * Marks the objects created so far as the ones that live across loops
+     * over the recorded frames.
+     */
+    void keep() { kept_ = created_.size(); }
+
+    /**
+     * Forgets about the objects created since ::keep().  The caller must
+     * delete them first, see ::unkept().
+     */
+    void forget_unkept()
+    {
+        for (size_t i = 0; i < names_.size(); i++) {
+            if (names_[i] && std::find(created_.begin() + kept_, created_.end(),
+                                       names_[i]) != created_.end())
+            {
+                names_[i] = 0;
+            }
+        }
+        created_.resize(kept_);
+    }
+
+    const std::vector<GLuint> &created() const { return created_; }
+    size_t kept() const { return kept_; }
+
+private:
+    std::vector<GLuint> names_;
+    std::vector<GLuint> created_;
+    size_t kept_;
+};
+
+/**
+ * Maps recorded uniform or attribute locations to replay locations.
+ */
+class LocationMap
+{
+public:
+    GLint operator()(GLint location) const
+    {
+        if (location < 0 || location >= static_cast<GLint>(locations_.size()) ||
+            locations_[location] == INT_MIN)
+        {
+            return location;
+        }
+        return locations_[location];
+    }
+
+    void set(GLint location, GLint new_location)
+    {
+        if (location < 0)
+            return;
+        if (location >= static_cast<GLint>(locations_.size()))
+            locations_.resize(location + 1, INT_MIN);
+        locations_[location] = new_location;
+    }
+
+private:
+    std::vector<GLint> locations_;
+};
+
+struct GLReplayPrivate
+{
+    GLReplayPrivate() :
+        uniforms(&no_program), stream(0), stream_end(0), frames_begin(0),
+        failed(false) {}
+
+    Header header;
+    NameMap buffers;
+    NameMap framebuffers;
+    NameMap programs;
+    NameMap renderbuffers;
+    NameMap shaders;
+    NameMap textures;
+    LocationMap attribs;
+    std::map<GLuint, LocationMap> program_uniforms;
+    LocationMap no_program;
+    LocationMap *uniforms;
+
+    const unsigned char *stream;
+    const unsigned char *stream_end;
+    const unsigned char *frames_begin;
+    bool failed;
+
+    /**
+     * Deletes a program and its uniform locations.
+     */
+    void delete_program(GLuint program)
+    {
+        std::map<GLuint, LocationMap>::iterator iter =
+            program_uniforms.find(program);
+
+        if (iter != program_uniforms.end()) {
+            if (uniforms == &iter->second)
+                uniforms = &no_program;
+            program_uniforms.erase(iter);
+        }
+        glDeleteProgram(program);
+    }
+
+    /**
+     * Deletes the objects created by the last loop over the recorded
+     * frames, so that the objects don't accumulate while replaying.
+     */
+    void release_unkept()
+    {
+        const std::vector<GLuint> &b = buffers.created();
+        const std::vector<GLuint> &f = framebuffers.created();
+        const std::vector<GLuint> &r = renderbuffers.created();
+        const std::vector<GLuint> &t = textures.created();
+
+        if (b.size() > buffers.kept())
+            glDeleteBuffers(b.size() - buffers.kept(), &b[buffers.kept()]);
+        if (f.size() > framebuffers.kept())
+            glDeleteFramebuffers(f.size() - framebuffers.kept(), &f[framebuffers.kept()]);
+        if (r.size() > renderbuffers.kept())
+            glDeleteRenderbuffers(r.size() - renderbuffers.kept(), &r[renderbuffers.kept()]);
+        if (t.size() > textures.kept())
+            glDeleteTextures(t.size() - textures.kept(), &t[textures.kept()]);
+
+        for (size_t i = programs.kept(); i < programs.created().size(); i++)
+            delete_program(programs.created()[i]);
+        for (size_t i = shaders.kept(); i < shaders.created().size(); i++)
+            glDeleteShader(shaders.created()[i]);
+
+        buffers.forget_unkept();
+        framebuffers.forget_unkept();
+        programs.forget_unkept();
+        renderbuffers.forget_unkept();
+        shaders.forget_unkept();
+        textures.forget_unkept();
+    }
+};
+
+/**
+ * Reads commands from a recording.
+ *
+ * Reads past the end of the recording fail the reader, and return zeroed
+ * values and null blobs, which the caller must not pass on to GL.
+ */
+class Reader
+{
+public:
+    Reader(const unsigned char *base, const unsigned char *pos,
+           const unsigned char *end) :
+        base_(base), pos_(pos), end_(end), ok_(true) {}
+
+    template <typename T> T get()
+    {
+        T v = T();
+
+        if (!ok_ || static_cast<size_t>(end_ - pos_) < sizeof(T)) {
+            ok_ = false;
+            return v;
+        }
+
+        std::memcpy(&v, pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return v;
+    }
+
+    const void *blob(uint64_t *size_out = 0)
+    {
+        uint64_t size = get<uint64_t>();
+        size_t offset = ((pos_ - base_ + 7) & ~static_cast<size_t>(7));
+
+        if (!ok_ || offset > static_cast<size_t>(end_ - base_) ||
+            size > static_cast<uint64_t>(end_ - (base_ + offset)))
+        {
+            ok_ = false;
+            return 0;
+        }
+
+        pos_ = base_ + offset;
+        const void *data = pos_;
+        pos_ += size;
+        if (size_out)
+            *size_out = size;
+        return data;
+    }
+
+    const char *string()
+    {
+        uint64_t size = 0;
+        const char *str = static_cast<const char *>(blob(&size));
+
+        /* Strings are recorded with their terminating NUL */
+        if (!str || size == 0 || str[size - 1] != '\0') {
+            ok_ = false;
+            return "";
+        }
+
+        return str;
+    }
+
+    bool ok() const { return ok_; }
+    const unsigned char *pos() const { return pos_; }
+
+private:
+    const unsigned char *base_;
+    const unsigned char *pos_;
+    const unsigned char *end_;
+    bool ok_;
+};
+
+GLReplay::GLReplay(Canvas &canvas) :
+    canvas_(canvas), priv_(new GLReplayPrivate())
+{
+}
+
+GLReplay::~GLReplay()
+{
+    /* Release all objects created by the recording */
+    const std::vector<GLuint> &buffers = priv_->buffers.created();
+    const std::vector<GLuint> &framebuffers = priv_->framebuffers.created();
+    const std::vector<GLuint> &renderbuffers = priv_->renderbuffers.created();
+    const std::vector<GLuint> &textures = priv_->textures.created();
+
+    if (!buffers.empty())
+        glDeleteBuffers(buffers.size(), &buffers[0]);
+    if (!framebuffers.empty())
+        glDeleteFramebuffers(framebuffers.size(), &framebuffers[0]);
+    if (!renderbuffers.empty())
+        glDeleteRenderbuffers(renderbuffers.size(), &renderbuffers[0]);
+    if (!textures.empty())
+        glDeleteTextures(textures.size(), &textures[0]);
+
+    for (size_t i = 0; i < priv_->programs.created().size(); i++)
+        glDeleteProgram(priv_->programs.created()[i]);
+    for (size_t i = 0; i < priv_->shaders.created().size(); i++)
+        glDeleteShader(priv_->shaders.created()[i]);
+
+    delete priv_;
+}
+
+bool
+GLReplay::load(const std::string &filename)
+{
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    if (!in) {
+        Log::error("Cannot open GL command stream file %s\n", filename.c_str());
+        return false;
+    }
+
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    in.seekg(0, std::ios::beg);
+
+    if (size < static_cast<std::streamoff>(sizeof(Header))) {
+        Log::error("Invalid GL command stream file %s\n", filename.c_str());
+        return false;
+    }
+
+    data_.resize(size);
+    in.read(reinterpret_cast<char *>(&data_[0]), size);
+
+    std::memcpy(&priv_->header, &data_[0], sizeof(Header));
+    if (std::memcmp(priv_->header.magic, magic, sizeof(magic)) ||
+        priv_->header.version != version)
+    {
+        Log::error("Invalid GL command stream file %s\n", filename.c_str());
+        return false;
+    }
+
+    if (priv_->header.width != static_cast<uint32_t>(canvas_.width()) ||
+        priv_->header.height != static_cast<uint32_t>(canvas_.height()))
+    {
+        Log::info("Warning: the command stream was recorded at %ux%u\n",
+                  priv_->header.width, priv_->header.height);
+    }
+
+    priv_->stream = &data_[0] + sizeof(Header);
+    priv_->stream_end = &data_[0] + data_.size();
+
+    /* The recording's default framebuffer is the canvas framebuffer */
+    if (priv_->header.default_fbo != canvas_.fbo())
+        priv_->framebuffers.alias(priv_->header.default_fbo, canvas_.fbo());
+
+    return true;
+}
+
+unsigned int
+GLReplay::run(double duration)
+{
+    unsigned int frames = 0;
+
+    if (!priv_->stream)
+        return 0;
+
+    /* Execute the setup part once */
+    priv_->frames_begin = execute(priv_->stream, priv_->stream_end, frames);
+    if (priv_->failed)
+        return 0;
+    if (priv_->frames_begin == priv_->stream_end) {
+        Log::error("The GL command stream contains no frames\n");
+        return 0;
+    }
+
+    priv_->buffers.keep();
+    priv_->framebuffers.keep();
+    priv_->programs.keep();
+    priv_->renderbuffers.keep();
+    priv_->shaders.keep();
+    priv_->textures.keep();
+
+    /* Replay the frames in a loop */
+    uint64_t start = Util::get_timestamp_us();
+    uint64_t end = start + static_cast<uint64_t>(duration * 1000000.0);
+    uint64_t now = start;
+    frames = 0;
+
+    while (now < end && !canvas_.should_quit()) {
+        execute(priv_->frames_begin, priv_->stream_end, frames);
+        if (priv_->failed)
+            return 0;
+        priv_->release_unkept();
+        now = Util::get_timestamp_us();
+    }
+
+    if (frames == 0 || now == start)
+        return 0;
+
+    return static_cast<unsigned int>(frames / ((now - start) / 1000000.0) + 0.5);
+}
+
+/**
+ * Executes commands until the end of the setup part, or the end of the
+ * stream.
+ *
+ * @return the position after the last executed command
+ */
+const unsigned char *
+GLReplay::execute(const unsigned char *pos, const unsigned char *end,
+                  unsigned int &frames)
+{
+    GLReplayPrivate &p(*priv_);
+    Reader r(p.stream, pos, p.stream_end);
+
+    while (r.pos() < end) {
+        Op op = static_cast<Op>(r.get<uint8_t>());
+
+        switch (op) {
+            case OpEndSetup:
+                return r.pos();
+            case OpEndFrame:
+                canvas_.update();
+                frames++;
+                break;
+            case OpActiveTexture:
+                glActiveTexture(r.get<uint32_t>());
+                break;
+            case OpAttachShader: {
+                GLuint program = p.programs(r.get<uint32_t>());
+                glAttachShader(program, p.shaders(r.get<uint32_t>()));
+                break;
+            }
+            case OpBindBuffer: {
+                GLenum target = r.get<uint32_t>();
+                glBindBuffer(target, p.buffers(r.get<uint32_t>()));
+                break;
+            }
+            case OpBindFramebuffer: {
+                GLenum target = r.get<uint32_t>();
+                glBindFramebuffer(target, p.framebuffers(r.get<uint32_t>()));
+                break;
+            }
+            case OpBindRenderbuffer: {
+                GLenum target = r.get<uint32_t>();
+                glBindRenderbuffer(target, p.renderbuffers(r.get<uint32_t>()));
+                break;
+            }
+            case OpBindTexture: {
+                GLenum target = r.get<uint32_t>();
+                glBindTexture(target, p.textures(r.get<uint32_t>()));
+                break;
+            }
+            case OpBlendFunc: {
+                GLenum sfactor = r.get<uint32_t>();
+                glBlendFunc(sfactor, r.get<uint32_t>());
+                break;
+            }
+            case OpBlendFuncSeparate: {
+                GLenum src_rgb = r.get<uint32_t>();
+                GLenum dst_rgb = r.get<uint32_t>();
+                GLenum src_alpha = r.get<uint32_t>();
+                glBlendFuncSeparate(src_rgb, dst_rgb, src_alpha,
+                                    r.get<uint32_t>());
+                break;
+            }
+            case OpBufferData: {
+                GLenum target = r.get<uint32_t>();
+                GLenum usage = r.get<uint32_t>();
+                GLsizeiptr size = r.get<uint64_t>();
+                const void *data = r.get<uint8_t>() ? r.blob() : 0;
+                if (!r.ok())
+                    break;
+                glBufferData(target, size, data, usage);
+                break;
+            }
+            case OpBufferSubData: {
+                GLenum target = r.get<uint32_t>();
+                GLintptr offset = r.get<uint64_t>();
+                uint64_t size = 0;
+                const void *data = r.blob(&size);
+                if (!r.ok())
+                    break;
+                glBufferSubData(target, offset, size, data);
+                break;
+            }
+            case OpClear:
+                glClear(r.get<uint32_t>());
+                break;
+            case OpClearColor: {
+                float red = r.get<float>();
+                float green = r.get<float>();
+                float blue = r.get<float>();
+                glClearColor(red, green, blue, r.get<float>());
+                break;
+            }
+            case OpClearDepth:
+#if GLMARK2_USE_GL
+                glClearDepth(r.get<float>());
+#else
+                glClearDepthf(r.get<float>());
+#endif
+                break;
+            case OpClientAttrib: {
+                GLuint index = p.attribs(r.get<uint32_t>());
+                GLint size = r.get<int32_t>();
+                GLenum type = r.get<uint32_t>();
+                GLboolean normalized = r.get<uint8_t>();
+                GLsizei stride = r.get<int32_t>();
+                const void *data = r.blob();
+                if (!r.ok())
+                    break;
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+                glVertexAttribPointer(index, size, type, normalized, stride,
+                                      data);
+                break;
+            }
+            case OpColorMask: {
+                GLboolean red = r.get<uint8_t>();
+                GLboolean green = r.get<uint8_t>();
+                GLboolean blue = r.get<uint8_t>();
+                glColorMask(red, green, blue, r.get<uint8_t>());
+                break;
+            }
+            case OpCompileShader:
+                glCompileShader(p.shaders(r.get<uint32_t>()));
+                break;
+            case OpCreateProgram:
+                p.programs.set(r.get<uint32_t>(), glCreateProgram());
+                break;
+            case OpCreateShader: {
+                GLenum type = r.get<uint32_t>();
+                p.shaders.set(r.get<uint32_t>(), glCreateShader(type));
+                break;
+            }
+            case OpCullFace:
+                glCullFace(r.get<uint32_t>());
+                break;
+            case OpDeleteBuffers:
+            case OpDeleteFramebuffers:
+            case OpDeleteRenderbuffers:
+            case OpDeleteTextures: {
+                GLsizei n = r.get<int32_t>();
+                for (GLsizei i = 0; i < n; i++) {
+                    GLuint name = r.get<uint32_t>();
+                    if (!r.ok())
+                        break;
+                    if (op == OpDeleteBuffers) {
+                        GLuint new_name = p.buffers(name);
+                        glDeleteBuffers(1, &new_name);
+                        p.buffers.forget(name);
+                    }
+                    else if (op == OpDeleteFramebuffers) {
+                        GLuint new_name = p.framebuffers(name);
+                        glDeleteFramebuffers(1, &new_name);
+                        p.framebuffers.forget(name);
+                    }
+                    else if (op == OpDeleteRenderbuffers) {
+                        GLuint new_name = p.renderbuffers(name);
+                        glDeleteRenderbuffers(1, &new_name);
+                        p.renderbuffers.forget(name);
+                    }
+                    else {
+                        GLuint new_name = p.textures(name);
+                        glDeleteTextures(1, &new_name);
+                        p.textures.forget(name);
+                    }
+                }
+                break;
+            }
+            case OpDeleteProgram: {
+                GLuint name = r.get<uint32_t>();
+                p.delete_program(p.programs(name));
+                p.programs.forget(name);
+                break;
+            }
+            case OpDeleteShader: {
+                GLuint name = r.get<uint32_t>();
+                glDeleteShader(p.shaders(name));
+                p.shaders.forget(name);
+                break;
+            }
+            case OpDepthFunc:
+                glDepthFunc(r.get<uint32_t>());
+                break;
+            case OpDepthMask:
+                glDepthMask(r.get<uint8_t>());
+                break;
+            case OpDisable:
+                glDisable(r.get<uint32_t>());
+                break;
+            case OpDisableVertexAttribArray:
+                glDisableVertexAttribArray(p.attribs(r.get<uint32_t>()));
+                break;
+            case OpDrawArrays: {
+                GLenum mode = r.get<uint32_t>();
+                GLint first = r.get<int32_t>();
+                glDrawArrays(mode, first, r.get<int32_t>());
+                break;
+            }
+            case OpDrawElements: {
+                GLenum mode = r.get<uint32_t>();
+                GLsizei count = r.get<int32_t>();
+                GLenum type = r.get<uint32_t>();
+                glDrawElements(mode, count, type,
+                               reinterpret_cast<const void *>(r.get<uint64_t>()));
+                break;
+            }
+            case OpDrawElementsClient: {
+                GLenum mode = r.get<uint32_t>();
+                GLsizei count = r.get<int32_t>();
+                GLenum type = r.get<uint32_t>();
+                const void *indices = r.blob();
+                if (!r.ok())
+                    break;
+                glDrawElements(mode, count, type, indices);
+                break;
+            }
+            case OpEnable:
+                glEnable(r.get<uint32_t>());
+                break;
+            case OpEnableVertexAttribArray:
+                glEnableVertexAttribArray(p.attribs(r.get<uint32_t>()));
+                break;
+            case OpFinish:
+                glFinish();
+                break;
+            case OpFramebufferRenderbuffer: {
+                GLenum target = r.get<uint32_t>();
+                GLenum attachment = r.get<uint32_t>();
+                GLenum renderbuffertarget = r.get<uint32_t>();
+                glFramebufferRenderbuffer(target, attachment, renderbuffertarget,
+                                          p.renderbuffers(r.get<uint32_t>()));
+                break;
+            }
+            case OpFramebufferTexture2D: {
+                GLenum target = r.get<uint32_t>();
+                GLenum attachment = r.get<uint32_t>();
+                GLenum textarget = r.get<uint32_t>();
+                GLuint texture = p.textures(r.get<uint32_t>());
+                glFramebufferTexture2D(target, attachment, textarget, texture,
+                                       r.get<int32_t>());
+                break;
+            }
+            case OpGenBuffers:
+            case OpGenFramebuffers:
+            case OpGenRenderbuffers:
+            case OpGenTextures: {
+                GLsizei n = r.get<int32_t>();
+                for (GLsizei i = 0; i < n; i++) {
+                    GLuint name = r.get<uint32_t>();
+                    GLuint new_name = 0;
+                    if (!r.ok())
+                        break;
+                    if (op == OpGenBuffers) {
+                        glGenBuffers(1, &new_name);
+                        p.buffers.set(name, new_name);
+                    }
+                    else if (op == OpGenFramebuffers) {
+                        glGenFramebuffers(1, &new_name);
+                        p.framebuffers.set(name, new_name);
+                    }
+                    else if (op == OpGenRenderbuffers) {
+                        glGenRenderbuffers(1, &new_name);
+                        p.renderbuffers.set(name, new_name);
+                    }
+                    else {
+                        glGenTextures(1, &new_name);
+                        p.textures.set(name, new_name);
+                    }
+                }
+                break;
+            }
+            case OpGenerateMipmap:
+                glGenerateMipmap(r.get<uint32_t>());
+                break;
+            case OpGetAttribLocation: {
+                GLuint program = p.programs(r.get<uint32_t>());
+                const char *name = r.string();
+                GLint location = r.get<int32_t>();
+                if (!r.ok())
+                    break;
+                p.attribs.set(location, glGetAttribLocation(program, name));
+                break;
+            }
+            case OpGetUniformLocation: {
+                GLuint program = p.programs(r.get<uint32_t>());
+                const char *name = r.string();
+                GLint location = r.get<int32_t>();
+                if (!r.ok())
+                    break;
+                p.program_uniforms[program].set(location,
+                                                glGetUniformLocation(program, name));
+                break;
+            }
+            case OpLinkProgram:
+                glLinkProgram(p.programs(r.get<uint32_t>()));
+                break;
+            case OpPixelStorei: {
+                GLenum pname = r.get<uint32_t>();
+                glPixelStorei(pname, r.get<int32_t>());
+                break;
+            }
+            case OpRenderbufferStorage: {
+                GLenum target = r.get<uint32_t>();
+                GLenum internalformat = r.get<uint32_t>();
+                GLsizei width = r.get<int32_t>();
+                glRenderbufferStorage(target, internalformat, width,
+                                      r.get<int32_t>());
+                break;
+            }
+            case OpShaderSource: {
+                GLuint shader = p.shaders(r.get<uint32_t>());
+                const char *source = r.string();
+                if (!r.ok())
+                    break;
+                glShaderSource(shader, 1, &source, 0);
+                break;
+            }
+            case OpTexImage2D: {
+                GLenum target = r.get<uint32_t>();
+                GLint level = r.get<int32_t>();
+                GLint internalformat = r.get<int32_t>();
+                GLsizei width = r.get<int32_t>();
+                GLsizei height = r.get<int32_t>();
+                GLint border = r.get<int32_t>();
+                GLenum format = r.get<uint32_t>();
+                GLenum type = r.get<uint32_t>();
+                bool has_pixels = r.get<uint8_t>();
+                const void *pixels = has_pixels && width > 0 && height > 0 ?
+                                     r.blob() : 0;
+                if (!r.ok())
+                    break;
+                glTexImage2D(target, level, internalformat, width, height,
+                             border, format, type, pixels);
+                break;
+            }
+            case OpTexParameterf: {
+                GLenum target = r.get<uint32_t>();
+                GLenum pname = r.get<uint32_t>();
+                glTexParameterf(target, pname, r.get<float>());
+                break;
+            }
+            case OpTexParameteri: {
+                GLenum target = r.get<uint32_t>();
+                GLenum pname = r.get<uint32_t>();
+                glTexParameteri(target, pname, r.get<int32_t>());
+                break;
+            }
+            case OpTexSubImage2D: {
+                GLenum target = r.get<uint32_t>();
+                GLint level = r.get<int32_t>();
+                GLint xoffset = r.get<int32_t>();
+                GLint yoffset = r.get<int32_t>();
+                GLsizei width = r.get<int32_t>();
+                GLsizei height = r.get<int32_t>();
+                GLenum format = r.get<uint32_t>();
+                GLenum type = r.get<uint32_t>();
+                const void *pixels = width > 0 && height > 0 ? r.blob() : 0;
+                if (!r.ok())
+                    break;
+                glTexSubImage2D(target, level, xoffset, yoffset, width, height,
+                                format, type, pixels);
+                break;
+            }
+            case OpUniform1f: {
+                GLint location = (*p.uniforms)(r.get<int32_t>());
+                glUniform1f(location, r.get<float>());
+                break;
+            }
+            case OpUniform1i: {
+                GLint location = (*p.uniforms)(r.get<int32_t>());
+                glUniform1i(location, r.get<int32_t>());
+                break;
+            }
+            case OpUniform2fv:
+            case OpUniform3fv:
+            case OpUniform4fv: {
+                GLint location = (*p.uniforms)(r.get<int32_t>());
+                GLsizei count = r.get<int32_t>();
+                const GLfloat *value = static_cast<const GLfloat *>(r.blob());
+                if (!r.ok())
+                    break;
+                if (op == OpUniform2fv)
+                    glUniform2fv(location, count, value);
+                else if (op == OpUniform3fv)
+                    glUniform3fv(location, count, value);
+                else
+                    glUniform4fv(location, count, value);
+                break;
+            }
+            case OpUniformMatrix2fv:
+            case OpUniformMatrix3fv:
+            case OpUniformMatrix4fv: {
+                GLint location = (*p.uniforms)(r.get<int32_t>());
+                GLsizei count = r.get<int32_t>();
+                GLboolean transpose = r.get<uint8_t>();
+                const GLfloat *value = static_cast<const GLfloat *>(r.blob());
+                if (!r.ok())
+                    break;
+                if (op == OpUniformMatrix2fv)
+                    glUniformMatrix2fv(location, count, transpose, value);
+                else if (op == OpUniformMatrix3fv)
+                    glUniformMatrix3fv(location, count, transpose, value);
+                else
+                    glUniformMatrix4fv(location, count, transpose, value);
+                break;
+            }
+            case OpUseProgram: {
+                GLuint program = p.programs(r.get<uint32_t>());
+                p.uniforms = &p.program_uniforms[program];
+                glUseProgram(program);
+                break;
+            }
+            case OpVertexAttribPointer: {
+                GLuint index = p.attribs(r.get<uint32_t>());
+                GLint size = r.get<int32_t>();
+                GLenum type = r.get<uint32_t>();
+                GLboolean normalized = r.get<uint8_t>();
+                GLsizei stride = r.get<int32_t>();
+                const void *pointer =
+                    reinterpret_cast<const void *>(r.get<uint64_t>());
+                glVertexAttribPointer(index, size, type, normalized, stride,
+                                      pointer);
+                break;
+            }
+            case OpViewport: {
+                GLint x = r.get<int32_t>();
+                GLint y = r.get<int32_t>();
+                GLsizei width = r.get<int32_t>();
+                glViewport(x, y, width, r.get<int32_t>());
+                break;
+            }
+            default:
+                Log::error("Unknown command %u in GL command stream\n", op);
+                p.failed = true;
+                return end;
+        }
+
+        if (!r.ok()) {
+            Log::error("Truncated command %u in GL command stream\n", op);
+            p.failed = true;
+            return end;
+        }
+    }
+
+    return r.pos();
+}
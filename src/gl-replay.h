@@ -0,0 +1,71 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_GL_REPLAY_H_
+#define GLMARK2_GL_REPLAY_H_
+
+#include "canvas.h"
+
+#include <string>
+#include <vector>
+
+struct GLReplayPrivate;
+
+/**
+ * Plays back a GL command stream recorded with GLCapture.
+ *
+ * The setup part of the recording is executed once, and then the recorded
+ * frames are executed repeatedly in a tight loop, without any scene logic.
+ */
+class GLReplay
+{
+public:
+    GLReplay(Canvas &canvas);
+    ~GLReplay();
+
+    /**
+     * Loads a recording.
+     *
+     * @param filename the file to load
+     *
+     * @return whether the file was loaded successfully
+     */
+    bool load(const std::string &filename);
+
+    /**
+     * Plays back the loaded recording.
+     *
+     * @param duration how long to play back the frames for, in seconds
+     *
+     * Playback stops at the first command that can't be decoded.
+     *
+     * @return the average FPS, or 0 if playback failed
+     */
+    unsigned int run(double duration);
+
+private:
+    const unsigned char *execute(const unsigned char *pos,
+                                 const unsigned char *end,
+                                 unsigned int &frames);
+
+    Canvas &canvas_;
+    std::vector<unsigned char> data_;
+    GLReplayPrivate *priv_;
+};
+
+#endif
@@ -38,6 +38,57 @@ typedef EGLDisplay (EGLAPIENTRYP PFNEGLGETPLATFORMDISPLAYEXTPROC) (EGLenum platf
 using std::vector;
 using std::string;
 
+#if GLMARK2_USE_GLESv2
+static const EGLenum egl_api(EGL_OPENGL_ES_API);
+#elif GLMARK2_USE_GL
+static const EGLenum egl_api(EGL_OPENGL_API);
+#endif
+
+/*
+ * A context shared with the main context.  It is current without a surface
+ * if EGL_KHR_surfaceless_context is supported, or with a 1x1 pbuffer.
+ */
+class GLSharedContextEGL : public GLSharedContext
+{
+public:
+    GLSharedContextEGL(EGLDisplay display, EGLContext context, EGLSurface surface) :
+        display_(display), context_(context), surface_(surface) {}
+
+    ~GLSharedContextEGL()
+    {
+        if (surface_ != EGL_NO_SURFACE)
+            eglDestroySurface(display_, surface_);
+        eglDestroyContext(display_, context_);
+    }
+
+    bool make_current()
+    {
+        /* The bound API is per-thread state */
+        if (!eglBindAPI(egl_api)) {
+            Log::error("eglBindAPI() failed with error: 0x%x\n", eglGetError());
+            return false;
+        }
+
+        if (!eglMakeCurrent(display_, surface_, surface_, context_)) {
+            Log::error("eglMakeCurrent() failed with error: 0x%x\n", eglGetError());
+            return false;
+        }
+
+        return true;
+    }
+
+    void release_current()
+    {
+        eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglReleaseThread();
+    }
+
+private:
+    EGLDisplay display_;
+    EGLContext context_;
+    EGLSurface surface_;
+};
+
 /****************************
  * EGLConfig public methods *
  ****************************/
@@ -297,6 +348,7 @@ EglConfig::print() const
 GLStateEGL::~GLStateEGL()
 {
     if(egl_display_ != nullptr){
+        destroy_extra_surfaces();
         if(!eglTerminate(egl_display_))
             Log::error("eglTerminate failed\n");
     }
@@ -322,9 +374,80 @@ GLStateEGL::init_surface(void* native_window)
     return gotValidSurface();
 }
 
+bool
+GLStateEGL::init_extra_surfaces(void* const* native_windows, unsigned int count)
+{
+    vector<EGLNativeWindowType> windows;
+    for (unsigned int i = 0; i < count; i++)
+        windows.push_back(reinterpret_cast<EGLNativeWindowType>(native_windows[i]));
+
+    if (windows == extra_windows_)
+        return true;
+
+    destroy_extra_surfaces();
+
+    if (!gotValidContext())
+        return false;
+
+    for (unsigned int i = 0; i < count; i++) {
+        EGLSurface surface = eglCreateWindowSurface(egl_display_, egl_config_,
+                                                    windows[i], 0);
+        if (!surface) {
+            Log::error("eglCreateWindowSurface failed with error: 0x%x\n", eglGetError());
+            return false;
+        }
+
+        extra_surfaces_.push_back(surface);
+        extra_windows_.push_back(windows[i]);
+
+        /*
+         * The swap interval is an attribute of the surface bound to the
+         * context, so set it once here instead of on every switch.
+         */
+        if (!eglMakeCurrent(egl_display_, surface, surface, egl_context_)) {
+            Log::error("eglMakeCurrent failed with error: 0x%x\n", eglGetError());
+            return false;
+        }
+
+        eglSwapInterval(egl_display_, 0);
+    }
+
+    if (!eglMakeCurrent(egl_display_, egl_surface_, egl_surface_, egl_context_)) {
+        Log::error("eglMakeCurrent failed with error: 0x%x\n", eglGetError());
+        return false;
+    }
+
+    current_surface_ = egl_surface_;
+
+    return true;
+}
+
+bool
+GLStateEGL::select_surface(unsigned int index)
+{
+    if (index > extra_surfaces_.size())
+        return false;
+
+    EGLSurface surface = index == 0 ? egl_surface_ : extra_surfaces_[index - 1];
+
+    if (surface == current_surface_)
+        return true;
+
+    if (!eglMakeCurrent(egl_display_, surface, surface, egl_context_)) {
+        Log::error("eglMakeCurrent failed with error: 0x%x\n", eglGetError());
+        return false;
+    }
+
+    current_surface_ = surface;
+
+    return true;
+}
+
 void
 GLStateEGL::init_gl_extensions()
 {
+    GLExtensions::init_capabilities();
+
 #if GLMARK2_USE_GLESv2
     if (GLExtensions::support("GL_OES_mapbuffer")) {
         GLExtensions::MapBuffer =
@@ -332,9 +455,104 @@ GLStateEGL::init_gl_extensions()
         GLExtensions::UnmapBuffer =
             reinterpret_cast<PFNGLUNMAPBUFFEROESPROC>(eglGetProcAddress("glUnmapBufferOES"));
     }
+    bool timer_query = GLExtensions::support("GL_EXT_disjoint_timer_query");
+    if (timer_query || GLExtensions::support("GL_EXT_occlusion_query_boolean")) {
+        GLExtensions::GenQueries =
+            reinterpret_cast<PFNGLGENQUERIESEXTPROC>(eglGetProcAddress("glGenQueriesEXT"));
+        GLExtensions::DeleteQueries =
+            reinterpret_cast<PFNGLDELETEQUERIESEXTPROC>(eglGetProcAddress("glDeleteQueriesEXT"));
+        GLExtensions::BeginQuery =
+            reinterpret_cast<PFNGLBEGINQUERYEXTPROC>(eglGetProcAddress("glBeginQueryEXT"));
+        GLExtensions::EndQuery =
+            reinterpret_cast<PFNGLENDQUERYEXTPROC>(eglGetProcAddress("glEndQueryEXT"));
+        GLExtensions::GetQueryObjectuiv =
+            reinterpret_cast<PFNGLGETQUERYOBJECTUIVEXTPROC>(eglGetProcAddress("glGetQueryObjectuivEXT"));
+    }
+    else if (GLExtensions::version(3, 0)) {
+        GLExtensions::GenQueries =
+            reinterpret_cast<PFNGLGENQUERIESEXTPROC>(eglGetProcAddress("glGenQueries"));
+        GLExtensions::DeleteQueries =
+            reinterpret_cast<PFNGLDELETEQUERIESEXTPROC>(eglGetProcAddress("glDeleteQueries"));
+        GLExtensions::BeginQuery =
+            reinterpret_cast<PFNGLBEGINQUERYEXTPROC>(eglGetProcAddress("glBeginQuery"));
+        GLExtensions::EndQuery =
+            reinterpret_cast<PFNGLENDQUERYEXTPROC>(eglGetProcAddress("glEndQuery"));
+        GLExtensions::GetQueryObjectuiv =
+            reinterpret_cast<PFNGLGETQUERYOBJECTUIVEXTPROC>(eglGetProcAddress("glGetQueryObjectuiv"));
+    }
+    if (timer_query) {
+        GLExtensions::GetQueryObjectui64v =
+            reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(eglGetProcAddress("glGetQueryObjectui64vEXT"));
+    }
+    if (GLExtensions::support(GLExtensions::UniformBufferObjects)) {
+        GLExtensions::BindBufferRange =
+            reinterpret_cast<void (*)(GLenum, GLuint, GLuint, GLintptr, GLsizeiptr)>(
+                eglGetProcAddress("glBindBufferRange"));
+        GLExtensions::GetUniformBlockIndex =
+            reinterpret_cast<GLuint (*)(GLuint, const GLchar *)>(
+                eglGetProcAddress("glGetUniformBlockIndex"));
+        GLExtensions::UniformBlockBinding =
+            reinterpret_cast<void (*)(GLuint, GLuint, GLuint)>(
+                eglGetProcAddress("glUniformBlockBinding"));
+    }
+    if (GLExtensions::version(3, 0)) {
+        GLExtensions::DrawBuffers =
+            reinterpret_cast<void (*)(GLsizei, const GLenum *)>(
+                eglGetProcAddress("glDrawBuffers"));
+    }
+    else if (GLExtensions::support("GL_EXT_draw_buffers")) {
+        GLExtensions::DrawBuffers =
+            reinterpret_cast<void (*)(GLsizei, const GLenum *)>(
+                eglGetProcAddress("glDrawBuffersEXT"));
+    }
+    if (GLExtensions::version(3, 0)) {
+        GLExtensions::InvalidateFramebuffer =
+            reinterpret_cast<void (*)(GLenum, GLsizei, const GLenum *)>(
+                eglGetProcAddress("glInvalidateFramebuffer"));
+    }
+    else if (GLExtensions::support("GL_EXT_discard_framebuffer")) {
+        GLExtensions::InvalidateFramebuffer =
+            reinterpret_cast<void (*)(GLenum, GLsizei, const GLenum *)>(
+                eglGetProcAddress("glDiscardFramebufferEXT"));
+    }
+    if (GLExtensions::support(GLExtensions::SyncObjects)) {
+        GLExtensions::FenceSync =
+            reinterpret_cast<GLsync (*)(GLenum, GLbitfield)>(
+                eglGetProcAddress("glFenceSync"));
+        GLExtensions::DeleteSync =
+            reinterpret_cast<void (*)(GLsync)>(
+                eglGetProcAddress("glDeleteSync"));
+        GLExtensions::ClientWaitSync =
+            reinterpret_cast<GLenum (*)(GLsync, GLbitfield, GLuint64)>(
+                eglGetProcAddress("glClientWaitSync"));
+        GLExtensions::WaitSync =
+            reinterpret_cast<void (*)(GLsync, GLbitfield, GLuint64)>(
+                eglGetProcAddress("glWaitSync"));
+    }
 #elif GLMARK2_USE_GL
     GLExtensions::MapBuffer = glMapBuffer;
     GLExtensions::UnmapBuffer = glUnmapBuffer;
+    GLExtensions::GenQueries = glGenQueries;
+    GLExtensions::DeleteQueries = glDeleteQueries;
+    GLExtensions::BeginQuery = glBeginQuery;
+    GLExtensions::EndQuery = glEndQuery;
+    GLExtensions::GetQueryObjectuiv = glGetQueryObjectuiv;
+    if (GLExtensions::support("GL_ARB_timer_query"))
+        GLExtensions::GetQueryObjectui64v = glGetQueryObjectui64v;
+    if (GLExtensions::support(GLExtensions::UniformBufferObjects)) {
+        GLExtensions::BindBufferRange = glBindBufferRange;
+        GLExtensions::GetUniformBlockIndex = glGetUniformBlockIndex;
+        GLExtensions::UniformBlockBinding = glUniformBlockBinding;
+    }
+    GLExtensions::DrawBuffers = glDrawBuffers;
+    if (GLExtensions::support(GLExtensions::FramebufferInvalidation))
+        GLExtensions::InvalidateFramebuffer = glInvalidateFramebuffer;
+    if (GLExtensions::support(GLExtensions::SyncObjects)) {
+        GLExtensions::FenceSync = glFenceSync;
+        GLExtensions::DeleteSync = glDeleteSync;
+        GLExtensions::ClientWaitSync = glClientWaitSync;
+        GLExtensions::WaitSync = glWaitSync;
+    }
 #endif
 }
 
@@ -361,6 +579,8 @@ GLStateEGL::valid()
         return false;
     }
 
+    current_surface_ = egl_surface_;
+
     if (!eglSwapInterval(egl_display_, 0)) {
         Log::info("** Failed to set swap interval. Results may be bounded above by refresh rate.\n");
     }
@@ -370,6 +590,135 @@ GLStateEGL::valid()
     return true;
 }
 
+/*
+ * An EGLImage, bound to textures with glEGLImageTargetTexture2DOES.
+ */
+class GLImageEGL : public GLImage
+{
+public:
+    GLImageEGL(EGLDisplay display, EGLImageKHR image,
+               PFNEGLDESTROYIMAGEKHRPROC destroy_image,
+               void (*image_target_texture)(GLenum, void *)) :
+        display_(display), image_(image), destroy_image_(destroy_image),
+        image_target_texture_(image_target_texture) {}
+
+    ~GLImageEGL()
+    {
+        destroy_image_(display_, image_);
+    }
+
+    void bind(unsigned int target)
+    {
+        image_target_texture_(target, image_);
+    }
+
+private:
+    EGLDisplay display_;
+    EGLImageKHR image_;
+    PFNEGLDESTROYIMAGEKHRPROC destroy_image_;
+    void (*image_target_texture_)(GLenum, void *);
+};
+
+GLImage *
+GLStateEGL::import_dma_buf(const GLDmaBuf &buf)
+{
+    static const EGLint plane_attribs[3][3] = {
+        {EGL_DMA_BUF_PLANE0_FD_EXT, EGL_DMA_BUF_PLANE0_OFFSET_EXT, EGL_DMA_BUF_PLANE0_PITCH_EXT},
+        {EGL_DMA_BUF_PLANE1_FD_EXT, EGL_DMA_BUF_PLANE1_OFFSET_EXT, EGL_DMA_BUF_PLANE1_PITCH_EXT},
+        {EGL_DMA_BUF_PLANE2_FD_EXT, EGL_DMA_BUF_PLANE2_OFFSET_EXT, EGL_DMA_BUF_PLANE2_PITCH_EXT}
+    };
+
+    if (!gotValidDisplay() || buf.planes == 0 || buf.planes > 3)
+        return 0;
+
+    const char *exts = eglQueryString(egl_display_, EGL_EXTENSIONS);
+    if (!exts || !strstr(exts, "EGL_EXT_image_dma_buf_import")) {
+        Log::debug("EGL_EXT_image_dma_buf_import is not supported\n");
+        return 0;
+    }
+
+    PFNEGLCREATEIMAGEKHRPROC create_image =
+        reinterpret_cast<PFNEGLCREATEIMAGEKHRPROC>(eglGetProcAddress("eglCreateImageKHR"));
+    PFNEGLDESTROYIMAGEKHRPROC destroy_image =
+        reinterpret_cast<PFNEGLDESTROYIMAGEKHRPROC>(eglGetProcAddress("eglDestroyImageKHR"));
+    void (*image_target_texture)(GLenum, void *) =
+        reinterpret_cast<void (*)(GLenum, void *)>(
+            eglGetProcAddress("glEGLImageTargetTexture2DOES"));
+
+    if (!create_image || !destroy_image || !image_target_texture) {
+        Log::debug("EGLImage entry points are not available\n");
+        return 0;
+    }
+
+    vector<EGLint> attribs;
+    attribs.push_back(EGL_WIDTH);
+    attribs.push_back(buf.width);
+    attribs.push_back(EGL_HEIGHT);
+    attribs.push_back(buf.height);
+    attribs.push_back(EGL_LINUX_DRM_FOURCC_EXT);
+    attribs.push_back(buf.fourcc);
+
+    for (unsigned int i = 0; i < buf.planes; i++) {
+        attribs.push_back(plane_attribs[i][0]);
+        attribs.push_back(buf.fds[i]);
+        attribs.push_back(plane_attribs[i][1]);
+        attribs.push_back(buf.offsets[i]);
+        attribs.push_back(plane_attribs[i][2]);
+        attribs.push_back(buf.pitches[i]);
+    }
+
+    /* Multi-plane buffers are YUV, which video and cameras produce in BT.601 */
+    if (buf.planes > 1) {
+        attribs.push_back(EGL_YUV_COLOR_SPACE_HINT_EXT);
+        attribs.push_back(EGL_ITU_REC601_EXT);
+        attribs.push_back(EGL_SAMPLE_RANGE_HINT_EXT);
+        attribs.push_back(EGL_YUV_NARROW_RANGE_EXT);
+    }
+
+    attribs.push_back(EGL_NONE);
+
+    EGLImageKHR image = create_image(egl_display_, EGL_NO_CONTEXT,
+                                     EGL_LINUX_DMA_BUF_EXT, 0, &attribs[0]);
+    if (image == EGL_NO_IMAGE_KHR) {
+        Log::error("eglCreateImageKHR() failed with error: 0x%x\n", eglGetError());
+        return 0;
+    }
+
+    return new GLImageEGL(egl_display_, image, destroy_image, image_target_texture);
+}
+
+GLSharedContext *
+GLStateEGL::create_shared_context()
+{
+    if (!gotValidContext())
+        return 0;
+
+    EGLContext context = create_context(egl_context_);
+    if (!context)
+        return 0;
+
+    EGLSurface surface = EGL_NO_SURFACE;
+    const char *exts = eglQueryString(egl_display_, EGL_EXTENSIONS);
+
+    if (!exts || !strstr(exts, "EGL_KHR_surfaceless_context")) {
+        static const EGLint pbuffer_attribs[] = {
+            EGL_WIDTH, 1,
+            EGL_HEIGHT, 1,
+            EGL_NONE
+        };
+
+        surface = eglCreatePbufferSurface(egl_display_, egl_config_, pbuffer_attribs);
+        if (!surface) {
+            Log::error("eglCreatePbufferSurface() failed with error: 0x%x\n",
+                       eglGetError());
+            eglDestroyContext(egl_display_, context);
+            return 0;
+        }
+    }
+
+    return new GLSharedContextEGL(egl_display_, context, surface);
+}
+
 bool
 GLStateEGL::reset()
 {
@@ -393,7 +742,7 @@ GLStateEGL::reset()
 void
 GLStateEGL::swap()
 {
-    eglSwapBuffers(egl_display_, egl_surface_);
+    eglSwapBuffers(egl_display_, current_surface_ ? current_surface_ : egl_surface_);
 }
 
 bool
@@ -487,12 +836,7 @@ GLStateEGL::gotValidDisplay()
         return false;
     }
 
-#if GLMARK2_USE_GLESv2
-    EGLenum apiType(EGL_OPENGL_ES_API);
-#elif GLMARK2_USE_GL
-    EGLenum apiType(EGL_OPENGL_API);
-#endif
-    if (!eglBindAPI(apiType)) {
+    if (!eglBindAPI(egl_api)) {
         Log::error("Failed to bind api EGL_OPENGL_ES_API\n");
         return false;
     }
@@ -552,6 +896,13 @@ GLStateEGL::gotValidConfig()
     if (!gotValidDisplay())
         return false;
 
+#if GLMARK2_USE_GLESv2
+    const EGLint renderable_type = Options::gles_version.first >= 3 ?
+                                   EGL_OPENGL_ES3_BIT_KHR : EGL_OPENGL_ES2_BIT;
+#elif GLMARK2_USE_GL
+    const EGLint renderable_type = EGL_OPENGL_BIT;
+#endif
+
     const EGLint config_attribs[] = {
         EGL_RED_SIZE, requested_visual_config_.red,
         EGL_GREEN_SIZE, requested_visual_config_.green,
@@ -559,11 +910,7 @@ GLStateEGL::gotValidConfig()
         EGL_ALPHA_SIZE, requested_visual_config_.alpha,
         EGL_DEPTH_SIZE, requested_visual_config_.depth,
         EGL_STENCIL_SIZE, requested_visual_config_.stencil,
-#if GLMARK2_USE_GLESv2
-        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
-#elif GLMARK2_USE_GL
-        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
-#endif
+        EGL_RENDERABLE_TYPE, renderable_type,
         EGL_NONE
     };
 
@@ -646,6 +993,27 @@ GLStateEGL::gotValidSurface()
     return true;
 }
 
+void
+GLStateEGL::destroy_extra_surfaces()
+{
+    if (egl_context_ && !extra_surfaces_.empty() &&
+        current_surface_ != egl_surface_)
+    {
+        eglMakeCurrent(egl_display_, egl_surface_, egl_surface_, egl_context_);
+        current_surface_ = egl_surface_;
+    }
+
+    for (vector<EGLSurface>::iterator iter = extra_surfaces_.begin();
+         iter != extra_surfaces_.end();
+         iter++)
+    {
+        eglDestroySurface(egl_display_, *iter);
+    }
+
+    extra_surfaces_.clear();
+    extra_windows_.clear();
+}
+
 bool
 GLStateEGL::gotValidContext()
 {
@@ -658,21 +1026,64 @@ GLStateEGL::gotValidContext()
     if (!gotValidConfig())
         return false;
 
-    static const EGLint context_attribs[] = {
+    egl_context_ = create_context(EGL_NO_CONTEXT);
+
+    return egl_context_ != 0;
+}
+
+/*
+ * Creates a context with the requested version and profile, sharing objects
+ * with share_context unless it is EGL_NO_CONTEXT.
+ */
+EGLContext
+GLStateEGL::create_context(EGLContext share_context)
+{
+    vector<EGLint> context_attribs;
+
 #ifdef GLMARK2_USE_GLESv2
-        EGL_CONTEXT_CLIENT_VERSION, 2,
+    const std::pair<int,int> &version = Options::gles_version;
+#else
+    const std::pair<int,int> &version = Options::gl_version;
 #endif
-        EGL_NONE
-    };
 
-    egl_context_ = eglCreateContext(egl_display_, egl_config_,
-                                    EGL_NO_CONTEXT, context_attribs);
-    if (!egl_context_) {
+    if (version.first > 0) {
+        const char *exts = eglQueryString(egl_display_, EGL_EXTENSIONS);
+
+        if (!exts || !strstr(exts, "EGL_KHR_create_context")) {
+            Log::error("EGL_KHR_create_context is not supported, cannot request"
+                       " a version %d.%d context\n", version.first, version.second);
+            return EGL_NO_CONTEXT;
+        }
+
+        context_attribs.push_back(EGL_CONTEXT_MAJOR_VERSION_KHR);
+        context_attribs.push_back(version.first);
+        context_attribs.push_back(EGL_CONTEXT_MINOR_VERSION_KHR);
+        context_attribs.push_back(version.second);
+#ifdef GLMARK2_USE_GL
+        if (version >= std::pair<int,int>(3, 2)) {
+            context_attribs.push_back(EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR);
+            context_attribs.push_back(Options::gl_core_profile ?
+                                      EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR :
+                                      EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT_KHR);
+        }
+#endif
+    }
+#ifdef GLMARK2_USE_GLESv2
+    else {
+        context_attribs.push_back(EGL_CONTEXT_CLIENT_VERSION);
+        context_attribs.push_back(2);
+    }
+#endif
+    context_attribs.push_back(EGL_NONE);
+
+    EGLContext context = eglCreateContext(egl_display_, egl_config_,
+                                          share_context, &context_attribs[0]);
+    if (!context) {
         Log::error("eglCreateContext() failed with error: 0x%x\n",
                    eglGetError());
-        return false;
+        return EGL_NO_CONTEXT;
     }
 
-    return true;
+    return context;
 }
 
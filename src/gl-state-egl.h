@@ -122,12 +122,18 @@ class GLStateEGL : public GLState
     EGLConfig egl_config_;
     EGLContext egl_context_;
     EGLSurface egl_surface_;
+    // The surfaces of additional windows, and the surface that is current
+    std::vector<EGLNativeWindowType> extra_windows_;
+    std::vector<EGLSurface> extra_surfaces_;
+    EGLSurface current_surface_;
     GLVisualConfig requested_visual_config_;
     EglConfig best_config_;
     bool gotValidDisplay();
     bool gotValidConfig();
     bool gotValidSurface();
     bool gotValidContext();
+    EGLContext create_context(EGLContext share_context);
+    void destroy_extra_surfaces();
     void get_glvisualconfig(EGLConfig config, GLVisualConfig& visual_config);
     EGLConfig select_best_config(std::vector<EGLConfig>& configs);
 public:
@@ -137,11 +143,16 @@ public:
         egl_display_(0),
         egl_config_(0),
         egl_context_(0),
-        egl_surface_(0) {}
+        egl_surface_(0),
+        current_surface_(0) {}
     ~GLStateEGL();
 
     bool init_display(void* native_display, GLVisualConfig& config_pref);
     bool init_surface(void* native_window);
+    bool init_extra_surfaces(void* const* native_windows, unsigned int count);
+    bool select_surface(unsigned int index);
+    GLSharedContext *create_shared_context();
+    GLImage *import_dma_buf(const GLDmaBuf &buf);
     void init_gl_extensions();
     bool valid();
     bool reset();
@@ -25,12 +25,20 @@
 #include "options.h"
 
 #include <climits>
+#include <cstring>
 
 namespace
 {
 PFNGLXSWAPINTERVALEXTPROC glXSwapIntervalEXT_;
 PFNGLXSWAPINTERVALMESAPROC glXSwapIntervalMESA_;
 PFNGLXGETSWAPINTERVALMESAPROC glXGetSwapIntervalMESA_;
+
+/* Failing to create a context with the requested attributes is not fatal */
+int
+ignore_x_error(Display *, XErrorEvent *)
+{
+    return 0;
+}
 }
 
 /******************
@@ -54,11 +62,94 @@ GLStateGLX::init_surface(void* native_window)
     return (xwin_ != 0);
 }
 
+bool
+GLStateGLX::init_extra_surfaces(void* const* native_windows, unsigned int count)
+{
+    extra_wins_.clear();
+
+    for (unsigned int i = 0; i < count; i++) {
+        Window win = reinterpret_cast<Window>(native_windows[i]);
+        if (!win)
+            return false;
+        extra_wins_.push_back(win);
+
+        /*
+         * The swap interval is an attribute of the drawable, so set it
+         * once here instead of on every switch.  GLX_MESA_swap_control
+         * only sets it for the current drawable.
+         */
+        if (glXSwapIntervalEXT_) {
+            glXSwapIntervalEXT_(xdpy_, win, 0);
+        }
+        else if (glXSwapIntervalMESA_) {
+            if (!glXMakeCurrent(xdpy_, win, glx_context_)) {
+                Log::error("glXMakeCurrent failed\n");
+                return false;
+            }
+            glXSwapIntervalMESA_(0);
+        }
+    }
+
+    if (!glXSwapIntervalEXT_ && glXSwapIntervalMESA_ && count > 0) {
+        if (!glXMakeCurrent(xdpy_, xwin_, glx_context_)) {
+            Log::error("glXMakeCurrent failed\n");
+            return false;
+        }
+        current_win_ = xwin_;
+    }
+
+    return true;
+}
+
+bool
+GLStateGLX::select_surface(unsigned int index)
+{
+    if (index > extra_wins_.size())
+        return false;
+
+    Window win = index == 0 ? xwin_ : extra_wins_[index - 1];
+
+    if (win == current_win_)
+        return true;
+
+    if (!glXMakeCurrent(xdpy_, win, glx_context_)) {
+        Log::error("glXMakeCurrent failed\n");
+        return false;
+    }
+
+    current_win_ = win;
+
+    return true;
+}
+
 void
 GLStateGLX::init_gl_extensions()
 {
+    GLExtensions::init_capabilities();
+
     GLExtensions::MapBuffer = glMapBuffer;
     GLExtensions::UnmapBuffer = glUnmapBuffer;
+    GLExtensions::GenQueries = glGenQueries;
+    GLExtensions::DeleteQueries = glDeleteQueries;
+    GLExtensions::BeginQuery = glBeginQuery;
+    GLExtensions::EndQuery = glEndQuery;
+    GLExtensions::GetQueryObjectuiv = glGetQueryObjectuiv;
+    if (GLExtensions::support("GL_ARB_timer_query"))
+        GLExtensions::GetQueryObjectui64v = glGetQueryObjectui64v;
+    if (GLExtensions::support(GLExtensions::UniformBufferObjects)) {
+        GLExtensions::BindBufferRange = glBindBufferRange;
+        GLExtensions::GetUniformBlockIndex = glGetUniformBlockIndex;
+        GLExtensions::UniformBlockBinding = glUniformBlockBinding;
+    }
+    GLExtensions::DrawBuffers = glDrawBuffers;
+    if (GLExtensions::support(GLExtensions::FramebufferInvalidation))
+        GLExtensions::InvalidateFramebuffer = glInvalidateFramebuffer;
+    if (GLExtensions::support(GLExtensions::SyncObjects)) {
+        GLExtensions::FenceSync = glFenceSync;
+        GLExtensions::DeleteSync = glDeleteSync;
+        GLExtensions::ClientWaitSync = glClientWaitSync;
+        GLExtensions::WaitSync = glWaitSync;
+    }
 }
 
 bool
@@ -80,6 +171,8 @@ GLStateGLX::valid()
         return false;
     }
 
+    current_win_ = xwin_;
+
     init_gl_extensions();
 
     unsigned int desired_swap(0);
@@ -104,6 +197,72 @@ GLStateGLX::valid()
 }
 
 
+/*
+ * A context shared with the main context, current with a 1x1 pbuffer.
+ */
+class GLSharedContextGLX : public GLSharedContext
+{
+public:
+    GLSharedContextGLX(Display *xdpy, GLXContext context, GLXPbuffer pbuffer) :
+        xdpy_(xdpy), context_(context), pbuffer_(pbuffer) {}
+
+    ~GLSharedContextGLX()
+    {
+        glXDestroyPbuffer(xdpy_, pbuffer_);
+        glXDestroyContext(xdpy_, context_);
+    }
+
+    bool make_current()
+    {
+        if (!glXMakeContextCurrent(xdpy_, pbuffer_, pbuffer_, context_)) {
+            Log::error("glXMakeContextCurrent failed\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    void release_current()
+    {
+        glXMakeContextCurrent(xdpy_, None, None, 0);
+    }
+
+private:
+    Display *xdpy_;
+    GLXContext context_;
+    GLXPbuffer pbuffer_;
+};
+
+GLSharedContext *
+GLStateGLX::create_shared_context()
+{
+    if (!ensure_glx_context())
+        return 0;
+
+    GLXContext context = create_glx_context(glx_context_);
+    if (!context)
+        return 0;
+
+    static const int pbuffer_attribs[] = {
+        GLX_PBUFFER_WIDTH, 1,
+        GLX_PBUFFER_HEIGHT, 1,
+        None
+    };
+
+    XErrorHandler old_handler = XSetErrorHandler(ignore_x_error);
+    GLXPbuffer pbuffer = glXCreatePbuffer(xdpy_, glx_fbconfig_, pbuffer_attribs);
+    XSync(xdpy_, False);
+    XSetErrorHandler(old_handler);
+
+    if (!pbuffer) {
+        Log::error("glXCreatePbuffer failed\n");
+        glXDestroyContext(xdpy_, context);
+        return 0;
+    }
+
+    return new GLSharedContextGLX(xdpy_, context, pbuffer);
+}
+
 bool
 GLStateGLX::reset()
 {
@@ -119,7 +278,7 @@ GLStateGLX::reset()
 void
 GLStateGLX::swap()
 {
-    glXSwapBuffers(xdpy_, xwin_);
+    glXSwapBuffers(xdpy_, current_win_ ? current_win_ : xwin_);
 }
 
 bool
@@ -293,15 +452,71 @@ GLStateGLX::ensure_glx_context()
     if (!ensure_glx_fbconfig())
         return false;
 
-    glx_context_ = glXCreateNewContext(xdpy_, glx_fbconfig_, GLX_RGBA_TYPE,
-                                       0, True);
-    if (!glx_context_) {
-        Log::error("glXCreateNewContext failed\n");
-        return false;
+    glx_context_ = create_glx_context(0);
+
+    return glx_context_ != 0;
+}
+
+/*
+ * Creates a context with the requested version and profile, sharing objects
+ * with share_context unless it is 0.
+ */
+GLXContext
+GLStateGLX::create_glx_context(GLXContext share_context)
+{
+    const std::pair<int,int> &version = Options::gl_version;
+
+    if (version.first > 0) {
+        const char *exts = glXQueryExtensionsString(xdpy_, DefaultScreen(xdpy_));
+        PFNGLXCREATECONTEXTATTRIBSARBPROC create_context_attribs =
+            reinterpret_cast<PFNGLXCREATECONTEXTATTRIBSARBPROC>(
+                glXGetProcAddress(
+                    reinterpret_cast<const GLubyte *>("glXCreateContextAttribsARB")
+                )
+            );
+
+        if (!exts || !strstr(exts, "GLX_ARB_create_context") ||
+            !create_context_attribs)
+        {
+            Log::error("GLX_ARB_create_context is not supported, cannot request"
+                       " a version %d.%d context\n", version.first, version.second);
+            return 0;
+        }
+
+        std::vector<int> attribs;
+        attribs.push_back(GLX_CONTEXT_MAJOR_VERSION_ARB);
+        attribs.push_back(version.first);
+        attribs.push_back(GLX_CONTEXT_MINOR_VERSION_ARB);
+        attribs.push_back(version.second);
+        if (version >= std::pair<int,int>(3, 2)) {
+            attribs.push_back(GLX_CONTEXT_PROFILE_MASK_ARB);
+            attribs.push_back(Options::gl_core_profile ?
+                              GLX_CONTEXT_CORE_PROFILE_BIT_ARB :
+                              GLX_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB);
+        }
+        attribs.push_back(None);
+
+        XErrorHandler old_handler = XSetErrorHandler(ignore_x_error);
+        GLXContext context = create_context_attribs(xdpy_, glx_fbconfig_,
+                                                    share_context, True,
+                                                    &attribs[0]);
+        XSync(xdpy_, False);
+        XSetErrorHandler(old_handler);
+
+        if (!context) {
+            Log::error("glXCreateContextAttribsARB failed to create a GL %d.%d"
+                       " context\n", version.first, version.second);
+        }
+
+        return context;
     }
 
+    GLXContext context = glXCreateNewContext(xdpy_, glx_fbconfig_, GLX_RGBA_TYPE,
+                                             share_context, True);
+    if (!context)
+        Log::error("glXCreateNewContext failed\n");
 
-    return true;
+    return context;
 }
 
 void
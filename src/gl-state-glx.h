@@ -38,11 +38,14 @@ class GLStateGLX : public GLState
 {
 public:
     GLStateGLX()
-        : xdpy_(0), xwin_(0), glx_fbconfig_(0), glx_context_(0) {}
+        : xdpy_(0), xwin_(0), current_win_(0), glx_fbconfig_(0), glx_context_(0) {}
 
     bool valid();
     bool init_display(void* native_display, GLVisualConfig& config_pref);
     bool init_surface(void* native_window);
+    bool init_extra_surfaces(void* const* native_windows, unsigned int count);
+    bool select_surface(unsigned int index);
+    GLSharedContext *create_shared_context();
     void init_gl_extensions();
     bool reset();
     void swap();
@@ -54,11 +57,15 @@ private:
     void init_extensions();
     bool ensure_glx_fbconfig();
     bool ensure_glx_context();
+    GLXContext create_glx_context(GLXContext share_context);
     void get_glvisualconfig_glx(GLXFBConfig config, GLVisualConfig &visual_config);
     GLXFBConfig select_best_config(std::vector<GLXFBConfig> configs);
 
     Display* xdpy_;
     Window xwin_;
+    /** The windows of the extra surfaces, and the window that is current */
+    std::vector<Window> extra_wins_;
+    Window current_win_;
     GLXFBConfig glx_fbconfig_;
     GLXContext glx_context_;
     GLVisualConfig requested_visual_config_;
@@ -24,6 +24,48 @@
 
 class GLVisualConfig;
 
+/*
+ * A context that shares its objects with the main context, for another
+ * thread to use.  It has no window surface, so it only renders to FBOs.
+ */
+class GLSharedContext
+{
+public:
+    virtual ~GLSharedContext() {}
+
+    /* Makes the context current in the calling thread */
+    virtual bool make_current() = 0;
+    /* Releases the context from the calling thread */
+    virtual void release_current() = 0;
+};
+
+/*
+ * A dma-buf in a DRM fourcc format, with one file descriptor, offset and
+ * pitch per plane.
+ */
+struct GLDmaBuf
+{
+    unsigned int width;
+    unsigned int height;
+    unsigned int fourcc;
+    unsigned int planes;
+    int fds[3];
+    unsigned int offsets[3];
+    unsigned int pitches[3];
+};
+
+/*
+ * An image imported from outside the GL, which textures can sample.
+ */
+class GLImage
+{
+public:
+    virtual ~GLImage() {}
+
+    /* Makes the image the storage of the texture bound to target */
+    virtual void bind(unsigned int target) = 0;
+};
+
 class GLState
 {
 public:
@@ -31,6 +73,34 @@ public:
 
     virtual bool init_display(void *native_display, GLVisualConfig& config_pref) = 0;
     virtual bool init_surface(void *native_window) = 0;
+    /*
+     * Creates the surfaces of additional native windows, which share the
+     * context with the main surface.
+     */
+    virtual bool init_extra_surfaces(void * const *native_windows, unsigned int count)
+    {
+        static_cast<void>(native_windows);
+        return count == 0;
+    }
+    /*
+     * Makes a surface current, 0 being the main surface and the others the
+     * extra surfaces in order.  swap() presents the current surface.
+     */
+    virtual bool select_surface(unsigned int index) { return index == 0; }
+    /*
+     * Creates a context that shares objects with the main context, or
+     * returns 0 if the state cannot create one.  The caller owns it.
+     */
+    virtual GLSharedContext *create_shared_context() { return 0; }
+    /*
+     * Imports a dma-buf as an image, or returns 0 if the state cannot
+     * import it.  The caller owns the image.
+     */
+    virtual GLImage *import_dma_buf(const GLDmaBuf &buf)
+    {
+        static_cast<void>(buf);
+        return 0;
+    }
     virtual void init_gl_extensions() = 0;
     virtual bool valid() = 0;
     virtual bool reset() = 0;
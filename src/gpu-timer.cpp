@@ -0,0 +1,225 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "gpu-timer.h"
+#include "util.h"
+
+GPUTimer::GPUTimer() :
+    head_(0), pending_(0), active_(false), initialized_(false),
+    elapsed_ms_(-1.0), total_ms_(0.0), samples_(0)
+{
+}
+
+GPUTimer::~GPUTimer()
+{
+    release();
+}
+
+bool
+GPUTimer::supported()
+{
+    return !GLCapture::active() &&
+           GLExtensions::GenQueries && GLExtensions::DeleteQueries &&
+           GLExtensions::BeginQuery && GLExtensions::EndQuery &&
+           GLExtensions::GetQueryObjectuiv &&
+           GLExtensions::GetQueryObjectui64v;
+}
+
+bool
+GPUTimer::init()
+{
+    release();
+
+    if (!supported())
+        return false;
+
+    GLExtensions::GenQueries(nqueries_, queries_);
+    head_ = 0;
+    pending_ = 0;
+    active_ = false;
+    elapsed_ms_ = -1.0;
+    total_ms_ = 0.0;
+    samples_ = 0;
+    initialized_ = true;
+
+    return true;
+}
+
+void
+GPUTimer::release()
+{
+    if (!initialized_)
+        return;
+
+    if (active_)
+        GLExtensions::EndQuery(GL_TIME_ELAPSED);
+
+    GLExtensions::DeleteQueries(nqueries_, queries_);
+    initialized_ = false;
+    active_ = false;
+    pending_ = 0;
+}
+
+void
+GPUTimer::begin()
+{
+    if (!initialized_ || active_)
+        return;
+
+    collect();
+
+    /* Never wait for the GPU; skip this measurement instead */
+    if (pending_ == nqueries_)
+        return;
+
+    GLExtensions::BeginQuery(GL_TIME_ELAPSED, queries_[head_]);
+    active_ = true;
+}
+
+void
+GPUTimer::end()
+{
+    if (!active_)
+        return;
+
+    GLExtensions::EndQuery(GL_TIME_ELAPSED);
+    head_ = (head_ + 1) % nqueries_;
+    pending_++;
+    active_ = false;
+}
+
+/**
+ * Reads back the results of all completed queries, oldest first.
+ */
+void
+GPUTimer::collect()
+{
+#if GLMARK2_USE_GLESv2
+    /*
+     * A disjoint operation (eg frequency change) invalidates all queries
+     * in flight, so just drop them.
+     */
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT, &disjoint);
+    if (disjoint) {
+        pending_ = 0;
+        return;
+    }
+#endif
+
+    while (pending_ > 0) {
+        GLuint query = queries_[(head_ + nqueries_ - pending_) % nqueries_];
+        GLuint available = 0;
+
+        GLExtensions::GetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE,
+                                        &available);
+        if (!available)
+            break;
+
+        GLuint64 elapsed_ns = 0;
+        GLExtensions::GetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+        elapsed_ms_ = elapsed_ns / 1000000.0;
+        total_ms_ += elapsed_ms_;
+        samples_++;
+        pending_--;
+    }
+}
+
+SweepTimer::SweepTimer() :
+    current_(0), batch_frames_(0), frames_per_batch_(1), batch_start_(0),
+    gpu_(false)
+{
+}
+
+SweepTimer::~SweepTimer()
+{
+    release();
+}
+
+bool
+SweepTimer::init(unsigned int variants, unsigned int frames_per_batch, bool gpu)
+{
+    release();
+
+    wall_us_.assign(variants, 0.0);
+    frames_.assign(variants, 0);
+    frames_per_batch_ = frames_per_batch;
+
+    gpu_ = gpu;
+    for (unsigned int i = 0; i < variants && gpu_; i++) {
+        timers_.push_back(new GPUTimer());
+        gpu_ = timers_.back()->init();
+    }
+
+    start_batch(0);
+
+    return gpu_;
+}
+
+void
+SweepTimer::release()
+{
+    Util::dispose_pointer_vector(timers_);
+    wall_us_.clear();
+    frames_.clear();
+    gpu_ = false;
+}
+
+void
+SweepTimer::end_batch()
+{
+    wall_us_[current_] += Util::get_timestamp_us() - batch_start_;
+    frames_[current_] += batch_frames_;
+    batch_frames_ = 0;
+}
+
+void
+SweepTimer::start_batch(unsigned int variant)
+{
+    current_ = variant;
+    batch_frames_ = 0;
+    batch_start_ = Util::get_timestamp_us();
+}
+
+void
+SweepTimer::begin()
+{
+    if (gpu_)
+        timers_[current_]->begin();
+}
+
+void
+SweepTimer::end()
+{
+    if (gpu_)
+        timers_[current_]->end();
+
+    batch_frames_++;
+}
+
+double
+SweepTimer::seconds(unsigned int variant) const
+{
+    if (gpu_ && timers_[variant]->average_ms() > 0.0)
+        return timers_[variant]->average_ms() / 1000.0;
+
+    if (frames_[variant] > 0)
+        return wall_us_[variant] / frames_[variant] / 1000000.0;
+
+    return -1.0;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_GPU_TIMER_H_
+#define GLMARK2_GPU_TIMER_H_
+
+#include "gl-headers.h"
+
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Measures GPU time using GL_TIME_ELAPSED queries.
+ *
+ * A small ring of queries is used so that results can be read back a few
+ * frames later without ever stalling the pipeline.  If all queries are still
+ * in flight, the measurement for the current interval is skipped.
+ */
+class GPUTimer
+{
+public:
+    GPUTimer();
+    ~GPUTimer();
+
+    /**
+     * Whether the current GL implementation supports timer queries.
+     *
+     * Timer queries are not recorded by GLCapture, so they are reported
+     * as unsupported while a capture is active, and scenes fall back to
+     * their CPU-side timings.
+     */
+    static bool supported();
+
+    /**
+     * Creates the query objects.
+     *
+     * Must be called with the GL context that will be used for timing.
+     *
+     * @return whether the timer is usable
+     */
+    bool init();
+
+    /**
+     * Deletes the query objects.
+     */
+    void release();
+
+    /**
+     * Starts timing the GL commands that follow.
+     */
+    void begin();
+
+    /**
+     * Stops timing the GL commands issued since begin().
+     */
+    void end();
+
+    /**
+     * Gets the most recent available GPU time.
+     *
+     * @return the elapsed time in milliseconds, or a negative value if
+     *         no result has become available yet
+     */
+    double elapsed_ms() const { return elapsed_ms_; }
+
+    /**
+     * Gets the average GPU time of all the results read back since ::init().
+     *
+     * @return the average time in milliseconds, or a negative value if
+     *         no result has become available yet
+     */
+    double average_ms() const
+    {
+        return samples_ > 0 ? total_ms_ / samples_ : -1.0;
+    }
+
+private:
+    GPUTimer(const GPUTimer &);
+    GPUTimer &operator=(const GPUTimer &);
+
+    void collect();
+
+    static const unsigned int nqueries_ = 4;
+    GLuint queries_[nqueries_];
+    unsigned int head_;
+    unsigned int pending_;
+    bool active_;
+    bool initialized_;
+    double elapsed_ms_;
+    double total_ms_;
+    unsigned int samples_;
+};
+
+/**
+ * Times a sweep over a number of variants (e.g. programs or texture sizes).
+ *
+ * Each variant is measured for a batch of frames in turn, so that all of
+ * them are measured under the same conditions over the duration of a
+ * scene.  Each variant has its own GPUTimer when GPU time is measured,
+ * and the wall-clock time of its batches is always accumulated as a
+ * fallback.
+ */
+class SweepTimer
+{
+public:
+    SweepTimer();
+    ~SweepTimer();
+
+    /**
+     * Sets up the measurements of the variants and starts the batch of
+     * the first one.
+     *
+     * @param variants the number of variants
+     * @param frames_per_batch the number of frames in each batch
+     * @param gpu whether to measure GPU time
+     *
+     * @return whether GPU time is measured
+     */
+    bool init(unsigned int variants, unsigned int frames_per_batch, bool gpu);
+
+    /**
+     * Deletes the GPU timers.
+     */
+    void release();
+
+    /**
+     * Whether the batch of the current variant is complete.
+     */
+    bool batch_done() const { return batch_frames_ >= frames_per_batch_; }
+
+    /**
+     * Ends the batch of the current variant.
+     */
+    void end_batch();
+
+    /**
+     * Starts a batch of a variant, which becomes the current one.
+     */
+    void start_batch(unsigned int variant);
+
+    unsigned int current() const { return current_; }
+    bool gpu() const { return gpu_; }
+
+    /**
+     * Starts timing the GL commands of a frame of the current variant.
+     */
+    void begin();
+
+    /**
+     * Stops timing the frame, which is counted in the batch.
+     */
+    void end();
+
+    /**
+     * Gets the average time per frame of a variant, in GPU time if it is
+     * measured and available, and in wall-clock time otherwise.
+     *
+     * @return the time in seconds, or a negative value if the variant
+     *         has not been measured
+     */
+    double seconds(unsigned int variant) const;
+
+private:
+    SweepTimer(const SweepTimer &);
+    SweepTimer &operator=(const SweepTimer &);
+
+    std::vector<GPUTimer *> timers_;
+    std::vector<double> wall_us_;
+    std::vector<unsigned int> frames_;
+    unsigned int current_;
+    unsigned int batch_frames_;
+    unsigned int frames_per_batch_;
+    uint64_t batch_start_;
+    bool gpu_;
+};
+
+#endif
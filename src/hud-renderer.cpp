@@ -0,0 +1,482 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "hud-renderer.h"
+#include "text-renderer.h"
+#include "scene.h"
+#include "shader-source.h"
+#include "texture.h"
+#include "gl-memory.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+
+using LibMatrix::vec2;
+
+/* Number of frames shown in the graph */
+static const unsigned int nslots(128);
+/* Maximum number of characters per text line */
+static const unsigned int line_chars(36);
+static const unsigned int text_lines(4);
+
+/* Quad layout in the vertex buffer */
+static const unsigned int background_quad(0);
+static const unsigned int slot_quads_base(1);
+static const unsigned int quads_per_slot(3);
+static const unsigned int line_quads_base(slot_quads_base + nslots * quads_per_slot);
+static const unsigned int text_quads_base(line_quads_base + 3);
+static const unsigned int total_quads(text_quads_base + line_chars * text_lines);
+
+/* How often to refresh the text, percentiles and graph scale */
+static const uint64_t refresh_interval(500000);
+
+static const GLubyte background_color[] = {0, 0, 0, 160};
+static const GLubyte cpu_color[] = {64, 128, 255, 255};
+static const GLubyte frame_color[] = {64, 220, 64, 255};
+static const GLubyte gpu_color[] = {255, 160, 0, 255};
+static const GLubyte p50_color[] = {255, 255, 255, 200};
+static const GLubyte p90_color[] = {255, 255, 0, 200};
+static const GLubyte p99_color[] = {255, 64, 64, 200};
+static const GLubyte text_color[] = {255, 255, 255, 255};
+
+/******************
+ * Public methods *
+ ******************/
+
+HudRenderer::HudRenderer(Canvas& canvas) :
+    canvas_(canvas), position_(-0.98, 0.3), position_loc_(-1),
+    texcoord_loc_(-1), color_loc_(-1), texture_(0),
+    vertices_(4 * total_quads), frame_ms_(nslots, 0.0), cpu_ms_(nslots, 0.0),
+    gpu_ms_(nslots, -1.0), scratch_(nslots), nsamples_(0), cursor_(0),
+    nglyphs_(0), dirty_slot_(nslots), dirty_(true), scale_ms_(1000.0 / 30.0),
+    hud_ms_total_(0.0), frame_ms_total_(0.0), nframes_(0),
+    refresh_timestamp_(Util::get_timestamp_us())
+{
+    size(vec2(0.8, 0.4));
+
+    GLint prev_array_buffer = 0;
+    GLint prev_elem_array_buffer = 0;
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &prev_array_buffer);
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &prev_elem_array_buffer);
+
+    /*
+     * Allocate the vertex storage once; all later updates happen in place.
+     * The element array never changes.
+     */
+    std::vector<GLushort> elem_array;
+    elem_array.reserve(6 * total_quads);
+    for (unsigned int i = 0; i < total_quads; i++) {
+        elem_array.push_back(4 * i);
+        elem_array.push_back(4 * i + 1);
+        elem_array.push_back(4 * i + 2);
+        elem_array.push_back(4 * i + 2);
+        elem_array.push_back(4 * i + 1);
+        elem_array.push_back(4 * i + 3);
+    }
+
+    glGenBuffers(2, vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_[0]);
+    GLMemory::buffer_data(GL_ARRAY_BUFFER, vertices_.size() * sizeof(Vertex), 0,
+                          GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo_[1]);
+    GLMemory::buffer_data(GL_ELEMENT_ARRAY_BUFFER, elem_array.size() * sizeof(GLushort),
+                          &elem_array[0], GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, prev_array_buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, prev_elem_array_buffer);
+
+    ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/hud.vert");
+    ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/hud.frag");
+
+    if (!Scene::load_shaders_from_strings(program_, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return;
+    }
+
+    GLint prev_program;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_program);
+
+    program_.start();
+    program_["Texture0"] = 0;
+    position_loc_ = program_["position"].location();
+    texcoord_loc_ = program_["texcoord"].location();
+    color_loc_ = program_["color"].location();
+
+    glUseProgram(prev_program);
+
+    /* The text shares the glyph texture atlas with TextRenderer */
+    Texture::find_textures();
+    Texture::load("glyph-atlas", &texture_,
+                  GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, 0);
+}
+
+HudRenderer::~HudRenderer()
+{
+    GLMemory::delete_buffers(2, vbo_);
+    GLMemory::delete_textures(1, &texture_);
+}
+
+/**
+ * Sets the screen position of the lower left corner of the graph.
+ *
+ * @param p the position in normalized screen coordinates
+ */
+void
+HudRenderer::position(const vec2& p)
+{
+    if (position_ != p) {
+        position_ = p;
+        refresh();
+    }
+}
+
+/**
+ * Sets the size of the graph.
+ *
+ * The text lines are placed above the graph and their glyphs are sized so
+ * that a full line spans the graph width.
+ *
+ * @param s the width and height in normalized screen coordinates
+ */
+void
+HudRenderer::size(const vec2& s)
+{
+    if (size_ != s) {
+        /* Take into account the glyph and canvas aspect ratio */
+        vec2 glyph_tex_size(TextRenderer::get_glyph_size());
+        double canvas_aspect =
+            static_cast<double>(canvas_.width()) / canvas_.height();
+        double glyph_aspect_rev = glyph_tex_size.y() / glyph_tex_size.x();
+        float glyph_width = s.x() / line_chars;
+
+        size_ = s;
+        glyph_size_ = vec2(glyph_width,
+                           glyph_width * canvas_aspect * glyph_aspect_rev);
+        refresh();
+    }
+}
+
+void
+HudRenderer::add_frame(double frame_ms, double cpu_ms, double gpu_ms,
+                       double hud_ms)
+{
+    frame_ms_[cursor_] = frame_ms;
+    cpu_ms_[cursor_] = cpu_ms;
+    gpu_ms_[cursor_] = gpu_ms;
+    hud_ms_total_ += hud_ms;
+    frame_ms_total_ += frame_ms;
+    nframes_++;
+
+    if (nsamples_ < nslots)
+        nsamples_++;
+
+    /*
+     * Only the slot of the new frame needs to be updated, unless there are
+     * other pending changes.
+     */
+    update_slot(cursor_);
+    if (dirty_slot_ != nslots && dirty_slot_ != cursor_)
+        dirty_ = true;
+    dirty_slot_ = cursor_;
+
+    cursor_ = (cursor_ + 1) % nslots;
+
+    uint64_t now = Util::get_timestamp_us();
+    if (now - refresh_timestamp_ >= refresh_interval) {
+        refresh();
+        hud_ms_total_ = 0.0;
+        frame_ms_total_ = 0.0;
+        nframes_ = 0;
+        refresh_timestamp_ = now;
+    }
+}
+
+/**
+ * Renders the HUD.
+ */
+void
+HudRenderer::render()
+{
+    /* Save state */
+    GLint prev_program = 0;
+    GLint prev_array_buffer = 0;
+    GLint prev_elem_array_buffer = 0;
+    GLint prev_blend_src_rgb = 0;
+    GLint prev_blend_dst_rgb = 0;
+    GLint prev_blend_src_alpha = 0;
+    GLint prev_blend_dst_alpha = 0;
+    GLboolean prev_blend = GL_FALSE;
+    GLboolean prev_depth_test = GL_FALSE;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_program);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &prev_array_buffer);
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &prev_elem_array_buffer);
+    glGetIntegerv(GL_BLEND_SRC_RGB, &prev_blend_src_rgb);
+    glGetIntegerv(GL_BLEND_DST_RGB, &prev_blend_dst_rgb);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &prev_blend_src_alpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &prev_blend_dst_alpha);
+    glGetBooleanv(GL_BLEND, &prev_blend);
+    glGetBooleanv(GL_DEPTH_TEST, &prev_depth_test);
+
+    /* Set new state */
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_[0]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo_[1]);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_DEPTH_TEST);
+
+    /* Update the buffer in place */
+    if (dirty_) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0,
+                        4 * (text_quads_base + nglyphs_) * sizeof(Vertex),
+                        &vertices_[0]);
+    }
+    else if (dirty_slot_ != nslots) {
+        unsigned int first = 4 * (slot_quads_base + quads_per_slot * dirty_slot_);
+        glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Vertex),
+                        4 * quads_per_slot * sizeof(Vertex),
+                        &vertices_[first]);
+    }
+    dirty_ = false;
+    dirty_slot_ = nslots;
+
+    program_.start();
+
+    /* Render everything in a single draw call */
+    glEnableVertexAttribArray(position_loc_);
+    glEnableVertexAttribArray(texcoord_loc_);
+    glEnableVertexAttribArray(color_loc_);
+    glVertexAttribPointer(position_loc_, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<const GLvoid *>(offsetof(Vertex, x)));
+    glVertexAttribPointer(texcoord_loc_, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<const GLvoid *>(offsetof(Vertex, u)));
+    glVertexAttribPointer(color_loc_, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex),
+                          reinterpret_cast<const GLvoid *>(offsetof(Vertex, color)));
+
+    glDrawElements(GL_TRIANGLES, 6 * (text_quads_base + nglyphs_),
+                   GL_UNSIGNED_SHORT, 0);
+
+    glDisableVertexAttribArray(color_loc_);
+    glDisableVertexAttribArray(texcoord_loc_);
+    glDisableVertexAttribArray(position_loc_);
+
+    /* Restore state */
+    if (prev_depth_test == GL_TRUE)
+        glEnable(GL_DEPTH_TEST);
+    if (prev_blend == GL_FALSE)
+        glDisable(GL_BLEND);
+    glBlendFuncSeparate(prev_blend_src_rgb, prev_blend_dst_rgb,
+                        prev_blend_src_alpha, prev_blend_dst_alpha);
+    glBindBuffer(GL_ARRAY_BUFFER, prev_array_buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, prev_elem_array_buffer);
+    glUseProgram(prev_program);
+}
+
+/*******************
+ * Private methods *
+ *******************/
+
+/**
+ * Sets the vertices of a quad.
+ *
+ * Solid quads are marked with negative texcoords.
+ */
+void
+HudRenderer::set_quad(unsigned int quad, float x0, float y0, float x1, float y1,
+                      const GLubyte *color)
+{
+    Vertex *v = &vertices_[4 * quad];
+    const float pos[4][2] = {{x0, y0}, {x1, y0}, {x0, y1}, {x1, y1}};
+
+    for (unsigned int i = 0; i < 4; i++) {
+        v[i].x = pos[i][0];
+        v[i].y = pos[i][1];
+        v[i].u = -1.0;
+        v[i].v = -1.0;
+        std::copy(color, color + 4, v[i].color);
+    }
+}
+
+void
+HudRenderer::set_glyph(unsigned int quad, float x, float y, char c)
+{
+    vec2 tex0(TextRenderer::get_glyph_coords(c));
+    vec2 tex1(tex0 + TextRenderer::get_glyph_size());
+
+    set_quad(quad, x, y, x + glyph_size_.x(), y + glyph_size_.y(), text_color);
+
+    Vertex *v = &vertices_[4 * quad];
+    v[0].u = tex0.x(); v[0].v = tex0.y();
+    v[1].u = tex1.x(); v[1].v = tex0.y();
+    v[2].u = tex0.x(); v[2].v = tex1.y();
+    v[3].u = tex1.x(); v[3].v = tex1.y();
+}
+
+/**
+ * Sets the glyph quads for a line of text.
+ *
+ * @return the number of glyph quads used
+ */
+unsigned int
+HudRenderer::set_text(unsigned int quad, float x, float y, const char *s)
+{
+    unsigned int n = 0;
+
+    for (; s[n] != '\0' && n < line_chars; n++)
+        set_glyph(quad + n, x + n * glyph_size_.x(), y, s[n]);
+
+    return n;
+}
+
+/**
+ * Sets the graph bar quads for a frame slot.
+ */
+void
+HudRenderer::update_slot(unsigned int slot)
+{
+    const float slot_width = size_.x() / nslots;
+    const float x0 = position_.x() + slot * slot_width;
+    const float x1 = x0 + slot_width;
+    const float y0 = position_.y();
+    const float h = size_.y();
+    const float line_width = 4.0 / canvas_.height();
+    unsigned int quad = slot_quads_base + quads_per_slot * slot;
+
+    float frame_y = y0 + std::min(frame_ms_[slot] / scale_ms_, 1.0f) * h;
+    float cpu_y = y0 + std::min(cpu_ms_[slot] / scale_ms_, 1.0f) * h;
+    cpu_y = std::min(cpu_y, frame_y);
+
+    /* The CPU part of the frame time at the bottom, the rest on top */
+    set_quad(quad, x0, y0, x1, cpu_y, cpu_color);
+    set_quad(quad + 1, x0, cpu_y, x1, frame_y, frame_color);
+
+    /* The GPU time as a tick, if known */
+    if (gpu_ms_[slot] >= 0.0) {
+        float gpu_y = y0 + std::min(gpu_ms_[slot] / scale_ms_, 1.0f) * h;
+        set_quad(quad + 2, x0, gpu_y - line_width / 2, x1, gpu_y + line_width / 2,
+                 gpu_color);
+    }
+    else {
+        set_quad(quad + 2, x0, y0, x1, y0, gpu_color);
+    }
+}
+
+/**
+ * Recalculates the percentiles and graph scale and rebuilds all geometry.
+ *
+ * This is the only place where the whole vertex array is regenerated, so
+ * the work done per frame stays constant.
+ */
+void
+HudRenderer::refresh()
+{
+    float p50 = 0.0;
+    float p90 = 0.0;
+    float p99 = 0.0;
+    double cpu_total = 0.0;
+    double gpu_total = 0.0;
+    unsigned int gpu_count = 0;
+
+    if (nsamples_ > 0) {
+        std::vector<float>::iterator begin(scratch_.begin());
+        std::vector<float>::iterator end(begin + nsamples_);
+
+        std::copy(frame_ms_.begin(), frame_ms_.begin() + nsamples_, begin);
+        std::nth_element(begin, begin + (nsamples_ - 1) * 50 / 100, end);
+        p50 = *(begin + (nsamples_ - 1) * 50 / 100);
+        std::nth_element(begin, begin + (nsamples_ - 1) * 90 / 100, end);
+        p90 = *(begin + (nsamples_ - 1) * 90 / 100);
+        std::nth_element(begin, begin + (nsamples_ - 1) * 99 / 100, end);
+        p99 = *(begin + (nsamples_ - 1) * 99 / 100);
+
+        for (unsigned int i = 0; i < nsamples_; i++) {
+            cpu_total += cpu_ms_[i];
+            if (gpu_ms_[i] >= 0.0) {
+                gpu_total += gpu_ms_[i];
+                gpu_count++;
+            }
+        }
+
+        /* Leave some headroom above the 99th percentile */
+        scale_ms_ = std::max(p99 * 1.25f, 1.0f);
+    }
+
+    const float x0 = position_.x();
+    const float y0 = position_.y();
+    const float w = size_.x();
+    const float h = size_.y();
+    const float line_width = 4.0 / canvas_.height();
+    const float pad = glyph_size_.x() / 2;
+    const float text_y0 = y0 + h + pad;
+
+    set_quad(background_quad, x0 - pad, y0 - pad,
+             x0 + w + pad, text_y0 + text_lines * glyph_size_.y() + pad,
+             background_color);
+
+    for (unsigned int i = 0; i < nslots; i++)
+        update_slot(i);
+
+    const float percentiles[] = {p50, p90, p99};
+    const GLubyte *percentile_colors[] = {p50_color, p90_color, p99_color};
+    for (unsigned int i = 0; i < 3; i++) {
+        float y = y0 + std::min(percentiles[i] / scale_ms_, 1.0f) * h;
+        set_quad(line_quads_base + i, x0, y - line_width / 2,
+                 x0 + w, y + line_width / 2, percentile_colors[i]);
+    }
+
+    /* Text, from the top line down */
+    char line[line_chars + 1];
+    double mean_ms = 0.0;
+    for (unsigned int i = 0; i < nsamples_; i++)
+        mean_ms += frame_ms_[i] / nsamples_;
+
+    nglyphs_ = 0;
+
+    snprintf(line, sizeof(line), "FPS: %u Frame: %.2f ms",
+             mean_ms > 0.0 ? static_cast<unsigned int>(1000.0 / mean_ms + 0.5) : 0,
+             mean_ms);
+    nglyphs_ += set_text(text_quads_base + nglyphs_, x0,
+                         text_y0 + 3 * glyph_size_.y(), line);
+
+    snprintf(line, sizeof(line), "p50 %.2f p90 %.2f p99 %.2f", p50, p90, p99);
+    nglyphs_ += set_text(text_quads_base + nglyphs_, x0,
+                         text_y0 + 2 * glyph_size_.y(), line);
+
+    if (gpu_count > 0) {
+        snprintf(line, sizeof(line), "CPU %.2f ms GPU %.2f ms",
+                 nsamples_ > 0 ? cpu_total / nsamples_ : 0.0,
+                 gpu_total / gpu_count);
+    }
+    else {
+        snprintf(line, sizeof(line), "CPU %.2f ms GPU n/a",
+                 nsamples_ > 0 ? cpu_total / nsamples_ : 0.0);
+    }
+    nglyphs_ += set_text(text_quads_base + nglyphs_, x0,
+                         text_y0 + glyph_size_.y(), line);
+
+    snprintf(line, sizeof(line), "HUD %.3f ms (%.2f%%)",
+             nframes_ > 0 ? hud_ms_total_ / nframes_ : 0.0,
+             frame_ms_total_ > 0.0 ? 100.0 * hud_ms_total_ / frame_ms_total_ : 0.0);
+    nglyphs_ += set_text(text_quads_base + nglyphs_, x0, text_y0, line);
+
+    dirty_ = true;
+}
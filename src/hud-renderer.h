@@ -0,0 +1,102 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_HUD_RENDERER_H_
+#define GLMARK2_HUD_RENDERER_H_
+
+#include <vector>
+#include <stdint.h>
+#include "gl-headers.h"
+#include "vec.h"
+#include "program.h"
+#include "canvas.h"
+
+/**
+ * Renders a heads-up display with a rolling frame-time graph, frame-time
+ * percentiles and the CPU/GPU time split.
+ *
+ * All HUD elements (background, graph bars, percentile lines and text) are
+ * drawn with a single draw call from a vertex buffer that is allocated once
+ * and updated in place.  Adding a frame only rewrites the vertices of its
+ * graph slot; the rest of the HUD is refreshed periodically.
+ */
+class HudRenderer
+{
+public:
+    HudRenderer(Canvas& canvas);
+    ~HudRenderer();
+
+    void position(const LibMatrix::vec2& p);
+    void size(const LibMatrix::vec2& s);
+
+    /**
+     * Adds the timings of a frame to the HUD.
+     *
+     * @param frame_ms the total frame time
+     * @param cpu_ms the CPU time spent in the scene
+     * @param gpu_ms the GPU time spent in the scene, negative if unknown
+     * @param hud_ms the CPU time spent rendering the HUD
+     */
+    void add_frame(double frame_ms, double cpu_ms, double gpu_ms,
+                   double hud_ms);
+
+    void render();
+
+private:
+    struct Vertex {
+        GLfloat x, y;
+        GLfloat u, v;
+        GLubyte color[4];
+    };
+
+    void set_quad(unsigned int quad, float x0, float y0, float x1, float y1,
+                  const GLubyte *color);
+    void set_glyph(unsigned int quad, float x, float y, char c);
+    unsigned int set_text(unsigned int quad, float x, float y, const char *s);
+    void update_slot(unsigned int slot);
+    void refresh();
+
+    Canvas& canvas_;
+    LibMatrix::vec2 position_;
+    LibMatrix::vec2 size_;
+    LibMatrix::vec2 glyph_size_;
+    Program program_;
+    GLint position_loc_;
+    GLint texcoord_loc_;
+    GLint color_loc_;
+    GLuint vbo_[2];
+    GLuint texture_;
+
+    std::vector<Vertex> vertices_;
+    std::vector<float> frame_ms_;
+    std::vector<float> cpu_ms_;
+    std::vector<float> gpu_ms_;
+    std::vector<float> scratch_;
+    unsigned int nsamples_;
+    unsigned int cursor_;
+    unsigned int nglyphs_;
+    unsigned int dirty_slot_;
+    bool dirty_;
+    float scale_ms_;
+    double hud_ms_total_;
+    double frame_ms_total_;
+    unsigned int nframes_;
+    uint64_t refresh_timestamp_;
+};
+
+#endif
@@ -150,7 +150,7 @@ Program::release()
     message_.clear();
 
     // Release all of the symbol map resources.
-    for (std::map<string, Symbol*>::iterator symbolIt = symbols_.begin(); symbolIt != symbols_.end(); symbolIt++)
+    for (SymbolMap::iterator symbolIt = symbols_.begin(); symbolIt != symbols_.end(); symbolIt++)
     {
         delete (*symbolIt).second;
     }
@@ -339,7 +339,7 @@ Program::Symbol::operator=(const int& i)
 Program::Symbol&
 Program::operator[](const std::string& name)
 {
-    std::map<std::string, Symbol*>::iterator mapIt = symbols_.find(name);
+    SymbolMap::iterator mapIt = symbols_.find(name);
     if (mapIt == symbols_.end())
     {
         Program::Symbol::SymbolType type(Program::Symbol::Attribute);
@@ -358,3 +358,14 @@ Program::operator[](const std::string& name)
     }
     return *(*mapIt).second;
 }
+
+Program::Symbol&
+Program::operator[](const char* name)
+{
+    SymbolMap::iterator mapIt = symbols_.find(name);
+    if (mapIt == symbols_.end())
+    {
+        return (*this)[std::string(name)];
+    }
+    return *(*mapIt).second;
+}
@@ -142,6 +142,9 @@ private:
     // vernacular).  Typically used in conjunction with various VertexAttrib
     // interfaces.  Equality operators are used to load uniform data.
     Symbol& operator[](const std::string& name);
+    // Same as above, but looking up a symbol that has been used before does
+    // not construct a string, so that it can be done for every frame.
+    Symbol& operator[](const char* name);
 
     // If "valid" then the program has successfully been created.
     // If "ready" then the program has successfully been built.
@@ -151,11 +154,15 @@ private:
     bool ready() const { return ready_; }
     const std::string& errorMessage() const { return message_; }
 
+    // Get the OpenGL handle of the program object.
+    unsigned int handle() const { return handle_; }
+
 private:
     int getAttribIndex(const std::string& name);
     int getUniformLocation(const std::string& name);
     unsigned int handle_;
-    std::map<std::string, Symbol*> symbols_;
+    typedef std::map<std::string, Symbol*, std::less<> > SymbolMap;
+    SymbolMap symbols_;
     std::vector<Shader> shaders_;
     std::string message_;
     bool ready_;
@@ -55,15 +55,30 @@ bool is_valid_shader_type(ShaderSource::ShaderType shader_type)
 std::vector<ShaderSource::Precision>
 ShaderSource::default_precision_(ShaderSource::ShaderTypeUnknown + 1);
 
+/**
+ * Holds the contents of the files that have been loaded
+ */
+std::map<std::string, std::string> ShaderSource::file_cache_;
+
 /**
  * Loads the contents of a file into a string.
  *
+ * The contents are cached, so each file is only read once.
+ *
  * @param filename the name of the file
  * @param str the string to put the contents of the file into
  */
 bool
 ShaderSource::load_file(const std::string& filename, std::string& str)
 {
+    std::map<std::string, std::string>::const_iterator cached =
+        file_cache_.find(filename);
+
+    if (cached != file_cache_.end()) {
+        str += cached->second;
+        return true;
+    }
+
     std::unique_ptr<std::istream> is_ptr(Util::get_resource(filename));
     std::istream& inputFile(*is_ptr);
 
@@ -73,16 +88,147 @@ ShaderSource::load_file(const std::string& filename, std::string& str)
         return false;
     }
 
+    std::string contents;
     std::string curLine;
     while (getline(inputFile, curLine))
     {
-        str += curLine;
-        str += '\n';
+        contents += curLine;
+        contents += '\n';
     }
 
+    file_cache_[filename] = contents;
+    str += contents;
+
     return true;
 }
 
+/**
+ * Gets the source as a single string.
+ *
+ * @return the concatenated segments
+ */
+const std::string&
+ShaderSource::source()
+{
+    if (!source_valid_) {
+        size_t size = 0;
+        for (std::vector<std::string>::const_iterator iter = segments_.begin();
+             iter != segments_.end();
+             iter++)
+        {
+            size += iter->size();
+        }
+
+        source_.clear();
+        source_.reserve(size);
+        for (std::vector<std::string>::const_iterator iter = segments_.begin();
+             iter != segments_.end();
+             iter++)
+        {
+            source_ += *iter;
+        }
+
+        source_valid_ = true;
+    }
+
+    return source_;
+}
+
+/**
+ * Splits the segments at a position in the source.
+ *
+ * @param pos the position in the source
+ *
+ * @return the index of the first segment after the position
+ */
+size_t
+ShaderSource::split(size_t pos)
+{
+    size_t seg_start = 0;
+
+    for (size_t i = 0; i < segments_.size(); i++) {
+        if (seg_start == pos)
+            return i;
+
+        size_t seg_end = seg_start + segments_[i].size();
+
+        if (pos < seg_end) {
+            segments_.insert(segments_.begin() + i + 1,
+                             segments_[i].substr(pos - seg_start));
+            segments_[i].erase(pos - seg_start);
+
+            for (std::map<std::string, size_t>::iterator iter = insertion_points_.begin();
+                 iter != insertion_points_.end();
+                 iter++)
+            {
+                if (iter->second > i)
+                    iter->second++;
+            }
+
+            return i + 1;
+        }
+
+        seg_start = seg_end;
+    }
+
+    return segments_.size();
+}
+
+/**
+ * Merges a range of segments into its first segment.
+ *
+ * Insertion points inside the range move to its start.
+ *
+ * @param first the index of the first segment
+ * @param last the index after the last segment
+ */
+void
+ShaderSource::merge(size_t first, size_t last)
+{
+    if (last <= first + 1)
+        return;
+
+    for (size_t i = first + 1; i < last; i++)
+        segments_[first] += segments_[i];
+
+    segments_.erase(segments_.begin() + first + 1, segments_.begin() + last);
+
+    for (std::map<std::string, size_t>::iterator iter = insertion_points_.begin();
+         iter != insertion_points_.end();
+         iter++)
+    {
+        if (iter->second >= last)
+            iter->second -= last - first - 1;
+        else if (iter->second > first)
+            iter->second = first;
+    }
+}
+
+/**
+ * Inserts a string at an insertion point.
+ *
+ * @param point the name of the insertion point
+ * @param str the string to insert
+ * @param in_order whether the string goes after earlier insertions at the
+ *        same point, instead of before them
+ */
+void
+ShaderSource::insert_at(const std::string &point, const std::string &str,
+                        bool in_order)
+{
+    size_t index = insertion_points_[point];
+
+    segments_.insert(segments_.begin() + index, str);
+    source_valid_ = false;
+
+    for (std::map<std::string, size_t>::iterator iter = insertion_points_.begin();
+         iter != insertion_points_.end();
+         iter++)
+    {
+        if (iter->second > index || (in_order && iter->first == point))
+            iter->second++;
+    }
+}
 
 /**
  * Appends a string to the shader source.
@@ -92,7 +238,8 @@ ShaderSource::load_file(const std::string& filename, std::string& str)
 void
 ShaderSource::append(const std::string &str)
 {
-    source_ << str;
+    segments_.push_back(str);
+    source_valid_ = false;
 }
 
 /**
@@ -105,7 +252,7 @@ ShaderSource::append_file(const std::string &filename)
 {
     std::string source;
     if (load_file(filename, source))
-        source_ << source;
+        append(source);
 }
 
 /**
@@ -117,16 +264,34 @@ ShaderSource::append_file(const std::string &filename)
 void
 ShaderSource::replace(const std::string &remove, const std::string &insert)
 {
+    if (remove.empty())
+        return;
+
+    const std::string &str(source());
+    std::vector<size_t> matches;
     std::string::size_type pos = 0;
-    std::string str(source_.str());
 
     while ((pos = str.find(remove, pos)) != std::string::npos) {
-        str.replace(pos, remove.size(), insert);
-        pos++;
+        matches.push_back(pos);
+        pos += remove.size();
+    }
+
+    if (matches.empty())
+        return;
+
+    /* Replace from the end, so that the earlier positions stay valid */
+    for (std::vector<size_t>::reverse_iterator iter = matches.rbegin();
+         iter != matches.rend();
+         iter++)
+    {
+        size_t first = split(*iter);
+        size_t last = split(*iter + remove.size());
+
+        merge(first, last);
+        segments_[first] = insert;
     }
 
-    source_.clear();
-    source_.str(str);
+    source_valid_ = false;
 }
 
 /**
@@ -144,45 +309,53 @@ ShaderSource::replace_with_file(const std::string &remove, const std::string &fi
 }
 
 /**
- * Adds a string (usually containing a constant definition) at
- * global (per shader) scope.
+ * Inserts a string at a placeholder of the form $NAME$.
  *
- * The string is placed after any default precision qualifiers.
+ * The placeholder is removed from the source on the first insertion, and
+ * the strings inserted at it appear in the order they were inserted.
  *
- * @param str the string to add
+ * @param point the name of the placeholder, without the '$' signs
+ * @param str the string to insert
  */
 void
-ShaderSource::add_global(const std::string &str)
+ShaderSource::insert(const std::string &point, const std::string &str)
 {
-    std::string::size_type pos = 0;
-    std::string source(source_.str());
+    std::string placeholder("$" + point + "$");
 
-    /* Find the last precision qualifier */
-    pos = source.rfind("precision");
+    if (insertion_points_.find(placeholder) == insertion_points_.end()) {
+        std::string::size_type pos = source().find(placeholder);
 
-    if (pos != std::string::npos) {
-        /*
-         * Find the next #endif line of a preprocessor block that contains
-         * the precision qualifier.
-         */
-        std::string::size_type pos_if = source.find("#if", pos);
-        std::string::size_type pos_endif = source.find("#endif", pos);
+        if (pos == std::string::npos) {
+            Log::error("Shader source has no insertion point \"%s\"\n",
+                       placeholder.c_str());
+            return;
+        }
 
-        if (pos_endif != std::string::npos && pos_endif < pos_if)
-            pos = pos_endif;
+        size_t first = split(pos);
+        size_t last = split(pos + placeholder.size());
 
-        /* Go to the next line */
-        pos = source.find("\n", pos);
-        if (pos != std::string::npos)
-            pos++;
+        merge(first, last);
+        segments_[first].clear();
+        source_valid_ = false;
+
+        insertion_points_[placeholder] = first;
     }
-    else
-        pos = 0;
 
-    source.insert(pos, str);
+    insert_at(placeholder, str, true);
+}
 
-    source_.clear();
-    source_.str(source);
+/**
+ * Inserts the contents of a file at a placeholder of the form $NAME$.
+ *
+ * @param point the name of the placeholder, without the '$' signs
+ * @param filename the name of the file to read from
+ */
+void
+ShaderSource::insert_file(const std::string &point, const std::string &filename)
+{
+    std::string source;
+    if (load_file(filename, source))
+        insert(point, source);
 }
 
 /**
@@ -191,28 +364,79 @@ ShaderSource::add_global(const std::string &str)
  *
  * The string is placed after any default precision qualifiers.
  *
+ * @param str the string to add
+ */
+void
+ShaderSource::add_global(const std::string &str)
+{
+    if (insertion_points_.find("") == insertion_points_.end()) {
+        const std::string &source(this->source());
+
+        /* Find the last precision qualifier */
+        std::string::size_type pos = source.rfind("precision");
+
+        if (pos != std::string::npos) {
+            /*
+             * Find the next #endif line of a preprocessor block that contains
+             * the precision qualifier.
+             */
+            std::string::size_type pos_if = source.find("#if", pos);
+            std::string::size_type pos_endif = source.find("#endif", pos);
+
+            if (pos_endif != std::string::npos && pos_endif < pos_if)
+                pos = pos_endif;
+
+            /* Go to the next line */
+            pos = source.find("\n", pos);
+            if (pos != std::string::npos)
+                pos++;
+            else
+                pos = source.size();
+        }
+        else
+            pos = 0;
+
+        insertion_points_[""] = split(pos);
+    }
+
+    insert_at("", str, false);
+}
+
+/**
+ * Adds a string (usually containing a constant definition) at
+ * the start of a function.
+ *
  * @param function the function to add the string into
  * @param str the string to add
  */
 void
 ShaderSource::add_local(const std::string &str, const std::string &function)
 {
-    std::string::size_type pos = 0;
-    std::string source(source_.str());
+    if (insertion_points_.find(function) == insertion_points_.end()) {
+        const std::string &source(this->source());
 
-    /* Find the function */
-    pos = source.find(function);
-    pos = source.find('{', pos);
+        /* Find the function */
+        std::string::size_type pos = source.find(function);
+        if (pos != std::string::npos)
+            pos = source.find('{', pos);
 
-    /* Go to the next line */
-    pos = source.find("\n", pos);
-    if (pos != std::string::npos)
-        pos++;
+        if (pos == std::string::npos) {
+            Log::error("Shader source has no function \"%s\"\n",
+                       function.c_str());
+            return;
+        }
+
+        /* Go to the next line */
+        pos = source.find("\n", pos);
+        if (pos != std::string::npos)
+            pos++;
+        else
+            pos = source.size();
 
-    source.insert(pos, str);
+        insertion_points_[function] = split(pos);
+    }
 
-    source_.clear();
-    source_.str(source);
+    insert_at(function, str, false);
 }
 
 /**
@@ -411,7 +635,7 @@ ShaderSource::type()
 {
     /* Try to infer the type from the source contents */
     if (type_ == ShaderSource::ShaderTypeUnknown) {
-        std::string source(source_.str());
+        const std::string &source(this->source());
 
         if (source.find("gl_FragColor") != std::string::npos)
             type_ = ShaderSource::ShaderTypeFragment;
@@ -501,7 +725,103 @@ ShaderSource::str()
         precision_str.insert(precision_str.size(), "#endif\n");
     }
 
-    return precision_str + source_.str();
+    return precision_str + source();
+}
+
+/**
+ * Gets a header that lets a GLSL ES 1.00 or GLSL 1.10 shader compile as a
+ * later GLSL version, which replaces attribute, varying, texture2D and the
+ * built-in fragment outputs.
+ *
+ * @param type the shader type
+ * @param version the version, as it appears in the #version directive
+ * @param outputs the number of fragment outputs (gl_FragData elements)
+ *
+ * @return the header
+ */
+std::string
+ShaderSource::version_header(ShaderSource::ShaderType type,
+                             const std::string &version, unsigned int outputs)
+{
+    bool es = version.find("es") != std::string::npos;
+    std::stringstream ss;
+
+    ss << "#version " << version << std::endl;
+    if (!es && outputs > 1)
+        ss << "#extension GL_ARB_explicit_attrib_location : enable" << std::endl;
+
+    ss << "#define texture2D texture" << std::endl;
+    ss << "#define textureCube texture" << std::endl;
+
+    if (type == ShaderSource::ShaderTypeVertex) {
+        ss << "#define attribute in" << std::endl;
+        ss << "#define varying out" << std::endl;
+    }
+    else if (outputs > 1) {
+        ss << "#define varying in" << std::endl;
+        ss << "layout(location = 0) out highp vec4 glmark2_FragData[" << outputs << "];" << std::endl;
+        ss << "#define gl_FragData glmark2_FragData" << std::endl;
+    }
+    else {
+        ss << "#define varying in" << std::endl;
+        ss << "out highp vec4 glmark2_FragColor;" << std::endl;
+        ss << "#define gl_FragColor glmark2_FragColor" << std::endl;
+    }
+
+    return ss.str();
+}
+
+/**
+ * Ports a complete shader without a #version directive to a later GLSL
+ * version.
+ *
+ * The shader gets the version_header() for the number of gl_FragData
+ * elements it writes, and its #extension directives are moved right after
+ * the #version directive, before the declarations of the header.  Shaders
+ * that already have a #version directive are returned unchanged.
+ *
+ * @param source the shader source
+ * @param type the shader type
+ * @param version the version, as it appears in the #version directive
+ *
+ * @return the ported shader source
+ */
+std::string
+ShaderSource::to_version(const std::string &source, ShaderSource::ShaderType type,
+                         const std::string &version)
+{
+    if (source.find("#version") != std::string::npos)
+        return source;
+
+    /* The outputs are as many as the highest gl_FragData index plus one */
+    static const std::string frag_data("gl_FragData[");
+    unsigned int outputs = 1;
+    size_t pos = 0;
+
+    while ((pos = source.find(frag_data, pos)) != std::string::npos) {
+        pos += frag_data.size();
+        unsigned int index = Util::fromString<unsigned int>(source.substr(pos, 2));
+        if (index + 1 > outputs)
+            outputs = index + 1;
+    }
+
+    std::stringstream extensions;
+    std::stringstream body;
+    std::istringstream lines(source);
+    std::string line;
+
+    while (std::getline(lines, line)) {
+        if (line.compare(0, 10, "#extension") == 0)
+            extensions << line << std::endl;
+        else
+            body << line << std::endl;
+    }
+
+    std::string header(version_header(type, version, outputs));
+    size_t version_end = header.find('\n') + 1;
+
+    return header.substr(0, version_end) + extensions.str() +
+           header.substr(version_end) + body.str();
 }
 
 /**
@@ -10,14 +10,25 @@
 //     Alexandros Frantzis <alexandros.frantzis@linaro.org>
 //     Jesse Barker <jesse.barker@linaro.org>
 //
+#ifndef SHADER_SOURCE_H_
+#define SHADER_SOURCE_H_
+
 #include <string>
 #include <sstream>
 #include <vector>
+#include <map>
 #include "vec.h"
 #include "mat.h"
 
 /**
  * Helper class for loading and manipulating shader sources.
+ *
+ * The source is kept as a list of segments, so that appending and inserting
+ * text doesn't copy the whole source.  Text is inserted at insertion points,
+ * which are found in the source once and then kept up to date: the global
+ * scope after the precision statements, the start of functions and
+ * placeholders of the form $NAME$.  Files are only read once and then
+ * served from memory.
  */
 class ShaderSource
 {
@@ -29,9 +40,9 @@ public:
     };
 
     ShaderSource(ShaderType type = ShaderTypeUnknown) :
-        precision_has_been_set_(false), type_(type) {}
+        source_valid_(true), precision_has_been_set_(false), type_(type) {}
     ShaderSource(const std::string &filename, ShaderType type = ShaderTypeUnknown) :
-        precision_has_been_set_(false), type_(type) { append_file(filename); }
+        source_valid_(true), precision_has_been_set_(false), type_(type) { append_file(filename); }
 
     void append(const std::string &str);
     void append_file(const std::string &filename);
@@ -39,6 +50,9 @@ public:
     void replace(const std::string &remove, const std::string &insert);
     void replace_with_file(const std::string &remove, const std::string &filename);
 
+    void insert(const std::string &point, const std::string &str);
+    void insert_file(const std::string &point, const std::string &filename);
+
     void add(const std::string &str, const std::string &function = "");
 
     void add_const(const std::string &name, float f,
@@ -87,6 +101,11 @@ public:
                                   ShaderType type = ShaderTypeUnknown);
     static const Precision& default_precision(ShaderType type);
 
+    static std::string version_header(ShaderType type, const std::string &version,
+                                      unsigned int outputs = 1);
+    static std::string to_version(const std::string &source, ShaderType type,
+                                  const std::string &version);
+
 private:
     void add_global(const std::string &str);
     void add_local(const std::string &str, const std::string &function);
@@ -94,10 +113,29 @@ private:
     void emit_precision(std::stringstream& ss, ShaderSource::PrecisionValue val,
                         const std::string& type_str);
 
-    std::stringstream source_;
+    const std::string& source();
+    size_t split(size_t pos);
+    void merge(size_t first, size_t last);
+    void insert_at(const std::string &point, const std::string &str, bool in_order);
+
+    /* The segments of the source, and their concatenation if it is valid */
+    std::vector<std::string> segments_;
+    std::string source_;
+    bool source_valid_;
+
+    /*
+     * The insertion points, as the index of the segment that text is
+     * inserted before.  The global scope uses an empty name, functions
+     * their name and placeholders their $NAME$ form.
+     */
+    std::map<std::string, size_t> insertion_points_;
+
     Precision precision_;
     bool precision_has_been_set_;
     ShaderType type_;
 
     static std::vector<Precision> default_precision_;
+    static std::map<std::string, std::string> file_cache_;
 };
+
+#endif // SHADER_SOURCE_H_
@@ -22,48 +22,69 @@ namespace LibMatrix
 // state.  Default construction puts an identity matrix on the top of the 
 // stack.
 //
+// The first inlineDepth matrices are stored in the object itself, so that
+// stacks created while drawing a frame do not touch the heap; only deeper
+// stacks spill into a vector.
+//
 template<typename T>
 class MatrixStack
 {
 public:
-    MatrixStack()
-    {
-        theStack_.push_back(T());
-    }
-    MatrixStack(const T& matrix)
+    MatrixStack() : depth_(1) {}
+    MatrixStack(const T& matrix) : depth_(1)
     {
-        theStack_.push_back(matrix);
+        inline_[0] = matrix;
     }
     ~MatrixStack() {}
 
-    const T& getCurrent() const { return theStack_.back(); }
+    const T& getCurrent() const { return top(); }
 
     void push()
     {
-        theStack_.push_back(theStack_.back());
+        const T current(top());
+        if (depth_ < inlineDepth)
+            inline_[depth_] = current;
+        else
+            overflow_.push_back(current);
+        depth_++;
     }
     void pop()
     {
-        theStack_.pop_back();
+        if (depth_ > inlineDepth)
+            overflow_.pop_back();
+        depth_--;
     }
     void loadIdentity()
     {
-        theStack_.back().setIdentity();
+        top().setIdentity();
     }
     T& operator*=(const T& rhs)
     {
-        T& curMatrix = theStack_.back();
+        T& curMatrix = top();
         curMatrix *= rhs;
         return curMatrix;
     }
     void print() const
     {
-        const T& curMatrix = theStack_.back();
+        const T& curMatrix = top();
         curMatrix.print();
     }
-    unsigned int getDepth() const { return theStack_.size(); }
+    unsigned int getDepth() const { return depth_; }
 private:
-    std::vector<T> theStack_;
+    static const unsigned int inlineDepth = 8;
+
+    T& top()
+    {
+        return depth_ > inlineDepth ? overflow_.back() : inline_[depth_ - 1];
+    }
+    const T& top() const
+    {
+        return depth_ > inlineDepth ? overflow_.back() : inline_[depth_ - 1];
+    }
+
+    T inline_[inlineDepth];
+    std::vector<T> overflow_;
+    unsigned int depth_;
 };
 
 class Stack4 : public MatrixStack<mat4> 
@@ -44,6 +44,10 @@ main(int argc, char** argv)
     testVec.push_back(new MatrixTest3x3Transpose());
     testVec.push_back(new MatrixTest4x4Transpose());
     testVec.push_back(new ShaderSourceBasic());
+    testVec.push_back(new ShaderSourceAddConstGlobal());
+    testVec.push_back(new ShaderSourceInsertionPoints());
+    testVec.push_back(new ShaderSourceManySteps());
+    testVec.push_back(new ShaderSourceToVersion());
     testVec.push_back(new UtilSplitTestNormal());
     testVec.push_back(new UtilSplitTestQuoted());
 
@@ -9,13 +9,18 @@
 // Contributors:
 //     Jesse Barker - original implementation.
 //
+#include <iostream>
+#include <sstream>
 #include <string>
 #include "libmatrix_test.h"
 #include "shader_source_test.h"
 #include "../shader-source.h"
+#include "../util.h"
 #include "../vec.h"
 
 using std::string;
+using std::cout;
+using std::endl;
 using LibMatrix::vec4;
 
 void
@@ -47,3 +52,112 @@ ShaderSourceAddConstGlobal::run(const Options& options)
     // Compare the output strings to confirm the results.
     pass_ = (src_shader.str() == result_shader.str());
 }
+
+void
+ShaderSourceInsertionPoints::run(const Options& options)
+{
+    ShaderSource source;
+    source.append("precision mediump float;\n"
+                  "void main()\n"
+                  "{\n"
+                  "$MAIN$\n"
+                  "}\n");
+
+    // Placeholder insertions keep their order, added constants don't
+    source.insert("MAIN", "a;\n");
+    source.insert("MAIN", "b;\n");
+    source.add_const("C", 1.0f);
+    source.add_const("D", 2.0f);
+    source.add_const("L", 3.0f, "main");
+
+    // The insertion points survive replacements
+    source.replace("a;", "x;");
+    source.insert("MAIN", "c;\n");
+
+    static const string expected("precision mediump float;\n"
+                                 "const float D = 2.000000;\n"
+                                 "const float C = 1.000000;\n"
+                                 "void main()\n"
+                                 "{\n"
+                                 "const float L = 3.000000;\n"
+                                 "x;\n"
+                                 "b;\n"
+                                 "c;\n"
+                                 "\n"
+                                 "}\n");
+
+    pass_ = (source.str() == expected);
+}
+
+void
+ShaderSourceManySteps::run(const Options& options)
+{
+    static const unsigned int steps = 2000;
+    static const string step("    d = fract(3.0 * d);\n");
+
+    uint64_t start = Util::get_timestamp_us();
+
+    // Build a shader the way the generated shader scenes do
+    ShaderSource source;
+    source.append("precision mediump float;\n"
+                  "void main()\n"
+                  "{\n"
+                  "    float d = 0.5;\n"
+                  "$MAIN$\n"
+                  "    gl_Position = vec4(d);\n"
+                  "}\n");
+
+    for (unsigned int i = 0; i < steps; i++) {
+        source.insert("MAIN", step);
+        source.add_const("K" + Util::toString(i), static_cast<float>(i));
+    }
+
+    string result(source.str());
+
+    uint64_t elapsed = Util::get_timestamp_us() - start;
+
+    if (options.beVerbose()) {
+        cout << "Built a shader with " << steps << " steps and constants ("
+             << result.size() << " bytes) in " << elapsed << " us" << endl;
+    }
+
+    std::stringstream expected;
+    expected << "precision mediump float;\n";
+    for (unsigned int i = steps; i > 0; i--) {
+        expected << "const float K" << i - 1 << " = " << std::fixed
+                 << static_cast<float>(i - 1) << ";" << endl;
+    }
+    expected << "void main()\n{\n    float d = 0.5;\n";
+    for (unsigned int i = 0; i < steps; i++)
+        expected << step;
+    expected << "\n    gl_Position = vec4(d);\n}\n";
+
+    pass_ = (result == expected.str());
+}
+
+void
+ShaderSourceToVersion::run(const Options& options)
+{
+    static const string fragment("#extension GL_EXT_frag_depth : enable\n"
+                                 "varying vec2 TexCoord;\n"
+                                 "void main()\n"
+                                 "{\n"
+                                 "    gl_FragData[0] = vec4(TexCoord, 0.0, 1.0);\n"
+                                 "    gl_FragData[1] = vec4(1.0);\n"
+                                 "}\n");
+
+    string ported(ShaderSource::to_version(fragment, ShaderSource::ShaderTypeFragment, "150"));
+
+    // The extension follows the version, and both outputs are declared
+    static const string expected_start("#version 150\n"
+                                       "#extension GL_EXT_frag_depth : enable\n"
+                                       "#extension GL_ARB_explicit_attrib_location : enable\n");
+
+    // Versioned shaders are left alone
+    static const string versioned("#version 140\nvoid main() {}\n");
+
+    pass_ = ported.compare(0, expected_start.size(), expected_start) == 0 &&
+            ported.find("glmark2_FragData[2]") != string::npos &&
+            ported.find("#define varying in") != string::npos &&
+            ShaderSource::to_version(versioned, ShaderSource::ShaderTypeVertex, "150") == versioned;
+}
@@ -29,4 +29,25 @@ public:
     virtual void run(const Options& options);
 };
 
+class ShaderSourceInsertionPoints : public MatrixTest
+{
+public:
+    ShaderSourceInsertionPoints() : MatrixTest("ShaderSource::InsertionPoints") {}
+    virtual void run(const Options& options);
+};
+
+class ShaderSourceManySteps : public MatrixTest
+{
+public:
+    ShaderSourceManySteps() : MatrixTest("ShaderSource::ManySteps") {}
+    virtual void run(const Options& options);
+};
+
+class ShaderSourceToVersion : public MatrixTest
+{
+public:
+    ShaderSourceToVersion() : MatrixTest("ShaderSource::ToVersion") {}
+    virtual void run(const Options& options);
+};
+
 #endif // SHADER_SOURCE_TEST_H
@@ -0,0 +1,303 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "light-grid.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cmath>
+
+LightGrid::LightGrid() :
+    width_(0), height_(0), tile_size_(1), tiles_x_(0), tiles_y_(0),
+    scale_x_(1.0), scale_y_(1.0), near_(1.0), nlights_(0), entries_(0),
+    job_(JobCount), generation_(0), pending_(0)
+{
+    pthread_mutex_init(&mutex_, 0);
+    pthread_cond_init(&start_, 0);
+    pthread_cond_init(&done_, 0);
+}
+
+LightGrid::~LightGrid()
+{
+    release();
+    pthread_cond_destroy(&done_);
+    pthread_cond_destroy(&start_);
+    pthread_mutex_destroy(&mutex_);
+}
+
+void
+LightGrid::configure(unsigned int width, unsigned int height,
+                     unsigned int tile_size, const LibMatrix::mat4 &projection,
+                     float near, unsigned int threads)
+{
+    release();
+
+    width_ = width;
+    height_ = height;
+    tile_size_ = std::max(tile_size, 1u);
+    tiles_x_ = (width_ + tile_size_ - 1) / tile_size_;
+    tiles_y_ = (height_ + tile_size_ - 1) / tile_size_;
+    scale_x_ = projection[0][0];
+    scale_y_ = projection[1][1];
+    near_ = near;
+
+    counts_.resize(tiles_x_ * tiles_y_);
+    offsets_.resize(tiles_x_ * tiles_y_);
+    tiles_.resize(4 * tiles_x_ * tiles_y_);
+
+    if (tiles_y_ == 0)
+        return;
+
+    threads = std::max(std::min(threads, tiles_y_), 1u);
+
+    bands_.resize(threads);
+    for (unsigned int b = 0; b < threads; b++) {
+        bands_[b].grid = this;
+        bands_[b].first_row = tiles_y_ * b / threads;
+        bands_[b].last_row = tiles_y_ * (b + 1) / threads - 1;
+    }
+
+    /* Bands without a worker are processed by the calling thread */
+    workers_.reserve(threads - 1);
+    for (unsigned int b = 1; b < threads; b++) {
+        pthread_t id;
+        if (pthread_create(&id, 0, worker, &bands_[b]) != 0) {
+            Log::debug("LightGrid: failed to create thread, running inline\n");
+            break;
+        }
+        workers_.push_back(id);
+    }
+}
+
+void
+LightGrid::release()
+{
+    if (!workers_.empty()) {
+        pthread_mutex_lock(&mutex_);
+        job_ = JobQuit;
+        generation_++;
+        pthread_cond_broadcast(&start_);
+        pthread_mutex_unlock(&mutex_);
+
+        for (unsigned int i = 0; i < workers_.size(); i++)
+            pthread_join(workers_[i], 0);
+    }
+
+    /* New workers start waiting for the first generation */
+    workers_.clear();
+    bands_.clear();
+    generation_ = 0;
+    pending_ = 0;
+}
+
+void
+LightGrid::assign(const float *x, const float *y, const float *z,
+                  const float *radius, unsigned int nlights)
+{
+    nlights_ = nlights;
+
+    compute_bounds(x, y, z, radius, nlights);
+
+    /* Count the lights of each tile, then pack the tile lists */
+    run(JobCount);
+
+    entries_ = 0;
+    for (unsigned int t = 0; t < counts_.size(); t++) {
+        unsigned int n = std::min(counts_[t], max_lights_per_tile);
+        offsets_[t] = entries_;
+        tiles_[4 * t] = entries_;
+        tiles_[4 * t + 1] = n;
+        entries_ += n;
+    }
+
+    unsigned int row_size = 4 * texture_width;
+    unsigned int rows = std::max((entries_ + row_size - 1) / row_size, 1u);
+    indices_.resize(rows * row_size);
+
+    run(JobFill);
+}
+
+void
+LightGrid::compute_bounds(const float *x, const float *y, const float *z,
+                          const float *radius, unsigned int nlights)
+{
+    min_x_.resize(nlights);
+    max_x_.resize(nlights);
+    min_y_.resize(nlights);
+    max_y_.resize(nlights);
+
+    /* Scale factors from NDC to tile coordinates */
+    const float tile_scale_x = 0.5 * width_ / tile_size_;
+    const float tile_scale_y = 0.5 * height_ / tile_size_;
+    const float last_x = tiles_x_ - 1.0;
+    const float last_y = tiles_y_ - 1.0;
+    const float near = near_;
+    const float scale_x = scale_x_;
+    const float scale_y = scale_y_;
+
+    /*
+     * A branch-free loop over the separate component arrays, which the
+     * compiler can vectorize.
+     */
+    for (unsigned int i = 0; i < nlights; i++) {
+        float r = radius[i];
+        float depth_far = -z[i] + r;
+        /* Clamping to the near plane keeps the bounds conservative */
+        float depth_near = std::max(-z[i] - r, near);
+        float inv_near = 1.0f / depth_near;
+        float inv_far = 1.0f / depth_far;
+
+        float x0 = std::min((x[i] - r) * inv_near, (x[i] - r) * inv_far) * scale_x;
+        float x1 = std::max((x[i] + r) * inv_near, (x[i] + r) * inv_far) * scale_x;
+        float y0 = std::min((y[i] - r) * inv_near, (y[i] - r) * inv_far) * scale_y;
+        float y1 = std::max((y[i] + r) * inv_near, (y[i] + r) * inv_far) * scale_y;
+
+        x0 = std::max(std::floor((x0 + 1.0f) * tile_scale_x), 0.0f);
+        x1 = std::min(std::floor((x1 + 1.0f) * tile_scale_x), last_x);
+        y0 = std::max(std::floor((y0 + 1.0f) * tile_scale_y), 0.0f);
+        y1 = std::min(std::floor((y1 + 1.0f) * tile_scale_y), last_y);
+
+        /* Lights entirely behind the near plane get an empty range */
+        bool visible = depth_far > near;
+        min_x_[i] = visible ? x0 : 1.0f;
+        max_x_[i] = visible ? x1 : 0.0f;
+        min_y_[i] = y0;
+        max_y_[i] = y1;
+    }
+}
+
+void
+LightGrid::count(unsigned int first_row, unsigned int last_row)
+{
+    std::fill(counts_.begin() + first_row * tiles_x_,
+              counts_.begin() + (last_row + 1) * tiles_x_, 0);
+
+    for (unsigned int i = 0; i < nlights_; i++) {
+        if (min_x_[i] > max_x_[i])
+            continue;
+
+        int y0 = std::max(static_cast<int>(min_y_[i]), static_cast<int>(first_row));
+        int y1 = std::min(static_cast<int>(max_y_[i]), static_cast<int>(last_row));
+        int x0 = min_x_[i];
+        int x1 = max_x_[i];
+
+        for (int ty = y0; ty <= y1; ty++) {
+            unsigned int *row = &counts_[ty * tiles_x_];
+            for (int tx = x0; tx <= x1; tx++)
+                row[tx]++;
+        }
+    }
+}
+
+void
+LightGrid::fill(unsigned int first_row, unsigned int last_row)
+{
+    /* The counts are reused as the fill position of each tile */
+    std::fill(counts_.begin() + first_row * tiles_x_,
+              counts_.begin() + (last_row + 1) * tiles_x_, 0);
+
+    for (unsigned int i = 0; i < nlights_; i++) {
+        if (min_x_[i] > max_x_[i])
+            continue;
+
+        int y0 = std::max(static_cast<int>(min_y_[i]), static_cast<int>(first_row));
+        int y1 = std::min(static_cast<int>(max_y_[i]), static_cast<int>(last_row));
+        int x0 = min_x_[i];
+        int x1 = max_x_[i];
+
+        for (int ty = y0; ty <= y1; ty++) {
+            for (int tx = x0; tx <= x1; tx++) {
+                unsigned int t = ty * tiles_x_ + tx;
+                if (counts_[t] < max_lights_per_tile)
+                    indices_[offsets_[t] + counts_[t]++] = i;
+            }
+        }
+    }
+}
+
+void
+LightGrid::work(Job job, const Band &band)
+{
+    if (job == JobCount)
+        count(band.first_row, band.last_row);
+    else if (job == JobFill)
+        fill(band.first_row, band.last_row);
+}
+
+void *
+LightGrid::worker(void *data)
+{
+    Band *band = static_cast<Band *>(data);
+    LightGrid &grid(*band->grid);
+    unsigned int seen = 0;
+
+    pthread_mutex_lock(&grid.mutex_);
+
+    while (true) {
+        while (grid.generation_ == seen)
+            pthread_cond_wait(&grid.start_, &grid.mutex_);
+
+        seen = grid.generation_;
+        Job job = grid.job_;
+        if (job == JobQuit)
+            break;
+
+        pthread_mutex_unlock(&grid.mutex_);
+        grid.work(job, *band);
+        pthread_mutex_lock(&grid.mutex_);
+
+        if (--grid.pending_ == 0)
+            pthread_cond_signal(&grid.done_);
+    }
+
+    pthread_mutex_unlock(&grid.mutex_);
+
+    return 0;
+}
+
+/**
+ * Runs a job over the bands of tile rows, waking the workers for their
+ * bands.  The calling thread processes the first band, and any bands
+ * whose worker couldn't be created, itself.
+ */
+void
+LightGrid::run(Job job)
+{
+    if (bands_.empty())
+        return;
+
+    if (!workers_.empty()) {
+        pthread_mutex_lock(&mutex_);
+        job_ = job;
+        pending_ = workers_.size();
+        generation_++;
+        pthread_cond_broadcast(&start_);
+        pthread_mutex_unlock(&mutex_);
+    }
+
+    work(job, bands_[0]);
+    for (unsigned int b = workers_.size() + 1; b < bands_.size(); b++)
+        work(job, bands_[b]);
+
+    if (!workers_.empty()) {
+        pthread_mutex_lock(&mutex_);
+        while (pending_ > 0)
+            pthread_cond_wait(&done_, &mutex_);
+        pthread_mutex_unlock(&mutex_);
+    }
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_LIGHT_GRID_H_
+#define GLMARK2_LIGHT_GRID_H_
+
+#include "mat.h"
+
+#include <vector>
+#include <pthread.h>
+
+/**
+ * Assigns point lights to the screen tiles they may affect (forward+ light
+ * culling).
+ *
+ * The lights are spheres in view space.  The light lists of all the tiles
+ * are packed in a single index array, and each tile stores the offset and
+ * the number of its entries, so that both can be uploaded as textures and
+ * a fragment shader only has to loop over the lights of its own tile.
+ */
+class LightGrid
+{
+public:
+    /* The width (in RGBA texels) of the light and index textures */
+    static const unsigned int texture_width = 1024;
+    /* Tiles with more lights than this drop the excess lights */
+    static const unsigned int max_lights_per_tile = 256;
+
+    LightGrid();
+    ~LightGrid();
+
+    /**
+     * Sets the geometry of the grid, and starts the worker threads.
+     *
+     * The workers persist until ::release(), so that ::assign() neither
+     * creates threads nor allocates the per-thread work.
+     *
+     * @param width the width of the framebuffer in pixels
+     * @param height the height of the framebuffer in pixels
+     * @param tile_size the size of each (square) tile in pixels
+     * @param projection the (symmetric) perspective projection matrix
+     * @param near the distance of the near plane
+     * @param threads the number of threads to use, including the caller
+     */
+    void configure(unsigned int width, unsigned int height,
+                   unsigned int tile_size, const LibMatrix::mat4 &projection,
+                   float near, unsigned int threads);
+
+    /**
+     * Stops the worker threads.
+     */
+    void release();
+
+    /**
+     * Assigns lights to the tiles.
+     *
+     * The light data is passed as separate arrays per component, so that
+     * the per-light bounds calculation can be vectorized by the compiler.
+     *
+     * @param x the view space x coordinates of the lights
+     * @param y the view space y coordinates of the lights
+     * @param z the view space z coordinates of the lights
+     * @param radius the radii of influence of the lights
+     * @param nlights the number of lights
+     */
+    void assign(const float *x, const float *y, const float *z,
+                const float *radius, unsigned int nlights);
+
+    unsigned int tiles_x() const { return tiles_x_; }
+    unsigned int tiles_y() const { return tiles_y_; }
+
+    /**
+     * Gets the tile data, an RGBA texel per tile holding the offset of the
+     * tile's first entry in the index array and the number of its entries.
+     */
+    const std::vector<float> &tiles() const { return tiles_; }
+
+    /**
+     * Gets the index array, four light indices per RGBA texel, padded to
+     * whole rows of ::texture_width texels.
+     */
+    const std::vector<float> &indices() const { return indices_; }
+
+    /**
+     * Gets the number of rows of the index array.
+     */
+    unsigned int index_rows() const
+    {
+        return indices_.size() / (4 * texture_width);
+    }
+
+    /**
+     * Gets the total number of light entries in all the tiles.
+     */
+    unsigned int entries() const { return entries_; }
+
+private:
+    /* The work done by the threads over each band of tile rows */
+    enum Job {
+        JobCount,
+        JobFill,
+        JobQuit
+    };
+
+    /* A range of tile rows processed by a single thread */
+    struct Band {
+        LightGrid *grid;
+        unsigned int first_row;
+        unsigned int last_row;
+    };
+
+    void compute_bounds(const float *x, const float *y, const float *z,
+                        const float *radius, unsigned int nlights);
+    void count(unsigned int first_row, unsigned int last_row);
+    void fill(unsigned int first_row, unsigned int last_row);
+    void work(Job job, const Band &band);
+    static void *worker(void *data);
+    void run(Job job);
+
+    unsigned int width_;
+    unsigned int height_;
+    unsigned int tile_size_;
+    unsigned int tiles_x_;
+    unsigned int tiles_y_;
+    float scale_x_;
+    float scale_y_;
+    float near_;
+    unsigned int nlights_;
+    unsigned int entries_;
+
+    /* The tile bounds of each light, empty if min > max */
+    std::vector<float> min_x_;
+    std::vector<float> max_x_;
+    std::vector<float> min_y_;
+    std::vector<float> max_y_;
+
+    std::vector<unsigned int> counts_;
+    std::vector<unsigned int> offsets_;
+    std::vector<float> tiles_;
+    std::vector<float> indices_;
+
+    /*
+     * The bands, the first one processed by the calling thread and each
+     * of the others by a worker.  The workers wait for the generation to
+     * change and then do the current job; pending_ counts the workers
+     * still busy with it.
+     */
+    std::vector<Band> bands_;
+    std::vector<pthread_t> workers_;
+    pthread_mutex_t mutex_;
+    pthread_cond_t start_;
+    pthread_cond_t done_;
+    Job job_;
+    unsigned int generation_;
+    unsigned int pending_;
+};
+
+#endif
@@ -23,14 +23,39 @@
 #include "main-loop.h"
 #include "util.h"
 #include "log.h"
+#include "gl-memory.h"
+#include "gl-headers.h"
+#include "alloc-counter.h"
+#include "scratch-arena.h"
 
 #include <string>
 #include <sstream>
+#include <iomanip>
 
 /************
  * MainLoop *
  ************/
 
+/*
+ * The frames at the start of each scene that are not counted, since they
+ * fill caches and grow buffers to their steady-state sizes.
+ */
+static const unsigned int alloc_warmup_frames = 10;
+
+unsigned int MainLoop::allocating_scenes_ = 0;
+
+static std::string
+pacing_string(const FramePacing &pacing)
+{
+    std::stringstream ss;
+
+    ss.precision(2);
+    ss << std::fixed << pacing.mean_ms() << "/" << pacing.stddev_ms()
+       << "/" << pacing.max_ms();
+
+    return ss.str();
+}
+
 MainLoop::MainLoop(Canvas &canvas, const std::vector<Benchmark *> &benchmarks) :
     canvas_(canvas), benchmarks_(benchmarks)
 {
@@ -45,6 +70,10 @@ MainLoop::reset()
     scene_setup_status_ = SceneSetupStatusUnknown;
     score_ = 0;
     benchmarks_run_ = 0;
+    recorded_ = false;
+    scene_frames_ = 0;
+    alloc_frames_ = 0;
+    surface_ = 0;
     bench_iter_ = benchmarks_.begin();
 }
 
@@ -80,9 +109,28 @@ MainLoop::step()
 
         /* If we have found a valid scene, set it up */
         if (bench_iter_ != benchmarks_.end()) {
-            if (!Options::reuse_context)
-                canvas_.reset();
+            /*
+             * Release resources of the previous scene before the canvas is
+             * reset, so that they are freed in the context they belong to.
+             */
             before_scene_setup();
+            if (!Options::reuse_context) {
+                GLMemory::clear();
+                canvas_.reset();
+            }
+            GLMemory::reset_peak();
+            AllocCounter::reset();
+            scene_frames_ = 0;
+            alloc_frames_ = 0;
+            surface_pacing_.assign(canvas_.surfaces(), FramePacing());
+            frame_pacing_.reset();
+            /* Record the GL command stream of the first benchmark */
+            if (!Options::record_file.empty() && !recorded_) {
+                GLCapture::start(Options::record_file, Options::record_frames,
+                                 canvas_.fbo(), canvas_.width(),
+                                 canvas_.height());
+                recorded_ = true;
+            }
             scene_ = &(*bench_iter_)->setup_scene();
             if (!scene_->running()) {
                 if (!scene_->supported(false))
@@ -94,6 +142,7 @@ MainLoop::step()
                 scene_setup_status_ = SceneSetupStatusSuccess;
             }
             after_scene_setup();
+            GLCapture::end_setup();
             log_scene_info();
         }
         else {
@@ -104,8 +153,27 @@ MainLoop::step()
 
     bool should_quit = canvas_.should_quit();
 
-    if (scene_ ->running() && !should_quit)
-        draw();
+    if (scene_ ->running() && !should_quit) {
+        unsigned int surfaces = canvas_.surfaces();
+
+        ScratchArena::reset();
+
+        /* Draw and present each surface in turn, updating the scene once */
+        for (surface_ = 0; surface_ < surfaces && scene_->running(); surface_++) {
+            canvas_.select_surface(surface_);
+            draw();
+            if (surfaces > 1)
+                surface_pacing_[surface_].add(Util::get_timestamp_us());
+        }
+
+        if (surfaces > 1) {
+            frame_pacing_.add(Util::get_timestamp_us());
+            canvas_.select_surface(0);
+            surface_ = 0;
+        }
+
+        GLCapture::end_frame();
+    }
 
     /*
      * Need to recheck whether the scene is still running, because code
@@ -116,7 +184,10 @@ MainLoop::step()
             score_ += scene_->average_fps();
             benchmarks_run_++;
         }
+        GLCapture::stop();
         log_scene_result();
+        if (scene_setup_status_ == SceneSetupStatusSuccess)
+            check_allocs();
         (*bench_iter_)->teardown_scene();
         scene_ = 0;
         next_benchmark();
@@ -130,8 +201,7 @@ MainLoop::draw()
 {
     canvas_.clear();
 
-    scene_->draw();
-    scene_->update();
+    draw_scene();
 
     canvas_.update();
 }
@@ -147,7 +217,7 @@ void
 MainLoop::log_scene_result()
 {
     static const std::string format_fps(Log::continuation_prefix +
-                                        " FPS: %u FrameTime: %.3f ms\n");
+                                        " FPS: %u FrameTime: %.3f ms%s\n");
     static const std::string format_unsupported(Log::continuation_prefix +
                                                 " Unsupported\n");
     static const std::string format_fail(Log::continuation_prefix +
@@ -155,7 +225,8 @@ MainLoop::log_scene_result()
 
     if (scene_setup_status_ == SceneSetupStatusSuccess) {
         Log::info(format_fps.c_str(), scene_->average_fps(),
-                                      1000.0 / scene_->average_fps());
+                                      1000.0 / scene_->average_fps(),
+                                      scene_result_extras().c_str());
     }
     else if (scene_setup_status_ == SceneSetupStatusUnsupported) {
         Log::info(format_unsupported.c_str());
@@ -165,6 +236,80 @@ MainLoop::log_scene_result()
     }
 }
 
+std::string
+MainLoop::scene_result_extras()
+{
+    static const double MiB = 1024.0 * 1024.0;
+    std::stringstream ss;
+    long long driver_bytes;
+
+    ss.precision(2);
+    ss << std::fixed << " Memory: " << GLMemory::peak_bytes() / MiB << " MiB";
+
+    if (GLMemory::driver_used_bytes(driver_bytes))
+        ss << " (driver: " << driver_bytes / MiB << " MiB)";
+
+    ss << scene_->result_extras();
+
+    if (surface_pacing_.size() > 1) {
+        ss << " Pacing (mean/stddev/max ms):";
+        for (size_t i = 0; i < surface_pacing_.size(); i++)
+            ss << " " << i << ": " << pacing_string(surface_pacing_[i]);
+        ss << " frame: " << pacing_string(frame_pacing_);
+    }
+
+    if (Options::alloc_stats && alloc_frames_ > 0) {
+        ss << " Allocs/frame: "
+           << static_cast<double>(AllocCounter::count()) / alloc_frames_;
+    }
+
+    return ss.str();
+}
+
+/**
+ * Draws the scene to the current surface, updating it after the last
+ * surface of the frame, and counts the heap allocations after the warm-up
+ * frames.
+ */
+void
+MainLoop::draw_scene()
+{
+    bool last_surface = surface_ + 1 >= canvas_.surfaces();
+    bool count = Options::alloc_stats && scene_frames_ >= alloc_warmup_frames;
+
+    scene_->lint_options(true);
+    if (count)
+        AllocCounter::start();
+
+    scene_->draw();
+    if (last_surface)
+        scene_->update();
+
+    if (count) {
+        AllocCounter::stop();
+        if (last_surface)
+            alloc_frames_++;
+    }
+    scene_->lint_options(false);
+
+    if (last_surface)
+        scene_frames_++;
+}
+
+/**
+ * Fails the scene with --zero-alloc if its steady-state frames allocated.
+ */
+void
+MainLoop::check_allocs()
+{
+    if (!Options::zero_alloc || AllocCounter::count() == 0)
+        return;
+
+    Log::error("%s: %llu heap allocations in %u steady-state frames\n",
+               scene_->name().c_str(), AllocCounter::count(), alloc_frames_);
+    allocating_scenes_++;
+}
+
 void
 MainLoop::next_benchmark()
 {
@@ -179,7 +324,9 @@ MainLoop::next_benchmark()
 
 MainLoopDecoration::MainLoopDecoration(Canvas &canvas, const std::vector<Benchmark *> &benchmarks) :
     MainLoop(canvas, benchmarks), show_fps_(false), show_title_(false),
-    fps_renderer_(0), title_renderer_(0), last_fps_(0)
+    show_hud_(false), fps_renderer_(0), title_renderer_(0), hud_renderer_(0),
+    last_fps_(0), frame_timestamp_(0), last_hud_us_(0), hud_us_total_(0),
+    frame_us_total_(0), hud_frames_(0)
 {
 
 }
@@ -190,6 +337,8 @@ MainLoopDecoration::~MainLoopDecoration()
     fps_renderer_ = 0;
     delete title_renderer_;
     title_renderer_ = 0;
+    delete hud_renderer_;
+    hud_renderer_ = 0;
 }
 
 void
@@ -197,10 +346,20 @@ MainLoopDecoration::draw()
 {
     static const unsigned int fps_interval = 500000;
 
+    uint64_t frame_start = Util::get_timestamp_us();
+
     canvas_.clear();
 
-    scene_->draw();
-    scene_->update();
+    /* The HUD measures the frame through the first surface */
+    bool first_surface = surface_ == 0;
+
+    if (show_hud_ && first_surface)
+        gpu_timer_.begin();
+
+    draw_scene();
+
+    if (show_hud_ && first_surface)
+        gpu_timer_.end();
 
     if (show_fps_) {
         uint64_t now = Util::get_timestamp_us();
@@ -215,6 +374,34 @@ MainLoopDecoration::draw()
     if (show_title_)
         title_renderer_->render();
 
+    if (show_hud_ && !first_surface) {
+        hud_renderer_->render();
+    }
+    else if (show_hud_) {
+        uint64_t hud_start = Util::get_timestamp_us();
+
+        /*
+         * The frame time is measured from the start of the previous frame,
+         * so that it includes the time spent in canvas_.update().
+         */
+        if (frame_timestamp_ != 0) {
+            uint64_t frame_us = frame_start - frame_timestamp_;
+            hud_frames_++;
+            hud_renderer_->add_frame(frame_us / 1000.0,
+                                     (hud_start - frame_start) / 1000.0,
+                                     gpu_timer_.elapsed_ms(),
+                                     last_hud_us_ / 1000.0);
+            frame_us_total_ += frame_us;
+        }
+        hud_renderer_->render();
+
+        last_hud_us_ = Util::get_timestamp_us() - hud_start;
+        hud_us_total_ += last_hud_us_;
+    }
+
+    if (first_surface)
+        frame_timestamp_ = frame_start;
+
     canvas_.update();
 }
 
@@ -225,6 +412,9 @@ MainLoopDecoration::before_scene_setup()
     fps_renderer_ = 0;
     delete title_renderer_;
     title_renderer_ = 0;
+    delete hud_renderer_;
+    hud_renderer_ = 0;
+    gpu_timer_.release();
 }
 
 void
@@ -232,8 +422,10 @@ MainLoopDecoration::after_scene_setup()
 {
     const Scene::Option &show_fps_option(scene_->options().find("show-fps")->second);
     const Scene::Option &title_option(scene_->options().find("title")->second);
+    const Scene::Option &show_hud_option(scene_->options().find("show-hud")->second);
     show_fps_ = show_fps_option.value == "true";
     show_title_ = !title_option.value.empty();
+    show_hud_ = show_hud_option.value == "true";
 
     if (show_fps_) {
         const Scene::Option &fps_pos_option(scene_->options().find("fps-pos")->second);
@@ -261,6 +453,36 @@ MainLoopDecoration::after_scene_setup()
         else
             title_renderer_->text(title_option.value);
     }
+
+    if (show_hud_) {
+        const Scene::Option &hud_pos_option(scene_->options().find("hud-pos")->second);
+        const Scene::Option &hud_size_option(scene_->options().find("hud-size")->second);
+        hud_renderer_ = new HudRenderer(canvas_);
+        hud_renderer_->position(vec2_from_pos_string(hud_pos_option.value));
+        hud_renderer_->size(vec2_from_pos_string(hud_size_option.value));
+        gpu_timer_.init();
+        frame_timestamp_ = 0;
+        last_hud_us_ = 0;
+        hud_us_total_ = 0;
+        frame_us_total_ = 0;
+        hud_frames_ = 0;
+    }
+}
+
+std::string
+MainLoopDecoration::scene_result_extras()
+{
+    if (!show_hud_ || hud_frames_ == 0 || frame_us_total_ == 0)
+        return MainLoop::scene_result_extras();
+
+    /* Report the HUD cost so that its impact on the result is known */
+    std::stringstream ss;
+    ss.precision(3);
+    ss << MainLoop::scene_result_extras();
+    ss << std::fixed << " HUD: " << hud_us_total_ / 1000.0 / hud_frames_ << " ms ("
+       << std::setprecision(2) << 100.0 * hud_us_total_ / frame_us_total_
+       << "%)";
+    return ss.str();
 }
 
 void
@@ -302,7 +524,9 @@ MainLoopValidation::draw()
     /* Draw only the first frame of the scene and stop */
     canvas_.clear();
 
+    scene_->lint_options(true);
     scene_->draw();
+    scene_->lint_options(false);
 
     canvas_.update();
 
@@ -25,7 +25,10 @@
 #include "canvas.h"
 #include "benchmark.h"
 #include "text-renderer.h"
+#include "hud-renderer.h"
+#include "gpu-timer.h"
 #include "vec.h"
+#include "frame-pacing.h"
 #include <vector>
 
 /**
@@ -83,6 +86,19 @@ public:
      */
     virtual void log_scene_result();
 
+    /**
+     * Overridable method for extra information to append to the scene result.
+     *
+     * By default this is the GL memory used by the scene.
+     */
+    virtual std::string scene_result_extras();
+
+    /**
+     * Gets the number of scenes that allocated heap memory in steady-state
+     * frames, with --zero-alloc.
+     */
+    static unsigned int allocating_scenes() { return allocating_scenes_; }
+
 protected:
     enum SceneSetupStatus {
         SceneSetupStatusUnknown,
@@ -91,12 +107,23 @@ protected:
         SceneSetupStatusUnsupported
     };
     void next_benchmark();
+    void draw_scene();
+    void check_allocs();
     Canvas &canvas_;
     Scene *scene_;
     const std::vector<Benchmark *> &benchmarks_;
     unsigned int score_;
     unsigned int benchmarks_run_;
     SceneSetupStatus scene_setup_status_;
+    bool recorded_;
+    /* The frames of the current scene, and those with counted allocations */
+    unsigned int scene_frames_;
+    unsigned int alloc_frames_;
+    static unsigned int allocating_scenes_;
+    /* The surface being drawn, and the pacing of each surface and frame */
+    unsigned int surface_;
+    std::vector<FramePacing> surface_pacing_;
+    FramePacing frame_pacing_;
 
     std::vector<Benchmark *>::const_iterator bench_iter_;
 };
@@ -113,6 +140,7 @@ public:
     virtual void draw();
     virtual void before_scene_setup();
     virtual void after_scene_setup();
+    virtual std::string scene_result_extras();
 
 protected:
     void fps_renderer_update_text(unsigned int fps);
@@ -120,10 +148,18 @@ protected:
 
     bool show_fps_;
     bool show_title_;
+    bool show_hud_;
     TextRenderer *fps_renderer_;
     TextRenderer *title_renderer_;
+    HudRenderer *hud_renderer_;
+    GPUTimer gpu_timer_;
     unsigned int last_fps_;
     uint64_t fps_timestamp_;
+    uint64_t frame_timestamp_;
+    uint64_t last_hud_us_;
+    uint64_t hud_us_total_;
+    uint64_t frame_us_total_;
+    unsigned int hud_frames_;
 };
 
 /**
@@ -31,6 +31,9 @@
 #include "main-loop.h"
 #include "benchmark-collection.h"
 #include "scene-collection.h"
+#include "gl-replay.h"
+#include "benchmark-planner.h"
+#include "alloc-counter.h"
 
 #include "canvas-generic.h"
 
@@ -125,6 +128,43 @@ do_benchmark(Canvas &canvas)
     delete loop;
 }
 
+void
+do_planned_benchmark(Canvas &canvas)
+{
+    BenchmarkCollection benchmark_collection;
+
+    benchmark_collection.populate_from_options();
+
+    BenchmarkPlanner planner(canvas, benchmark_collection.benchmarks());
+
+    planner.run(Options::time_budget);
+
+    Log::info("=======================================================\n");
+    Log::info("                                  glmark2 Score: %u \n", planner.score());
+    Log::info("=======================================================\n");
+}
+
+void
+do_replay(Canvas &canvas)
+{
+    static const double duration = 10.0;
+    GLReplay replay(canvas);
+
+    if (!replay.load(Options::replay_file))
+        return;
+
+    Log::info("[replay] %s", Options::replay_file.c_str());
+    Log::flush();
+
+    unsigned int fps = replay.run(duration);
+    if (!fps) {
+        Log::info(" Failed\n");
+        return;
+    }
+
+    Log::info(" FPS: %u FrameTime: %.3f ms\n", fps, 1000.0 / fps);
+}
+
 void
 do_validation(Canvas &canvas)
 {
@@ -161,6 +201,15 @@ main(int argc, char *argv[])
         Options::size = std::pair<int,int>(800, 600);
     }
 
+    if (Options::alloc_stats && !AllocCounter::available()) {
+        if (Options::zero_alloc) {
+            Log::error("Allocation counting is not available in this build\n");
+            return 1;
+        }
+        Log::info("Allocation counting is not available in this build, ignoring --alloc-stats\n");
+        Options::alloc_stats = false;
+    }
+
     // Create the canvas
 #if GLMARK2_USE_X11
     NativeStateX11 native_state;
@@ -184,6 +233,8 @@ main(int argc, char *argv[])
 
     canvas.offscreen(Options::offscreen);
 
+    canvas.surfaces(Options::surfaces);
+
     canvas.visual_config(Options::visual_config);
 
     // Register the scenes, so they can be looked up by name
@@ -208,10 +259,20 @@ main(int argc, char *argv[])
 
     canvas.visible(true);
 
-    if (Options::validate)
+    if (!Options::replay_file.empty())
+        do_replay(canvas);
+    else if (Options::validate)
         do_validation(canvas);
+    else if (Options::time_budget > 0.0)
+        do_planned_benchmark(canvas);
     else
         do_benchmark(canvas);
 
+    if (Options::zero_alloc && MainLoop::allocating_scenes() > 0) {
+        Log::error("%u benchmarks allocated heap memory while drawing\n",
+                   MainLoop::allocating_scenes());
+        return 1;
+    }
+
     return 0;
 }
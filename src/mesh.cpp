@@ -24,6 +24,7 @@
 #include "mesh.h"
 #include "log.h"
 #include "gl-headers.h"
+#include "gl-memory.h"
 
 
 Mesh::Mesh() :
@@ -344,8 +345,8 @@ Mesh::build_vbo()
 
             glGenBuffers(1, &vbo);
             glBindBuffer(GL_ARRAY_BUFFER, vbo);
-            glBufferData(GL_ARRAY_BUFFER, nvertices * ai->first * sizeof(float),
-                         data, buffer_usage);
+            GLMemory::buffer_data(GL_ARRAY_BUFFER, nvertices * ai->first * sizeof(float),
+                                  data, buffer_usage);
 
             vbos_.push_back(vbo);
             attrib_data_ptr_.push_back(0);
@@ -359,8 +360,8 @@ Mesh::build_vbo()
         glGenBuffers(1, &vbo);
         glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-        glBufferData(GL_ARRAY_BUFFER, nvertices * vertex_size_ * sizeof(float),
-                     vertex_arrays_[0], GL_STATIC_DRAW);
+        GLMemory::buffer_data(GL_ARRAY_BUFFER, nvertices * vertex_size_ * sizeof(float),
+                              vertex_arrays_[0], GL_STATIC_DRAW);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
 
@@ -527,7 +528,7 @@ Mesh::delete_vbo()
 {
     for (size_t i = 0; i < vbos_.size(); i++) {
         GLuint vbo = vbos_[i];
-        glDeleteBuffers(1, &vbo);
+        GLMemory::delete_buffers(1, &vbo);
     }
 
     vbos_.clear();
@@ -23,6 +23,8 @@
 #include "native-state-x11.h"
 #include "log.h"
 
+#include <sstream>
+
 #include <X11/Xutil.h>
 #include <X11/keysym.h>
 #include <X11/Xatom.h>
@@ -35,6 +37,8 @@ NativeStateX11::~NativeStateX11()
 {
     if (xdpy_)
     {
+        destroy_extra_windows();
+
         if (xwin_)
             XDestroyWindow(xdpy_, xwin_);
 
@@ -45,8 +49,11 @@ NativeStateX11::~NativeStateX11()
 bool
 NativeStateX11::init_display()
 {
-    if (!xdpy_)
+    if (!xdpy_) {
+        /* Scenes may make shared contexts current from other threads */
+        XInitThreads();
         xdpy_ = XOpenDisplay(NULL);
+    }
 
     return (xdpy_ != 0);
 }
@@ -100,6 +107,93 @@ NativeStateX11::create_window(WindowProperties const& properties)
         properties_.height = properties.height;
     }
 
+    xwin_ = create_xwindow(win_name);
+
+    return xwin_ != 0;
+}
+
+void*
+NativeStateX11::window(WindowProperties& properties)
+{
+    properties = properties_;
+    return (void*)xwin_;
+}
+
+void
+NativeStateX11::visible(bool visible)
+{
+    if (visible) {
+        XMapWindow(xdpy_, xwin_);
+        for (size_t i = 0; i < extra_wins_.size(); i++)
+            XMapWindow(xdpy_, extra_wins_[i]);
+    }
+}
+
+bool
+NativeStateX11::should_quit()
+{
+    XEvent event;
+
+    if (!XPending(xdpy_))
+        return false;
+
+    XNextEvent(xdpy_, &event);
+
+    if (event.type == KeyPress) {
+        if (XLookupKeysym(&event.xkey, 0) == XK_Escape)
+            return true;
+    }
+    else if (event.type == ClientMessage) {
+        /* Window Delete event from window manager */
+        return true;
+    }
+
+    return false;
+}
+
+bool
+NativeStateX11::create_extra_windows(unsigned int count)
+{
+    destroy_extra_windows();
+
+    if (count > 0 && !xwin_) {
+        Log::error("Error: The main X window has not been created!\n");
+        return false;
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        std::stringstream name;
+        name << "glmark2 " GLMARK_VERSION " (surface " << i + 1 << ")";
+
+        Window win = create_xwindow(name.str().c_str());
+        if (!win)
+            return false;
+
+        extra_wins_.push_back(win);
+    }
+
+    return true;
+}
+
+void*
+NativeStateX11::extra_window(unsigned int index)
+{
+    if (index >= extra_wins_.size())
+        return 0;
+
+    return (void*)extra_wins_[index];
+}
+
+/*******************
+ * Private methods *
+ *******************/
+
+/**
+ * Creates an X window with the current properties.
+ */
+Window
+NativeStateX11::create_xwindow(const char *name)
+{
     XVisualInfo vis_tmpl;
     XVisualInfo *vis_info = 0;
     int num_visuals;
@@ -110,7 +204,7 @@ NativeStateX11::create_window(WindowProperties const& properties)
                              &num_visuals);
     if (!vis_info) {
         Log::error("Error: Could not get a valid XVisualInfo!\n");
-        return false;
+        return 0;
     }
 
     Log::debug("Creating XWindow W: %d H: %d VisualID: 0x%x\n",
@@ -127,15 +221,15 @@ NativeStateX11::create_window(WindowProperties const& properties)
     attr.event_mask = KeyPressMask;
     mask = CWBackPixel | CWBorderPixel | CWColormap | CWEventMask;
 
-    xwin_ = XCreateWindow(xdpy_, root, 0, 0, properties_.width, properties_.height,
-                          0, vis_info->depth, InputOutput,
-                          vis_info->visual, mask, &attr);
+    Window xwin = XCreateWindow(xdpy_, root, 0, 0, properties_.width, properties_.height,
+                                0, vis_info->depth, InputOutput,
+                                vis_info->visual, mask, &attr);
 
     XFree(vis_info);
 
-    if (!xwin_) {
+    if (!xwin) {
         Log::error("Error: XCreateWindow() failed!\n");
-        return false;
+        return 0;
     }
 
     /* set hints and properties */
@@ -146,7 +240,7 @@ NativeStateX11::create_window(WindowProperties const& properties)
             Log::debug("Warning: Could not set EWMH Fullscreen hint.\n");
     }
     if (fs_atom != None) {
-        XChangeProperty(xdpy_, xwin_,
+        XChangeProperty(xdpy_, xwin,
                         XInternAtom(xdpy_, "_NET_WM_STATE", True),
                         XA_ATOM, 32, PropModeReplace,
                         reinterpret_cast<unsigned char*>(&fs_atom),  1);
@@ -159,52 +253,25 @@ NativeStateX11::create_window(WindowProperties const& properties)
         sizehints.max_height = properties_.height;
         sizehints.flags = PMaxSize | PMinSize;
 
-        XSetWMProperties(xdpy_, xwin_, NULL, NULL,
+        XSetWMProperties(xdpy_, xwin, NULL, NULL,
                          NULL, 0, &sizehints, NULL, NULL);
     }
 
     /* Set the window name */
-    XStoreName(xdpy_ , xwin_,  win_name);
+    XStoreName(xdpy_ , xwin,  name);
 
     /* Gracefully handle Window Delete event from window manager */
     Atom wmDelete = XInternAtom(xdpy_, "WM_DELETE_WINDOW", True);
-    XSetWMProtocols(xdpy_, xwin_, &wmDelete, 1);
-
-    return true;
-}
+    XSetWMProtocols(xdpy_, xwin, &wmDelete, 1);
 
-void*
-NativeStateX11::window(WindowProperties& properties)
-{
-    properties = properties_;
-    return (void*)xwin_;
+    return xwin;
 }
 
 void
-NativeStateX11::visible(bool visible)
-{
-    if (visible)
-        XMapWindow(xdpy_, xwin_);
-}
-
-bool
-NativeStateX11::should_quit()
+NativeStateX11::destroy_extra_windows()
 {
-    XEvent event;
-
-    if (!XPending(xdpy_))
-        return false;
+    for (size_t i = 0; i < extra_wins_.size(); i++)
+        XDestroyWindow(xdpy_, extra_wins_[i]);
 
-    XNextEvent(xdpy_, &event);
-
-    if (event.type == KeyPress) {
-        if (XLookupKeysym(&event.xkey, 0) == XK_Escape)
-            return true;
-    }
-    else if (event.type == ClientMessage) {
-        /* Window Delete event from window manager */
-        return true;
-    }
-
-    return false;
+    extra_wins_.clear();
 }
@@ -25,6 +25,7 @@
 
 #include "native-state.h"
 #include <X11/Xlib.h>
+#include <vector>
 
 class NativeStateX11 : public NativeState
 {
@@ -39,12 +40,19 @@ public:
     void visible(bool v);
     bool should_quit();
     void flip() { }
+    bool create_extra_windows(unsigned int count);
+    void* extra_window(unsigned int index);
 
 private:
+    Window create_xwindow(const char *name);
+    void destroy_extra_windows();
+
     /** The X display associated with this canvas. */
     Display* xdpy_;
     /** The X window associated with this canvas. */
     Window xwin_;
+    /** The additional windows, for presenting to several surfaces. */
+    std::vector<Window> extra_wins_;
     WindowProperties properties_;
 };
 
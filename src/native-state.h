@@ -63,6 +63,16 @@ public:
 
     /* Flips the display */
     virtual void flip() = 0;
+
+    /*
+     * Creates (or recreates) additional windows with the properties of the
+     * main window, for presenting to several surfaces.  Only some native
+     * systems support more than one window.
+     */
+    virtual bool create_extra_windows(unsigned int count) { return count == 0; }
+
+    /* Gets an additional native window */
+    virtual void* extra_window(unsigned int index) { static_cast<void>(index); return 0; }
 };
 
 #endif /* GLMARK2_NATIVE_STATE_H_ */
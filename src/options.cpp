@@ -24,12 +24,14 @@
 #include <cstring>
 #include <cstdio>
 #include <getopt.h>
+#include <algorithm>
 
 #include "options.h"
 #include "util.h"
 
 std::vector<std::string> Options::benchmarks;
 std::vector<std::string> Options::benchmark_files;
+std::vector<std::string> Options::benchmark_tags;
 bool Options::validate = false;
 Options::FrameEnd Options::frame_end = Options::FrameEndDefault;
 std::pair<int,int> Options::size(800, 600);
@@ -39,20 +41,40 @@ bool Options::show_debug = false;
 bool Options::show_help = false;
 bool Options::reuse_context = false;
 bool Options::run_forever = false;
+double Options::time_budget = 0.0;
 bool Options::annotate = false;
+bool Options::alloc_stats = false;
+bool Options::zero_alloc = false;
 bool Options::offscreen = false;
+unsigned int Options::surfaces = 1;
+std::pair<int,int> Options::gl_version(0, 0);
+bool Options::gl_core_profile = false;
+std::pair<int,int> Options::gles_version(0, 0);
+std::string Options::record_file;
+unsigned int Options::record_frames = 100;
+std::string Options::replay_file;
 GLVisualConfig Options::visual_config;
 
 static struct option long_options[] = {
     {"annotate", 0, 0, 0},
     {"benchmark", 1, 0, 0},
     {"benchmark-file", 1, 0, 0},
+    {"tags", 1, 0, 0},
     {"validate", 0, 0, 0},
     {"frame-end", 1, 0, 0},
     {"off-screen", 0, 0, 0},
+    {"surfaces", 1, 0, 0},
     {"visual-config", 1, 0, 0},
+    {"gl-version", 1, 0, 0},
+    {"gles-version", 1, 0, 0},
     {"reuse-context", 0, 0, 0},
     {"run-forever", 0, 0, 0},
+    {"time-budget", 1, 0, 0},
+    {"record", 1, 0, 0},
+    {"record-frames", 1, 0, 0},
+    {"replay", 1, 0, 0},
+    {"alloc-stats", 0, 0, 0},
+    {"zero-alloc", 0, 0, 0},
     {"size", 1, 0, 0},
     {"fullscreen", 0, 0, 0},
     {"list-scenes", 0, 0, 0},
@@ -86,6 +108,31 @@ parse_size(const std::string &str, std::pair<int,int> &size)
         size.second = size.first;
 }
 
+/**
+ * Parses a context version string of the form MAJOR[.MINOR][:PROFILE]
+ *
+ * @param str the string to parse
+ * @param version the parsed version (major, minor)
+ * @param core whether the core profile was requested
+ */
+static void
+parse_context_version(const std::string &str, std::pair<int,int> &version,
+                      bool *core)
+{
+    std::vector<std::string> p;
+    std::vector<std::string> d;
+    Util::split(str, ':', p, Util::SplitModeNormal);
+
+    if (!p.empty())
+        Util::split(p[0], '.', d, Util::SplitModeNormal);
+
+    version.first = !d.empty() ? Util::fromString<int>(d[0]) : 0;
+    version.second = d.size() > 1 ? Util::fromString<int>(d[1]) : 0;
+
+    if (core)
+        *core = p.size() > 1 && p[1] == "core";
+}
+
 /**
  * Parses a frame-end method string
  *
@@ -121,14 +168,21 @@ Options::print_help()
            "  -f, --benchmark-file F Load benchmarks to run from a file containing a\n"
            "                         list of benchmark descriptions (one per line)\n"
            "                         (the option can be used multiple times)\n"
+           "      --tags T1[,T2]*    Only run the benchmarks from benchmark files that\n"
+           "                         have at least one of the specified tags\n"
            "      --validate         Run a quick output validation test instead of \n"
            "                         running the benchmarks\n"
            "      --frame-end METHOD How to end a frame [default,none,swap,finish,readpixels]\n"
            "      --off-screen       Render to an off-screen surface\n"
+           "      --surfaces N       Draw and present each frame to N surfaces of the same\n"
+           "                         size, through a single context (default: 1)\n"
            "      --visual-config C  The visual configuration to use for the rendering\n"
            "                         target: 'red=R:green=G:blue=B:alpha=A:buffer=BUF'.\n"
            "                         The parameters may be defined in any order, and any\n"
            "                         omitted parameters assume a default value of '1'\n"
+           "      --gl-version V     The GL context version to request: 'MAJOR.MINOR[:core]'\n"
+           "                         (by default, a compatibility profile context)\n"
+           "      --gles-version V   The GLES context version to request: 'MAJOR.MINOR'\n"
            "      --reuse-context    Use a single context for all scenes\n"
            "                         (by default, each scene gets its own context)\n"
            "  -s, --size WxH         Size of the output window (default: 800x600)\n"
@@ -139,8 +193,19 @@ Options::print_help()
            "                         (only explicitly set options are shown by default)\n"
            "      --run-forever      Run indefinitely, looping from the last benchmark\n"
            "                         back to the first\n"
+           "      --time-budget SECS Run the benchmarks within a total time budget, spending\n"
+           "                         the time on the scenes with the least precise results\n"
            "      --annotate         Annotate the benchmarks with on-screen information\n"
            "                         (same as -b :show-fps=true:title=#info#)\n"
+           "      --record FILE      Record the GL command stream of the first benchmark\n"
+           "                         to a file\n"
+           "      --record-frames N  The number of frames to record (default: 100)\n"
+           "      --replay FILE      Play back a GL command stream recorded with --record\n"
+           "                         instead of running the benchmarks\n"
+           "      --alloc-stats      Report the heap allocations per frame of each\n"
+           "                         benchmark (needs --enable-alloc-counter)\n"
+           "      --zero-alloc       Fail if any benchmark allocates heap memory after\n"
+           "                         its first frames (implies --alloc-stats)\n"
            "  -d, --debug            Display debug messages\n"
            "  -h, --help             Display help\n");
 }
@@ -169,14 +234,23 @@ Options::parse_args(int argc, char **argv)
             Options::benchmarks.push_back(optarg);
         else if (c == 'f' || !strcmp(optname, "benchmark-file"))
             Options::benchmark_files.push_back(optarg);
+        else if (!strcmp(optname, "tags"))
+            Util::split(optarg, ',', Options::benchmark_tags, Util::SplitModeNormal);
         else if (!strcmp(optname, "validate"))
             Options::validate = true;
         else if (!strcmp(optname, "frame-end"))
             Options::frame_end = frame_end_from_str(optarg);
         else if (!strcmp(optname, "off-screen"))
             Options::offscreen = true;
+        else if (!strcmp(optname, "surfaces"))
+            Options::surfaces = std::max(Util::fromString<unsigned int>(optarg), 1u);
         else if (!strcmp(optname, "visual-config"))
             Options::visual_config = GLVisualConfig(optarg);
+        else if (!strcmp(optname, "gl-version"))
+            parse_context_version(optarg, Options::gl_version,
+                                  &Options::gl_core_profile);
+        else if (!strcmp(optname, "gles-version"))
+            parse_context_version(optarg, Options::gles_version, 0);
         else if (!strcmp(optname, "reuse-context"))
             Options::reuse_context = true;
         else if (c == 's' || !strcmp(optname, "size"))
@@ -189,6 +263,18 @@ Options::parse_args(int argc, char **argv)
             Options::show_all_options = true;
         else if (!strcmp(optname, "run-forever"))
             Options::run_forever = true;
+        else if (!strcmp(optname, "time-budget"))
+            Options::time_budget = Util::fromString<double>(optarg);
+        else if (!strcmp(optname, "record"))
+            Options::record_file = optarg;
+        else if (!strcmp(optname, "record-frames"))
+            Options::record_frames = Util::fromString<unsigned int>(optarg);
+        else if (!strcmp(optname, "replay"))
+            Options::replay_file = optarg;
+        else if (!strcmp(optname, "alloc-stats"))
+            Options::alloc_stats = true;
+        else if (!strcmp(optname, "zero-alloc"))
+            Options::zero_alloc = Options::alloc_stats = true;
         else if (c == 'd' || !strcmp(optname, "debug"))
             Options::show_debug = true;
         else if (c == 'h' || !strcmp(optname, "help"))
@@ -42,6 +42,7 @@ struct Options {
 
     static std::vector<std::string> benchmarks;
     static std::vector<std::string> benchmark_files;
+    static std::vector<std::string> benchmark_tags;
     static bool validate;
     static FrameEnd frame_end;
     static std::pair<int,int> size;
@@ -51,8 +52,18 @@ struct Options {
     static bool show_help;
     static bool reuse_context;
     static bool run_forever;
+    static double time_budget;
     static bool annotate;
+    static bool alloc_stats;
+    static bool zero_alloc;
     static bool offscreen;
+    static unsigned int surfaces;
+    static std::pair<int,int> gl_version;
+    static bool gl_core_profile;
+    static std::pair<int,int> gles_version;
+    static std::string record_file;
+    static unsigned int record_frames;
+    static std::string replay_file;
     static GLVisualConfig visual_config;
 };
 
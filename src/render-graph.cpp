@@ -0,0 +1,335 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "render-graph.h"
+#include "gl-memory.h"
+#include "log.h"
+
+#include <algorithm>
+#include <sstream>
+
+const unsigned int RenderGraph::screen;
+
+RenderGraph::RenderGraph()
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+    release();
+}
+
+unsigned int
+RenderGraph::add_target(unsigned int width, unsigned int height, GLenum format,
+                        bool has_depth, bool persistent)
+{
+    Target target;
+
+    target.width = width;
+    target.height = height;
+    target.format = format;
+    target.has_depth = has_depth;
+    target.persistent = persistent;
+    target.first_use = screen;
+    target.last_use = 0;
+    target.framebuffer = 0;
+
+    targets_.push_back(target);
+
+    return targets_.size() - 1;
+}
+
+unsigned int
+RenderGraph::add_pass(unsigned int output)
+{
+    Pass pass;
+    pass.output = output;
+
+    passes_.push_back(pass);
+
+    return passes_.size() - 1;
+}
+
+void
+RenderGraph::add_input(unsigned int pass, unsigned int target)
+{
+    passes_[pass].inputs.push_back(target);
+}
+
+bool
+RenderGraph::compile(bool alias, bool invalidate)
+{
+    const unsigned int npasses = passes_.size();
+    std::vector<unsigned int> last_write(targets_.size(), screen);
+
+    /* Find the passes that use each target */
+    for (unsigned int p = 0; p < npasses; p++) {
+        std::vector<unsigned int> used(passes_[p].inputs);
+        used.push_back(passes_[p].output);
+
+        for (std::vector<unsigned int>::const_iterator iter = used.begin();
+             iter != used.end();
+             iter++)
+        {
+            if (*iter == screen)
+                continue;
+            Target &target(targets_[*iter]);
+            target.first_use = std::min(target.first_use, p);
+            target.last_use = std::max(target.last_use, p);
+        }
+
+        if (passes_[p].output != screen)
+            last_write[passes_[p].output] = p;
+    }
+
+    /*
+     * Give each target a framebuffer, in the order they are first used.
+     * A transient target can reuse the framebuffer of an earlier target
+     * with the same size and format, if that target is no longer used.
+     * Targets that no pass uses (e.g. ones rendered once at setup) are
+     * treated as persistent.
+     */
+    for (unsigned int p = 0; p <= npasses; p++) {
+        for (unsigned int t = 0; t < targets_.size(); t++) {
+            Target &target(targets_[t]);
+            bool unused = target.first_use == screen;
+
+            if ((unused && p != npasses) || (!unused && target.first_use != p))
+                continue;
+
+            bool keep = target.persistent || unused;
+            unsigned int f = 0;
+
+            for (; alias && !keep && f < framebuffers_.size(); f++) {
+                Framebuffer &fb(framebuffers_[f]);
+                const Target &owner(targets_[fb.first_target]);
+
+                if (fb.busy_until != screen && fb.busy_until < target.first_use &&
+                    owner.width == target.width && owner.height == target.height &&
+                    owner.format == target.format &&
+                    owner.has_depth == target.has_depth)
+                {
+                    break;
+                }
+            }
+
+            if (alias && !keep && f < framebuffers_.size()) {
+                framebuffers_[f].users++;
+                framebuffers_[f].busy_until = target.last_use;
+            }
+            else {
+                Framebuffer fb = {0, 0, 0, t, 1, keep ? screen : target.last_use};
+                framebuffers_.push_back(fb);
+                f = framebuffers_.size() - 1;
+            }
+
+            target.framebuffer = f;
+        }
+    }
+
+    /* Create the framebuffers */
+    bool complete = true;
+
+    for (std::vector<Framebuffer>::iterator iter = framebuffers_.begin();
+         iter != framebuffers_.end();
+         iter++)
+    {
+        const Target &target(targets_[iter->first_target]);
+
+        glGenTextures(1, &iter->texture);
+        glBindTexture(GL_TEXTURE_2D, iter->texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, target.format,
+                               target.width, target.height, 0,
+                               target.format, GL_UNSIGNED_BYTE, 0);
+
+        glGenFramebuffers(1, &iter->fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, iter->fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D, iter->texture, 0);
+
+        if (target.has_depth) {
+            glGenRenderbuffers(1, &iter->depth_renderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, iter->depth_renderbuffer);
+            GLMemory::renderbuffer_storage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16,
+                                           target.width, target.height);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                      GL_RENDERBUFFER, iter->depth_renderbuffer);
+        }
+
+        unsigned int status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            Log::error("RenderGraph::compile: glCheckFramebufferStatus failed (0x%x)\n", status);
+            complete = false;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    /*
+     * A transient target's contents are dead when the first pass using it
+     * starts, and its depth buffer (which is never sampled) after the last
+     * pass rendering to it.
+     */
+    if (invalidate && GLExtensions::InvalidateFramebuffer) {
+        for (unsigned int p = 0; p < npasses; p++) {
+            Pass &pass(passes_[p]);
+            if (pass.output == screen || targets_[pass.output].persistent)
+                continue;
+
+            const Target &target(targets_[pass.output]);
+
+            if (target.first_use == p) {
+                pass.invalidate_begin.push_back(GL_COLOR_ATTACHMENT0);
+                if (target.has_depth)
+                    pass.invalidate_begin.push_back(GL_DEPTH_ATTACHMENT);
+            }
+
+            if (target.has_depth && last_write[pass.output] == p)
+                pass.invalidate_end.push_back(GL_DEPTH_ATTACHMENT);
+        }
+    }
+
+    Log::debug("RenderGraph: %u targets in %u framebuffers, %zu bytes (%zu unaliased)\n",
+               static_cast<unsigned int>(targets_.size()),
+               static_cast<unsigned int>(framebuffers_.size()),
+               memory(), unaliased_memory());
+
+    return complete;
+}
+
+void
+RenderGraph::release()
+{
+    for (std::vector<Framebuffer>::iterator iter = framebuffers_.begin();
+         iter != framebuffers_.end();
+         iter++)
+    {
+        glDeleteFramebuffers(1, &iter->fbo);
+        GLMemory::delete_textures(1, &iter->texture);
+        if (iter->depth_renderbuffer)
+            GLMemory::delete_renderbuffers(1, &iter->depth_renderbuffer);
+    }
+
+    framebuffers_.clear();
+    targets_.clear();
+    passes_.clear();
+}
+
+GLuint
+RenderGraph::fbo(unsigned int target) const
+{
+    return framebuffers_[targets_[target].framebuffer].fbo;
+}
+
+GLuint
+RenderGraph::texture(unsigned int target) const
+{
+    return framebuffers_[targets_[target].framebuffer].texture;
+}
+
+GLuint
+RenderGraph::depth_renderbuffer(unsigned int target) const
+{
+    return framebuffers_[targets_[target].framebuffer].depth_renderbuffer;
+}
+
+bool
+RenderGraph::aliased(unsigned int target) const
+{
+    return framebuffers_[targets_[target].framebuffer].users > 1;
+}
+
+void
+RenderGraph::begin_pass(unsigned int pass)
+{
+    invalidate(passes_[pass].invalidate_begin);
+}
+
+void
+RenderGraph::end_pass(unsigned int pass)
+{
+    invalidate(passes_[pass].invalidate_end);
+}
+
+size_t
+RenderGraph::memory() const
+{
+    size_t bytes = 0;
+
+    for (std::vector<Framebuffer>::const_iterator iter = framebuffers_.begin();
+         iter != framebuffers_.end();
+         iter++)
+    {
+        bytes += target_bytes(targets_[iter->first_target]);
+    }
+
+    return bytes;
+}
+
+size_t
+RenderGraph::unaliased_memory() const
+{
+    size_t bytes = 0;
+
+    for (std::vector<Target>::const_iterator iter = targets_.begin();
+         iter != targets_.end();
+         iter++)
+    {
+        bytes += target_bytes(*iter);
+    }
+
+    return bytes;
+}
+
+std::string
+RenderGraph::memory_summary() const
+{
+    static const double MiB = 1024.0 * 1024.0;
+    std::stringstream ss;
+
+    ss.precision(2);
+    ss << std::fixed;
+    ss << " RT memory: " << memory() / MiB << " MiB"
+       << " (" << unaliased_memory() / MiB << " MiB unaliased)";
+
+    return ss.str();
+}
+
+size_t
+RenderGraph::target_bytes(const Target &target) const
+{
+    size_t pixel = GLMemory::bytes_per_pixel(target.format, GL_UNSIGNED_BYTE);
+
+    if (target.has_depth)
+        pixel += GLMemory::bytes_per_pixel(GL_DEPTH_COMPONENT16, GL_NONE);
+
+    return static_cast<size_t>(target.width) * target.height * pixel;
+}
+
+void
+RenderGraph::invalidate(const std::vector<GLenum> &attachments)
+{
+    if (!attachments.empty()) {
+        GLExtensions::InvalidateFramebuffer(GL_FRAMEBUFFER, attachments.size(),
+                                            &attachments[0]);
+    }
+}
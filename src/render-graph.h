@@ -0,0 +1,170 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_RENDER_GRAPH_H_
+#define GLMARK2_RENDER_GRAPH_H_
+
+#include "gl-headers.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Schedules the offscreen render targets used by the passes of a frame.
+ *
+ * A scene declares its render targets and then, in execution order, the
+ * passes of a frame with the target each one renders to and the targets
+ * it samples.  compile() works out the lifetime of each target within the
+ * frame and backs transient targets whose lifetimes do not overlap with the
+ * same framebuffer, if their size and format match.
+ *
+ * The passes bracket their rendering with begin_pass() and end_pass(),
+ * which invalidate the attachment contents that will not be used: the
+ * leftovers of the previous frame or of an aliased target, and depth
+ * buffers after their last pass.
+ */
+class RenderGraph
+{
+public:
+    /* The output of passes that render to the screen */
+    static const unsigned int screen = ~0u;
+
+    RenderGraph();
+    ~RenderGraph();
+
+    /**
+     * Declares a render target with a color texture.
+     *
+     * @param width the width of the target
+     * @param height the height of the target
+     * @param format the (unsized) format of the color texture
+     * @param has_depth whether the target has a depth buffer
+     * @param persistent whether the contents must be kept between frames;
+     *        persistent targets are never aliased or invalidated
+     *
+     * @return the id of the target
+     */
+    unsigned int add_target(unsigned int width, unsigned int height,
+                            GLenum format, bool has_depth,
+                            bool persistent = false);
+
+    /**
+     * Declares the next pass of a frame.
+     *
+     * @param output the target the pass renders to, or ::screen
+     *
+     * @return the id of the pass
+     */
+    unsigned int add_pass(unsigned int output);
+
+    /**
+     * Declares a target that a pass samples.
+     */
+    void add_input(unsigned int pass, unsigned int target);
+
+    /**
+     * Creates the framebuffers of the declared targets.
+     *
+     * @param alias whether to share framebuffers between transient targets
+     * @param invalidate whether to invalidate unused attachment contents
+     *
+     * @return whether all the framebuffers are complete
+     */
+    bool compile(bool alias, bool invalidate);
+
+    /**
+     * Deletes the framebuffers and forgets all targets and passes.
+     */
+    void release();
+
+    GLuint fbo(unsigned int target) const;
+    GLuint texture(unsigned int target) const;
+    GLuint depth_renderbuffer(unsigned int target) const;
+
+    /**
+     * Whether a target shares its framebuffer with other targets.  The
+     * users of an aliased texture must set its parameters before use.
+     */
+    bool aliased(unsigned int target) const;
+
+    /**
+     * Marks the start of a pass.  The output of the pass must be bound.
+     */
+    void begin_pass(unsigned int pass);
+
+    /**
+     * Marks the end of a pass.  The output of the pass must be bound.
+     */
+    void end_pass(unsigned int pass);
+
+    /**
+     * Gets the size of the allocated render targets in bytes.
+     */
+    size_t memory() const;
+
+    /**
+     * Gets the size the render targets would have without aliasing.
+     */
+    size_t unaliased_memory() const;
+
+    /**
+     * Gets a summary of the render target memory, for scene results.
+     */
+    std::string memory_summary() const;
+
+private:
+    struct Target {
+        unsigned int width;
+        unsigned int height;
+        GLenum format;
+        bool has_depth;
+        bool persistent;
+        /* The first and last pass that use the target, and its framebuffer */
+        unsigned int first_use;
+        unsigned int last_use;
+        unsigned int framebuffer;
+    };
+
+    struct Framebuffer {
+        GLuint fbo;
+        GLuint texture;
+        GLuint depth_renderbuffer;
+        /* The first target backed by the framebuffer, and their number */
+        unsigned int first_target;
+        unsigned int users;
+        /* The last pass of the current user, or ::screen if it is persistent */
+        unsigned int busy_until;
+    };
+
+    struct Pass {
+        unsigned int output;
+        std::vector<unsigned int> inputs;
+        /* The attachments to invalidate at the start and end of the pass */
+        std::vector<GLenum> invalidate_begin;
+        std::vector<GLenum> invalidate_end;
+    };
+
+    size_t target_bytes(const Target &target) const;
+    void invalidate(const std::vector<GLenum> &attachments);
+
+    std::vector<Target> targets_;
+    std::vector<Framebuffer> framebuffers_;
+    std::vector<Pass> passes_;
+};
+
+#endif
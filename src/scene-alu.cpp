@@ -0,0 +1,394 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "log.h"
+#include "util.h"
+#include "shader-source.h"
+#include "gpu-timer.h"
+
+#include <sstream>
+
+using LibMatrix::vec4;
+
+struct SceneAluPrivate
+{
+    Program program;
+    Mesh mesh;
+    std::string op;
+    /* Whether GPU time can be measured once calibration is done */
+    bool gpu_timing;
+
+    /* The shader invocations per frame, and the operations per iteration */
+    double invocations;
+    double ops_per_iteration;
+    unsigned int iterations;
+
+    /*
+     * Calibration doubles the iterations until a batch of frames takes at
+     * least the target time per frame.
+     */
+    bool calibrating;
+    double target_us;
+    unsigned int batch_frames;
+    uint64_t batch_start;
+
+    /* The measurement, which starts after calibration */
+    uint64_t measure_start;
+    uint64_t measure_end;
+    unsigned int frames;
+    GPUTimer timer;
+    bool time_gpu;
+
+    SceneAluPrivate() :
+        gpu_timing(false), invocations(0.0), ops_per_iteration(0.0), iterations(1),
+        calibrating(false), target_us(0.0), batch_frames(0), batch_start(0),
+        measure_start(0), measure_end(0), frames(0), time_gpu(false) {}
+};
+
+/* The operations in the loop body, and the frames per calibration batch */
+static const unsigned int body_lines = 16;
+static const unsigned int calibration_frames = 5;
+static const unsigned int max_iterations = 1 << 16;
+
+SceneAlu::SceneAlu(Canvas &canvas) :
+    Scene(canvas, "alu")
+{
+    priv_ = new SceneAluPrivate();
+
+    options_["op"] = Scene::Option("op", "mad",
+                                   "The operation that dominates the shader (mad: highp float multiply-add, mad-mediump: mediump float multiply-add)",
+                                   "mad,mad-mediump,int,sin,exp,inversesqrt");
+    options_["chain"] = Scene::Option("chain", "independent",
+                                      "Whether each operation depends on the previous one",
+                                      "dependent,independent");
+    options_["stage"] = Scene::Option("stage", "fragment",
+                                      "The shader stage that runs the operations",
+                                      "fragment,vertex");
+    options_["iterations"] = Scene::Option("iterations", "auto",
+                                           "The number of loop iterations, or auto to calibrate them");
+    options_["target-ms"] = Scene::Option("target-ms", "10",
+                                          "The frame time that auto calibration aims for");
+    options_["grid-size"] = Scene::Option("grid-size", "128",
+                                          "The number of grid cells per side for the vertex stage");
+}
+
+SceneAlu::~SceneAlu()
+{
+    delete priv_;
+}
+
+bool
+SceneAlu::load()
+{
+    running_ = false;
+
+    return true;
+}
+
+void
+SceneAlu::unload()
+{
+}
+
+/**
+ * Generates the code of the loop that runs the operations.
+ *
+ * The body applies one operation per line, to one accumulator in a dependent
+ * chain or to four accumulators in turn, so that consecutive operations are
+ * independent.  The operations converge to fixed points, so the values stay
+ * finite however many iterations run.
+ */
+static void
+add_alu_code(ShaderSource &source, const std::string &op, bool dependent)
+{
+    bool integer = op == "int";
+    const std::string type(integer ? "ivec4" : "vec4");
+    unsigned int accumulators = dependent ? 1 : 4;
+
+    if (integer) {
+        source.insert("UNIFORMS", "uniform int IntScale;\n"
+                                  "uniform int IntBias;\n");
+    }
+    else {
+        source.insert("UNIFORMS", "uniform vec4 Scale;\n"
+                                  "uniform vec4 Bias;\n");
+    }
+    source.insert("UNIFORMS", "uniform int Iterations;\n");
+
+    for (unsigned int i = 0; i < accumulators; i++) {
+        std::stringstream ss;
+        ss << "    " << type << " a" << i << " = ";
+        if (integer)
+            ss << "ivec4(TexCoord.xyxy * 256.0) + " << i << ";";
+        else
+            ss << "TexCoord.xyxy + " << i + 1 << ".0;";
+        ss << std::endl;
+        source.insert("DECLARATIONS", ss.str());
+    }
+
+    for (unsigned int line = 0; line < body_lines; line++) {
+        std::stringstream ss;
+        std::stringstream acc;
+        acc << "a" << line % accumulators;
+
+        ss << "        " << acc.str() << " = ";
+        if (op == "int")
+            ss << acc.str() << " * IntScale + IntBias;";
+        else if (op == "sin")
+            ss << "sin(" << acc.str() << ");";
+        else if (op == "exp")
+            ss << "exp(-" << acc.str() << ");";
+        else if (op == "inversesqrt")
+            ss << "inversesqrt(" << acc.str() << ");";
+        else
+            ss << acc.str() << " * Scale + Bias;";
+        ss << std::endl;
+
+        source.insert("BODY", ss.str());
+    }
+
+    for (unsigned int i = 0; i < accumulators; i++) {
+        std::stringstream ss;
+        ss << "    result += ";
+        if (integer)
+            ss << "vec4(a" << i << ");";
+        else
+            ss << "a" << i << ";";
+        ss << std::endl;
+        source.insert("RESULT", ss.str());
+    }
+}
+
+bool
+SceneAlu::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    SceneAluPrivate &p(*priv_);
+
+    p.op = options_["op"].value;
+    const std::string &op(p.op);
+    bool dependent = options_["chain"].value == "dependent";
+    bool vertex = options_["stage"].value == "vertex";
+    unsigned int grid_size = vertex ?
+        Util::fromString<unsigned int>(options_["grid-size"].value) : 1;
+
+    if (grid_size == 0) {
+        Log::error("SceneAlu: grid-size must be at least 1\n");
+        return false;
+    }
+
+    /*
+     * The precision of the operations comes from the vertex-precision and
+     * fragment-precision options, except for the float precision of the
+     * multiply-add classes and the int precision of the integer class,
+     * which the class selects.
+     */
+    ShaderSource::ShaderType type = vertex ? ShaderSource::ShaderTypeVertex :
+                                             ShaderSource::ShaderTypeFragment;
+    ShaderSource::Precision precision(ShaderSource::default_precision(type));
+
+    if (op == "mad")
+        precision.float_precision = ShaderSource::PrecisionValueHigh;
+    else if (op == "mad-mediump")
+        precision.float_precision = ShaderSource::PrecisionValueMedium;
+    else if (op == "int")
+        precision.int_precision = ShaderSource::PrecisionValueHigh;
+
+    ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/alu.vert",
+                            ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/alu.frag",
+                            ShaderSource::ShaderTypeFragment);
+    ShaderSource &alu_source(vertex ? vtx_source : frg_source);
+    ShaderSource &other_source(vertex ? frg_source : vtx_source);
+
+    add_alu_code(alu_source, op, dependent);
+    alu_source.precision(precision);
+
+    static const char *placeholders[] = {"$UNIFORMS$", "$DECLARATIONS$",
+                                         "$BODY$", "$RESULT$"};
+    for (unsigned int i = 0; i < 4; i++)
+        other_source.replace(placeholders[i], "");
+
+    std::string define(vertex ? "#define ALU_VERTEX\n" : "#define ALU_FRAGMENT\n");
+
+    if (!Scene::load_shaders_from_strings(p.program, define + vtx_source.str(),
+                                          define + frg_source.str()))
+    {
+        return false;
+    }
+
+    p.program.start();
+    if (op == "int") {
+        p.program["IntScale"] = 1;
+        p.program["IntBias"] = 0;
+    }
+    else {
+        p.program["Scale"] = vec4(0.999, 0.999, 0.999, 0.999);
+        p.program["Bias"] = vec4(0.001, 0.001, 0.001, 0.001);
+    }
+    p.program.stop();
+
+    /* A single quad covering the screen, or a grid for the vertex stage */
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    p.mesh.set_vertex_format(vertex_format);
+    p.mesh.make_grid(grid_size, grid_size, 2.0, 2.0, 0.0);
+    p.mesh.build_vbo();
+
+    std::vector<GLint> attrib_locations;
+    attrib_locations.push_back(p.program["position"].location());
+    p.mesh.set_attrib_locations(attrib_locations);
+
+    /* Each line of the loop body is one operation on four components */
+    if (vertex)
+        p.invocations = grid_size * grid_size * 6.0;
+    else
+        p.invocations = static_cast<double>(canvas_.width()) * canvas_.height();
+    p.ops_per_iteration = body_lines * 4.0;
+
+    p.calibrating = options_["iterations"].value == "auto";
+    if (p.calibrating) {
+        p.iterations = 1;
+        p.target_us = Util::fromString<double>(options_["target-ms"].value) * 1000.0;
+    }
+    else {
+        p.iterations = Util::fromString<unsigned int>(options_["iterations"].value);
+    }
+
+    p.batch_frames = 0;
+    p.batch_start = Util::get_timestamp_us();
+    p.measure_start = p.batch_start;
+    p.measure_end = p.batch_start;
+    p.frames = 0;
+    p.gpu_timing = gpu_timing();
+    p.time_gpu = false;
+
+    currentFrame_ = 0;
+    running_ = true;
+    startTime_ = Util::get_timestamp_us() / 1000000.0;
+    lastUpdateTime_ = startTime_;
+
+    return true;
+}
+
+void
+SceneAlu::teardown()
+{
+    SceneAluPrivate &p(*priv_);
+
+    p.program.release();
+    p.mesh.reset();
+    p.timer.release();
+
+    Scene::teardown();
+}
+
+void
+SceneAlu::update()
+{
+    Scene::update();
+}
+
+void
+SceneAlu::draw()
+{
+    SceneAluPrivate &p(*priv_);
+    uint64_t now = Util::get_timestamp_us();
+
+    if (p.calibrating && p.batch_frames == calibration_frames) {
+        double frame_us = static_cast<double>(now - p.batch_start) / p.batch_frames;
+
+        if (frame_us < p.target_us && p.iterations < max_iterations) {
+            p.iterations *= 2;
+        }
+        else {
+            p.calibrating = false;
+            Log::debug("SceneAlu: calibrated to %u iterations (%.2f ms/frame)\n",
+                       p.iterations, frame_us / 1000.0);
+        }
+
+        p.batch_frames = 0;
+        p.batch_start = now;
+    }
+
+    /* Start measuring with the first frame after calibration */
+    bool measure = !p.calibrating;
+    if (measure && p.frames == 0) {
+        p.measure_start = now;
+        p.time_gpu = p.gpu_timing && p.timer.init();
+    }
+
+    glDisable(GL_DEPTH_TEST);
+
+    if (measure && p.time_gpu)
+        p.timer.begin();
+
+    p.program.start();
+    p.program["Iterations"] = static_cast<int>(p.iterations);
+    p.mesh.render_vbo();
+    p.program.stop();
+
+    if (measure && p.time_gpu)
+        p.timer.end();
+
+    glEnable(GL_DEPTH_TEST);
+
+    if (measure) {
+        p.frames++;
+        p.measure_end = Util::get_timestamp_us();
+    }
+    else {
+        p.batch_frames++;
+    }
+}
+
+std::string
+SceneAlu::result_extras()
+{
+    SceneAluPrivate &p(*priv_);
+    double seconds = -1.0;
+
+    if (p.frames == 0)
+        return " Calibration did not finish";
+
+    /*
+     * The GPU time covers the ALU draw only; the wall-clock time also
+     * includes the rest of the frame, so it underestimates the throughput.
+     */
+    if (p.time_gpu && p.timer.average_ms() > 0.0)
+        seconds = p.timer.average_ms() / 1000.0;
+    else if (p.measure_end > p.measure_start)
+        seconds = (p.measure_end - p.measure_start) / 1000000.0 / p.frames;
+
+    if (seconds <= 0.0)
+        return "";
+
+    double ops = p.invocations * p.ops_per_iteration * p.iterations;
+
+    std::stringstream ss;
+    ss.precision(2);
+    ss << std::fixed;
+    ss << " " << p.op << ": " << ops / seconds / 1.0e9 << " Gops/s"
+       << " (" << p.iterations << " iterations, "
+       << (p.time_gpu ? "GPU" : "wall-clock") << " time)";
+
+    return ss.str();
+}
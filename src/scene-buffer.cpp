@@ -97,6 +97,8 @@ public:
         wave_full_period_(wave_period_ / duty_cycle),
         wave_velocity_(0.1 * length), displacement_(nlength + 1)
     {
+        /* There can't be more ranges than length indices */
+        ranges_.reserve(nlength + 1);
         create_program();
         create_mesh();
     }
@@ -114,7 +116,8 @@ public:
         std::vector<std::vector<float> >& vertices(mesh_.vertices());
 
         /* Figure out which length index ranges need update */
-        std::vector<std::pair<size_t, size_t> > ranges;
+        std::vector<std::pair<size_t, size_t> >& ranges(ranges_);
+        ranges.clear();
 
         for (size_t n = 0; n <= nlength_; n++) {
             double d(displacement(n, elapsed));
@@ -186,6 +189,8 @@ private:
     double wave_velocity_;
 
     std::vector<double> displacement_;
+    /* The ranges of the last update, kept to avoid allocating each frame */
+    std::vector<std::pair<size_t, size_t> > ranges_;
 
     /**
      * Calculates the length index of a vertex.
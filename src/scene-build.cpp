@@ -64,6 +64,15 @@ SceneBuild::~SceneBuild()
 {
 }
 
+bool
+SceneBuild::supported(bool show_errors)
+{
+    if (options_["use-vbo"].value == "false")
+        return require_capability(GLExtensions::ClientArrays, show_errors);
+
+    return true;
+}
+
 bool
 SceneBuild::load()
 {
@@ -27,6 +27,7 @@
 #include "shader-source.h"
 #include "model.h"
 #include "texture.h"
+#include "gl-memory.h"
 #include "util.h"
 #include <cmath>
 
@@ -334,7 +335,7 @@ SceneBump::teardown()
     program_.stop();
     program_.release();
 
-    glDeleteTextures(1, &texture_);
+    GLMemory::delete_textures(1, &texture_);
     texture_ = 0;
 
     Scene::teardown();
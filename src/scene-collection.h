@@ -75,6 +75,16 @@ private:
         scenes_.push_back(new SceneShadow(canvas));
         scenes_.push_back(new SceneRefract(canvas));
         scenes_.push_back(new SceneClear(canvas));
+        scenes_.push_back(new SceneDeferred(canvas));
+        scenes_.push_back(new SceneLoadStore(canvas));
+        scenes_.push_back(new SceneFboSwitch(canvas));
+        scenes_.push_back(new SceneOcclusion(canvas));
+        scenes_.push_back(new SceneOverdraw(canvas));
+        scenes_.push_back(new SceneRegisters(canvas));
+        scenes_.push_back(new SceneAlu(canvas));
+        scenes_.push_back(new SceneTexcache(canvas));
+        scenes_.push_back(new SceneTextureStream(canvas));
+        scenes_.push_back(new SceneDmabufStream(canvas));
 
     }
 };
@@ -28,6 +28,7 @@
 #include "util.h"
 
 #include <cmath>
+#include <sstream>
 
 static const std::string shader_file_base(GLMARK_DATA_PATH"/shaders/conditionals");
 
@@ -35,6 +36,7 @@ static const std::string vtx_file(shader_file_base + ".vert");
 static const std::string frg_file(shader_file_base + ".frag");
 static const std::string step_conditional_file(shader_file_base + "-step-conditional.all");
 static const std::string step_simple_file(shader_file_base + "-step-simple.all");
+static const std::string step_divergent_file(shader_file_base + "-step-divergent.all");
 
 SceneConditionals::SceneConditionals(Canvas &pCanvas) :
     SceneGrid(pCanvas, "conditionals")
@@ -47,6 +49,12 @@ SceneConditionals::SceneConditionals(Canvas &pCanvas) :
             "The number of computational steps in the vertex shader");
     options_["vertex-conditionals"] = Scene::Option("vertex-conditionals", "true",
             "Whether each computational step includes an if-else clause", "false,true");
+    options_["divergence"] = Scene::Option("divergence", "none",
+            "The screen-space pattern of the fragment branch conditions"
+            " (none: data dependent)",
+            "none,uniform,blocks,checkerboard,random");
+    options_["block-size"] = Scene::Option("block-size", "8",
+            "The size in pixels of the blocks of the 'blocks' divergence pattern");
 }
 
 SceneConditionals::~SceneConditionals()
@@ -57,36 +65,72 @@ static std::string
 get_vertex_shader_source(int steps, bool conditionals)
 {
     ShaderSource source(vtx_file);
-    ShaderSource source_main;
 
     for (int i = 0; i < steps; i++) {
         if (conditionals)
-            source_main.append_file(step_conditional_file);
+            source.insert_file("MAIN", step_conditional_file);
         else
-            source_main.append_file(step_simple_file);
+            source.insert_file("MAIN", step_simple_file);
     }
 
-    source.replace("$MAIN$", source_main.str());
+    /* Remove the placeholder if there are no steps */
+    source.replace("$MAIN$", "");
 
     return source.str();
 }
 
+/**
+ * Gets the defines that select the branch of each fragment from a pattern.
+ *
+ * The pattern sets the granularity at which neighbouring fragments take
+ * different branches, which shows how divergence within a GPU's SIMD
+ * groups affects performance.
+ */
 static std::string
-get_fragment_shader_source(int steps, bool conditionals)
+get_divergence_defines(const std::string &divergence, unsigned int block_size)
+{
+    std::stringstream ss;
+
+    if (divergence == "uniform") {
+        ss << "#define DIVERGENCE_PATTERN (cell.x >= 0.0)" << std::endl;
+    }
+    else if (divergence == "blocks" || divergence == "checkerboard") {
+        ss << "#define DIVERGENCE_PATTERN (mod(cell.x + cell.y, 2.0) >= 1.0)" << std::endl;
+    }
+    else if (divergence == "random") {
+        ss << "#define DIVERGENCE_PATTERN (divergence_hash(cell) >= 0.5)" << std::endl;
+    }
+    else {
+        return "";
+    }
+
+    if (divergence != "blocks")
+        block_size = 1;
+
+    ss << "#define DIVERGENCE_BLOCK_SIZE " << block_size << ".0" << std::endl;
+
+    return ss.str();
+}
+
+static std::string
+get_fragment_shader_source(int steps, bool conditionals,
+                           const std::string &divergence_defines)
 {
     ShaderSource source(frg_file);
-    ShaderSource source_main;
 
     for (int i = 0; i < steps; i++) {
-        if (conditionals)
-            source_main.append_file(step_conditional_file);
+        if (conditionals && !divergence_defines.empty())
+            source.insert_file("MAIN", step_divergent_file);
+        else if (conditionals)
+            source.insert_file("MAIN", step_conditional_file);
         else
-            source_main.append_file(step_simple_file);
+            source.insert_file("MAIN", step_simple_file);
     }
 
-    source.replace("$MAIN$", source_main.str());
+    /* Remove the placeholder if there are no steps */
+    source.replace("$MAIN$", "");
 
-    return source.str();
+    return divergence_defines + source.str();
 }
 
 bool
@@ -100,9 +144,19 @@ SceneConditionals::setup()
     bool frg_conditionals = options_["fragment-conditionals"].value == "true";
     int vtx_steps(Util::fromString<int>(options_["vertex-steps"].value));
     int frg_steps(Util::fromString<int>(options_["fragment-steps"].value));
+    unsigned int block_size(Util::fromString<unsigned int>(options_["block-size"].value));
+
+    if (block_size == 0) {
+        Log::error("SceneConditionals: block-size must be at least 1\n");
+        return false;
+    }
+
     /* Load shaders */
+    std::string divergence_defines(get_divergence_defines(options_["divergence"].value,
+                                                          block_size));
     std::string vtx_shader(get_vertex_shader_source(vtx_steps, vtx_conditionals));
-    std::string frg_shader(get_fragment_shader_source(frg_steps, frg_conditionals));
+    std::string frg_shader(get_fragment_shader_source(frg_steps, frg_conditionals,
+                                                      divergence_defines));
 
     if (!Scene::load_shaders_from_strings(program_, vtx_shader, frg_shader))
         return false;
@@ -128,7 +182,7 @@ SceneConditionals::validate()
     bool frg_conditionals = options_["fragment-conditionals"].value == "true";
     int frg_steps(Util::fromString<int>(options_["fragment-steps"].value));
 
-    if (!frg_conditionals)
+    if (!frg_conditionals || options_["divergence"].value != "none")
         return Scene::ValidationUnknown;
 
     Canvas::Pixel ref;
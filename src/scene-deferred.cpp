@@ -0,0 +1,573 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "mat.h"
+#include "stack.h"
+#include "log.h"
+#include "util.h"
+#include "shader-source.h"
+#include "model.h"
+#include "gl-memory.h"
+#include "gpu-timer.h"
+
+#include <cmath>
+#include <sstream>
+
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+using LibMatrix::mat4;
+
+struct SceneDeferredPrivate
+{
+    Program gbuffer_program;
+    Program ambient_program;
+    Program light_program;
+    Mesh model_mesh;
+    Mesh quad_mesh;
+    Mesh sphere_mesh;
+
+    /* The G-buffer */
+    GLuint fbo;
+    GLuint textures[4];
+    GLuint depth_texture;
+    unsigned int attachments;
+    unsigned int attachment_bytes;
+
+    vec3 center;
+    float radius;
+    mat4 projection;
+    float rotation;
+
+    /* Radius of orbit, height, phase and angular speed of each light */
+    std::vector<vec4> light_orbits;
+    std::vector<vec3> light_colors;
+    float light_range;
+
+    GPUTimer geometry_timer;
+    GPUTimer lighting_timer;
+    bool time_gpu;
+    double bytes_written;
+    double bytes_read;
+    unsigned int frames;
+
+    SceneDeferredPrivate() :
+        fbo(0), depth_texture(0), attachments(0), attachment_bytes(0),
+        radius(1.0), rotation(0.0), light_range(0.0), time_gpu(false),
+        bytes_written(0.0), bytes_read(0.0), frames(0)
+    {
+        textures[0] = textures[1] = textures[2] = textures[3] = 0;
+    }
+};
+
+/* The near plane of the projection */
+static const float near_plane = 2.0;
+
+SceneDeferred::SceneDeferred(Canvas &canvas) :
+    Scene(canvas, "deferred")
+{
+    priv_ = new SceneDeferredPrivate();
+
+    const ModelMap& modelMap = Model::find_models();
+    std::string optionValues;
+    for (ModelMap::const_iterator modelIt = modelMap.begin();
+         modelIt != modelMap.end();
+         modelIt++)
+    {
+        if (!optionValues.empty())
+            optionValues += ",";
+        optionValues += modelIt->first;
+    }
+
+    options_["model"] = Scene::Option("model", "cat", "Which model to use",
+                                      optionValues);
+    options_["attachments"] = Scene::Option("attachments", "3",
+                                            "The number of G-buffer color attachments",
+                                            "2,3,4");
+    options_["normals"] = Scene::Option("normals", "unpacked",
+                                        "How to store the normals in the G-buffer",
+                                        "packed,unpacked");
+    options_["format"] = Scene::Option("format", "rgba8",
+                                       "The format of the G-buffer color attachments",
+                                       "rgba8,rgba16f");
+    options_["lights"] = Scene::Option("lights", "32",
+                                       "The number of light volumes in the light pass");
+}
+
+SceneDeferred::~SceneDeferred()
+{
+    delete priv_;
+}
+
+bool
+SceneDeferred::supported(bool show_errors)
+{
+    /*
+     * The shaders use the same GLSL version as uniform blocks, and the
+     * G-buffer attachments are read back with texelFetch().
+     */
+    if (!require_capability(GLExtensions::UniformBufferObjects, show_errors) ||
+        !require_capability(GLExtensions::MultipleRenderTargets, show_errors) ||
+        !require_no_capture("multiple render targets", show_errors))
+    {
+        return false;
+    }
+
+    if (options_["format"].value == "rgba16f")
+        return require_capability(GLExtensions::HalfFloatRenderTargets, show_errors);
+
+    return true;
+}
+
+bool
+SceneDeferred::load()
+{
+    running_ = false;
+
+    return true;
+}
+
+void
+SceneDeferred::unload()
+{
+}
+
+/**
+ * Loads a program, upgrading its shaders to GLSL ES 3.00 (GLSL 1.40) and
+ * adding the G-buffer configuration defines.
+ */
+static bool
+load_deferred_program(Program &program, ShaderSource &vtx_source,
+                      ShaderSource &frg_source, const std::string &defines,
+                      unsigned int outputs)
+{
+    std::string vtx(UniformBlock::shader_header(ShaderSource::ShaderTypeVertex) +
+                    defines + vtx_source.str());
+    std::string frg(UniformBlock::shader_header(ShaderSource::ShaderTypeFragment, outputs) +
+                    defines + frg_source.str());
+
+    return Scene::load_shaders_from_strings(program, vtx, frg);
+}
+
+static void
+add_triangle(Mesh &mesh, const vec3 &a, const vec3 &b, const vec3 &c)
+{
+    const vec3 *v[] = {&a, &b, &c};
+
+    for (int i = 0; i < 3; i++) {
+        mesh.next_vertex();
+        mesh.set_attrib(0, *v[i]);
+    }
+}
+
+/**
+ * Creates a unit sphere for the light volumes, slightly enlarged so that
+ * its flat faces still enclose the actual sphere.
+ */
+static void
+create_sphere_mesh(Mesh &mesh)
+{
+    static const int slices = 12;
+    static const int stacks = 8;
+    const float scale = 1.0 / std::cos(M_PI / slices);
+
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    mesh.set_vertex_format(vertex_format);
+
+    for (int i = 0; i < stacks; i++) {
+        float theta0 = M_PI * i / stacks;
+        float theta1 = M_PI * (i + 1) / stacks;
+
+        for (int j = 0; j < slices; j++) {
+            float phi0 = 2.0 * M_PI * j / slices;
+            float phi1 = 2.0 * M_PI * (j + 1) / slices;
+
+            vec3 v00(std::sin(theta0) * std::cos(phi0), std::cos(theta0), std::sin(theta0) * std::sin(phi0));
+            vec3 v01(std::sin(theta0) * std::cos(phi1), std::cos(theta0), std::sin(theta0) * std::sin(phi1));
+            vec3 v10(std::sin(theta1) * std::cos(phi0), std::cos(theta1), std::sin(theta1) * std::sin(phi0));
+            vec3 v11(std::sin(theta1) * std::cos(phi1), std::cos(theta1), std::sin(theta1) * std::sin(phi1));
+
+            /* Counter-clockwise when seen from outside the sphere */
+            add_triangle(mesh, v00 * scale, v01 * scale, v10 * scale);
+            add_triangle(mesh, v01 * scale, v11 * scale, v10 * scale);
+        }
+    }
+
+    mesh.build_vbo();
+}
+
+bool
+SceneDeferred::setup_gbuffer()
+{
+    bool half_float = options_["format"].value == "rgba16f";
+    GLint internal_format = half_float ? GL_RGBA16F : GL_RGBA8;
+    GLenum type = half_float ? GL_HALF_FLOAT : GL_UNSIGNED_BYTE;
+    GLenum draw_buffers[4];
+
+    priv_->attachment_bytes = half_float ? 8 : 4;
+
+    glGenFramebuffers(1, &priv_->fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, priv_->fbo);
+
+    glGenTextures(priv_->attachments, priv_->textures);
+    glGenTextures(1, &priv_->depth_texture);
+
+    for (unsigned int i = 0; i <= priv_->attachments; i++) {
+        bool depth = i == priv_->attachments;
+        GLuint texture = depth ? priv_->depth_texture : priv_->textures[i];
+
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        if (depth) {
+            GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24,
+                                   canvas_.width(), canvas_.height(), 0,
+                                   GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                   GL_TEXTURE_2D, texture, 0);
+        }
+        else {
+            GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, internal_format,
+                                   canvas_.width(), canvas_.height(), 0,
+                                   GL_RGBA, type, 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i,
+                                   GL_TEXTURE_2D, texture, 0);
+            draw_buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+        }
+    }
+
+    GLExtensions::DrawBuffers(priv_->attachments, draw_buffers);
+
+    unsigned int status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        Log::error("SceneDeferred: glCheckFramebufferStatus failed (0x%x)\n", status);
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SceneDeferred::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    priv_->attachments = Util::fromString<unsigned int>(options_["attachments"].value);
+    unsigned int lights = Util::fromString<unsigned int>(options_["lights"].value);
+
+    /* Load the model */
+    Model model;
+    if (!model.load(options_["model"].value))
+        return false;
+
+    if (model.needNormals())
+        model.calculate_normals();
+
+    std::vector<std::pair<Model::AttribType, int> > attribs;
+    attribs.push_back(std::pair<Model::AttribType, int>(Model::AttribTypePosition, 3));
+    attribs.push_back(std::pair<Model::AttribType, int>(Model::AttribTypeNormal, 3));
+    model.convert_to_mesh(priv_->model_mesh, attribs);
+    priv_->model_mesh.build_vbo();
+
+    vec3 max_vec(model.maxVec());
+    vec3 min_vec(model.minVec());
+    priv_->center = (max_vec + min_vec) / 2.0;
+    float diameter = (max_vec - min_vec).length();
+    priv_->radius = diameter / 2.0;
+
+    float fovy = 2.0 * atanf(priv_->radius / (near_plane + priv_->radius)) * 180.0 / M_PI;
+    float aspect = static_cast<float>(canvas_.width()) / canvas_.height();
+    priv_->projection.setIdentity();
+    priv_->projection *= LibMatrix::Mat4::perspective(fovy, aspect, near_plane,
+                                                      near_plane + diameter);
+
+    /* Load the shaders */
+    std::stringstream defines;
+    defines << "#define GBUFFER_ATTACHMENTS " << priv_->attachments << std::endl;
+    if (options_["normals"].value == "packed")
+        defines << "#define PACKED_NORMALS" << std::endl;
+
+    ShaderSource gbuffer_vtx(GLMARK_DATA_PATH"/shaders/deferred-gbuffer.vert");
+    ShaderSource gbuffer_frg(GLMARK_DATA_PATH"/shaders/deferred-gbuffer.frag",
+                             ShaderSource::ShaderTypeFragment);
+    gbuffer_frg.add_const("ModelScale", 4.0f / priv_->radius);
+
+    ShaderSource ambient_vtx(GLMARK_DATA_PATH"/shaders/deferred-light.vert");
+    ShaderSource ambient_frg(GLMARK_DATA_PATH"/shaders/deferred-light.frag");
+    ShaderSource light_vtx(GLMARK_DATA_PATH"/shaders/deferred-light.vert");
+    ShaderSource light_frg(GLMARK_DATA_PATH"/shaders/deferred-light.frag");
+
+    if (!load_deferred_program(priv_->gbuffer_program, gbuffer_vtx, gbuffer_frg,
+                               defines.str(), priv_->attachments) ||
+        !load_deferred_program(priv_->ambient_program, ambient_vtx, ambient_frg,
+                               defines.str() + "#define AMBIENT_PASS\n", 1) ||
+        !load_deferred_program(priv_->light_program, light_vtx, light_frg,
+                               defines.str(), 1))
+    {
+        return false;
+    }
+
+    std::vector<GLint> attrib_locations;
+    attrib_locations.push_back(priv_->gbuffer_program["position"].location());
+    attrib_locations.push_back(priv_->gbuffer_program["normal"].location());
+    priv_->model_mesh.set_attrib_locations(attrib_locations);
+
+    /* A single quad covering the screen */
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    priv_->quad_mesh.set_vertex_format(vertex_format);
+    priv_->quad_mesh.make_grid(1, 1, 2.0, 2.0, 0.0);
+    priv_->quad_mesh.build_vbo();
+    attrib_locations.clear();
+    attrib_locations.push_back(priv_->ambient_program["position"].location());
+    priv_->quad_mesh.set_attrib_locations(attrib_locations);
+
+    create_sphere_mesh(priv_->sphere_mesh);
+    attrib_locations.clear();
+    attrib_locations.push_back(priv_->light_program["position"].location());
+    priv_->sphere_mesh.set_attrib_locations(attrib_locations);
+
+    /* The G-buffer textures use units 0-3, and the depth unit 4 */
+    mat4 inverse_projection(priv_->projection);
+    inverse_projection.inverse();
+
+    Program *light_programs[] = {&priv_->ambient_program, &priv_->light_program};
+    for (int i = 0; i < 2; i++) {
+        Program &program(*light_programs[i]);
+        program.start();
+        program["GBuffer0"] = 0;
+        program["GBuffer1"] = 1;
+        program["GBuffer2"] = 2;
+        program["GBuffer3"] = 3;
+        program["GBufferDepth"] = 4;
+        program["ProjectionMatrix"] = priv_->projection;
+        program["InverseProjectionMatrix"] = inverse_projection;
+        program["ScreenSize"] = LibMatrix::vec2(canvas_.width(), canvas_.height());
+        program.stop();
+    }
+
+    if (!setup_gbuffer())
+        return false;
+
+    /* Place the lights on orbits around the model */
+    priv_->light_range = priv_->radius * 0.6;
+    priv_->light_orbits.clear();
+    priv_->light_colors.clear();
+    for (unsigned int i = 0; i < lights; i++) {
+        float f = static_cast<float>(i) / lights;
+        priv_->light_orbits.push_back(vec4(priv_->radius * (0.6 + 0.5 * std::fmod(f * 7.0, 1.0)),
+                                           priv_->radius * (std::fmod(f * 13.0, 1.6) - 0.8),
+                                           2.0 * M_PI * std::fmod(f * 3.0, 1.0),
+                                           0.5 + std::fmod(f * 5.0, 1.0)));
+
+        float hue = 2.0 * M_PI * f;
+        priv_->light_colors.push_back(vec3(0.5 + 0.5 * std::cos(hue),
+                                           0.5 + 0.5 * std::cos(hue - 2.0 * M_PI / 3.0),
+                                           0.5 + 0.5 * std::cos(hue + 2.0 * M_PI / 3.0)));
+    }
+
+    priv_->time_gpu = gpu_timing() &&
+                      priv_->geometry_timer.init() &&
+                      priv_->lighting_timer.init();
+    priv_->bytes_written = 0.0;
+    priv_->bytes_read = 0.0;
+    priv_->frames = 0;
+    priv_->rotation = 0.0;
+
+    currentFrame_ = 0;
+    running_ = true;
+    startTime_ = Util::get_timestamp_us() / 1000000.0;
+    lastUpdateTime_ = startTime_;
+
+    return true;
+}
+
+void
+SceneDeferred::teardown()
+{
+    priv_->gbuffer_program.release();
+    priv_->ambient_program.release();
+    priv_->light_program.release();
+    priv_->model_mesh.reset();
+    priv_->quad_mesh.reset();
+    priv_->sphere_mesh.reset();
+
+    if (priv_->fbo) {
+        glDeleteFramebuffers(1, &priv_->fbo);
+        priv_->fbo = 0;
+    }
+    if (priv_->attachments) {
+        GLMemory::delete_textures(priv_->attachments, priv_->textures);
+        GLMemory::delete_textures(1, &priv_->depth_texture);
+        priv_->depth_texture = 0;
+        priv_->attachments = 0;
+    }
+
+    priv_->geometry_timer.release();
+    priv_->lighting_timer.release();
+
+    Scene::teardown();
+}
+
+void
+SceneDeferred::update()
+{
+    Scene::update();
+
+    double elapsed_time = lastUpdateTime_ - startTime_;
+
+    priv_->rotation = 36.0 * elapsed_time;
+}
+
+void
+SceneDeferred::draw()
+{
+    SceneDeferredPrivate &p(*priv_);
+    double elapsed_time = lastUpdateTime_ - startTime_;
+    double pixels = static_cast<double>(canvas_.width()) * canvas_.height();
+
+    /* Geometry pass: write the G-buffer */
+    LibMatrix::Stack4 model_view;
+    model_view.translate(-p.center.x(), -p.center.y(),
+                         -(p.center.z() + near_plane + p.radius));
+    model_view.rotate(p.rotation, 0.0f, 1.0f, 0.0f);
+
+    mat4 model_view_proj(p.projection);
+    model_view_proj *= model_view.getCurrent();
+    mat4 normal_matrix(model_view.getCurrent());
+    normal_matrix.inverse().transpose();
+
+    if (p.time_gpu)
+        p.geometry_timer.begin();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, p.fbo);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    p.gbuffer_program.start();
+    p.gbuffer_program["ModelViewProjectionMatrix"] = model_view_proj;
+    p.gbuffer_program["NormalMatrix"] = normal_matrix;
+    p.model_mesh.render_vbo();
+    p.gbuffer_program.stop();
+
+    if (p.time_gpu)
+        p.geometry_timer.end();
+
+    /* Light pass: accumulate the ambient term and the light volumes */
+    if (p.time_gpu)
+        p.lighting_timer.begin();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+
+    for (unsigned int i = 0; i < p.attachments; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, p.textures[i]);
+    }
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, p.depth_texture);
+    glActiveTexture(GL_TEXTURE0);
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+
+    p.ambient_program.start();
+    p.quad_mesh.render_vbo();
+    p.ambient_program.stop();
+
+    /* Draw the back faces, which are visible even from inside a volume */
+    glCullFace(GL_FRONT);
+
+    float center_z = -(near_plane + p.radius);
+    float half_height = canvas_.height() / 2.0;
+    double light_pixels = 0.0;
+
+    p.light_program.start();
+
+    for (unsigned int i = 0; i < p.light_orbits.size(); i++) {
+        const vec4 &orbit(p.light_orbits[i]);
+        float angle = orbit.z() + orbit.w() * elapsed_time;
+        vec4 sphere(orbit.x() * std::cos(angle), orbit.y(),
+                    center_z + orbit.x() * std::sin(angle), p.light_range);
+
+        p.light_program["LightSphere"] = sphere;
+        p.light_program["LightColor"] = p.light_colors[i];
+        p.sphere_mesh.render_vbo();
+
+        /* Estimate the pixels covered by the volume from its projection */
+        float depth = std::max(-sphere.z() - sphere.w(), near_plane);
+        float radius_pixels = p.projection[1][1] * sphere.w() / depth * half_height;
+        light_pixels += std::min(M_PI * radius_pixels * radius_pixels, pixels);
+    }
+
+    p.light_program.stop();
+
+    glCullFace(GL_BACK);
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+
+    if (p.time_gpu)
+        p.lighting_timer.end();
+
+    /*
+     * Estimate the G-buffer traffic: the geometry pass stores all the
+     * attachments and the depth, the ambient pass reads all of them, and
+     * the light volumes read the first three attachments and the depth for
+     * the pixels they cover.  Blending the light pass output reads and
+     * writes the framebuffer.
+     */
+    double gbuffer_bytes = p.attachments * p.attachment_bytes + 4.0;
+    double light_bytes = std::min(p.attachments, 3u) * p.attachment_bytes + 4.0;
+
+    p.bytes_written += pixels * gbuffer_bytes + (pixels + light_pixels) * 4.0;
+    p.bytes_read += pixels * gbuffer_bytes + light_pixels * (light_bytes + 4.0);
+    p.frames++;
+}
+
+std::string
+SceneDeferred::result_extras()
+{
+    static const double MiB = 1024.0 * 1024.0;
+    SceneDeferredPrivate &p(*priv_);
+
+    if (p.frames == 0)
+        return "";
+
+    std::stringstream ss;
+    ss.precision(3);
+    ss << std::fixed;
+
+    if (p.time_gpu && p.geometry_timer.average_ms() >= 0.0 &&
+        p.lighting_timer.average_ms() >= 0.0)
+    {
+        ss << " Geometry: " << p.geometry_timer.average_ms() << " ms"
+           << " Lighting: " << p.lighting_timer.average_ms() << " ms";
+    }
+
+    ss.precision(1);
+    ss << " Written: " << p.bytes_written / p.frames / MiB << " MiB/frame"
+       << " Read: " << p.bytes_read / p.frames / MiB << " MiB/frame";
+
+    return ss.str();
+}
@@ -32,6 +32,8 @@
 #include "shader-source.h"
 #include "util.h"
 #include "texture.h"
+#include "gl-memory.h"
+#include "render-graph.h"
 
 enum BlurDirection {
     BlurDirectionHorizontal,
@@ -39,11 +41,66 @@ enum BlurDirection {
     BlurDirectionBoth
 };
 
+/*
+ * Whether quads get their vertices from a uniform block (uniforms=ubo),
+ * instead of from client-side vertex arrays.
+ */
+static bool use_quad_block = false;
+
+static UniformBlock
+create_quad_block()
+{
+    UniformBlock block("Quad", 0);
+    /* The position in xy and the texture coordinates in zw */
+    block.add("QuadVertices", UniformBlock::TypeVec4, 4);
+    return block;
+}
+
+static UniformBlock quad_block(create_quad_block());
+static UniformBufferRing quad_ring;
+
+static const char *
+quad_vertex_shader()
+{
+    if (use_quad_block)
+        return GLMARK_DATA_PATH"/shaders/desktop-ubo.vert";
+
+    return GLMARK_DATA_PATH"/shaders/desktop.vert";
+}
+
+static bool
+load_quad_program(Program &program, ShaderSource &vtx_source,
+                  ShaderSource &frg_source)
+{
+    if (!use_quad_block) {
+        return Scene::load_shaders_from_strings(program, vtx_source.str(),
+                                                frg_source.str());
+    }
+
+    quad_block.declare(vtx_source);
+
+    std::string vtx_header(UniformBlock::shader_header(ShaderSource::ShaderTypeVertex));
+    std::string frg_header(UniformBlock::shader_header(ShaderSource::ShaderTypeFragment));
+
+    if (!Scene::load_shaders_from_strings(program, vtx_header + vtx_source.str(),
+                                          frg_header + frg_source.str()))
+    {
+        return false;
+    }
+
+    if (!quad_block.bind(program)) {
+        Log::error("SceneDesktop: the program has no quad uniform block\n");
+        return false;
+    }
+
+    return true;
+}
+
 static void
 create_blur_shaders(ShaderSource& vtx_source, ShaderSource& frg_source,
                     unsigned int radius, float sigma, BlurDirection direction)
 {
-    vtx_source.append_file(GLMARK_DATA_PATH"/shaders/desktop.vert");
+    vtx_source.append_file(quad_vertex_shader());
     frg_source.append_file(GLMARK_DATA_PATH"/shaders/desktop-blur.frag");
 
     /* Don't let the gaussian curve become too narrow */
@@ -107,13 +164,40 @@ class RenderObject
 {
 public:
     RenderObject() :
-        texture_(0), fbo_(0), rotation_rad_(0),
-        texture_contents_invalid_(true) { }
+        texture_(0), fbo_(0), owns_target_(true), graph_(0), graph_pass_(0),
+        rotation_rad_(0), texture_contents_invalid_(true) { }
 
     virtual ~RenderObject() {}
 
+    /**
+     * Renders to a target of a render graph instead of creating a texture
+     * and FBO of its own.  Must be called before init().
+     */
+    void use_target(RenderGraph &graph, unsigned int target)
+    {
+        texture_ = graph.texture(target);
+        fbo_ = graph.fbo(target);
+        owns_target_ = false;
+    }
+
+    /**
+     * Sets the pass of a render graph that renders to this object.
+     */
+    void schedule(RenderGraph &graph, unsigned int pass)
+    {
+        graph_ = &graph;
+        graph_pass_ = pass;
+    }
+
     virtual void init()
     {
+        texture_contents_invalid_ = true;
+
+        if (!owns_target_) {
+            init_program();
+            return;
+        }
+
         /* Create a texture to draw to */
         glGenTextures(1, &texture_);
         glBindTexture(GL_TEXTURE_2D, texture_);
@@ -134,8 +218,8 @@ public:
          * at draw time.
          */ 
         if (size_.x() != 0 && size_.y() != 0) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size_.x(), size_.y(), 0,
-                         GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_RGBA, size_.x(), size_.y(), 0,
+                                   GL_RGBA, GL_UNSIGNED_BYTE, 0);
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
                                    GL_TEXTURE_2D, texture_, 0);
             unsigned int status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
@@ -146,31 +230,24 @@ public:
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        /* Load the shader program when this class if first used */
-        if (RenderObject::use_count == 0) {
-            ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/desktop.vert");
-            ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/desktop.frag");
-            Scene::load_shaders_from_strings(main_program, vtx_source.str(),
-                                             frg_source.str());
-        }
-
-        texture_contents_invalid_ = true;
-        RenderObject::use_count++;
+        init_program();
     }
 
     virtual void release()
     {
         /* Release resources */
-        if (texture_ != 0)
+        if (texture_ != 0 && owns_target_)
         {
-            glDeleteTextures(1, &texture_);
-            texture_ = 0;
+            GLMemory::delete_textures(1, &texture_);
         }
-        if (fbo_ != 0)
+        if (fbo_ != 0 && owns_target_)
         {
             glDeleteFramebuffers(1, &fbo_);
-            fbo_ = 0;
         }
+        texture_ = 0;
+        fbo_ = 0;
+        owns_target_ = true;
+        graph_ = 0;
 
         /*
          * Release the shader program when object of this class
@@ -193,13 +270,17 @@ public:
 
     virtual void size(const LibMatrix::vec2& size)
     {
+        /* A render graph target already has the correct size */
+        if (!owns_target_)
+            size_ = size;
+
         /* Recreate the backing texture with correct size */
         if (size_.x() != size.x() || size_.y() != size.y()) {
             size_ = size;
             /* If we're resizing the texture, we need to tell the framebuffer*/
             glBindTexture(GL_TEXTURE_2D, texture_);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size_.x(), size_.y(), 0,
-                         GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_RGBA, size_.x(), size_.y(), 0,
+                                   GL_RGBA, GL_UNSIGNED_BYTE, 0);
             glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
                                    GL_TEXTURE_2D, texture_, 0);
@@ -226,6 +307,7 @@ public:
     virtual void clear()
     {
         make_current();
+        begin_pass();
         glClear(GL_COLOR_BUFFER_BIT);
     }
 
@@ -319,9 +401,36 @@ public:
     }
 
 protected:
+    /**
+     * Marks the start of the render graph pass of this object, if any.
+     * The object must be the current rendering target.
+     */
+    void begin_pass()
+    {
+        if (graph_)
+            graph_->begin_pass(graph_pass_);
+    }
+
     void draw_quad_with_program(const GLfloat *position, const GLfloat *texcoord,
                                 Program &program)
     {
+        if (use_quad_block) {
+            for (int i = 0; i < 4; i++) {
+                quad_block.set(0, LibMatrix::vec4(position[2 * i], position[2 * i + 1],
+                                                  texcoord[2 * i], texcoord[2 * i + 1]),
+                               i);
+            }
+
+            GLintptr offset = quad_ring.push(quad_block);
+            quad_ring.flush();
+
+            program.start();
+            quad_ring.bind(quad_block, offset);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            program.stop();
+            return;
+        }
+
         int pos_index = program["position"].location();
         int tex_index = program["texcoord"].location();
 
@@ -349,8 +458,23 @@ protected:
     LibMatrix::vec2 speed_;
     GLuint texture_;
     GLuint fbo_;
+    bool owns_target_;
+    RenderGraph *graph_;
+    unsigned int graph_pass_;
 
 private:
+    void init_program()
+    {
+        /* Load the shader program when this class if first used */
+        if (RenderObject::use_count == 0) {
+            ShaderSource vtx_source(quad_vertex_shader());
+            ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/desktop.frag");
+            load_quad_program(main_program, vtx_source, frg_source);
+        }
+
+        RenderObject::use_count++;
+    }
+
     float rotate_x(float x, float y)
     {
         return x * cos(rotation_rad_) - y * sin(rotation_rad_);
@@ -408,7 +532,7 @@ public:
 
     virtual void release()
     {
-        glDeleteTextures(1, &background_texture_);
+        GLMemory::delete_textures(1, &background_texture_);
         background_texture_ = 0;
 
         RenderObject::release();
@@ -430,6 +554,7 @@ public:
         };
 
         make_current();
+        begin_pass();
         glClear(GL_COLOR_BUFFER_BIT);
 
         glActiveTexture(GL_TEXTURE0);
@@ -488,6 +613,10 @@ public:
 
     virtual void render_to(RenderObject& target)
     {
+        /* The blurred copy of the target is only needed within this pass */
+        make_current();
+        begin_pass();
+
         if (separable_) {
             Program& blur_program_h1 = blur_program_h(target.size().x());
             Program& blur_program_v1 = blur_program_v(target.size().y());
@@ -549,8 +678,7 @@ private:
                                 radius_ / 3.0, BlurDirectionBoth);
             frg_source.add_const("TextureStepX", 1.0 / w);
             frg_source.add_const("TextureStepY", 1.0 / h);
-            Scene::load_shaders_from_strings(blur_program_, vtx_source.str(),
-                                             frg_source.str());
+            load_quad_program(blur_program_, vtx_source, frg_source);
         }
 
         return blur_program_;
@@ -574,8 +702,7 @@ private:
             create_blur_shaders(vtx_source, frg_source, radius_,
                                 radius_ / 3.0, BlurDirectionHorizontal);
             frg_source.add_const("TextureStepX", 1.0 / w);
-            Scene::load_shaders_from_strings(blur_program_h_, vtx_source.str(),
-                                             frg_source.str());
+            load_quad_program(blur_program_h_, vtx_source, frg_source);
         }
 
         return blur_program_h_;
@@ -599,8 +726,7 @@ private:
             create_blur_shaders(vtx_source, frg_source, radius_,
                                 radius_ / 3.0, BlurDirectionVertical);
             frg_source.add_const("TextureStepY", 1.0 / h);
-            Scene::load_shaders_from_strings(blur_program_v_, vtx_source.str(),
-                                             frg_source.str());
+            load_quad_program(blur_program_v_, vtx_source, frg_source);
         }
 
         return blur_program_v_;
@@ -768,6 +894,7 @@ struct SceneDesktopPrivate
     RenderScreen screen;
     RenderClearImage desktop;
     std::vector<RenderObject *> windows;
+    RenderGraph graph;
 
     SceneDesktopPrivate(Canvas &canvas) :
         screen(canvas), desktop("effect-2d") {}
@@ -796,6 +923,15 @@ SceneDesktop::SceneDesktop(Canvas &canvas) :
                                           "false,true");
     options_["shadow-size"] = Scene::Option("shadow-size", "20",
                                             "the size of the shadow (in pixels)");
+    options_["uniforms"] = Scene::Option("uniforms", "classic",
+                                         "How to pass the per-draw quad vertices",
+                                         "classic,ubo");
+    options_["alias"] = Scene::Option("alias", "true",
+                                      "Share the window render targets between windows",
+                                      "false,true");
+    options_["invalidate"] = Scene::Option("invalidate", "false",
+                                           "Invalidate render target contents that are not needed",
+                                           "false,true");
 }
 
 SceneDesktop::~SceneDesktop()
@@ -803,6 +939,24 @@ SceneDesktop::~SceneDesktop()
     delete priv_;
 }
 
+bool
+SceneDesktop::supported(bool show_errors)
+{
+    if (options_["uniforms"].value == "ubo" &&
+        (!require_capability(GLExtensions::UniformBufferObjects, show_errors) ||
+         !require_no_capture("uniform buffers", show_errors)))
+    {
+        return false;
+    }
+
+    if (options_["invalidate"].value == "true") {
+        return require_capability(GLExtensions::FramebufferInvalidation, show_errors) &&
+               require_no_capture("framebuffer invalidation", show_errors);
+    }
+
+    return true;
+}
+
 bool
 SceneDesktop::load()
 {
@@ -842,18 +996,59 @@ SceneDesktop::setup()
     glDisable(GL_DEPTH_TEST);
     glDepthMask(GL_FALSE);
 
+    /*
+     * Each window draws a few quads per effect pass, plus a few more for
+     * the window itself and its shadow.
+     */
+    use_quad_block = options_["uniforms"].value == "ubo";
+    if (use_quad_block && !quad_ring.init(quad_block, windows * (2 * passes + 6) + 2))
+        return false;
+
+    const float angular_step(2.0 * M_PI / windows);
+    unsigned int min_dimension = std::min(canvas_.width(), canvas_.height());
+    float window_size(min_dimension * window_size_factor);
+    static const LibMatrix::vec2 corner_offset(window_size / 2.0,
+                                               window_size / 2.0);
+
+    /*
+     * Declare the render targets and passes of a frame.  Each blur window
+     * renders a blurred copy of the desktop beneath it to a target of its
+     * own, and blends it back to the desktop in the same pass.
+     */
+    bool blur = options_["effect"].value != "shadow";
+    RenderGraph &graph(priv_->graph);
+    unsigned int desktop_target = graph.add_target(canvas_.width(), canvas_.height(),
+                                                   GL_RGBA, false);
+    unsigned int clear_pass = graph.add_pass(desktop_target);
+    std::vector<unsigned int> window_targets;
+    std::vector<unsigned int> window_passes;
+
+    for (unsigned int i = 0; i < windows && blur; i++) {
+        window_targets.push_back(graph.add_target(window_size, window_size,
+                                                  GL_RGBA, false));
+        window_passes.push_back(graph.add_pass(window_targets.back()));
+        graph.add_input(window_passes.back(), desktop_target);
+    }
+
+    unsigned int screen_pass = graph.add_pass(RenderGraph::screen);
+    graph.add_input(screen_pass, desktop_target);
+
+    if (!graph.compile(options_["alias"].value == "true",
+                       options_["invalidate"].value == "true"))
+    {
+        graph.release();
+        return false;
+    }
+
     /* Set up the screen and desktop RenderObjects */
+    priv_->desktop.use_target(graph, desktop_target);
+    priv_->desktop.schedule(graph, clear_pass);
     priv_->screen.init();
     priv_->desktop.init();
     priv_->screen.size(LibMatrix::vec2(canvas_.width(), canvas_.height()));
     priv_->desktop.size(LibMatrix::vec2(canvas_.width(), canvas_.height()));
 
     /* Create the windows */
-    const float angular_step(2.0 * M_PI / windows);
-    unsigned int min_dimension = std::min(canvas_.width(), canvas_.height());
-    float window_size(min_dimension * window_size_factor);
-    static const LibMatrix::vec2 corner_offset(window_size / 2.0,
-                                               window_size / 2.0);
 
     for (unsigned int i = 0; i < windows; i++) {
         LibMatrix::vec2 center(canvas_.width() * (0.5 + 0.25 * cos(i * angular_step)),
@@ -864,6 +1059,10 @@ SceneDesktop::setup()
         else
             win = new RenderWindowBlur(passes, blur_radius, separable);
 
+        if (blur) {
+            win->use_target(graph, window_targets[i]);
+            win->schedule(graph, window_passes[i]);
+        }
         win->init();
         win->position(center - corner_offset);
         win->size(LibMatrix::vec2(window_size, window_size));
@@ -914,6 +1113,10 @@ SceneDesktop::teardown()
 
     priv_->desktop.release();
     priv_->screen.release();
+    priv_->graph.release();
+
+    quad_ring.release();
+    use_quad_block = false;
 
     Scene::teardown();
 }
@@ -969,6 +1172,9 @@ SceneDesktop::draw()
     /* Ensure we get a transparent clear color for all following operations */
     glClearColor(0.0, 0.0, 0.0, 0.0);
 
+    if (use_quad_block)
+        quad_ring.begin_frame();
+
     priv_->desktop.clear();
 
     for (std::vector<RenderObject *>::const_iterator iter = windows.begin();
@@ -983,6 +1189,12 @@ SceneDesktop::draw()
 
 }
 
+std::string
+SceneDesktop::result_extras()
+{
+    return priv_->graph.memory_summary();
+}
+
 Scene::ValidationResult
 SceneDesktop::validate()
 {
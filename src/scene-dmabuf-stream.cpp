@@ -0,0 +1,704 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "log.h"
+#include "util.h"
+#include "dma-buf.h"
+#include "gl-memory.h"
+#include "gl-state.h"
+#include "shader-source.h"
+
+#include <pthread.h>
+#include <sstream>
+
+/* The layout of a frame in one of the streamed formats */
+struct DmabufStreamLayout
+{
+    unsigned int fourcc;
+    unsigned int planes;
+    unsigned int offsets[3];
+    unsigned int pitches[3];
+    unsigned int widths[3];
+    unsigned int heights[3];
+    /* The bytes per pixel of each plane, to upload it with */
+    unsigned int pixel_bytes[3];
+    size_t size;
+};
+
+/*
+ * A buffer of the ring.  A buffer goes from Free to Filling and Filled,
+ * wherever it is filled, to InUse while the render thread draws from it and
+ * to Retired until the fence after that draw signals.  Buffers are filled
+ * and drawn in ring order.
+ */
+struct DmabufStreamBuffer
+{
+    enum State {
+        StateFree,
+        StateFilling,
+        StateFilled,
+        StateInUse,
+        StateRetired
+    };
+
+    DmaBuf dma_buf;
+    std::vector<unsigned char> memory;
+    unsigned char *data;
+    GLImage *image;
+    GLuint texture;
+    GLsync fence;
+    State state;
+    unsigned int frame;
+
+    DmabufStreamBuffer() :
+        data(0), image(0), texture(0), fence(0), state(StateFree), frame(0) {}
+};
+
+struct SceneDmabufStreamPrivate
+{
+    Program program;
+    Mesh mesh;
+    DmabufStreamLayout layout;
+    unsigned int width;
+    unsigned int height;
+    bool use_dma_buf;
+    bool reimport;
+    bool fill_thread;
+
+    std::vector<DmabufStreamBuffer *> buffers;
+    /* The plane textures of the upload path, and their formats */
+    GLuint upload_textures[3];
+    GLenum upload_formats[3];
+    unsigned int next;
+
+    pthread_t producer;
+    bool producer_started;
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    bool stop;
+
+    /* Statistics; fill_us is protected by the mutex when a thread fills */
+    uint64_t imports;
+    uint64_t import_us;
+    uint64_t fills;
+    uint64_t fill_us;
+    uint64_t upload_us;
+    uint64_t stall_us;
+    unsigned int frames;
+    uint64_t start_time;
+    uint64_t end_time;
+
+    SceneDmabufStreamPrivate() :
+        width(0), height(0), use_dma_buf(true), reimport(false),
+        fill_thread(false), next(0), producer_started(false), stop(false),
+        imports(0), import_us(0), fills(0), fill_us(0), upload_us(0),
+        stall_us(0), frames(0), start_time(0), end_time(0)
+    {
+        upload_textures[0] = upload_textures[1] = upload_textures[2] = 0;
+        upload_formats[0] = upload_formats[1] = upload_formats[2] = GL_NONE;
+        pthread_mutex_init(&mutex, 0);
+        pthread_cond_init(&changed, 0);
+    }
+
+    ~SceneDmabufStreamPrivate()
+    {
+        pthread_cond_destroy(&changed);
+        pthread_mutex_destroy(&mutex);
+    }
+};
+
+SceneDmabufStream::SceneDmabufStream(Canvas &canvas) :
+    Scene(canvas, "dmabuf-stream")
+{
+    priv_ = new SceneDmabufStreamPrivate();
+
+    options_["path"] = Scene::Option("path", "dma-buf",
+                                     "How the frames reach the GPU (dma-buf: EGLImage import, upload: glTexSubImage2D)",
+                                     "dma-buf,upload");
+    options_["format"] = Scene::Option("format", "rgba",
+                                       "The format of the frames",
+                                       "rgba,nv12,yuv420");
+    options_["frame-width"] = Scene::Option("frame-width", "1280",
+                                            "The width of the frames, in pixels");
+    options_["frame-height"] = Scene::Option("frame-height", "720",
+                                             "The height of the frames, in pixels");
+    options_["buffers"] = Scene::Option("buffers", "3",
+                                        "The number of buffers in the ring");
+    options_["fill"] = Scene::Option("fill", "render",
+                                     "The thread that fills the frames with the CPU",
+                                     "render,thread");
+    options_["reimport"] = Scene::Option("reimport", "false",
+                                         "Whether to import the dma-buf of each frame again, instead of once per buffer",
+                                         "false,true");
+}
+
+SceneDmabufStream::~SceneDmabufStream()
+{
+    delete priv_;
+}
+
+bool
+SceneDmabufStream::supported(bool show_errors)
+{
+    if (!require_capability(GLExtensions::SyncObjects, show_errors) ||
+        !require_no_capture("sync objects", show_errors))
+    {
+        return false;
+    }
+
+    if (options_["path"].value != "dma-buf")
+        return true;
+
+    if (!GLExtensions::support("GL_OES_EGL_image_external")) {
+        if (show_errors) {
+            Log::error("SceneDmabufStream: GL_OES_EGL_image_external is not supported\n");
+        }
+        return false;
+    }
+
+    if (!DmaBuf::available()) {
+        if (show_errors) {
+            Log::error("SceneDmabufStream: dma-bufs cannot be allocated (is /dev/udmabuf accessible?)\n");
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SceneDmabufStream::load()
+{
+    running_ = false;
+
+    return true;
+}
+
+void
+SceneDmabufStream::unload()
+{
+}
+
+/**
+ * Computes the layout of a frame with tightly packed planes.
+ */
+static bool
+compute_layout(const std::string &format, unsigned int width, unsigned int height,
+               DmabufStreamLayout &layout)
+{
+    if (format == "rgba") {
+        layout.fourcc = DmaBuf::FourccABGR8888;
+        layout.planes = 1;
+        layout.widths[0] = width;
+        layout.heights[0] = height;
+        layout.pixel_bytes[0] = 4;
+    }
+    else if (width % 2 || height % 2) {
+        Log::error("SceneDmabufStream: YUV frames need an even width and height\n");
+        return false;
+    }
+    else if (format == "nv12") {
+        layout.fourcc = DmaBuf::FourccNV12;
+        layout.planes = 2;
+        layout.widths[0] = width;
+        layout.heights[0] = height;
+        layout.pixel_bytes[0] = 1;
+        layout.widths[1] = width / 2;
+        layout.heights[1] = height / 2;
+        layout.pixel_bytes[1] = 2;
+    }
+    else {
+        layout.fourcc = DmaBuf::FourccYUV420;
+        layout.planes = 3;
+        for (unsigned int i = 0; i < 3; i++) {
+            layout.widths[i] = i == 0 ? width : width / 2;
+            layout.heights[i] = i == 0 ? height : height / 2;
+            layout.pixel_bytes[i] = 1;
+        }
+    }
+
+    layout.size = 0;
+    for (unsigned int i = 0; i < layout.planes; i++) {
+        layout.offsets[i] = layout.size;
+        layout.pitches[i] = layout.widths[i] * layout.pixel_bytes[i];
+        layout.size += layout.pitches[i] * layout.heights[i];
+    }
+
+    return true;
+}
+
+/**
+ * Fills a frame with a pattern that moves from frame to frame, touching
+ * every byte like a decoder or camera would.
+ */
+static void
+fill_frame(const DmabufStreamLayout &layout, unsigned char *data, unsigned int frame)
+{
+    for (unsigned int i = 0; i < layout.planes; i++) {
+        unsigned int row_bytes = layout.widths[i] * layout.pixel_bytes[i];
+
+        for (unsigned int y = 0; y < layout.heights[i]; y++) {
+            unsigned char *row = data + layout.offsets[i] + y * layout.pitches[i];
+            unsigned char base = (y + frame * 2) * (i + 1);
+
+            for (unsigned int x = 0; x < row_bytes; x++)
+                row[x] = base + x;
+        }
+    }
+}
+
+static void
+fill_buffer(SceneDmabufStreamPrivate &p, DmabufStreamBuffer &buffer)
+{
+    if (p.use_dma_buf)
+        buffer.dma_buf.begin_cpu_access();
+
+    fill_frame(p.layout, buffer.data, buffer.frame);
+
+    if (p.use_dma_buf)
+        buffer.dma_buf.end_cpu_access();
+}
+
+/**
+ * The producer thread of fill=thread, which fills the free buffers in ring
+ * order without any GL context.
+ */
+static void *
+produce_frames(void *arg)
+{
+    SceneDmabufStreamPrivate &p(*static_cast<SceneDmabufStreamPrivate *>(arg));
+    unsigned int index = 0;
+    unsigned int frame = 0;
+
+    pthread_mutex_lock(&p.mutex);
+
+    while (!p.stop) {
+        DmabufStreamBuffer &buffer(*p.buffers[index]);
+
+        if (buffer.state != DmabufStreamBuffer::StateFree) {
+            pthread_cond_wait(&p.changed, &p.mutex);
+            continue;
+        }
+
+        buffer.state = DmabufStreamBuffer::StateFilling;
+        buffer.frame = frame++;
+        pthread_mutex_unlock(&p.mutex);
+
+        uint64_t before = Util::get_timestamp_us();
+        fill_buffer(p, buffer);
+        uint64_t after = Util::get_timestamp_us();
+
+        pthread_mutex_lock(&p.mutex);
+        buffer.state = DmabufStreamBuffer::StateFilled;
+        p.fill_us += after - before;
+        p.fills++;
+        pthread_cond_broadcast(&p.changed);
+
+        index = (index + 1) % p.buffers.size();
+    }
+
+    pthread_mutex_unlock(&p.mutex);
+
+    return 0;
+}
+
+/**
+ * Imports the dma-buf of a buffer and binds it to the buffer texture.
+ */
+static bool
+import_buffer(SceneDmabufStreamPrivate &p, Canvas &canvas, DmabufStreamBuffer &buffer)
+{
+    GLDmaBuf buf;
+    buf.width = p.width;
+    buf.height = p.height;
+    buf.fourcc = p.layout.fourcc;
+    buf.planes = p.layout.planes;
+    for (unsigned int i = 0; i < buf.planes; i++) {
+        buf.fds[i] = buffer.dma_buf.fd();
+        buf.offsets[i] = p.layout.offsets[i];
+        buf.pitches[i] = p.layout.pitches[i];
+    }
+
+    uint64_t before = Util::get_timestamp_us();
+
+    delete buffer.image;
+    buffer.image = canvas.import_dma_buf(buf);
+    if (!buffer.image)
+        return false;
+
+    glBindTexture(GL_TEXTURE_EXTERNAL_OES, buffer.texture);
+    buffer.image->bind(GL_TEXTURE_EXTERNAL_OES);
+
+    p.import_us += Util::get_timestamp_us() - before;
+    p.imports++;
+
+    return true;
+}
+
+bool
+SceneDmabufStream::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    SceneDmabufStreamPrivate &p(*priv_);
+
+    p.width = Util::fromString<unsigned int>(options_["frame-width"].value);
+    p.height = Util::fromString<unsigned int>(options_["frame-height"].value);
+    unsigned int buffers = Util::fromString<unsigned int>(options_["buffers"].value);
+    const std::string &format(options_["format"].value);
+
+    if (p.width == 0 || p.height == 0) {
+        Log::error("SceneDmabufStream: the frames must not be empty\n");
+        return false;
+    }
+
+    if (buffers < 2) {
+        Log::error("SceneDmabufStream: the ring needs at least 2 buffers\n");
+        return false;
+    }
+
+    if (!compute_layout(format, p.width, p.height, p.layout))
+        return false;
+
+    p.use_dma_buf = options_["path"].value == "dma-buf";
+    p.reimport = options_["reimport"].value == "true";
+    p.fill_thread = options_["fill"].value == "thread";
+
+    /*
+     * The dma-buf path samples the imported frame directly, converting
+     * YUV in the sampler; the upload path converts in the shader, as
+     * applications without EGLImage support do.
+     */
+    std::stringstream defines;
+    if (p.use_dma_buf) {
+        defines << "#extension GL_OES_EGL_image_external : require" << std::endl;
+        defines << "#define EXTERNAL" << std::endl;
+    }
+    else if (format == "nv12") {
+        defines << "#define FORMAT_NV12" << std::endl;
+        /* Core contexts have no luminance formats, see below */
+        if (GLExtensions::core_profile)
+            defines << "#define RG_PLANES" << std::endl;
+    }
+    else if (format == "yuv420") {
+        defines << "#define FORMAT_YUV420" << std::endl;
+    }
+
+    ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/dmabuf-stream.vert");
+    ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/dmabuf-stream.frag");
+
+    if (!Scene::load_shaders_from_strings(p.program, vtx_source.str(),
+                                          defines.str() + frg_source.str()))
+    {
+        return false;
+    }
+
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    p.mesh.set_vertex_format(vertex_format);
+    p.mesh.make_grid(1, 1, 2.0, 2.0, 0.0);
+    p.mesh.build_vbo();
+    p.mesh.set_attrib_locations(std::vector<int>(1, p.program["position"].location()));
+
+    p.imports = 0;
+    p.import_us = 0;
+
+    for (unsigned int i = 0; i < buffers; i++) {
+        p.buffers.push_back(new DmabufStreamBuffer());
+        DmabufStreamBuffer &buffer(*p.buffers.back());
+
+        if (!p.use_dma_buf) {
+            buffer.memory.resize(p.layout.size);
+            buffer.data = &buffer.memory[0];
+            continue;
+        }
+
+        if (!buffer.dma_buf.allocate(p.layout.size))
+            return false;
+        buffer.data = buffer.dma_buf.data();
+
+        glGenTextures(1, &buffer.texture);
+        glBindTexture(GL_TEXTURE_EXTERNAL_OES, buffer.texture);
+        glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        if (!import_buffer(p, canvas_, buffer)) {
+            Log::error("SceneDmabufStream: failed to import a %s dma-buf\n",
+                       format.c_str());
+            return false;
+        }
+    }
+
+    if (!p.use_dma_buf) {
+        static const GLenum formats[] = {GL_LUMINANCE, GL_LUMINANCE_ALPHA, GL_RGB, GL_RGBA};
+        static const GLenum core_formats[] = {GL_RED, GL_RG, GL_RGB, GL_RGBA};
+
+        glGenTextures(p.layout.planes, p.upload_textures);
+        for (unsigned int i = 0; i < p.layout.planes; i++) {
+            GLenum plane_format = (GLExtensions::core_profile ? core_formats : formats)
+                                  [p.layout.pixel_bytes[i] - 1];
+            p.upload_formats[i] = plane_format;
+
+            glBindTexture(GL_TEXTURE_2D, p.upload_textures[i]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, plane_format,
+                                   p.layout.widths[i], p.layout.heights[i], 0,
+                                   plane_format, GL_UNSIGNED_BYTE, 0);
+        }
+    }
+
+    p.program.start();
+    p.program["Texture0"] = 0;
+    if (!p.use_dma_buf) {
+        p.program["Texture1"] = 1;
+        p.program["Texture2"] = 2;
+    }
+    p.program.stop();
+
+    p.next = 0;
+    p.stop = false;
+    p.fills = 0;
+    p.fill_us = 0;
+    p.upload_us = 0;
+    p.stall_us = 0;
+    p.frames = 0;
+
+    if (p.fill_thread) {
+        p.producer_started = pthread_create(&p.producer, 0, produce_frames, &p) == 0;
+        if (!p.producer_started) {
+            Log::error("SceneDmabufStream: failed to start the producer thread\n");
+            return false;
+        }
+    }
+
+    p.start_time = Util::get_timestamp_us();
+    p.end_time = p.start_time;
+
+    currentFrame_ = 0;
+    running_ = true;
+    startTime_ = Util::get_timestamp_us() / 1000000.0;
+    lastUpdateTime_ = startTime_;
+
+    return true;
+}
+
+void
+SceneDmabufStream::teardown()
+{
+    SceneDmabufStreamPrivate &p(*priv_);
+
+    if (p.producer_started) {
+        pthread_mutex_lock(&p.mutex);
+        p.stop = true;
+        pthread_cond_broadcast(&p.changed);
+        pthread_mutex_unlock(&p.mutex);
+
+        pthread_join(p.producer, 0);
+        p.producer_started = false;
+    }
+
+    for (std::vector<DmabufStreamBuffer *>::iterator iter = p.buffers.begin();
+         iter != p.buffers.end();
+         iter++)
+    {
+        DmabufStreamBuffer *buffer = *iter;
+
+        if (buffer->fence)
+            GLExtensions::DeleteSync(buffer->fence);
+        if (buffer->texture)
+            glDeleteTextures(1, &buffer->texture);
+        delete buffer->image;
+        delete buffer;
+    }
+
+    p.buffers.clear();
+
+    for (unsigned int i = 0; i < 3; i++) {
+        if (p.upload_textures[i])
+            GLMemory::delete_textures(1, &p.upload_textures[i]);
+        p.upload_textures[i] = 0;
+    }
+
+    p.program.release();
+    p.mesh.reset();
+
+    Scene::teardown();
+}
+
+void
+SceneDmabufStream::update()
+{
+    Scene::update();
+}
+
+/**
+ * Waits for the GPU to finish with a retired buffer and returns it to the
+ * ring.  Called with the mutex held.
+ *
+ * A blocking wait flushes the fence, which may still be unflushed if the
+ * canvas doesn't flush at the end of the frame (e.g. --frame-end=none).
+ */
+static void
+reclaim_buffer(SceneDmabufStreamPrivate &p, DmabufStreamBuffer &buffer, bool wait)
+{
+    GLenum status;
+
+    do {
+        status = GLExtensions::ClientWaitSync(buffer.fence,
+                                              wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                              wait ? 1000000000ull : 0);
+    } while (wait && status == GL_TIMEOUT_EXPIRED);
+
+    if (status == GL_TIMEOUT_EXPIRED)
+        return;
+
+    GLExtensions::DeleteSync(buffer.fence);
+    buffer.fence = 0;
+    buffer.state = DmabufStreamBuffer::StateFree;
+    pthread_cond_broadcast(&p.changed);
+}
+
+void
+SceneDmabufStream::draw()
+{
+    SceneDmabufStreamPrivate &p(*priv_);
+    DmabufStreamBuffer &buffer(*p.buffers[p.next]);
+
+    pthread_mutex_lock(&p.mutex);
+
+    /* Hand the buffers whose draws are done back to the producer */
+    for (unsigned int i = 0; i < p.buffers.size(); i++) {
+        if (p.buffers[i]->state == DmabufStreamBuffer::StateRetired)
+            reclaim_buffer(p, *p.buffers[i], false);
+    }
+
+    /* Wait until the next buffer in the ring can be written, or is filled */
+    uint64_t before = Util::get_timestamp_us();
+
+    if (buffer.state == DmabufStreamBuffer::StateRetired)
+        reclaim_buffer(p, buffer, true);
+
+    if (p.fill_thread) {
+        while (buffer.state != DmabufStreamBuffer::StateFilled)
+            pthread_cond_wait(&p.changed, &p.mutex);
+    }
+
+    p.stall_us += Util::get_timestamp_us() - before;
+    buffer.state = DmabufStreamBuffer::StateInUse;
+
+    pthread_mutex_unlock(&p.mutex);
+
+    if (!p.fill_thread) {
+        buffer.frame = p.frames;
+        before = Util::get_timestamp_us();
+        fill_buffer(p, buffer);
+        p.fill_us += Util::get_timestamp_us() - before;
+        p.fills++;
+    }
+
+    if (p.use_dma_buf) {
+        if (p.reimport && !import_buffer(p, canvas_, buffer))
+            Log::debug("SceneDmabufStream: failed to import a dma-buf\n");
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_EXTERNAL_OES, buffer.texture);
+    }
+    else {
+        before = Util::get_timestamp_us();
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        for (unsigned int i = 0; i < p.layout.planes; i++) {
+            glActiveTexture(GL_TEXTURE0 + i);
+            glBindTexture(GL_TEXTURE_2D, p.upload_textures[i]);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, p.layout.widths[i], p.layout.heights[i],
+                            p.upload_formats[i], GL_UNSIGNED_BYTE,
+                            buffer.data + p.layout.offsets[i]);
+        }
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        p.upload_us += Util::get_timestamp_us() - before;
+    }
+
+    glDisable(GL_DEPTH_TEST);
+
+    p.program.start();
+    p.mesh.render_vbo();
+    p.program.stop();
+
+    glEnable(GL_DEPTH_TEST);
+    glActiveTexture(GL_TEXTURE0);
+
+    /*
+     * The upload path copies the frame, so its buffer is free at once; the
+     * dma-buf path samples the buffer itself until the draw is done.
+     */
+    pthread_mutex_lock(&p.mutex);
+    if (p.use_dma_buf) {
+        buffer.fence = GLExtensions::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        buffer.state = DmabufStreamBuffer::StateRetired;
+    }
+    else {
+        buffer.state = DmabufStreamBuffer::StateFree;
+        pthread_cond_broadcast(&p.changed);
+    }
+    pthread_mutex_unlock(&p.mutex);
+
+    p.next = (p.next + 1) % p.buffers.size();
+    p.frames++;
+    p.end_time = Util::get_timestamp_us();
+}
+
+std::string
+SceneDmabufStream::result_extras()
+{
+    SceneDmabufStreamPrivate &p(*priv_);
+    double seconds = (p.end_time - p.start_time) / 1000000.0;
+
+    if (seconds <= 0.0 || p.frames == 0)
+        return "";
+
+    pthread_mutex_lock(&p.mutex);
+    uint64_t fills = p.fills;
+    uint64_t fill_us = p.fill_us;
+    pthread_mutex_unlock(&p.mutex);
+
+    std::stringstream ss;
+    ss.precision(2);
+    ss << std::fixed;
+    ss << " Stream: " << p.frames * static_cast<double>(p.layout.size) / seconds / (1024.0 * 1024.0)
+       << " MiB/s";
+
+    if (p.use_dma_buf && p.imports > 0)
+        ss << " Import: " << p.import_us / 1000.0 / p.imports << " ms (" << p.imports << " imports)";
+    else if (!p.use_dma_buf)
+        ss << " Upload: " << p.upload_us / 1000.0 / p.frames << " ms/frame";
+
+    if (fills > 0)
+        ss << " Fill: " << fill_us / 1000.0 / fills << " ms/frame";
+
+    ss << " Stall: " << p.stall_us / 1000.0 / p.frames << " ms/frame";
+
+    return ss.str();
+}
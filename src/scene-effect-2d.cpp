@@ -33,6 +33,7 @@
 #include "shader-source.h"
 #include "util.h"
 #include "texture.h"
+#include "gl-memory.h"
 
 SceneEffect2D::SceneEffect2D(Canvas &pCanvas) :
     Scene(pCanvas, "effect2d")
@@ -292,7 +293,7 @@ SceneEffect2D::load()
 void
 SceneEffect2D::unload()
 {
-    glDeleteTextures(1, &texture_);
+    GLMemory::delete_textures(1, &texture_);
 }
 
 bool
@@ -0,0 +1,375 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "mat.h"
+#include "stack.h"
+#include "log.h"
+#include "util.h"
+#include "shader-source.h"
+#include "gl-memory.h"
+#include "gpu-timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+using LibMatrix::mat4;
+
+struct SceneFboSwitchPrivate
+{
+    Program program;
+    Mesh quad_mesh;
+
+    /* The render targets, which may all share the first depth renderbuffer */
+    std::vector<GLuint> fbos;
+    std::vector<GLuint> textures;
+    std::vector<GLuint> depth_renderbuffers;
+    unsigned int size;
+
+    unsigned int switches;
+    unsigned int draws;
+
+    GPUTimer timer;
+    bool time_gpu;
+    unsigned int frames;
+
+    SceneFboSwitchPrivate() :
+        size(0), switches(0), draws(0), time_gpu(false), frames(0) {}
+};
+
+SceneFboSwitch::SceneFboSwitch(Canvas &canvas) :
+    Scene(canvas, "fbo-switch")
+{
+    priv_ = new SceneFboSwitchPrivate();
+
+    options_["switches"] = Scene::Option("switches", "16",
+                                         "The number of render target switches per frame");
+    options_["targets"] = Scene::Option("targets", "4",
+                                        "The number of render targets to switch between");
+    options_["size"] = Scene::Option("size", "256",
+                                     "The width and height of the render targets");
+    options_["format"] = Scene::Option("format", "rgba8",
+                                       "The format of the render targets",
+                                       "rgba8,rgb565,rgba4,rgba16f");
+    options_["depth"] = Scene::Option("depth", "separate",
+                                      "Whether the render targets have their own depth buffers, share one or have none",
+                                      "none,separate,shared");
+    options_["draws"] = Scene::Option("draws", "1",
+                                      "The number of draw calls after each switch");
+}
+
+SceneFboSwitch::~SceneFboSwitch()
+{
+    delete priv_;
+}
+
+bool
+SceneFboSwitch::supported(bool show_errors)
+{
+    if (options_["format"].value == "rgba16f")
+        return require_capability(GLExtensions::HalfFloatRenderTargets, show_errors);
+
+    return true;
+}
+
+bool
+SceneFboSwitch::load()
+{
+    running_ = false;
+
+    return true;
+}
+
+void
+SceneFboSwitch::unload()
+{
+}
+
+bool
+SceneFboSwitch::setup_targets(unsigned int count)
+{
+    SceneFboSwitchPrivate &p(*priv_);
+    const std::string &format(options_["format"].value);
+    const std::string &depth(options_["depth"].value);
+
+    GLint internal_format = GL_RGBA;
+    GLenum pixel_format = GL_RGBA;
+    GLenum type = GL_UNSIGNED_BYTE;
+
+    if (format == "rgb565") {
+        internal_format = GL_RGB;
+        pixel_format = GL_RGB;
+        type = GL_UNSIGNED_SHORT_5_6_5;
+    }
+    else if (format == "rgba4") {
+        type = GL_UNSIGNED_SHORT_4_4_4_4;
+    }
+    else if (format == "rgba16f") {
+        bool unsized = false;
+#if GLMARK2_USE_GLESv2
+        /* GLES2 (OES_texture_half_float) only has unsized half float formats */
+        unsized = !GLExtensions::version(3, 0);
+#endif
+        internal_format = unsized ? GL_RGBA : GL_RGBA16F;
+        type = unsized ? GL_HALF_FLOAT_OES : GL_HALF_FLOAT;
+    }
+
+    unsigned int depth_count = depth == "separate" ? count : depth == "shared" ? 1 : 0;
+
+    p.fbos.resize(count);
+    p.textures.resize(count);
+    p.depth_renderbuffers.resize(depth_count);
+
+    glGenFramebuffers(count, &p.fbos[0]);
+    glGenTextures(count, &p.textures[0]);
+
+    if (depth_count > 0) {
+        glGenRenderbuffers(depth_count, &p.depth_renderbuffers[0]);
+        for (unsigned int i = 0; i < depth_count; i++) {
+            glBindRenderbuffer(GL_RENDERBUFFER, p.depth_renderbuffers[i]);
+            GLMemory::renderbuffer_storage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16,
+                                           p.size, p.size);
+        }
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        glBindTexture(GL_TEXTURE_2D, p.textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, internal_format, p.size, p.size,
+                               0, pixel_format, type, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, p.fbos[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D, p.textures[i], 0);
+        if (depth_count > 0) {
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                      GL_RENDERBUFFER,
+                                      p.depth_renderbuffers[i % depth_count]);
+        }
+
+        unsigned int status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            Log::error("SceneFboSwitch: glCheckFramebufferStatus failed (0x%x)\n", status);
+            glBindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+            return false;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+
+    return true;
+}
+
+bool
+SceneFboSwitch::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    SceneFboSwitchPrivate &p(*priv_);
+
+    unsigned int targets = Util::fromString<unsigned int>(options_["targets"].value);
+    p.size = Util::fromString<unsigned int>(options_["size"].value);
+    p.switches = Util::fromString<unsigned int>(options_["switches"].value);
+    p.draws = Util::fromString<unsigned int>(options_["draws"].value);
+
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &max_size);
+
+    if (targets == 0 || p.size == 0 ||
+        p.size > static_cast<unsigned int>(max_size))
+    {
+        Log::error("SceneFboSwitch: invalid number (%u) or size (%u) of render targets\n",
+                   targets, p.size);
+        return false;
+    }
+
+    ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/loadstore.vert");
+    ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/loadstore.frag");
+
+    if (!Scene::load_shaders_from_strings(p.program, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    /* A single quad covering the screen */
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    p.quad_mesh.set_vertex_format(vertex_format);
+    p.quad_mesh.make_grid(1, 1, 2.0, 2.0, 0.0);
+    p.quad_mesh.build_vbo();
+    std::vector<GLint> attrib_locations;
+    attrib_locations.push_back(p.program["position"].location());
+    p.quad_mesh.set_attrib_locations(attrib_locations);
+
+    if (!setup_targets(targets))
+        return false;
+
+    p.time_gpu = gpu_timing() && p.timer.init();
+    p.frames = 0;
+
+    currentFrame_ = 0;
+    running_ = true;
+    startTime_ = Util::get_timestamp_us() / 1000000.0;
+    lastUpdateTime_ = startTime_;
+
+    return true;
+}
+
+void
+SceneFboSwitch::teardown()
+{
+    SceneFboSwitchPrivate &p(*priv_);
+
+    p.program.release();
+    p.quad_mesh.reset();
+
+    if (!p.fbos.empty()) {
+        glDeleteFramebuffers(p.fbos.size(), &p.fbos[0]);
+        GLMemory::delete_textures(p.textures.size(), &p.textures[0]);
+    }
+    if (!p.depth_renderbuffers.empty()) {
+        GLMemory::delete_renderbuffers(p.depth_renderbuffers.size(),
+                                       &p.depth_renderbuffers[0]);
+    }
+    p.fbos.clear();
+    p.textures.clear();
+    p.depth_renderbuffers.clear();
+
+    p.timer.release();
+
+    Scene::teardown();
+}
+
+void
+SceneFboSwitch::update()
+{
+    Scene::update();
+}
+
+void
+SceneFboSwitch::draw()
+{
+    SceneFboSwitchPrivate &p(*priv_);
+    double elapsed_time = lastUpdateTime_ - startTime_;
+    unsigned int targets = p.fbos.size();
+    GLbitfield clear_bits = GL_COLOR_BUFFER_BIT |
+                            (p.depth_renderbuffers.empty() ? 0 : GL_DEPTH_BUFFER_BIT);
+    mat4 identity;
+
+    if (p.time_gpu)
+        p.timer.begin();
+
+    p.program.start();
+    p.program["Texture"] = 0;
+    p.program["TextureScale"] = 0.5f;
+    glActiveTexture(GL_TEXTURE0);
+
+    /*
+     * Each switch clears its target and draws small quads into it, so that
+     * the cost is dominated by starting and flushing the render pass.
+     */
+    glViewport(0, 0, p.size, p.size);
+    p.program["TextureWeight"] = 0.0f;
+
+    for (unsigned int s = 0; s < p.switches; s++) {
+        glBindFramebuffer(GL_FRAMEBUFFER, p.fbos[s % targets]);
+        glClear(clear_bits);
+
+        for (unsigned int d = 0; d < p.draws; d++) {
+            float phase = 2.0 * M_PI * (s * p.draws + d) / (p.switches * p.draws);
+            LibMatrix::Stack4 transform;
+            transform.translate(0.6 * std::cos(phase + elapsed_time),
+                                0.6 * std::sin(phase + elapsed_time), 0.0);
+            transform.scale(0.3, 0.3, 1.0);
+            p.program["Transform"] = transform.getCurrent();
+            p.program["Color"] = vec4(0.5 + 0.5 * std::cos(phase),
+                                      0.5 + 0.5 * std::cos(phase - 2.0 * M_PI / 3.0),
+                                      0.5 + 0.5 * std::cos(phase + 2.0 * M_PI / 3.0),
+                                      1.0);
+            p.quad_mesh.render_vbo();
+        }
+    }
+
+    /*
+     * Show the targets in a grid.  Targets beyond the number of switches
+     * are never rendered to, so their contents are undefined.
+     */
+    glBindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+    glViewport(0, 0, canvas_.width(), canvas_.height());
+    glDisable(GL_DEPTH_TEST);
+
+    unsigned int shown = std::min(targets, p.switches);
+    unsigned int columns = std::ceil(std::sqrt(static_cast<double>(shown)));
+    unsigned int rows = columns > 0 ? (shown + columns - 1) / columns : 0;
+    p.program["TextureWeight"] = 1.0f;
+
+    for (unsigned int i = 0; i < shown; i++) {
+        LibMatrix::Stack4 transform;
+        transform.translate(-1.0 + (2.0 * (i % columns) + 1.0) / columns,
+                            1.0 - (2.0 * (i / columns) + 1.0) / rows, 0.0);
+        transform.scale(0.95 / columns, 0.95 / rows, 1.0);
+        p.program["Transform"] = transform.getCurrent();
+        glBindTexture(GL_TEXTURE_2D, p.textures[i]);
+        p.quad_mesh.render_vbo();
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    p.program.stop();
+
+    if (p.time_gpu)
+        p.timer.end();
+
+    p.frames++;
+}
+
+std::string
+SceneFboSwitch::result_extras()
+{
+    SceneFboSwitchPrivate &p(*priv_);
+    double elapsed_time = lastUpdateTime_ - startTime_;
+    double switches = static_cast<double>(p.frames) * p.switches;
+
+    if (switches == 0.0 || elapsed_time <= 0.0)
+        return "";
+
+    /*
+     * The cost per switch includes the draws after it and a share of the
+     * final composite; comparing runs with different draws= and switches=
+     * values separates the fixed cost of the switch itself.
+     */
+    std::stringstream ss;
+    ss.precision(1);
+    ss << std::fixed;
+    ss << " Switches: " << switches / elapsed_time << "/s"
+       << " Cost: " << elapsed_time * 1000000.0 / switches << " us/switch";
+
+    if (p.time_gpu && p.timer.average_ms() >= 0.0 && p.switches > 0) {
+        ss << " GPU: " << p.timer.average_ms() * 1000.0 / p.switches
+           << " us/switch";
+    }
+
+    return ss.str();
+}
@@ -62,7 +62,6 @@ static std::string
 get_vertex_shader_source(int steps, bool function, std::string &complexity)
 {
     ShaderSource source(vtx_file);
-    ShaderSource source_main;
     std::string step_file;
 
     if (complexity == "low")
@@ -72,9 +71,9 @@ get_vertex_shader_source(int steps, bool function, std::string &complexity)
 
     for (int i = 0; i < steps; i++) {
         if (function)
-            source_main.append_file(call_file);
+            source.insert_file("MAIN", call_file);
         else
-            source_main.append_file(step_file);
+            source.insert_file("MAIN", step_file);
     }
 
     if (function)
@@ -82,7 +81,8 @@ get_vertex_shader_source(int steps, bool function, std::string &complexity)
     else
         source.replace("$PROCESS$", "");
 
-    source.replace("$MAIN$", source_main.str());
+    /* Remove the placeholder if there are no steps */
+    source.replace("$MAIN$", "");
 
     return source.str();
 }
@@ -91,7 +91,6 @@ static std::string
 get_fragment_shader_source(int steps, bool function, std::string &complexity)
 {
     ShaderSource source(frg_file);
-    ShaderSource source_main;
     std::string step_file;
 
     if (complexity == "low")
@@ -101,9 +100,9 @@ get_fragment_shader_source(int steps, bool function, std::string &complexity)
 
     for (int i = 0; i < steps; i++) {
         if (function)
-            source_main.append_file(call_file);
+            source.insert_file("MAIN", call_file);
         else
-            source_main.append_file(step_file);
+            source.insert_file("MAIN", step_file);
     }
 
     if (function)
@@ -111,7 +110,8 @@ get_fragment_shader_source(int steps, bool function, std::string &complexity)
     else
         source.replace("$PROCESS$", "");
 
-    source.replace("$MAIN$", source_main.str());
+    /* Remove the placeholder if there are no steps */
+    source.replace("$MAIN$", "");
 
     return source.str();
 }
@@ -26,6 +26,7 @@
 #include <vector>
 #include "vec.h"
 #include "gl-headers.h"
+#include "gl-memory.h"
 
 class PrimitiveState
 {
@@ -75,7 +76,7 @@ struct Character
         // First, setup the vertex data by binding the first buffer object, 
         // allocating its data store, and filling it in with our vertex data.
         glBindBuffer(GL_ARRAY_BUFFER, bufferObjects_[0]);
-        glBufferData(GL_ARRAY_BUFFER, vertexData_.size() * sizeof(LibMatrix::vec2), 
+        GLMemory::buffer_data(GL_ARRAY_BUFFER, vertexData_.size() * sizeof(LibMatrix::vec2), 
             &vertexData_.front(), GL_STATIC_DRAW);
 
         // Finally, setup the pointer to our vertex data and enable this
@@ -85,7 +86,7 @@ struct Character
 
         // Now repeat for our index data.
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferObjects_[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, 
+        GLMemory::buffer_data(GL_ELEMENT_ARRAY_BUFFER, 
             indexData_.size() * sizeof(unsigned short), &indexData_.front(), 
             GL_STATIC_DRAW);
 
@@ -96,7 +97,7 @@ struct Character
     }
     ~Character()
     {
-        glDeleteBuffers(2, &bufferObjects_[0]);
+        GLMemory::delete_buffers(2, &bufferObjects_[0]);
     }
     Character() :
         vertexIndex_(0),
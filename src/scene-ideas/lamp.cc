@@ -26,6 +26,7 @@
 #include "shader-source.h"
 #include "log.h"
 #include "scene.h"
+#include "gl-memory.h"
 
 using std::string;
 using LibMatrix::vec3;
@@ -155,7 +156,7 @@ Lamp::~Lamp()
 {
     if (valid_)
     {
-        glDeleteBuffers(2, &bufferObjects_[0]);
+        GLMemory::delete_buffers(2, &bufferObjects_[0]);
     }
 }
 
@@ -200,11 +201,11 @@ Lamp::init()
     // First, setup the vertex data by binding the first buffer object, 
     // allocating its data store, and filling it in with our vertex data.
     glBindBuffer(GL_ARRAY_BUFFER, bufferObjects_[0]);
-    glBufferData(GL_ARRAY_BUFFER, vertexData_.size() * sizeof(vec3), &vertexData_.front(), GL_STATIC_DRAW);
+    GLMemory::buffer_data(GL_ARRAY_BUFFER, vertexData_.size() * sizeof(vec3), &vertexData_.front(), GL_STATIC_DRAW);
 
     // Now repeat for our index data.
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferObjects_[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData_.size() * sizeof(unsigned short), &indexData_.front(), GL_STATIC_DRAW);
+    GLMemory::buffer_data(GL_ELEMENT_ARRAY_BUFFER, indexData_.size() * sizeof(unsigned short), &indexData_.front(), GL_STATIC_DRAW);
 
     // We're ready to go.
     valid_ = true;
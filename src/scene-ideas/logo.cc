@@ -26,6 +26,7 @@
 #include "scene.h"
 #include "shader-source.h"
 #include "log.h"
+#include "gl-memory.h"
 
 using std::string;
 using LibMatrix::vec3;
@@ -408,7 +409,7 @@ SGILogo::~SGILogo()
 {
     if (valid_)
     {
-        glDeleteBuffers(2, &bufferObjects_[0]);
+        GLMemory::delete_buffers(2, &bufferObjects_[0]);
     }
 }
 
@@ -435,6 +436,12 @@ SGILogo::init()
     }
     normalVertexIndex_ = normalProgram_[vertexAttribName_].location();
     normalNormalIndex_ = normalProgram_[normalAttribName_].location();
+    // The logo first shows up well into the scene, so look up the uniforms
+    // now rather than allocating their symbols while drawing.
+    normalProgram_[lightPositionName_];
+    normalProgram_[projectionName_];
+    normalProgram_[modelviewName_];
+    normalProgram_[normalMatrixName_];
 
     // The program for handling the flat object...
     string logo_flat_vtx_filename(GLMARK_DATA_PATH"/shaders/ideas-logo-flat.vert");
@@ -448,6 +455,9 @@ SGILogo::init()
         return;
     }
     flatVertexIndex_ = flatProgram_[vertexAttribName_].location();
+    flatProgram_[logoColorName_];
+    flatProgram_[projectionName_];
+    flatProgram_[modelviewName_];
 
     // The program for handling the shadow object with texturing...
     string logo_shadow_vtx_filename(GLMARK_DATA_PATH"/shaders/ideas-logo-shadow.vert");
@@ -461,6 +471,8 @@ SGILogo::init()
         return;
     }
     shadowVertexIndex_ = shadowProgram_[vertexAttribName_].location();
+    shadowProgram_[projectionName_];
+    shadowProgram_[modelviewName_];
 
     // We need 2 buffers for our work here.  One for the vertex data.
     // and one for the index data.
@@ -469,7 +481,7 @@ SGILogo::init()
     // First, setup the vertex data by binding the first buffer object, 
     // allocating its data store, and filling it in with our vertex data.
     glBindBuffer(GL_ARRAY_BUFFER, bufferObjects_[0]);
-    glBufferData(GL_ARRAY_BUFFER, dataMap_.totalSize, 0, GL_STATIC_DRAW);
+    GLMemory::buffer_data(GL_ARRAY_BUFFER, dataMap_.totalSize, 0, GL_STATIC_DRAW);
     glBufferSubData(GL_ARRAY_BUFFER, dataMap_.scvOffset, dataMap_.scvSize,
                     &singleCylinderVertices_.front());
     glBufferSubData(GL_ARRAY_BUFFER, dataMap_.scnOffset, dataMap_.scnSize,
@@ -487,8 +499,8 @@ SGILogo::init()
 
     // Now repeat for our index data.
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferObjects_[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData_.size() * sizeof(unsigned short),
-                 &indexData_.front(), GL_STATIC_DRAW);
+    GLMemory::buffer_data(GL_ELEMENT_ARRAY_BUFFER, indexData_.size() * sizeof(unsigned short),
+                          &indexData_.front(), GL_STATIC_DRAW);
 
     // Setup our the texture that the shadow program will use...
     glGenTextures(1, &textureName_);
@@ -497,9 +509,26 @@ SGILogo::init()
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA,
-                 textureResolution_, textureResolution_,
-                 0, GL_ALPHA, GL_UNSIGNED_BYTE, textureImage_);
+    if (GLExtensions::core_profile) {
+        // Core profile contexts have no GL_ALPHA textures, so store the
+        // pattern in the alpha channel of an RGBA texture.
+        GLubyte rgbaImage[32][32][4] = {};
+        for (unsigned int i = 0; i < textureResolution_; i++)
+        {
+            for (unsigned int j = 0; j < textureResolution_; j++)
+            {
+                rgbaImage[i][j][3] = textureImage_[i][j];
+            }
+        }
+        GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_RGBA,
+                               textureResolution_, textureResolution_,
+                               0, GL_RGBA, GL_UNSIGNED_BYTE, rgbaImage);
+    }
+    else {
+        GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_ALPHA,
+                               textureResolution_, textureResolution_,
+                               0, GL_ALPHA, GL_UNSIGNED_BYTE, textureImage_);
+    }
 
     // We're ready to go.
     valid_ = true;
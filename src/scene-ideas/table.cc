@@ -24,6 +24,7 @@
 #include "scene.h"
 #include "shader-source.h"
 #include "log.h"
+#include "gl-memory.h"
 
 using std::string;
 using LibMatrix::vec3;
@@ -86,7 +87,7 @@ Table::~Table(void)
 {
     if (valid_)
     {
-        glDeleteBuffers(2, &bufferObjects_[0]);
+        GLMemory::delete_buffers(2, &bufferObjects_[0]);
     }
 }
 
@@ -112,6 +113,13 @@ Table::init(void)
         return;
     }
     textVertexIndex_ = tableProgram_[vertexAttribName_].location();
+    // The table first shows up well into the scene, so look up the uniforms
+    // now rather than allocating their symbols while drawing.
+    tableProgram_[projectionName_];
+    tableProgram_[modelviewName_];
+    tableProgram_[lightPositionName_];
+    tableProgram_[logoDirectionName_];
+    tableProgram_[curTimeName_];
 
     // Program to render the paper with lighting and a time-based fade...
     string paper_vtx_filename(GLMARK_DATA_PATH"/shaders/ideas-paper.vert");
@@ -125,6 +133,11 @@ Table::init(void)
         return;
     }
     paperVertexIndex_ = paperProgram_[vertexAttribName_].location();
+    paperProgram_[projectionName_];
+    paperProgram_[modelviewName_];
+    paperProgram_[lightPositionName_];
+    paperProgram_[logoDirectionName_];
+    paperProgram_[curTimeName_];
 
     // Program to handle the text (time-based color fade)...
     string text_vtx_filename(GLMARK_DATA_PATH"/shaders/ideas-text.vert");
@@ -138,6 +151,9 @@ Table::init(void)
         return;
     }
     textVertexIndex_ = textProgram_[vertexAttribName_].location();
+    textProgram_[projectionName_];
+    textProgram_[modelviewName_];
+    textProgram_[curTimeName_];
 
     // Program for the drawUnder functionality (just paint it black)...
     string under_table_vtx_filename(GLMARK_DATA_PATH"/shaders/ideas-under-table.vert");
@@ -151,6 +167,8 @@ Table::init(void)
         return;
     }
     underVertexIndex_ = underProgram_[vertexAttribName_].location();
+    underProgram_[modelviewName_];
+    underProgram_[projectionName_];
 
     // Tell all of the characters to initialize themselves...
     i_.init(textVertexIndex_);
@@ -170,7 +188,7 @@ Table::init(void)
     // First, setup the vertex data by binding the first buffer object, 
     // allocating its data store, and filling it in with our vertex data.
     glBindBuffer(GL_ARRAY_BUFFER, bufferObjects_[0]);
-    glBufferData(GL_ARRAY_BUFFER, dataMap_.totalSize, 0, GL_STATIC_DRAW);
+    GLMemory::buffer_data(GL_ARRAY_BUFFER, dataMap_.totalSize, 0, GL_STATIC_DRAW);
     glBufferSubData(GL_ARRAY_BUFFER, dataMap_.tvOffset, dataMap_.tvSize, 
                     &tableVertices_.front());
     glBufferSubData(GL_ARRAY_BUFFER, dataMap_.pvOffset, dataMap_.pvSize,
@@ -178,8 +196,8 @@ Table::init(void)
 
     // Now repeat for our index data.
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferObjects_[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData_.size() * sizeof(unsigned short),
-                 &indexData_.front(), GL_STATIC_DRAW);
+    GLMemory::buffer_data(GL_ELEMENT_ARRAY_BUFFER, indexData_.size() * sizeof(unsigned short),
+                          &indexData_.front(), GL_STATIC_DRAW);
 
     // We're ready to go.
     valid_ = true;
@@ -29,6 +29,7 @@
 #include "log.h"
 #include "util.h"
 #include "texture.h"
+#include "gl-memory.h"
 #include "shader-source.h"
 
 SceneJellyfish::SceneJellyfish(Canvas& canvas) :
@@ -141,8 +142,8 @@ GradientRenderer::init()
     // Set up the VBO and stash our position data in it.
     glGenBuffers(1, &bufferObject_);
     glBindBuffer(GL_ARRAY_BUFFER, bufferObject_);
-    glBufferData(GL_ARRAY_BUFFER, (vertices_.size() + uvs_.size()) * sizeof(vec2),
-                 0, GL_STATIC_DRAW);
+    GLMemory::buffer_data(GL_ARRAY_BUFFER, (vertices_.size() + uvs_.size()) * sizeof(vec2),
+                          0, GL_STATIC_DRAW);
     glBufferSubData(GL_ARRAY_BUFFER, 0, vertices_.size() * sizeof(vec2),
                     &vertices_.front());
     glBufferSubData(GL_ARRAY_BUFFER, uvOffset_, uvs_.size() * sizeof(vec2),
@@ -158,7 +159,7 @@ GradientRenderer::cleanup()
     program_.stop();
     program_.release();
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glDeleteBuffers(1, &bufferObject_);
+    GLMemory::delete_buffers(1, &bufferObject_);
 }
 
 void
@@ -435,7 +436,7 @@ JellyfishPrivate::initialize()
     // First, setup the vertex data by binding the first buffer object, 
     // allocating its data store, and filling it in with our vertex data.
     glBindBuffer(GL_ARRAY_BUFFER, bufferObjects_[0]);
-    glBufferData(GL_ARRAY_BUFFER, dataMap_.totalSize, 0, GL_STATIC_DRAW);
+    GLMemory::buffer_data(GL_ARRAY_BUFFER, dataMap_.totalSize, 0, GL_STATIC_DRAW);
     glBufferSubData(GL_ARRAY_BUFFER, dataMap_.positionOffset,
                     dataMap_.positionSize, &positions_.front());
     glBufferSubData(GL_ARRAY_BUFFER, dataMap_.normalOffset,
@@ -447,8 +448,8 @@ JellyfishPrivate::initialize()
 
     // Now repeat for our index data.
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferObjects_[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_.size() * sizeof(unsigned short),
-                 &indices_.front(), GL_STATIC_DRAW);
+    GLMemory::buffer_data(GL_ELEMENT_ARRAY_BUFFER, indices_.size() * sizeof(unsigned short),
+                          &indices_.front(), GL_STATIC_DRAW);
 
     // "Unbind" our buffer objects to make sure the state is consistent.
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -547,8 +548,8 @@ JellyfishPrivate::cleanup()
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-    glDeleteTextures(33, &textureObjects_[0]);
-    glDeleteBuffers(2, &bufferObjects_[0]);
+    GLMemory::delete_textures(33, &textureObjects_[0]);
+    GLMemory::delete_buffers(2, &bufferObjects_[0]);
 
     gradient_.cleanup();
 }
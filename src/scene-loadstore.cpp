@@ -0,0 +1,399 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "mat.h"
+#include "stack.h"
+#include "log.h"
+#include "util.h"
+#include "shader-source.h"
+#include "gl-memory.h"
+#include "gpu-timer.h"
+
+#include <cmath>
+#include <sstream>
+
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+using LibMatrix::mat4;
+
+struct SceneLoadStorePrivate
+{
+    Program program;
+    Mesh quad_mesh;
+
+    /* The render targets */
+    std::vector<GLuint> fbos;
+    std::vector<GLuint> textures;
+    std::vector<GLuint> depth_renderbuffers;
+
+    unsigned int passes;
+    bool load;
+    bool invalidate_color;
+    bool invalidate_depth;
+
+    GPUTimer timer;
+    bool time_gpu;
+    double bytes_loaded;
+    double bytes_stored;
+    double bytes_saved;
+    unsigned int frames;
+
+    SceneLoadStorePrivate() :
+        passes(0), load(false), invalidate_color(false),
+        invalidate_depth(false), time_gpu(false), bytes_loaded(0.0),
+        bytes_stored(0.0), bytes_saved(0.0), frames(0) {}
+};
+
+/* The bytes per pixel of the color and depth attachments */
+static const double color_bytes = 4.0;
+static const double depth_bytes = 2.0;
+
+/* The number of quads drawn on top of the previous target in each pass */
+static const unsigned int quads_per_pass = 4;
+
+SceneLoadStore::SceneLoadStore(Canvas &canvas) :
+    Scene(canvas, "loadstore")
+{
+    priv_ = new SceneLoadStorePrivate();
+
+    options_["targets"] = Scene::Option("targets", "2",
+                                        "The number of render targets to ping-pong between");
+    options_["passes"] = Scene::Option("passes", "4",
+                                       "The number of render target passes per frame");
+    options_["strategy"] = Scene::Option("strategy", "clear",
+                                         "Whether each pass clears its target or loads the previous contents",
+                                         "clear,load");
+    options_["invalidate"] = Scene::Option("invalidate", "none",
+                                           "Which attachments to invalidate when their contents are no longer needed",
+                                           "none,color,depth,all");
+    options_["depth"] = Scene::Option("depth", "true",
+                                      "Whether the render targets have a depth attachment",
+                                      "false,true");
+}
+
+SceneLoadStore::~SceneLoadStore()
+{
+    delete priv_;
+}
+
+bool
+SceneLoadStore::supported(bool show_errors)
+{
+    if (options_["invalidate"].value != "none") {
+        return require_capability(GLExtensions::FramebufferInvalidation, show_errors) &&
+               require_no_capture("framebuffer invalidation", show_errors);
+    }
+
+    return true;
+}
+
+bool
+SceneLoadStore::load()
+{
+    running_ = false;
+
+    return true;
+}
+
+void
+SceneLoadStore::unload()
+{
+}
+
+bool
+SceneLoadStore::setup_targets(unsigned int count, bool has_depth)
+{
+    SceneLoadStorePrivate &p(*priv_);
+
+    p.fbos.resize(count);
+    p.textures.resize(count);
+    p.depth_renderbuffers.resize(has_depth ? count : 0);
+
+    glGenFramebuffers(count, &p.fbos[0]);
+    glGenTextures(count, &p.textures[0]);
+    if (has_depth)
+        glGenRenderbuffers(count, &p.depth_renderbuffers[0]);
+
+    for (unsigned int i = 0; i < count; i++) {
+        glBindTexture(GL_TEXTURE_2D, p.textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_RGBA,
+                               canvas_.width(), canvas_.height(), 0,
+                               GL_RGBA, GL_UNSIGNED_BYTE, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, p.fbos[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D, p.textures[i], 0);
+
+        if (has_depth) {
+            glBindRenderbuffer(GL_RENDERBUFFER, p.depth_renderbuffers[i]);
+            GLMemory::renderbuffer_storage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16,
+                                           canvas_.width(), canvas_.height());
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                      GL_RENDERBUFFER, p.depth_renderbuffers[i]);
+        }
+
+        unsigned int status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            Log::error("SceneLoadStore: glCheckFramebufferStatus failed (0x%x)\n", status);
+            glBindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+            return false;
+        }
+
+        /* Start from defined contents, even when the passes only load */
+        glClear(GL_COLOR_BUFFER_BIT | (has_depth ? GL_DEPTH_BUFFER_BIT : 0));
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+
+    return true;
+}
+
+bool
+SceneLoadStore::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    SceneLoadStorePrivate &p(*priv_);
+
+    unsigned int targets = Util::fromString<unsigned int>(options_["targets"].value);
+    const std::string &invalidate(options_["invalidate"].value);
+    bool has_depth = options_["depth"].value == "true";
+
+    if (targets < 2) {
+        Log::error("SceneLoadStore: at least 2 render targets are needed\n");
+        return false;
+    }
+
+    p.passes = Util::fromString<unsigned int>(options_["passes"].value);
+    p.load = options_["strategy"].value == "load";
+    p.invalidate_color = invalidate == "color" || invalidate == "all";
+    p.invalidate_depth = has_depth && (invalidate == "depth" || invalidate == "all");
+
+    ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/loadstore.vert");
+    ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/loadstore.frag");
+
+    if (!Scene::load_shaders_from_strings(p.program, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    /* A single quad covering the screen */
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    p.quad_mesh.set_vertex_format(vertex_format);
+    p.quad_mesh.make_grid(1, 1, 2.0, 2.0, 0.0);
+    p.quad_mesh.build_vbo();
+    std::vector<GLint> attrib_locations;
+    attrib_locations.push_back(p.program["position"].location());
+    p.quad_mesh.set_attrib_locations(attrib_locations);
+
+    if (!setup_targets(targets, has_depth))
+        return false;
+
+    p.time_gpu = gpu_timing() && p.timer.init();
+    p.bytes_loaded = 0.0;
+    p.bytes_stored = 0.0;
+    p.bytes_saved = 0.0;
+    p.frames = 0;
+
+    currentFrame_ = 0;
+    running_ = true;
+    startTime_ = Util::get_timestamp_us() / 1000000.0;
+    lastUpdateTime_ = startTime_;
+
+    return true;
+}
+
+void
+SceneLoadStore::teardown()
+{
+    SceneLoadStorePrivate &p(*priv_);
+
+    p.program.release();
+    p.quad_mesh.reset();
+
+    if (!p.fbos.empty()) {
+        glDeleteFramebuffers(p.fbos.size(), &p.fbos[0]);
+        GLMemory::delete_textures(p.textures.size(), &p.textures[0]);
+    }
+    if (!p.depth_renderbuffers.empty()) {
+        GLMemory::delete_renderbuffers(p.depth_renderbuffers.size(),
+                                       &p.depth_renderbuffers[0]);
+    }
+    p.fbos.clear();
+    p.textures.clear();
+    p.depth_renderbuffers.clear();
+
+    p.timer.release();
+
+    Scene::teardown();
+}
+
+void
+SceneLoadStore::update()
+{
+    Scene::update();
+}
+
+void
+SceneLoadStore::draw()
+{
+    SceneLoadStorePrivate &p(*priv_);
+    double elapsed_time = lastUpdateTime_ - startTime_;
+    double pixels = static_cast<double>(canvas_.width()) * canvas_.height();
+    float aspect = static_cast<float>(canvas_.height()) / canvas_.width();
+    unsigned int targets = p.fbos.size();
+    bool has_depth = !p.depth_renderbuffers.empty();
+    mat4 identity;
+
+    if (p.time_gpu)
+        p.timer.begin();
+
+    p.program.start();
+    p.program["Texture"] = 0;
+    glActiveTexture(GL_TEXTURE0);
+
+    for (unsigned int pass = 0; pass < p.passes; pass++) {
+        unsigned int target = (currentFrame_ * p.passes + pass) % targets;
+        unsigned int source = (target + targets - 1) % targets;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, p.fbos[target]);
+
+        /*
+         * The whole target is drawn over, so its previous contents are
+         * either cleared, loaded, or discarded by invalidating them.
+         */
+        if (!p.load) {
+            glClear(GL_COLOR_BUFFER_BIT | (has_depth ? GL_DEPTH_BUFFER_BIT : 0));
+        }
+        else if (p.invalidate_color) {
+            static const GLenum attachment(GL_COLOR_ATTACHMENT0);
+            GLExtensions::InvalidateFramebuffer(GL_FRAMEBUFFER, 1, &attachment);
+        }
+
+        /* Feed the previous target back, slightly zoomed and faded */
+        glBindTexture(GL_TEXTURE_2D, p.textures[source]);
+        glDepthFunc(GL_ALWAYS);
+        p.program["Transform"] = identity;
+        p.program["TextureScale"] = 0.49f;
+        p.program["TextureWeight"] = 0.95f;
+        p.program["Color"] = vec4(0.0, 0.0, 0.0, 1.0);
+        p.quad_mesh.render_vbo();
+
+        /* Overlapping quads, which need the depth test to sort out */
+        glDepthFunc(GL_LESS);
+        p.program["TextureWeight"] = 0.0f;
+        for (unsigned int i = 0; i < quads_per_pass; i++) {
+            float phase = 2.0 * M_PI * i / quads_per_pass;
+            float angle = 60.0 * elapsed_time + 90.0 * i + 20.0 * pass;
+            LibMatrix::Stack4 transform;
+            transform.translate(0.5 * std::cos(phase + elapsed_time),
+                                0.5 * std::sin(phase + elapsed_time),
+                                0.4 * std::sin(phase + 2.0 * elapsed_time));
+            transform.scale(0.3 * aspect, 0.3, 1.0);
+            transform.rotate(angle, 0.0, 0.3, 1.0);
+            p.program["Transform"] = transform.getCurrent();
+            p.program["Color"] = vec4(0.5 + 0.5 * std::cos(phase),
+                                      0.5 + 0.5 * std::cos(phase - 2.0 * M_PI / 3.0),
+                                      0.5 + 0.5 * std::cos(phase + 2.0 * M_PI / 3.0),
+                                      1.0);
+            p.quad_mesh.render_vbo();
+        }
+
+        /* The depth buffer is not needed by any later pass */
+        if (p.invalidate_depth) {
+            static const GLenum attachment(GL_DEPTH_ATTACHMENT);
+            GLExtensions::InvalidateFramebuffer(GL_FRAMEBUFFER, 1, &attachment);
+        }
+    }
+
+    /* Show the last target */
+    unsigned int last = (currentFrame_ * p.passes + p.passes + targets - 1) % targets;
+    glBindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+    glBindTexture(GL_TEXTURE_2D, p.textures[last]);
+    glDepthFunc(GL_ALWAYS);
+    p.program["Transform"] = identity;
+    p.program["TextureScale"] = 0.5f;
+    p.program["TextureWeight"] = 1.0f;
+    p.quad_mesh.render_vbo();
+
+    /* Restore the default depth function of the canvas */
+    glDepthFunc(GL_LEQUAL);
+
+    p.program.stop();
+
+    if (p.time_gpu)
+        p.timer.end();
+
+    /*
+     * Estimate the attachment traffic of each pass on a tile-based GPU.
+     * The color is always stored, since the next pass samples it, and is
+     * loaded unless it is cleared or invalidated.  The depth is loaded
+     * and stored unless it is cleared or invalidated respectively.  The
+     * savings are relative to loading and storing everything.
+     */
+    double loaded = 0.0;
+    double stored = color_bytes;
+
+    if (p.load && !p.invalidate_color)
+        loaded += color_bytes;
+    if (has_depth) {
+        if (p.load && !p.invalidate_depth)
+            loaded += depth_bytes;
+        if (!p.invalidate_depth)
+            stored += depth_bytes;
+    }
+
+    double worst = 2.0 * (color_bytes + (has_depth ? depth_bytes : 0.0));
+
+    p.bytes_loaded += p.passes * pixels * loaded;
+    p.bytes_stored += p.passes * pixels * stored;
+    p.bytes_saved += p.passes * pixels * (worst - loaded - stored);
+    p.frames++;
+}
+
+std::string
+SceneLoadStore::result_extras()
+{
+    static const double MiB = 1024.0 * 1024.0;
+    SceneLoadStorePrivate &p(*priv_);
+
+    if (p.frames == 0)
+        return "";
+
+    std::stringstream ss;
+    ss.precision(3);
+    ss << std::fixed;
+
+    if (p.time_gpu && p.timer.average_ms() >= 0.0)
+        ss << " GPU: " << p.timer.average_ms() << " ms";
+
+    ss.precision(1);
+    ss << " Loaded: " << p.bytes_loaded / p.frames / MiB << " MiB/frame"
+       << " Stored: " << p.bytes_stored / p.frames / MiB << " MiB/frame"
+       << " Saved: " << p.bytes_saved / p.frames / MiB << " MiB/frame";
+
+    return ss.str();
+}
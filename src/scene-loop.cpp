@@ -63,24 +63,22 @@ static std::string
 get_fragment_shader_source(int steps, bool loop, bool uniform)
 {
     ShaderSource source(frg_file);
-    ShaderSource source_main;
 
     if (loop) {
-        source_main.append_file(step_loop_file);
+        source.replace_with_file("$MAIN$", step_loop_file);
         if (uniform) {
-            source_main.replace("$NLOOPS$", "FragmentLoops");
+            source.replace("$NLOOPS$", "FragmentLoops");
         }
         else {
-            source_main.replace("$NLOOPS$", Util::toString(steps));
+            source.replace("$NLOOPS$", Util::toString(steps));
         }
     }
     else {
         for (int i = 0; i < steps; i++)
-            source_main.append_file(step_simple_file);
+            source.insert_file("MAIN", step_simple_file);
+        source.replace("$MAIN$", "");
     }
 
-    source.replace("$MAIN$", source_main.str());
-
     return source.str();
 }
 
@@ -88,24 +86,22 @@ static std::string
 get_vertex_shader_source(int steps, bool loop, bool uniform)
 {
     ShaderSource source(vtx_file);
-    ShaderSource source_main;
 
     if (loop) {
-        source_main.append_file(step_loop_file);
+        source.replace_with_file("$MAIN$", step_loop_file);
         if (uniform) {
-            source_main.replace("$NLOOPS$", "VertexLoops");
+            source.replace("$NLOOPS$", "VertexLoops");
         }
         else {
-            source_main.replace("$NLOOPS$", Util::toString(steps));
+            source.replace("$NLOOPS$", Util::toString(steps));
         }
     }
     else {
         for (int i = 0; i < steps; i++)
-            source_main.append_file(step_simple_file);
+            source.insert_file("MAIN", step_simple_file);
+        source.replace("$MAIN$", "");
     }
 
-    source.replace("$MAIN$", source_main.str());
-
     return source.str();
 }
 
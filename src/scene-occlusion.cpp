@@ -0,0 +1,450 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "mat.h"
+#include "stack.h"
+#include "log.h"
+#include "util.h"
+#include "shader-source.h"
+#include "model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+using LibMatrix::mat4;
+
+struct SceneOcclusionPrivate
+{
+    Program program;
+    Mesh model_mesh;
+    Mesh box_mesh;
+
+    vec3 center;
+    float radius;
+    mat4 projection;
+
+    /* The position of each occludee, and its transformations in this frame */
+    std::vector<vec3> positions;
+    std::vector<mat4> transforms;
+    std::vector<mat4> normal_matrices;
+    std::vector<mat4> box_transforms;
+    unsigned int occluders;
+
+    /*
+     * The queries of the occludees, in latency + 1 sets that are used in
+     * turn, so that a set is read latency frames after it is issued.
+     */
+    GLenum query_target;
+    std::vector<GLuint> queries;
+    unsigned int latency;
+    unsigned int frame;
+
+    /* Statistics */
+    unsigned long tested;
+    unsigned long culled;
+    double stall_us;
+    unsigned int frames;
+
+    SceneOcclusionPrivate() :
+        radius(1.0), occluders(0), query_target(GL_ANY_SAMPLES_PASSED),
+        latency(0), frame(0), tested(0), culled(0), stall_us(0.0), frames(0)
+    {
+    }
+};
+
+/* The depth of the occluder row, and of the nearest and farthest occludees */
+static const float occluder_depth = 10.0;
+static const float occludee_near = 13.0;
+static const float occludee_far = 22.0;
+
+/* The size of the occludees */
+static const float occludee_radius = 0.6;
+
+SceneOcclusion::SceneOcclusion(Canvas &canvas) :
+    Scene(canvas, "occlusion")
+{
+    priv_ = new SceneOcclusionPrivate();
+
+    const ModelMap& modelMap = Model::find_models();
+    std::string optionValues;
+    for (ModelMap::const_iterator modelIt = modelMap.begin();
+         modelIt != modelMap.end();
+         modelIt++)
+    {
+        if (!optionValues.empty())
+            optionValues += ",";
+        optionValues += modelIt->first;
+    }
+
+    options_["model"] = Scene::Option("model", "horse",
+                                      "Which model to use for the occludees",
+                                      optionValues);
+    options_["occluders"] = Scene::Option("occluders", "6",
+                                          "The number of moving walls in front of the occludees");
+    options_["occludees"] = Scene::Option("occludees", "64",
+                                          "The number of models tested with occlusion queries");
+    options_["latency"] = Scene::Option("latency", "1",
+                                        "The number of frames before a query result is used (0: same frame)",
+                                        "0,1,2");
+}
+
+SceneOcclusion::~SceneOcclusion()
+{
+    delete priv_;
+}
+
+bool
+SceneOcclusion::supported(bool show_errors)
+{
+    /* The queries, and the draws skipped on their results, are not recorded */
+    return require_capability(GLExtensions::OcclusionQueries, show_errors) &&
+           require_no_capture("occlusion queries", show_errors);
+}
+
+bool
+SceneOcclusion::load()
+{
+    running_ = false;
+
+    return true;
+}
+
+void
+SceneOcclusion::unload()
+{
+}
+
+/**
+ * Creates a box from -1 to 1 on each axis, with the normals of its faces.
+ */
+static void
+create_box_mesh(Mesh &mesh)
+{
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    vertex_format.push_back(3);
+    mesh.set_vertex_format(vertex_format);
+
+    static const vec3 axes[] = {vec3(1.0, 0.0, 0.0),
+                                vec3(0.0, 1.0, 0.0),
+                                vec3(0.0, 0.0, 1.0)};
+    /* The corners of two triangles, counter-clockwise around the normal */
+    static const float corners[6][2] = {{-1.0, -1.0}, {1.0, -1.0}, {1.0, 1.0},
+                                        {-1.0, -1.0}, {1.0, 1.0}, {-1.0, 1.0}};
+
+    for (int a = 0; a < 3; a++) {
+        for (int s = -1; s <= 1; s += 2) {
+            vec3 n(axes[a] * s);
+            vec3 u(axes[(a + 1) % 3]);
+            vec3 v(axes[(a + 2) % 3]);
+
+            if (s < 0)
+                std::swap(u, v);
+
+            for (int i = 0; i < 6; i++) {
+                mesh.next_vertex();
+                mesh.set_attrib(0, n + u * corners[i][0] + v * corners[i][1]);
+                mesh.set_attrib(1, n);
+            }
+        }
+    }
+
+    mesh.build_vbo();
+}
+
+bool
+SceneOcclusion::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    SceneOcclusionPrivate &p(*priv_);
+
+    p.occluders = Util::fromString<unsigned int>(options_["occluders"].value);
+    p.latency = Util::fromString<unsigned int>(options_["latency"].value);
+    unsigned int occludees = Util::fromString<unsigned int>(options_["occludees"].value);
+
+    if (p.latency > 2) {
+        Log::error("SceneOcclusion: latency must be 0, 1 or 2\n");
+        return false;
+    }
+
+    if (occludees == 0) {
+        Log::error("SceneOcclusion: there must be at least one occludee\n");
+        return false;
+    }
+
+    /* Load the model */
+    Model model;
+    if (!model.load(options_["model"].value))
+        return false;
+
+    if (model.needNormals())
+        model.calculate_normals();
+
+    std::vector<std::pair<Model::AttribType, int> > attribs;
+    attribs.push_back(std::pair<Model::AttribType, int>(Model::AttribTypePosition, 3));
+    attribs.push_back(std::pair<Model::AttribType, int>(Model::AttribTypeNormal, 3));
+    model.convert_to_mesh(p.model_mesh, attribs);
+    p.model_mesh.build_vbo();
+
+    vec3 max_vec(model.maxVec());
+    vec3 min_vec(model.minVec());
+    p.center = (max_vec + min_vec) / 2.0;
+    p.radius = (max_vec - min_vec).length() / 2.0;
+
+    create_box_mesh(p.box_mesh);
+
+    /* Load the shaders */
+    ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/occlusion.vert");
+    ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/occlusion.frag");
+
+    if (!Scene::load_shaders_from_strings(p.program, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    std::vector<GLint> attrib_locations;
+    attrib_locations.push_back(p.program["position"].location());
+    attrib_locations.push_back(p.program["normal"].location());
+    p.model_mesh.set_attrib_locations(attrib_locations);
+    p.box_mesh.set_attrib_locations(attrib_locations);
+
+    float aspect = static_cast<float>(canvas_.width()) / canvas_.height();
+    p.projection = LibMatrix::Mat4::perspective(50.0, aspect, 1.0, occludee_far + 2.0);
+
+    /* Spread the occludees over a grid behind the occluders */
+    unsigned int columns = std::max(1u, static_cast<unsigned int>(std::ceil(std::sqrt(occludees * 2.0))));
+    unsigned int rows = (occludees + columns - 1) / columns;
+    float half_width = 0.4 * occludee_near * aspect;
+    float half_height = 0.4 * occludee_near;
+
+    p.positions.clear();
+    for (unsigned int i = 0; i < occludees; i++) {
+        float x = columns > 1 ? (i % columns) / (columns - 1.0) : 0.5;
+        float y = rows > 1 ? (i / columns) / (rows - 1.0) : 0.5;
+        float z = std::fmod(i * 0.618034f, 1.0f);
+
+        p.positions.push_back(vec3(half_width * (2.0 * x - 1.0),
+                                   half_height * (2.0 * y - 1.0),
+                                   -(occludee_near + (occludee_far - occludee_near) * z)));
+    }
+
+    /*
+     * A boolean query can stop counting at the first sample that passes.
+     * Desktop GL before 3.3 only has sample counting queries.
+     */
+#if GLMARK2_USE_GL
+    if (!GLExtensions::version(3, 3) &&
+        !GLExtensions::support("GL_ARB_occlusion_query2"))
+    {
+        p.query_target = GL_SAMPLES_PASSED;
+    }
+    else
+#endif
+    {
+        p.query_target = GL_ANY_SAMPLES_PASSED;
+    }
+
+    p.queries.resize(occludees * (p.latency + 1));
+    GLExtensions::GenQueries(p.queries.size(), &p.queries[0]);
+
+    p.frame = 0;
+    p.tested = 0;
+    p.culled = 0;
+    p.stall_us = 0.0;
+    p.frames = 0;
+
+    currentFrame_ = 0;
+    running_ = true;
+    startTime_ = Util::get_timestamp_us() / 1000000.0;
+    lastUpdateTime_ = startTime_;
+
+    return true;
+}
+
+void
+SceneOcclusion::teardown()
+{
+    SceneOcclusionPrivate &p(*priv_);
+
+    p.program.release();
+    p.model_mesh.reset();
+    p.box_mesh.reset();
+
+    if (!p.queries.empty()) {
+        GLExtensions::DeleteQueries(p.queries.size(), &p.queries[0]);
+        p.queries.clear();
+    }
+
+    Scene::teardown();
+}
+
+void
+SceneOcclusion::update()
+{
+    Scene::update();
+}
+
+void
+SceneOcclusion::draw()
+{
+    SceneOcclusionPrivate &p(*priv_);
+    double elapsed_time = lastUpdateTime_ - startTime_;
+    unsigned int occludees = p.positions.size();
+    float aspect = static_cast<float>(canvas_.width()) / canvas_.height();
+
+    p.program.start();
+
+    /*
+     * Draw the occluders: a row of walls that slide sideways, so that the
+     * occludees behind them are revealed and hidden over time.
+     */
+    float row_width = 0.8 * occluder_depth * aspect;
+    float wall_width = row_width / std::max(p.occluders, 1u);
+
+    for (unsigned int i = 0; i < p.occluders; i++) {
+        float x = -row_width / 2.0 + wall_width * (i + 0.5) +
+                  0.3 * wall_width * std::sin(elapsed_time * (0.7 + 0.2 * i) + i);
+
+        LibMatrix::Stack4 model_view;
+        model_view.translate(x, 0.0, -occluder_depth);
+        model_view.scale(0.4 * wall_width, 0.4 * occluder_depth, 0.2);
+
+        mat4 model_view_proj(p.projection);
+        model_view_proj *= model_view.getCurrent();
+
+        p.program["ModelViewProjectionMatrix"] = model_view_proj;
+        p.program["NormalMatrix"] = mat4();
+        p.program["MaterialColor"] = vec4(0.5, 0.5, 0.55, 1.0);
+        p.box_mesh.render_vbo();
+    }
+
+    /* The transformation of each occludee, and of its bounding box */
+    std::vector<mat4> &transforms(p.transforms);
+    std::vector<mat4> &normal_matrices(p.normal_matrices);
+    std::vector<mat4> &box_transforms(p.box_transforms);
+    transforms.resize(occludees);
+    normal_matrices.resize(occludees);
+    box_transforms.resize(occludees);
+    float scale = occludee_radius / p.radius;
+
+    for (unsigned int i = 0; i < occludees; i++) {
+        const vec3 &pos(p.positions[i]);
+
+        LibMatrix::Stack4 model_view;
+        model_view.translate(pos.x(), pos.y(), pos.z());
+        model_view.rotate(45.0 * elapsed_time + 37.0 * i, 0.0, 1.0, 0.0);
+        model_view.scale(scale, scale, scale);
+        model_view.translate(-p.center.x(), -p.center.y(), -p.center.z());
+
+        transforms[i] = p.projection;
+        transforms[i] *= model_view.getCurrent();
+        normal_matrices[i] = model_view.getCurrent();
+        normal_matrices[i].inverse().transpose();
+
+        /* A box around the bounding sphere covers the model at any rotation */
+        LibMatrix::Stack4 box_view;
+        box_view.translate(pos.x(), pos.y(), pos.z());
+        box_view.scale(occludee_radius, occludee_radius, occludee_radius);
+
+        box_transforms[i] = p.projection;
+        box_transforms[i] *= box_view.getCurrent();
+    }
+
+    /*
+     * Issue the queries of this frame: draw the bounding box of each
+     * occludee without writing color or depth, and count the samples that
+     * pass the depth test against the occluders.
+     */
+    GLuint *issued = &p.queries[(p.frame % (p.latency + 1)) * occludees];
+
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+
+    for (unsigned int i = 0; i < occludees; i++) {
+        p.program["ModelViewProjectionMatrix"] = box_transforms[i];
+        GLExtensions::BeginQuery(p.query_target, issued[i]);
+        p.box_mesh.render_vbo();
+        GLExtensions::EndQuery(p.query_target);
+    }
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+
+    /*
+     * Draw the occludees that were visible latency frames ago.  Waiting
+     * for the results stalls the CPU until the GPU has processed the
+     * queries, which takes longest for the queries of the current frame.
+     * Until the first results arrive, all occludees are drawn.
+     */
+    bool have_results = p.frame >= p.latency;
+    GLuint *results = &p.queries[((p.frame + 1) % (p.latency + 1)) * occludees];
+
+    for (unsigned int i = 0; i < occludees; i++) {
+        if (have_results) {
+            GLuint passed = 0;
+            uint64_t before = Util::get_timestamp_us();
+            GLExtensions::GetQueryObjectuiv(results[i], GL_QUERY_RESULT, &passed);
+            p.stall_us += Util::get_timestamp_us() - before;
+
+            p.tested++;
+            if (!passed) {
+                p.culled++;
+                continue;
+            }
+        }
+
+        float hue = 2.0 * M_PI * i / occludees;
+        p.program["ModelViewProjectionMatrix"] = transforms[i];
+        p.program["NormalMatrix"] = normal_matrices[i];
+        p.program["MaterialColor"] = vec4(0.6 + 0.4 * std::cos(hue),
+                                          0.6 + 0.4 * std::cos(hue - 2.0 * M_PI / 3.0),
+                                          0.6 + 0.4 * std::cos(hue + 2.0 * M_PI / 3.0),
+                                          1.0);
+        p.model_mesh.render_vbo();
+    }
+
+    p.program.stop();
+
+    p.frame++;
+    p.frames++;
+}
+
+std::string
+SceneOcclusion::result_extras()
+{
+    SceneOcclusionPrivate &p(*priv_);
+
+    if (p.frames == 0 || p.tested == 0)
+        return "";
+
+    std::stringstream ss;
+    ss.precision(1);
+    ss << std::fixed;
+    ss << " Culled: " << 100.0 * p.culled / p.tested << "%";
+    ss.precision(3);
+    ss << " Stall: " << p.stall_us / p.frames / 1000.0 << " ms/frame";
+
+    return ss.str();
+}
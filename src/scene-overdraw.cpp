@@ -0,0 +1,282 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "log.h"
+#include "util.h"
+#include "shader-source.h"
+#include "gpu-timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+
+struct SceneOverdrawPrivate
+{
+    Program program;
+    Program prepass_program;
+    Mesh quad_mesh;
+    std::vector<GLint> attrib_locations;
+    std::vector<GLint> prepass_attrib_locations;
+
+    /* The layers in drawing order, as indices from front to back */
+    std::vector<unsigned int> order;
+    bool prepass;
+
+    GPUTimer timer;
+    bool time_gpu;
+    unsigned int frames;
+
+    SceneOverdrawPrivate() :
+        prepass(false), time_gpu(false), frames(0) {}
+};
+
+SceneOverdraw::SceneOverdraw(Canvas &canvas) :
+    Scene(canvas, "overdraw")
+{
+    priv_ = new SceneOverdrawPrivate();
+
+    options_["layers"] = Scene::Option("layers", "8",
+                                       "The number of full screen layers");
+    options_["order"] = Scene::Option("order", "back-to-front",
+                                      "The order in which the layers are drawn",
+                                      "front-to-back,back-to-front,random");
+    options_["prepass"] = Scene::Option("prepass", "false",
+                                        "Whether to lay down the depth of all layers first",
+                                        "false,true");
+    options_["iterations"] = Scene::Option("iterations", "16",
+                                           "The cost of the layer fragment shader, in loop iterations");
+    options_["discard"] = Scene::Option("discard", "false",
+                                        "Whether the fragment shader may discard fragments",
+                                        "false,true");
+    options_["frag-depth"] = Scene::Option("frag-depth", "false",
+                                           "Whether the fragment shader writes the depth",
+                                           "false,true");
+}
+
+SceneOverdraw::~SceneOverdraw()
+{
+    delete priv_;
+}
+
+bool
+SceneOverdraw::supported(bool show_errors)
+{
+    if (options_["frag-depth"].value == "true")
+        return require_capability(GLExtensions::FragmentDepth, show_errors);
+
+    return true;
+}
+
+bool
+SceneOverdraw::load()
+{
+    running_ = false;
+
+    return true;
+}
+
+void
+SceneOverdraw::unload()
+{
+}
+
+bool
+SceneOverdraw::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    SceneOverdrawPrivate &p(*priv_);
+
+    unsigned int layers = Util::fromString<unsigned int>(options_["layers"].value);
+    unsigned int iterations = Util::fromString<unsigned int>(options_["iterations"].value);
+    const std::string &order(options_["order"].value);
+
+    if (layers == 0) {
+        Log::error("SceneOverdraw: there must be at least one layer\n");
+        return false;
+    }
+
+    /*
+     * Discarding or writing the depth in the shader keeps the GPU from
+     * rejecting hidden fragments before shading them.  The pre-pass uses
+     * the same shader without the expensive part, so it produces the same
+     * depth values.
+     */
+    std::stringstream defines;
+    if (options_["frag-depth"].value == "true") {
+#if GLMARK2_USE_GLESv2
+        defines << "#extension GL_EXT_frag_depth : enable" << std::endl;
+        defines << "#define gl_FragDepth gl_FragDepthEXT" << std::endl;
+#endif
+        defines << "#define FRAG_DEPTH" << std::endl;
+    }
+    if (options_["discard"].value == "true")
+        defines << "#define DISCARD" << std::endl;
+
+    ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/overdraw.vert");
+    ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/overdraw.frag");
+    std::stringstream frg_defines;
+    frg_defines << defines.str() << "#define ITERATIONS " << iterations << std::endl;
+
+    if (!Scene::load_shaders_from_strings(p.program, vtx_source.str(),
+                                          frg_defines.str() + frg_source.str()) ||
+        !Scene::load_shaders_from_strings(p.prepass_program, vtx_source.str(),
+                                          defines.str() + "#define ITERATIONS 0\n" +
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    /* A single quad covering the screen */
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    p.quad_mesh.set_vertex_format(vertex_format);
+    p.quad_mesh.make_grid(1, 1, 2.0, 2.0, 0.0);
+    p.quad_mesh.build_vbo();
+    p.attrib_locations.assign(1, p.program["position"].location());
+    p.prepass_attrib_locations.assign(1, p.prepass_program["position"].location());
+
+    /* Layer 0 is the front one */
+    p.order.clear();
+    for (unsigned int i = 0; i < layers; i++)
+        p.order.push_back(order == "back-to-front" ? layers - 1 - i : i);
+
+    if (order == "random") {
+        /* Use a fixed shuffle, so that runs are comparable */
+        unsigned int seed = 12345;
+        for (unsigned int i = layers - 1; i > 0; i--) {
+            seed = seed * 1103515245 + 12345;
+            std::swap(p.order[i], p.order[(seed >> 16) % (i + 1)]);
+        }
+    }
+
+    p.prepass = options_["prepass"].value == "true";
+    p.time_gpu = gpu_timing() && p.timer.init();
+    p.frames = 0;
+
+    currentFrame_ = 0;
+    running_ = true;
+    startTime_ = Util::get_timestamp_us() / 1000000.0;
+    lastUpdateTime_ = startTime_;
+
+    return true;
+}
+
+void
+SceneOverdraw::teardown()
+{
+    SceneOverdrawPrivate &p(*priv_);
+
+    p.program.release();
+    p.prepass_program.release();
+    p.quad_mesh.reset();
+    p.timer.release();
+
+    Scene::teardown();
+}
+
+void
+SceneOverdraw::update()
+{
+    Scene::update();
+}
+
+void
+SceneOverdraw::draw()
+{
+    SceneOverdrawPrivate &p(*priv_);
+    unsigned int layers = p.order.size();
+
+    if (p.time_gpu)
+        p.timer.begin();
+
+    /* Lay down the depth, so that only the front layer passes the test */
+    if (p.prepass) {
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        p.prepass_program.start();
+        p.quad_mesh.set_attrib_locations(p.prepass_attrib_locations);
+        p.prepass_program["Color"] = vec4(1.0, 1.0, 1.0, 1.0);
+
+        for (unsigned int i = 0; i < layers; i++) {
+            p.prepass_program["Depth"] = -0.9f + 1.8f * (i + 0.5f) / layers;
+            p.quad_mesh.render_vbo();
+        }
+
+        p.prepass_program.stop();
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDepthMask(GL_FALSE);
+    }
+
+    p.program.start();
+    p.quad_mesh.set_attrib_locations(p.attrib_locations);
+
+    for (unsigned int i = 0; i < layers; i++) {
+        unsigned int layer = p.order[i];
+        float hue = 2.0 * M_PI * layer / layers;
+
+        p.program["Depth"] = -0.9f + 1.8f * (layer + 0.5f) / layers;
+        p.program["Color"] = vec4(0.5 + 0.5 * std::cos(hue),
+                                  0.5 + 0.5 * std::cos(hue - 2.0 * M_PI / 3.0),
+                                  0.5 + 0.5 * std::cos(hue + 2.0 * M_PI / 3.0),
+                                  1.0);
+        p.quad_mesh.render_vbo();
+    }
+
+    p.program.stop();
+
+    if (p.prepass)
+        glDepthMask(GL_TRUE);
+
+    if (p.time_gpu)
+        p.timer.end();
+
+    p.frames++;
+}
+
+std::string
+SceneOverdraw::result_extras()
+{
+    SceneOverdrawPrivate &p(*priv_);
+    double elapsed_time = lastUpdateTime_ - startTime_;
+    double layers = static_cast<double>(p.frames) * p.order.size();
+
+    if (layers == 0.0 || elapsed_time <= 0.0)
+        return "";
+
+    /*
+     * With perfect hidden surface removal, the cost per layer falls as
+     * layers are added, since only one layer per pixel is shaded; without
+     * it, the cost per layer stays that of a full screen of shading.
+     */
+    std::stringstream ss;
+    ss.precision(1);
+    ss << std::fixed;
+    ss << " Cost: " << elapsed_time * 1000000.0 / layers << " us/layer";
+
+    if (p.time_gpu && p.timer.average_ms() >= 0.0) {
+        ss << " GPU: " << p.timer.average_ms() * 1000.0 / p.order.size()
+           << " us/layer";
+    }
+
+    return ss.str();
+}
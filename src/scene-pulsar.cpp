@@ -32,6 +32,8 @@
 #include "shader-source.h"
 #include "util.h"
 #include "texture.h"
+#include "gl-memory.h"
+#include "scratch-arena.h"
 #include <cmath>
 
 using LibMatrix::vec2;
@@ -43,7 +45,12 @@ using LibMatrix::Stack4;
 ScenePulsar::ScenePulsar(Canvas &pCanvas) :
     Scene(pCanvas, "pulsar"),
     numQuads_(0),
-    texture_(0)
+    texture_(0),
+    use_texture_(false),
+    use_light_(false),
+    use_random_(false),
+    use_ubo_(false),
+    transform_block_("Transform", 0)
 {
     options_["quads"] = Scene::Option("quads", "5", "Number of quads to render");
     options_["texture"] = Scene::Option("texture", "false", "Enable texturing",
@@ -52,12 +59,34 @@ ScenePulsar::ScenePulsar(Canvas &pCanvas) :
                                       "false,true");
     options_["random"] = Scene::Option("random", "false", "Enable random rotation speeds",
                                        "false,true");
+    options_["uniforms"] = Scene::Option("uniforms", "classic",
+                                         "How to upload the per-draw uniforms",
+                                         "classic,ubo");
+
+    bind_option("quads", numQuads_);
+    bind_option("texture", use_texture_);
+    bind_option("light", use_light_);
+    bind_option("random", use_random_);
+
+    transform_block_.add("ModelViewProjectionMatrix", UniformBlock::TypeMat4);
+    transform_block_.add("NormalMatrix", UniformBlock::TypeMat4);
 }
 
 ScenePulsar::~ScenePulsar()
 {
 }
 
+bool
+ScenePulsar::supported(bool show_errors)
+{
+    if (options_["uniforms"].value == "ubo") {
+        return require_capability(GLExtensions::UniformBufferObjects, show_errors) &&
+               require_no_capture("uniform buffers", show_errors);
+    }
+
+    return true;
+}
+
 bool
 ScenePulsar::load()
 {
@@ -87,12 +116,10 @@ ScenePulsar::setup()
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
 
     // Create a rotation for each quad.
-    numQuads_ = Util::fromString<int>(options_["quads"].value);
-
     srand((unsigned)time(0));
     for (int i = 0; i < numQuads_; i++) {
         rotations_.push_back(vec3());
-        if (options_["random"].value == "true") {
+        if (use_random_) {
             rotationSpeeds_.push_back(vec3((static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * 5.0,
                                             (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * 5.0,
                                              0.0));
@@ -111,13 +138,13 @@ ScenePulsar::setup()
     std::string vtx_shader_filename;
     std::string frg_shader_filename;
     static const vec4 lightPosition(-20.0f, 20.0f,-20.0f, 1.0f);
-    if (options_["light"].value == "true") {
+    if (use_light_) {
         vtx_shader_filename = GLMARK_DATA_PATH"/shaders/pulsar-light.vert";
     } else {
         vtx_shader_filename = GLMARK_DATA_PATH"/shaders/pulsar.vert";
     }
 
-    if (options_["texture"].value == "true") {
+    if (use_texture_) {
         frg_shader_filename = GLMARK_DATA_PATH"/shaders/light-basic-tex.frag";
         Texture::find_textures();
         if (!Texture::load("crate-base", &texture_, GL_NEAREST, GL_NEAREST, 0))
@@ -129,17 +156,36 @@ ScenePulsar::setup()
 
     ShaderSource vtx_source(vtx_shader_filename);
     ShaderSource frg_source(frg_shader_filename);
-    if (options_["light"].value == "true") {
+    if (use_light_) {
         // Load the light position constant
         vtx_source.add_const("LightSourcePosition", lightPosition);
     }
 
-    if (!Scene::load_shaders_from_strings(program_, vtx_source.str(),
-                                          frg_source.str()))
+    use_ubo_ = options_["uniforms"].value == "ubo";
+
+    std::string vtx_header;
+    std::string frg_header;
+    if (use_ubo_) {
+        transform_block_.declare(vtx_source);
+        vtx_header = UniformBlock::shader_header(ShaderSource::ShaderTypeVertex);
+        frg_header = UniformBlock::shader_header(ShaderSource::ShaderTypeFragment);
+    }
+
+    if (!Scene::load_shaders_from_strings(program_, vtx_header + vtx_source.str(),
+                                          frg_header + frg_source.str()))
     {
         return false;
     }
 
+    if (use_ubo_) {
+        if (!transform_block_.bind(program_)) {
+            Log::error("ScenePulsar: the program has no transform uniform block\n");
+            return false;
+        }
+        if (!ubo_ring_.init(transform_block_, numQuads_))
+            return false;
+    }
+
     create_and_setup_mesh();
 
     program_.start();
@@ -158,9 +204,10 @@ ScenePulsar::teardown()
 {
     program_.stop();
     program_.release();
+    ubo_ring_.release();
 
-    if (options_["texture"].value == "true") {
-        glDeleteTextures(1, &texture_);
+    if (use_texture_) {
+        GLMemory::delete_textures(1, &texture_);
         texture_ = 0;
     }
 
@@ -191,11 +238,18 @@ ScenePulsar::update()
 void
 ScenePulsar::draw()
 {
-    if (options_["texture"].value == "true") {
+    if (use_texture_) {
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, texture_);
     }
 
+    // With uniform blocks, the data of all the quads is uploaded at once
+    GLintptr *offsets = 0;
+    if (use_ubo_) {
+        offsets = ScratchArena::allocate<GLintptr>(numQuads_);
+        ubo_ring_.begin_frame();
+    }
+
     for (int i = 0; i < numQuads_; i++) {
         // Load the ModelViewProjectionMatrix uniform in the shader
         Stack4 model_view;
@@ -206,17 +260,35 @@ ScenePulsar::draw()
         model_view.rotate(rotations_[i].y(), 0.0f, 1.0f, 0.0f);
         model_view.rotate(rotations_[i].z(), 0.0f, 0.0f, 1.0f);
         model_view_proj *= model_view.getCurrent();
-        program_["ModelViewProjectionMatrix"] = model_view_proj;
+        if (use_ubo_)
+            transform_block_.set(0, model_view_proj);
+        else
+            program_["ModelViewProjectionMatrix"] = model_view_proj;
 
-        if (options_["light"].value == "true") {
+        if (use_light_) {
             // Load the NormalMatrix uniform in the shader. The NormalMatrix is the
             // inverse transpose of the model view matrix.
             mat4 normal_matrix(model_view.getCurrent());
             normal_matrix.inverse().transpose();
-            program_["NormalMatrix"] = normal_matrix;
+            if (use_ubo_)
+                transform_block_.set(1, normal_matrix);
+            else
+                program_["NormalMatrix"] = normal_matrix;
         }
 
-        mesh_.render_vbo();
+        if (use_ubo_)
+            offsets[i] = ubo_ring_.push(transform_block_);
+        else
+            mesh_.render_vbo();
+    }
+
+    if (use_ubo_) {
+        ubo_ring_.flush();
+
+        for (int i = 0; i < numQuads_; i++) {
+            ubo_ring_.bind(transform_block_, offsets[i]);
+            mesh_.render_vbo();
+        }
     }
 }
 
@@ -225,11 +297,7 @@ ScenePulsar::validate()
 {
     static const double radius_3d(std::sqrt(3.0));
 
-    int quads = Util::fromString<int>(options_["quads"].value);
-
-    if (options_["texture"].value != "false" ||
-        options_["light"].value != "false" ||
-        quads != 5)
+    if (use_texture_ || use_light_ || numQuads_ != 5)
     {
         return Scene::ValidationUnknown;
     }
@@ -253,8 +321,8 @@ ScenePulsar::validate()
 void
 ScenePulsar::create_and_setup_mesh()
 {
-    bool texture = options_["texture"].value == "true";
-    bool light = options_["light"].value == "true";
+    bool texture = use_texture_;
+    bool light = use_light_;
 
     struct PlaneMeshVertex {
         vec3 position;
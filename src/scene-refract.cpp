@@ -22,6 +22,7 @@
 #include "scene-refract.h"
 #include "model.h"
 #include "texture.h"
+#include "gl-memory.h"
 #include "util.h"
 #include "log.h"
 #include "shader-source.h"
@@ -100,6 +101,12 @@ SceneRefract::supported(bool show_errors)
 
         return false;
     }
+
+    if (options_["use-vbo"].value == "false" &&
+        !require_capability(GLExtensions::ClientArrays, show_errors))
+    {
+        return false;
+    }
     return true;
 }
 
@@ -212,16 +219,16 @@ DistanceRenderTarget::setup(unsigned int width, unsigned int height)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width_, height_, 0,
-                 GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, 0);
+    GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width_, height_, 0,
+                           GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, 0);
     glBindTexture(GL_TEXTURE_2D, tex_[COLOR]);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width_, height_, 0,
-                 GL_RGBA, GL_UNSIGNED_BYTE, 0);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_RGBA, width_, height_, 0,
+                           GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    GLMemory::generate_mipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
 
     glGenFramebuffers(1, &fbo_);
@@ -246,7 +253,7 @@ DistanceRenderTarget::teardown()
     program_.stop();
     program_.release();
     if (tex_[0]) {
-        glDeleteTextures(2, &tex_[0]);
+        GLMemory::delete_textures(2, &tex_[0]);
         tex_[DEPTH] = tex_[COLOR] = 0;
     }
     if (fbo_) {
@@ -387,6 +394,13 @@ RefractPrivate::setup(map<string, Scene::Option>& options)
         return false;
     }
 
+    depthAttribLocations_.clear();
+    depthAttribLocations_.push_back(depthTarget_.program()["position"].location());
+    depthAttribLocations_.push_back(depthTarget_.program()["normal"].location());
+    attribLocations_.clear();
+    attribLocations_.push_back(program_["position"].location());
+    attribLocations_.push_back(program_["normal"].location());
+
     return true;
 }
 void
@@ -426,10 +440,7 @@ RefractPrivate::draw()
 
     // Enable the depth render target with our transformation and render.
     depthTarget_.enable(mvp);
-    vector<GLint> attrib_locations;
-    attrib_locations.push_back(depthTarget_.program()["position"].location());
-    attrib_locations.push_back(depthTarget_.program()["normal"].location());
-    mesh_.set_attrib_locations(attrib_locations);
+    mesh_.set_attrib_locations(depthAttribLocations_);
     if (useVbo_) {
         mesh_.render_vbo();
     }
@@ -468,10 +479,7 @@ RefractPrivate::draw()
     normal_matrix.inverse().transpose();
     program_["NormalMatrix"] = normal_matrix;
     program_["LightMatrix"] = light_;
-    attrib_locations.clear();
-    attrib_locations.push_back(program_["position"].location());
-    attrib_locations.push_back(program_["normal"].location());
-    mesh_.set_attrib_locations(attrib_locations);
+    mesh_.set_attrib_locations(attribLocations_);
     if (useVbo_) {
         mesh_.render_vbo();
     }
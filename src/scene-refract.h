@@ -75,6 +75,10 @@ class RefractPrivate
     LibMatrix::Stack4 projection_;
     LibMatrix::mat4 light_;
     Mesh mesh_;
+    // The attribute locations of the depth pass and the normal view, looked
+    // up once so that drawing a frame does not allocate.
+    std::vector<GLint> depthAttribLocations_;
+    std::vector<GLint> attribLocations_;
     LibMatrix::vec3 centerVec_;
     bool orientModel_;
     float orientationAngle_;
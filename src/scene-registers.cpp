@@ -0,0 +1,347 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "log.h"
+#include "util.h"
+#include "shader-source.h"
+#include "gl-memory.h"
+#include "gpu-timer.h"
+
+#include <sstream>
+
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+
+struct SceneRegistersPrivate
+{
+    /* One program for each number of live temporaries */
+    std::vector<Program *> programs;
+    std::vector<unsigned int> live_counts;
+    std::vector<GLint> position_locations;
+    std::vector<GLint> attrib_locations;
+    Mesh quad_mesh;
+    GLuint texture;
+
+    unsigned int fetches;
+    unsigned int chain;
+    unsigned int iterations;
+
+    /* The measurements of each program, in batches of frames */
+    unsigned int frames_per_batch;
+    SweepTimer sweep;
+
+    SceneRegistersPrivate() :
+        texture(0), fetches(0), chain(1), iterations(1), frames_per_batch(1) {}
+};
+
+/* A drop in throughput larger than this fraction is reported as a cliff */
+static const double cliff_drop = 0.2;
+
+SceneRegisters::SceneRegisters(Canvas &canvas) :
+    Scene(canvas, "registers")
+{
+    priv_ = new SceneRegistersPrivate();
+
+    options_["live-min"] = Scene::Option("live-min", "4",
+                                         "The smallest number of live vec4 temporaries");
+    options_["live-max"] = Scene::Option("live-max", "64",
+                                         "The largest number of live vec4 temporaries");
+    options_["live-step"] = Scene::Option("live-step", "4",
+                                          "The step between the numbers of live temporaries");
+    options_["fetches"] = Scene::Option("fetches", "0",
+                                        "The number of texture fetch results kept live");
+    options_["chain"] = Scene::Option("chain", "1",
+                                      "The length of the dependency chain updating each temporary");
+    options_["iterations"] = Scene::Option("iterations", "4",
+                                           "The number of loop iterations in the shader");
+    options_["batch"] = Scene::Option("batch", "10",
+                                      "The number of frames measured before moving to the next register count");
+}
+
+SceneRegisters::~SceneRegisters()
+{
+    delete priv_;
+}
+
+bool
+SceneRegisters::load()
+{
+    running_ = false;
+
+    return true;
+}
+
+void
+SceneRegisters::unload()
+{
+}
+
+/**
+ * Generates a fragment shader that keeps a number of vec4 temporaries and
+ * texture fetch results live throughout its loop.
+ *
+ * Each iteration updates every temporary from the next one, so none of
+ * them can be retired early, and the fetch results feed the first updates,
+ * so the fetches can't be moved past the loop.
+ */
+static std::string
+get_fragment_shader_source(unsigned int live, unsigned int fetches,
+                           unsigned int chain, unsigned int iterations)
+{
+    ShaderSource source(GLMARK_DATA_PATH"/shaders/registers.frag");
+
+    for (unsigned int i = 0; i < live; i++) {
+        std::stringstream ss;
+        ss << std::fixed;
+        ss << "    vec4 r" << i << " = Seed * " << (1.0 + 0.01 * i)
+           << " + TexCoord.xyxy;" << std::endl;
+        source.insert("DECLARATIONS", ss.str());
+    }
+
+    for (unsigned int i = 0; i < fetches; i++) {
+        std::stringstream ss;
+        ss << std::fixed;
+        ss << "    vec4 t" << i << " = texture2D(Texture, TexCoord + vec2("
+           << 0.01 * (i + 1) << "));" << std::endl;
+        source.insert("DECLARATIONS", ss.str());
+    }
+
+    for (unsigned int i = 0; i < live; i++) {
+        std::stringstream ss;
+        unsigned int next = (i + 1) % live;
+
+        for (unsigned int c = 0; c < chain; c++) {
+            ss << "        r" << i << " = r" << i << " * r" << next << " + ";
+            /* The first update uses the fetches i, i + live, ... */
+            if (c == 0 && fetches > 0) {
+                unsigned int t = i % fetches;
+                ss << "t" << t;
+                for (t += live; t < fetches; t += live)
+                    ss << " + t" << t;
+                ss << ";" << std::endl;
+            }
+            else {
+                ss << "Seed;" << std::endl;
+            }
+        }
+
+        source.insert("BODY", ss.str());
+    }
+
+    for (unsigned int i = 0; i < live; i++)
+        source.insert("RESULT", "    result += r" + Util::toString(i) + ";\n");
+    for (unsigned int i = 0; i < fetches; i++)
+        source.insert("RESULT", "    result += t" + Util::toString(i) + ";\n");
+
+    std::stringstream defines;
+    defines << "#define ITERATIONS " << iterations << std::endl;
+
+    return defines.str() + source.str();
+}
+
+bool
+SceneRegisters::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    SceneRegistersPrivate &p(*priv_);
+
+    unsigned int live_min = Util::fromString<unsigned int>(options_["live-min"].value);
+    unsigned int live_max = Util::fromString<unsigned int>(options_["live-max"].value);
+    unsigned int live_step = Util::fromString<unsigned int>(options_["live-step"].value);
+    p.fetches = Util::fromString<unsigned int>(options_["fetches"].value);
+    p.chain = Util::fromString<unsigned int>(options_["chain"].value);
+    p.iterations = Util::fromString<unsigned int>(options_["iterations"].value);
+    p.frames_per_batch = Util::fromString<unsigned int>(options_["batch"].value);
+
+    if (live_min == 0 || live_step == 0 || live_max < live_min ||
+        p.chain == 0 || p.frames_per_batch == 0)
+    {
+        Log::error("SceneRegisters: invalid live-min/live-max/live-step/chain/batch values\n");
+        return false;
+    }
+
+    /* Generate the programs */
+    ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/registers.vert");
+
+    for (unsigned int live = live_min; live <= live_max; live += live_step) {
+        Program *program = new Program();
+        p.programs.push_back(program);
+
+        std::string frg(get_fragment_shader_source(live, p.fetches, p.chain,
+                                                   p.iterations));
+
+        if (!Scene::load_shaders_from_strings(*program, vtx_source.str(), frg))
+            return false;
+
+        program->start();
+        (*program)["Texture"] = 0;
+        (*program)["Seed"] = vec4(0.5, 0.25, 0.125, 0.0625);
+        program->stop();
+
+        p.live_counts.push_back(live);
+        p.position_locations.push_back((*program)["position"].location());
+    }
+
+    /* A single quad covering the screen */
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    p.quad_mesh.set_vertex_format(vertex_format);
+    p.quad_mesh.make_grid(1, 1, 2.0, 2.0, 0.0);
+    p.quad_mesh.build_vbo();
+    p.attrib_locations.assign(1, p.position_locations[0]);
+    p.quad_mesh.set_attrib_locations(p.attrib_locations);
+
+    /* A small noise texture for the fetches */
+    static const unsigned int texture_size = 64;
+    std::vector<unsigned char> texels(texture_size * texture_size * 4);
+    for (unsigned int i = 0; i < texels.size(); i++)
+        texels[i] = (i * 2654435761u) >> 24;
+
+    glGenTextures(1, &p.texture);
+    glBindTexture(GL_TEXTURE_2D, p.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_RGBA, texture_size, texture_size,
+                           0, GL_RGBA, GL_UNSIGNED_BYTE, &texels[0]);
+
+    /* Set up the measurements */
+    p.sweep.init(p.programs.size(), p.frames_per_batch, gpu_timing());
+
+    currentFrame_ = 0;
+    running_ = true;
+    startTime_ = Util::get_timestamp_us() / 1000000.0;
+    lastUpdateTime_ = startTime_;
+
+    return true;
+}
+
+void
+SceneRegisters::teardown()
+{
+    SceneRegistersPrivate &p(*priv_);
+
+    for (std::vector<Program *>::iterator iter = p.programs.begin();
+         iter != p.programs.end();
+         iter++)
+    {
+        (*iter)->release();
+        delete *iter;
+    }
+    p.programs.clear();
+    p.live_counts.clear();
+    p.position_locations.clear();
+
+    p.sweep.release();
+
+    p.quad_mesh.reset();
+
+    if (p.texture) {
+        GLMemory::delete_textures(1, &p.texture);
+        p.texture = 0;
+    }
+
+    Scene::teardown();
+}
+
+void
+SceneRegisters::update()
+{
+    Scene::update();
+}
+
+void
+SceneRegisters::draw()
+{
+    SceneRegistersPrivate &p(*priv_);
+
+    /*
+     * Measure each program for a batch of frames and then move to the next
+     * one, so that all of them are measured under the same conditions over
+     * the duration of the scene.
+     */
+    if (p.sweep.batch_done()) {
+        p.sweep.end_batch();
+        p.sweep.start_batch((p.sweep.current() + 1) % p.programs.size());
+
+        p.attrib_locations.assign(1, p.position_locations[p.sweep.current()]);
+        p.quad_mesh.set_attrib_locations(p.attrib_locations);
+    }
+
+    Program &program(*p.programs[p.sweep.current()]);
+
+    glBindTexture(GL_TEXTURE_2D, p.texture);
+    glDisable(GL_DEPTH_TEST);
+
+    p.sweep.begin();
+    program.start();
+    p.quad_mesh.render_vbo();
+    program.stop();
+    p.sweep.end();
+
+    glEnable(GL_DEPTH_TEST);
+}
+
+std::string
+SceneRegisters::result_extras()
+{
+    SceneRegistersPrivate &p(*priv_);
+    double pixels = static_cast<double>(canvas_.width()) * canvas_.height();
+    std::vector<double> throughput;
+
+    /*
+     * The throughput is in vec4 multiply-adds per second (four scalar
+     * operations each).  With enough registers it is roughly independent
+     * of the number of live temporaries; when the temporaries no longer
+     * fit, fewer threads can run at once or values spill to memory, and
+     * it drops.
+     */
+    for (unsigned int i = 0; i < p.programs.size(); i++) {
+        double seconds = p.sweep.seconds(i);
+        double ops = pixels * p.live_counts[i] * p.chain * p.iterations * 4.0;
+        throughput.push_back(seconds > 0.0 ? ops / seconds / 1.0e9 : -1.0);
+    }
+
+    std::stringstream ss;
+    std::stringstream cliffs;
+    ss.precision(2);
+    ss << std::fixed;
+    ss << " Gops/s by live vec4s:";
+
+    for (unsigned int i = 0; i < throughput.size(); i++) {
+        if (throughput[i] < 0.0)
+            continue;
+
+        ss << " " << p.live_counts[i] << "=" << throughput[i];
+
+        if (i > 0 && throughput[i - 1] > 0.0 &&
+            throughput[i] < (1.0 - cliff_drop) * throughput[i - 1])
+        {
+            cliffs << " " << p.live_counts[i];
+        }
+    }
+
+    if (!cliffs.str().empty())
+        ss << " Cliffs at:" << cliffs.str();
+
+    return ss.str();
+}
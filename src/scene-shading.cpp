@@ -30,6 +30,7 @@
 #include "util.h"
 #include "shader-source.h"
 #include "model.h"
+#include "gl-memory.h"
 
 #include <cmath>
 #include <sstream>
@@ -40,8 +41,12 @@ using std::endl;
 
 SceneShading::SceneShading(Canvas &pCanvas) :
     Scene(pCanvas, "shading"),
-    orientModel_(false)
+    orientModel_(false), use_ubo_(false), transform_block_("Transform", 0),
+    clustered_(false), light_threads_(1), index_rows_(0), time_gpu_(false),
+    culling_us_(0), culling_entries_(0), culling_frames_(0)
 {
+    light_textures_[0] = light_textures_[1] = light_textures_[2] = 0;
+
     const ModelMap& modelMap = Model::find_models();
     std::string optionValues;
     for (ModelMap::const_iterator modelIt = modelMap.begin();
@@ -59,17 +64,51 @@ SceneShading::SceneShading(Canvas &pCanvas) :
     }
     options_["shading"] = Scene::Option("shading", "gouraud",
                                         "Which shading method to use",
-                                        "gouraud,blinn-phong-inf,phong,cel");
+                                        "gouraud,blinn-phong-inf,phong,cel,clustered");
     options_["num-lights"] = Scene::Option("num-lights", "1",
-            "The number of lights applied to the scene (phong only)");
+            "The number of lights applied to the scene (phong and clustered only)");
+    options_["tile-size"] = Scene::Option("tile-size", "16",
+            "The size in pixels of the screen tiles used for light culling (clustered only)");
+    options_["light-threads"] = Scene::Option("light-threads", "1",
+            "The number of CPU threads used for light culling (clustered only)");
     options_["model"] = Scene::Option("model", "cat", "Which model to use",
                                       optionValues);
+    options_["uniforms"] = Scene::Option("uniforms", "classic",
+                                         "How to upload the per-draw uniforms",
+                                         "classic,ubo");
+
+    transform_block_.add("ModelViewProjectionMatrix", UniformBlock::TypeMat4);
+    transform_block_.add("NormalMatrix", UniformBlock::TypeMat4);
+    transform_block_.add("ModelViewMatrix", UniformBlock::TypeMat4);
 }
 
 SceneShading::~SceneShading()
 {
 }
 
+bool
+SceneShading::supported(bool show_errors)
+{
+    if (options_["shading"].value == "clustered") {
+        /*
+         * The light data is fetched from float textures by shaders using
+         * the same GLSL version as uniform blocks.
+         */
+        if (!require_capability(GLExtensions::FloatTextures, show_errors) ||
+            !require_capability(GLExtensions::UniformBufferObjects, show_errors))
+        {
+            return false;
+        }
+    }
+
+    if (options_["uniforms"].value == "ubo") {
+        return require_capability(GLExtensions::UniformBufferObjects, show_errors) &&
+               require_no_capture("uniform buffers", show_errors);
+    }
+
+    return true;
+}
+
 bool
 SceneShading::load()
 {
@@ -184,13 +223,43 @@ SceneShading::setup()
         vtx_source.append_file(vtx_shader_filename);
         frg_source.append_file(frg_shader_filename);
     }
+    else if (shading == "clustered") {
+        vtx_shader_filename = GLMARK_DATA_PATH"/shaders/light-phong.vert";
+        frg_shader_filename = GLMARK_DATA_PATH"/shaders/light-clustered.frag";
+        vtx_source.append_file(vtx_shader_filename);
+        frg_source.append_file(frg_shader_filename);
+        frg_source.add_const("MaterialDiffuse", materialDiffuse);
+        frg_source.replace("$TILE_SIZE$", options_["tile-size"].value);
+    }
+
+    use_ubo_ = options_["uniforms"].value == "ubo";
+    clustered_ = shading == "clustered";
+
+    if (use_ubo_)
+        transform_block_.declare(vtx_source);
+
+    std::string vtx_header;
+    std::string frg_header;
+    if (use_ubo_ || clustered_) {
+        vtx_header = UniformBlock::shader_header(ShaderSource::ShaderTypeVertex);
+        frg_header = UniformBlock::shader_header(ShaderSource::ShaderTypeFragment);
+    }
 
-    if (!Scene::load_shaders_from_strings(program_, vtx_source.str(),
-                                          frg_source.str()))
+    if (!Scene::load_shaders_from_strings(program_, vtx_header + vtx_source.str(),
+                                          frg_header + frg_source.str()))
     {
         return false;
     }
 
+    if (use_ubo_) {
+        if (!transform_block_.bind(program_)) {
+            Log::error("SceneShading: the program has no transform uniform block\n");
+            return false;
+        }
+        if (!ubo_ring_.init(transform_block_, 1))
+            return false;
+    }
+
     Model model;
     const std::string& whichModel(options_["model"].value);
     bool modelLoaded = model.load(whichModel);
@@ -260,6 +329,9 @@ SceneShading::setup()
     attrib_locations.push_back(program_["normal"].location());
     mesh_.set_attrib_locations(attrib_locations);
 
+    if (clustered_ && !setup_clustered())
+        return false;
+
     currentFrame_ = 0;
     rotation_ = 0.0f;
     running_ = true;
@@ -274,6 +346,10 @@ SceneShading::teardown()
 {
     program_.stop();
     program_.release();
+    ubo_ring_.release();
+
+    if (clustered_)
+        teardown_clustered();
 
     Scene::teardown();
 }
@@ -302,18 +378,37 @@ SceneShading::draw()
     LibMatrix::mat4 model_view_proj(perspective_);
     model_view_proj *= model_view.getCurrent();
 
-    program_["ModelViewProjectionMatrix"] = model_view_proj;
-
-    // Load the NormalMatrix uniform in the shader. The NormalMatrix is the
-    // inverse transpose of the model view matrix.
+    // The NormalMatrix is the inverse transpose of the model view matrix.
     LibMatrix::mat4 normal_matrix(model_view.getCurrent());
     normal_matrix.inverse().transpose();
-    program_["NormalMatrix"] = normal_matrix;
 
-    // Load the modelview matrix itself
-    program_["ModelViewMatrix"] = model_view.getCurrent();
+    if (use_ubo_) {
+        // Upload all the matrices with a single buffer update
+        transform_block_.set(0, model_view_proj);
+        transform_block_.set(1, normal_matrix);
+        transform_block_.set(2, model_view.getCurrent());
+
+        ubo_ring_.begin_frame();
+        GLintptr offset = ubo_ring_.push(transform_block_);
+        ubo_ring_.flush();
+        ubo_ring_.bind(transform_block_, offset);
+    }
+    else {
+        program_["ModelViewProjectionMatrix"] = model_view_proj;
+        program_["NormalMatrix"] = normal_matrix;
+        program_["ModelViewMatrix"] = model_view.getCurrent();
+    }
+
+    if (clustered_)
+        update_clustered();
+
+    if (time_gpu_)
+        gpu_timer_.begin();
 
     mesh_.render_vbo();
+
+    if (time_gpu_)
+        gpu_timer_.end();
 }
 
 Scene::ValidationResult
@@ -351,3 +446,191 @@ SceneShading::validate()
         return Scene::ValidationFailure;
     }
 }
+
+std::string
+SceneShading::result_extras()
+{
+    if (!clustered_ || culling_frames_ == 0)
+        return "";
+
+    std::stringstream ss;
+    ss.precision(3);
+    ss << std::fixed;
+    ss << " LightCulling: " << culling_us_ / 1000.0 / culling_frames_ << " ms";
+    if (time_gpu_ && gpu_timer_.average_ms() >= 0.0)
+        ss << " GPU: " << gpu_timer_.average_ms() << " ms";
+    ss.precision(1);
+    ss << " Lights/tile: "
+       << static_cast<double>(culling_entries_) / culling_frames_ /
+          (light_grid_.tiles_x() * light_grid_.tiles_y());
+
+    return ss.str();
+}
+
+/**
+ * Creates a texture holding RGBA float data that is read with texelFetch().
+ */
+static void
+create_float_texture(GLuint &texture, unsigned int width, unsigned int height)
+{
+    if (!texture)
+        glGenTextures(1, &texture);
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0,
+                           GL_RGBA, GL_FLOAT, 0);
+}
+
+/**
+ * A hash of an integer to [0, 1), for placing the lights.
+ */
+static float
+light_random(unsigned int i, unsigned int component)
+{
+    float f = std::sin((i * 4 + component) * 12.9898f) * 43758.5453f;
+    return f - std::floor(f);
+}
+
+bool
+SceneShading::setup_clustered()
+{
+    static const float near = 2.0;
+    static const unsigned int lights_per_row = LightGrid::texture_width / 2;
+
+    unsigned int num_lights = Util::fromString<unsigned int>(options_["num-lights"].value);
+    unsigned int tile_size = Util::fromString<unsigned int>(options_["tile-size"].value);
+    light_threads_ = Util::fromString<unsigned int>(options_["light-threads"].value);
+
+    if (num_lights == 0 || tile_size == 0) {
+        Log::error("SceneShading: num-lights and tile-size must be positive\n");
+        return false;
+    }
+
+    /*
+     * The lights orbit the model.  Their range shrinks as their number
+     * grows, so that each fragment is lit by roughly the same number of
+     * lights, while the number of lights per tile stays bounded.
+     */
+    float light_range = radius_ * 1.5 / std::cbrt(static_cast<float>(num_lights));
+    float intensity = 0.8;
+
+    light_orbits_.resize(num_lights);
+    light_x_.resize(num_lights);
+    light_y_.resize(num_lights);
+    light_z_.resize(num_lights);
+    light_radius_.assign(num_lights, light_range);
+
+    unsigned int light_rows = (num_lights + lights_per_row - 1) / lights_per_row;
+    light_texels_.assign(4 * LightGrid::texture_width * light_rows, 0.0);
+
+    for (unsigned int i = 0; i < num_lights; i++) {
+        /* Orbit radius, height, phase and angular speed */
+        light_orbits_[i] = LibMatrix::vec4(radius_ * (0.5 + 0.7 * light_random(i, 0)),
+                                           radius_ * (1.6 * light_random(i, 1) - 0.8),
+                                           2.0 * M_PI * light_random(i, 2),
+                                           0.5 + 1.5 * light_random(i, 3));
+
+        /* The color texel follows the position/radius texel */
+        float hue = 2.0 * M_PI * i / num_lights;
+        float *color = &light_texels_[8 * i + 4];
+        color[0] = intensity * (0.5 + 0.5 * std::cos(hue));
+        color[1] = intensity * (0.5 + 0.5 * std::cos(hue - 2.0 * M_PI / 3.0));
+        color[2] = intensity * (0.5 + 0.5 * std::cos(hue + 2.0 * M_PI / 3.0));
+        color[3] = 1.0;
+    }
+
+    light_grid_.configure(canvas_.width(), canvas_.height(), tile_size,
+                          perspective_, near, light_threads_);
+
+    create_float_texture(light_textures_[0], light_grid_.tiles_x(),
+                         light_grid_.tiles_y());
+    create_float_texture(light_textures_[1], LightGrid::texture_width, 1);
+    create_float_texture(light_textures_[2], LightGrid::texture_width, light_rows);
+    index_rows_ = 1;
+
+    program_["LightTiles"] = 0;
+    program_["LightIndices"] = 1;
+    program_["Lights"] = 2;
+
+    time_gpu_ = gpu_timing() && gpu_timer_.init();
+    culling_us_ = 0;
+    culling_entries_ = 0;
+    culling_frames_ = 0;
+
+    return true;
+}
+
+void
+SceneShading::update_clustered()
+{
+    uint64_t start = Util::get_timestamp_us();
+
+    /* Move the lights around the center of the model, in view space */
+    double elapsed_time = lastUpdateTime_ - startTime_;
+    float center_z = -(2.0 + radius_);
+    unsigned int num_lights = light_orbits_.size();
+
+    for (unsigned int i = 0; i < num_lights; i++) {
+        const LibMatrix::vec4 &orbit(light_orbits_[i]);
+        float angle = orbit.z() + orbit.w() * elapsed_time;
+        light_x_[i] = orbit.x() * std::cos(angle);
+        light_y_[i] = orbit.y();
+        light_z_[i] = center_z + orbit.x() * std::sin(angle);
+    }
+
+    light_grid_.assign(&light_x_[0], &light_y_[0], &light_z_[0],
+                       &light_radius_[0], num_lights);
+
+    culling_us_ += Util::get_timestamp_us() - start;
+    culling_entries_ += light_grid_.entries();
+    culling_frames_++;
+
+    for (unsigned int i = 0; i < num_lights; i++) {
+        float *sphere = &light_texels_[8 * i];
+        sphere[0] = light_x_[i];
+        sphere[1] = light_y_[i];
+        sphere[2] = light_z_[i];
+        sphere[3] = light_radius_[i];
+    }
+
+    /* Upload the grid, growing the index texture if needed */
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, light_textures_[0]);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                    light_grid_.tiles_x(), light_grid_.tiles_y(),
+                    GL_RGBA, GL_FLOAT, &light_grid_.tiles()[0]);
+
+    glActiveTexture(GL_TEXTURE1);
+    if (light_grid_.index_rows() > index_rows_) {
+        index_rows_ = light_grid_.index_rows();
+        create_float_texture(light_textures_[1], LightGrid::texture_width,
+                             index_rows_);
+    }
+    glBindTexture(GL_TEXTURE_2D, light_textures_[1]);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                    LightGrid::texture_width, light_grid_.index_rows(),
+                    GL_RGBA, GL_FLOAT, &light_grid_.indices()[0]);
+
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, light_textures_[2]);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                    LightGrid::texture_width,
+                    light_texels_.size() / (4 * LightGrid::texture_width),
+                    GL_RGBA, GL_FLOAT, &light_texels_[0]);
+
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void
+SceneShading::teardown_clustered()
+{
+    GLMemory::delete_textures(3, light_textures_);
+    light_textures_[0] = light_textures_[1] = light_textures_[2] = 0;
+    light_grid_.release();
+    gpu_timer_.release();
+    time_gpu_ = false;
+}
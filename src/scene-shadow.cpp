@@ -22,6 +22,7 @@
 #include "scene.h"
 #include "model.h"
 #include "util.h"
+#include "gl-memory.h"
 #include "log.h"
 #include "shader-source.h"
 #include "stack.h"
@@ -53,6 +54,7 @@ class DepthRenderTarget
     unsigned int height_;
     unsigned int tex_;
     unsigned int fbo_;
+    bool invalidate_;
 public:
     DepthRenderTarget() :
         canvas_width_(0),
@@ -60,9 +62,10 @@ public:
         width_(0),
         height_(0),
         tex_(0),
-        fbo_(0) {}
+        fbo_(0),
+        invalidate_(false) {}
     ~DepthRenderTarget() {}
-    bool setup(unsigned int width, unsigned int height);
+    bool setup(unsigned int width, unsigned int height, bool invalidate);
     void teardown();
     void enable(const mat4& mvp);
     void disable();
@@ -71,7 +74,7 @@ public:
 };
 
 bool
-DepthRenderTarget::setup(unsigned int width, unsigned int height)
+DepthRenderTarget::setup(unsigned int width, unsigned int height, bool invalidate)
 {
     static const string vtx_shader_filename(GLMARK_DATA_PATH"/shaders/depth.vert");
     static const string frg_shader_filename(GLMARK_DATA_PATH"/shaders/depth.frag");
@@ -85,6 +88,7 @@ DepthRenderTarget::setup(unsigned int width, unsigned int height)
 
     canvas_width_ = width;
     canvas_height_ = height;
+    invalidate_ = invalidate && GLExtensions::InvalidateFramebuffer;
     width_ = canvas_width_ * 2;
     height_ = canvas_height_ * 2;
 
@@ -107,8 +111,8 @@ DepthRenderTarget::setup(unsigned int width, unsigned int height)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width_, height_, 0,
-                 GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, 0);
+    GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width_, height_, 0,
+                           GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
 
     glGenFramebuffers(1, &fbo_);
@@ -131,7 +135,7 @@ DepthRenderTarget::teardown()
     program_.stop();
     program_.release();
     if (tex_) {
-        glDeleteTextures(1, &tex_);
+        GLMemory::delete_textures(1, &tex_);
         tex_ = 0;
     }
     if (fbo_) {
@@ -150,6 +154,13 @@ DepthRenderTarget::enable(const mat4& mvp)
                            tex_, 0);
     glViewport(0, 0, width_, height_);
     glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    // The previous frame's shadow map is no longer needed.  Saying so lets
+    // tilers skip restoring it, and lets drivers give the pass fresh storage
+    // instead of waiting for the previous ground pass to finish sampling it.
+    if (invalidate_) {
+        static const GLenum attachment(GL_DEPTH_ATTACHMENT);
+        GLExtensions::InvalidateFramebuffer(GL_FRAMEBUFFER, 1, &attachment);
+    }
     glClear(GL_DEPTH_BUFFER_BIT);
 }
 
@@ -222,8 +233,8 @@ GroundRenderer::setup(const mat4& projection, unsigned int texture)
     // Set up the VBO and stash our position data in it.
     glGenBuffers(1, &bufferObject_);
     glBindBuffer(GL_ARRAY_BUFFER, bufferObject_);
-    glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(vec2),
-                 &vertices_.front(), GL_STATIC_DRAW);
+    GLMemory::buffer_data(GL_ARRAY_BUFFER, vertices_.size() * sizeof(vec2),
+                          &vertices_.front(), GL_STATIC_DRAW);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     // Set up the light matrix with a bias that will convert values
@@ -245,7 +256,7 @@ GroundRenderer::teardown()
     program_.stop();
     program_.release();
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glDeleteBuffers(1, &bufferObject_);
+    GLMemory::delete_buffers(1, &bufferObject_);
     bufferObject_ = 0;
     texture_= 0;
     vertices_.clear();
@@ -289,6 +300,10 @@ class ShadowPrivate
     Stack4 modelview_;
     Stack4 projection_;
     Mesh mesh_;
+    // The attribute locations of the depth pass and the normal view, looked
+    // up once so that drawing a frame does not allocate.
+    vector<GLint> depthAttribLocations_;
+    vector<GLint> attribLocations_;
     vec3 centerVec_;
     float radius_;
     float rotation_;
@@ -372,7 +387,8 @@ ShadowPrivate::setup(map<string, Scene::Option>& options)
     float aspect(static_cast<float>(canvas_.width())/static_cast<float>(canvas_.height()));
     projection_.perspective(fovy, aspect, 2.0, 50.0);
 
-    if (!depthTarget_.setup(canvas_.width(), canvas_.height())) {
+    bool invalidate = options["invalidate"].value == "true";
+    if (!depthTarget_.setup(canvas_.width(), canvas_.height(), invalidate)) {
         Log::error("Failed to set up the render target for the depth pass\n");
         return false;
     }
@@ -382,6 +398,13 @@ ShadowPrivate::setup(map<string, Scene::Option>& options)
         return false;
     }
 
+    depthAttribLocations_.clear();
+    depthAttribLocations_.push_back(depthTarget_.program()["position"].location());
+    depthAttribLocations_.push_back(depthTarget_.program()["normal"].location());
+    attribLocations_.clear();
+    attribLocations_.push_back(program_["position"].location());
+    attribLocations_.push_back(program_["normal"].location());
+
     return true;
 }
 
@@ -420,10 +443,7 @@ ShadowPrivate::draw()
 
     // Enable the depth render target with our transformation and render.
     depthTarget_.enable(mvp);
-    vector<GLint> attrib_locations;
-    attrib_locations.push_back(depthTarget_.program()["position"].location());
-    attrib_locations.push_back(depthTarget_.program()["normal"].location());
-    mesh_.set_attrib_locations(attrib_locations);
+    mesh_.set_attrib_locations(depthAttribLocations_);
     if (useVbo_) {
         mesh_.render_vbo();
     }
@@ -450,10 +470,7 @@ ShadowPrivate::draw()
     LibMatrix::mat4 normal_matrix(modelview_.getCurrent());
     normal_matrix.inverse().transpose();
     program_["NormalMatrix"] = normal_matrix;
-    attrib_locations.clear();
-    attrib_locations.push_back(program_["position"].location());
-    attrib_locations.push_back(program_["normal"].location());
-    mesh_.set_attrib_locations(attrib_locations);
+    mesh_.set_attrib_locations(attribLocations_);
     if (useVbo_) {
         mesh_.render_vbo();
     }
@@ -475,6 +492,9 @@ SceneShadow::SceneShadow(Canvas& canvas) :
     options_["interleave"] = Scene::Option("interleave", "false",
                                            "Whether to interleave vertex attribute data",
                                            "false,true");
+    options_["invalidate"] = Scene::Option("invalidate", "false",
+                                           "Whether to invalidate the shadow map before each depth pass",
+                                           "false,true");
 }
 
 bool
@@ -490,6 +510,18 @@ SceneShadow::supported(bool show_errors)
 
         return false;
     }
+
+    if (options_["use-vbo"].value == "false" &&
+        !require_capability(GLExtensions::ClientArrays, show_errors))
+    {
+        return false;
+    }
+
+    if (options_["invalidate"].value == "true") {
+        return require_capability(GLExtensions::FramebufferInvalidation, show_errors) &&
+               require_no_capture("framebuffer invalidation", show_errors);
+    }
+
     return true;
 }
 
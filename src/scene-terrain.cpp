@@ -29,6 +29,7 @@
 #include "texture.h"
 #include "shader-source.h"
 #include "renderer.h"
+#include "render-graph.h"
 
 using LibMatrix::vec2;
 using LibMatrix::vec3;
@@ -39,9 +40,12 @@ class SceneTerrainPrivate
 {
 public:
     SceneTerrainPrivate(Canvas &canvas, const LibMatrix::vec2 &repeat_overlay,
-                        bool use_bloom, bool use_tilt_shift) :
+                        bool use_bloom, bool use_tilt_shift, bool alias,
+                        bool invalidate, float anisotropy, float lod_bias) :
         canvas(canvas), repeat_overlay(repeat_overlay),
         use_bloom(use_bloom), use_tilt_shift(use_tilt_shift),
+        alias(alias), invalidate(invalidate),
+        anisotropy(anisotropy), lod_bias(lod_bias), scheduled(false),
         terrain_renderer(0), bloom_v_renderer(0), bloom_h_renderer(0),
         overlay_renderer(0), tilt_v_renderer(0), tilt_h_renderer(0),
         copy_renderer(0), height_map_renderer(0), normal_map_renderer(0),
@@ -65,20 +69,15 @@ public:
         const vec2 grass_res(512.0f, 512.0f);
 
         height_map_renderer = new SimplexNoiseRenderer(map_res);
-        height_map_renderer->setup(height_map_renderer->size(), false, false);
 
         normal_map_renderer = new NormalFromHeightRenderer(map_res);
-        normal_map_renderer->setup(normal_map_renderer->size(), false, false);
 
         specular_map_renderer = new LuminanceRenderer(grass_res);
         specular_map_renderer->setup_texture(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR,
                                              GL_REPEAT, GL_REPEAT);
-        specular_map_renderer->setup(specular_map_renderer->size(), false, false);
 
-        terrain_renderer = new TerrainRenderer(screen_res, repeat_overlay);
-        terrain_renderer->setup(terrain_renderer->size(),
-                                !use_bloom && !use_tilt_shift,
-                                true);
+        terrain_renderer = new TerrainRenderer(screen_res, repeat_overlay,
+                                               anisotropy, lod_bias);
         terrain_renderer->setup_texture(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR,
                                         GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
 
@@ -90,7 +89,6 @@ public:
                                                 0.0);
             bloom_h_renderer->setup_texture(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR,
                                             GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
-            bloom_h_renderer->setup(bloom_h_renderer->size(), false, false);
 
             bloom_v_renderer = new BlurRenderer(bloom_res, 2, 4.0,
                                                 BlurRenderer::BlurDirectionVertical,
@@ -98,7 +96,6 @@ public:
                                                 0.0);
             bloom_v_renderer->setup_texture(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR,
                                             GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
-            bloom_v_renderer->setup(bloom_v_renderer->size(), false, false);
             overlay_renderer = new OverlayRenderer(*terrain_renderer, 0.6);
         }
 
@@ -110,7 +107,6 @@ public:
                                                0.5);
             tilt_h_renderer->setup_texture(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR,
                                            GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
-            tilt_h_renderer->setup(tilt_h_renderer->size(), false, false);
 
             tilt_v_renderer = new BlurRenderer(screen_res, 4, 2.7,
                                                BlurRenderer::BlurDirectionVertical,
@@ -122,6 +118,10 @@ public:
         if (use_bloom && !use_tilt_shift)
             copy_renderer = new CopyRenderer(screen_res);
 
+        scheduled = schedule_renderers();
+        if (!scheduled)
+            return;
+
         /* Height normal chain */
         height_normal_chain = new RendererChain();
         height_normal_chain->append(*height_map_renderer);
@@ -168,6 +168,98 @@ public:
         specular_map_renderer->input_texture(terrain_renderer->diffuse1_texture());
     }
 
+    /**
+     * Declares the render targets and passes of a frame, and sets up the
+     * renderers to use them.  The renderers not set up here render to the
+     * screen.
+     *
+     * @return whether the render targets are complete
+     */
+    bool schedule_renderers()
+    {
+        const unsigned int screen = RenderGraph::screen;
+        const vec2 map_res(height_map_renderer->size());
+        const vec2 grass_res(specular_map_renderer->size());
+        const vec2 screen_res(terrain_renderer->size());
+        bool terrain_offscreen = use_bloom || use_tilt_shift;
+
+        /* Targets */
+        unsigned int height_map = graph.add_target(map_res.x(), map_res.y(),
+                                                   GL_RGBA, false);
+        unsigned int normal_map = graph.add_target(map_res.x(), map_res.y(),
+                                                   GL_RGBA, false);
+        /* The specular map is rendered once, at setup */
+        unsigned int specular_map = graph.add_target(grass_res.x(), grass_res.y(),
+                                                     GL_RGBA, false, true);
+        unsigned int terrain = screen;
+        if (terrain_offscreen) {
+            terrain = graph.add_target(screen_res.x(), screen_res.y(),
+                                       GL_RGBA, true);
+        }
+
+        /* Passes */
+        unsigned int height_pass = graph.add_pass(height_map);
+
+        unsigned int normal_pass = graph.add_pass(normal_map);
+        graph.add_input(normal_pass, height_map);
+
+        unsigned int terrain_pass = graph.add_pass(terrain);
+        graph.add_input(terrain_pass, height_map);
+        graph.add_input(terrain_pass, normal_map);
+        graph.add_input(terrain_pass, specular_map);
+
+        unsigned int bloom_h = 0, bloom_v = 0, tilt_h = 0;
+        unsigned int bloom_h_pass = 0, bloom_v_pass = 0, overlay_pass = 0;
+        unsigned int tilt_h_pass = 0;
+
+        if (use_bloom) {
+            const vec2 bloom_res(bloom_h_renderer->size());
+            bloom_h = graph.add_target(bloom_res.x(), bloom_res.y(), GL_RGBA, false);
+            bloom_v = graph.add_target(bloom_res.x(), bloom_res.y(), GL_RGBA, false);
+
+            bloom_h_pass = graph.add_pass(bloom_h);
+            graph.add_input(bloom_h_pass, terrain);
+            bloom_v_pass = graph.add_pass(bloom_v);
+            graph.add_input(bloom_v_pass, bloom_h);
+            overlay_pass = graph.add_pass(terrain);
+            graph.add_input(overlay_pass, bloom_v);
+        }
+
+        if (use_tilt_shift) {
+            tilt_h = graph.add_target(screen_res.x(), screen_res.y(), GL_RGBA, false);
+
+            tilt_h_pass = graph.add_pass(tilt_h);
+            graph.add_input(tilt_h_pass, terrain);
+            unsigned int tilt_v_pass = graph.add_pass(screen);
+            graph.add_input(tilt_v_pass, tilt_h);
+        }
+        else if (use_bloom) {
+            unsigned int copy_pass = graph.add_pass(screen);
+            graph.add_input(copy_pass, terrain);
+        }
+
+        if (!graph.compile(alias, invalidate))
+            return false;
+
+        height_map_renderer->setup(graph, height_map, height_pass);
+        normal_map_renderer->setup(graph, normal_map, normal_pass);
+        specular_map_renderer->setup(graph, specular_map, screen);
+
+        if (terrain_offscreen)
+            terrain_renderer->setup(graph, terrain, terrain_pass);
+
+        if (use_bloom) {
+            bloom_h_renderer->setup(graph, bloom_h, bloom_h_pass);
+            bloom_v_renderer->setup(graph, bloom_v, bloom_v_pass);
+            overlay_renderer->setup(graph, overlay_pass);
+        }
+
+        if (use_tilt_shift)
+            tilt_h_renderer->setup(graph, tilt_h, tilt_h_pass);
+
+        return true;
+    }
+
     void release_renderers()
     {
         delete terrain_chain;
@@ -191,6 +283,13 @@ public:
     LibMatrix::vec2 repeat_overlay;
     bool use_bloom;
     bool use_tilt_shift;
+    bool alias;
+    bool invalidate;
+    float anisotropy;
+    float lod_bias;
+    RenderGraph graph;
+    /* Whether the render targets were set up successfully */
+    bool scheduled;
 
     /* Renderers */
     TerrainRenderer *terrain_renderer;
@@ -223,6 +322,16 @@ SceneTerrain::SceneTerrain(Canvas &pCanvas) :
     options_["tilt-shift"] = Scene::Option("tilt-shift", "true",
                                            "Use tilt-shift post-processing effect",
                                            "false,true");
+    options_["alias"] = Scene::Option("alias", "true",
+                                      "Share render targets whose lifetimes don't overlap",
+                                      "false,true");
+    options_["invalidate"] = Scene::Option("invalidate", "false",
+                                           "Invalidate render target contents that are not needed",
+                                           "false,true");
+    options_["anisotropy"] = Scene::Option("anisotropy", "1",
+                                           "The maximum degree of anisotropic filtering of the terrain textures (1-16)");
+    options_["lod-bias"] = Scene::Option("lod-bias", "0.0",
+                                         "The bias added to the level of detail of the terrain textures");
 }
 
 SceneTerrain::~SceneTerrain()
@@ -241,8 +350,21 @@ SceneTerrain::supported(bool show_errors)
                    "but GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS is %d\n",
                    vertex_textures);
     }
-    
-    return vertex_textures > 0;
+
+    if (vertex_textures <= 0)
+        return false;
+
+    if (options_["invalidate"].value == "true" &&
+        (!require_capability(GLExtensions::FramebufferInvalidation, show_errors) ||
+         !require_no_capture("framebuffer invalidation", show_errors)))
+    {
+        return false;
+    }
+
+    if (Util::fromString<float>(options_["anisotropy"].value) > 1.0)
+        return require_capability(GLExtensions::AnisotropicFiltering, show_errors);
+
+    return true;
 }
 
 bool
@@ -272,9 +394,16 @@ SceneTerrain::setup()
     LibMatrix::vec2 repeat_overlay(repeat, repeat);
     bool use_bloom = options_["bloom"].value == "true";
     bool use_tilt_shift = options_["tilt-shift"].value == "true";
+    bool alias = options_["alias"].value == "true";
+    bool invalidate = options_["invalidate"].value == "true";
+    float anisotropy = Util::fromString<float>(options_["anisotropy"].value);
+    float lod_bias = Util::fromString<float>(options_["lod-bias"].value);
 
     priv_ = new SceneTerrainPrivate(canvas_, repeat_overlay,
-                                    use_bloom, use_tilt_shift);
+                                    use_bloom, use_tilt_shift, alias, invalidate,
+                                    anisotropy, lod_bias);
+    if (!priv_->scheduled)
+        return false;
 
     /* Set up terrain rendering program */
     LibMatrix::Stack4 model;
@@ -355,6 +484,15 @@ SceneTerrain::draw()
     priv_->terrain_chain->render();
 }
 
+std::string
+SceneTerrain::result_extras()
+{
+    if (!priv_)
+        return "";
+
+    return priv_->graph.memory_summary();
+}
+
 Scene::ValidationResult
 SceneTerrain::validate()
 {
@@ -20,19 +20,25 @@
  *  Alexandros Frantzis
  */
 #include "renderer.h"
+#include "gl-memory.h"
 
 BaseRenderer::BaseRenderer(const LibMatrix::vec2 &size) :
     texture_(0), input_texture_(0), fbo_(0), depth_renderbuffer_(0),
     min_filter_(GL_LINEAR), mag_filter_(GL_LINEAR),
-    wrap_s_(GL_CLAMP_TO_EDGE), wrap_t_(GL_CLAMP_TO_EDGE)
+    wrap_s_(GL_CLAMP_TO_EDGE), wrap_t_(GL_CLAMP_TO_EDGE),
+    graph_(0), graph_target_(0), graph_pass_(RenderGraph::screen)
 {
     setup(size, true, true);
 }
 
 BaseRenderer::~BaseRenderer()
 {
-    glDeleteTextures(1, &texture_);
-    glDeleteRenderbuffers(1, &depth_renderbuffer_);
+    /* The render graph owns its targets */
+    if (graph_)
+        return;
+
+    GLMemory::delete_textures(1, &texture_);
+    GLMemory::delete_renderbuffers(1, &depth_renderbuffer_);
     glDeleteFramebuffers(1, &fbo_);
 }
 
@@ -43,6 +49,21 @@ BaseRenderer::setup(const LibMatrix::vec2 &size, bool onscreen, bool has_depth)
     recreate(onscreen, has_depth);
 }
 
+void
+BaseRenderer::setup(RenderGraph &graph, unsigned int target, unsigned int pass)
+{
+    recreate(true, false);
+
+    graph_ = &graph;
+    graph_target_ = target;
+    graph_pass_ = pass;
+    texture_ = graph.texture(target);
+    fbo_ = graph.fbo(target);
+    depth_renderbuffer_ = graph.depth_renderbuffer(target);
+
+    update_texture_parameters();
+}
+
 void
 BaseRenderer::setup_texture(GLint min_filter, GLint mag_filter,
                             GLint wrap_s, GLint wrap_t)
@@ -74,19 +95,48 @@ BaseRenderer::update_mipmap()
 {
     if (texture_ && min_filter_ != GL_NEAREST && min_filter_ != GL_LINEAR) {
         glBindTexture(GL_TEXTURE_2D, texture_);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        GLMemory::generate_mipmap(GL_TEXTURE_2D);
+    }
+}
+
+void
+BaseRenderer::begin_pass()
+{
+    make_current();
+
+    if (graph_ && graph_pass_ != RenderGraph::screen) {
+        graph_->begin_pass(graph_pass_);
+
+        /* Other renderers may have left their parameters on the texture */
+        if (graph_->aliased(graph_target_))
+            apply_texture_parameters();
     }
 }
 
+void
+BaseRenderer::end_pass()
+{
+    if (graph_ && graph_pass_ != RenderGraph::screen)
+        graph_->end_pass(graph_pass_);
+}
+
 void
 BaseRenderer::recreate(bool onscreen, bool has_depth)
 {
+    /* Forget the render graph target, which we don't own */
+    if (graph_) {
+        graph_ = 0;
+        texture_ = 0;
+        fbo_ = 0;
+        depth_renderbuffer_ = 0;
+    }
+
     if (texture_) {
-        glDeleteTextures(1, &texture_);
+        GLMemory::delete_textures(1, &texture_);
         texture_ = 0;
     }
     if (fbo_) {
-        glDeleteRenderbuffers(1, &depth_renderbuffer_);
+        GLMemory::delete_renderbuffers(1, &depth_renderbuffer_);
         depth_renderbuffer_ = 0;
         glDeleteFramebuffers(1, &fbo_);
         fbo_ = 0;
@@ -102,13 +152,13 @@ BaseRenderer::create_texture()
 {
     glGenTextures(1, &texture_);
     glBindTexture(GL_TEXTURE_2D, texture_);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size_.x(), size_.y(), 0,
+    GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_RGBA, size_.x(), size_.y(), 0,
             GL_RGBA, GL_UNSIGNED_BYTE, 0);
     update_texture_parameters();
 }
 
 void
-BaseRenderer::update_texture_parameters()
+BaseRenderer::apply_texture_parameters()
 {
     if (texture_) {
         glBindTexture(GL_TEXTURE_2D, texture_);
@@ -117,6 +167,12 @@ BaseRenderer::update_texture_parameters()
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_s_);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_t_);
     }
+}
+
+void
+BaseRenderer::update_texture_parameters()
+{
+    apply_texture_parameters();
     update_mipmap();
 }
 
@@ -127,7 +183,7 @@ BaseRenderer::create_fbo(bool has_depth)
         /* Create a renderbuffer for depth storage */
         glGenRenderbuffers(1, &depth_renderbuffer_);
         glBindRenderbuffer(GL_RENDERBUFFER, depth_renderbuffer_);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16,
+        GLMemory::renderbuffer_storage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16,
                 size_.x(), size_.y());
     }
 
@@ -24,7 +24,8 @@
 #include "shader-source.h"
 
 OverlayRenderer::OverlayRenderer(IRenderer &target, GLfloat opacity) :
-    target_renderer_(target), opacity_(opacity)
+    target_renderer_(target), opacity_(opacity), graph_(0),
+    graph_pass_(RenderGraph::screen)
 
 {
     create_program();
@@ -40,6 +41,13 @@ OverlayRenderer::setup(const LibMatrix::vec2 &size, bool onscreen, bool has_dept
     static_cast<void>(has_depth);
 }
 
+void
+OverlayRenderer::setup(RenderGraph &graph, unsigned int pass)
+{
+    graph_ = &graph;
+    graph_pass_ = pass;
+}
+
 void
 OverlayRenderer::setup_texture(GLint min_filter, GLint mag_filter,
                                GLint wrap_s, GLint wrap_t)
@@ -66,6 +74,8 @@ void
 OverlayRenderer::render()
 {
     target_renderer_.make_current();
+    if (graph_)
+        graph_->begin_pass(graph_pass_);
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, input_texture_);
@@ -80,6 +90,8 @@ OverlayRenderer::render()
 
     glDisable(GL_BLEND);
 
+    if (graph_)
+        graph_->end_pass(graph_pass_);
     target_renderer_.update_mipmap();
 }
 
@@ -26,6 +26,7 @@
 #include "vec.h"
 #include "program.h"
 #include "gl-headers.h"
+#include "render-graph.h"
 
 /** 
  * Renderer interface.
@@ -122,9 +123,22 @@ public:
     virtual void update_mipmap();
     virtual void render() = 0;
 
+    /**
+     * Sets up the renderer to render to a target of a render graph.
+     *
+     * @param graph the compiled render graph
+     * @param target the target to render to
+     * @param pass the pass of the graph the renderer performs, or
+     *        RenderGraph::screen if it renders outside the frame passes
+     */
+    void setup(RenderGraph &graph, unsigned int target, unsigned int pass);
+
 protected:
     void recreate(bool onscreen, bool has_depth);
+    void begin_pass();
+    void end_pass();
     void create_texture();
+    void apply_texture_parameters();
     void update_texture_parameters();
     void create_fbo(bool has_depth);
 
@@ -137,6 +151,9 @@ protected:
     GLint mag_filter_;
     GLint wrap_s_;
     GLint wrap_t_;
+    RenderGraph *graph_;
+    unsigned int graph_target_;
+    unsigned int graph_pass_;
 };
 
 /** 
@@ -270,6 +287,11 @@ public:
                        GLint wrap_s, GLint wrap_t);
     void input_texture(GLuint t) { input_texture_ = t; }
     virtual GLuint texture() { return target_renderer_.texture(); }
+
+    /**
+     * Sets the pass of a render graph the renderer performs.
+     */
+    void setup(RenderGraph &graph, unsigned int pass);
     virtual LibMatrix::vec2 size() { return target_renderer_.size(); }
     virtual void render();
     void make_current();
@@ -284,6 +306,8 @@ private:
     IRenderer &target_renderer_;
     GLfloat opacity_;
     GLuint input_texture_;
+    RenderGraph *graph_;
+    unsigned int graph_pass_;
 };
 
 /** 
@@ -293,7 +317,8 @@ private:
 class TerrainRenderer : public BaseRenderer
 {
 public:
-    TerrainRenderer(const LibMatrix::vec2 &size, const LibMatrix::vec2 &repeat_overlay);
+    TerrainRenderer(const LibMatrix::vec2 &size, const LibMatrix::vec2 &repeat_overlay,
+                    float anisotropy, float lod_bias);
     virtual ~TerrainRenderer();
 
     /* IRenderable Methods */
@@ -345,4 +370,6 @@ private:
     GLuint diffuse2_tex_;
     GLuint detail_tex_;
     LibMatrix::vec2 repeat_overlay_;
+    float anisotropy_;
+    float lod_bias_;
 };
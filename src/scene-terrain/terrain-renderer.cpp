@@ -22,12 +22,17 @@
 #include "scene.h"
 #include "renderer.h"
 #include "texture.h"
+#include "gl-memory.h"
 #include "shader-source.h"
 
+#include <sstream>
+
 TerrainRenderer::TerrainRenderer(const LibMatrix::vec2 &size,
-                                 const LibMatrix::vec2 &repeat_overlay) :
+                                 const LibMatrix::vec2 &repeat_overlay,
+                                 float anisotropy, float lod_bias) :
     BaseRenderer(size), height_map_tex_(0), normal_map_tex_(0),
-    specular_map_tex_(0), repeat_overlay_(repeat_overlay)
+    specular_map_tex_(0), repeat_overlay_(repeat_overlay),
+    anisotropy_(anisotropy), lod_bias_(lod_bias)
 {
     create_mesh();
     init_textures();
@@ -42,7 +47,7 @@ TerrainRenderer::~TerrainRenderer()
 void
 TerrainRenderer::render()
 {
-    make_current();
+    begin_pass();
     glClearColor(0.825f, 0.7425f, 0.61875f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
 
@@ -53,6 +58,7 @@ TerrainRenderer::render()
 
     program_.stop();
 
+    end_pass();
     update_mipmap();
 }
 
@@ -79,6 +85,13 @@ TerrainRenderer::init_textures()
     glBindTexture(GL_TEXTURE_2D, detail_tex_);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    /* The overlay textures are seen at grazing angles */
+    if (anisotropy_ > 1.0) {
+        Texture::set_anisotropy(diffuse1_tex_, anisotropy_);
+        Texture::set_anisotropy(diffuse2_tex_, anisotropy_);
+        Texture::set_anisotropy(detail_tex_, anisotropy_);
+    }
 }
 
 
@@ -88,8 +101,15 @@ TerrainRenderer::init_program()
     ShaderSource vtx_shader(GLMARK_DATA_PATH"/shaders/terrain.vert");
     ShaderSource frg_shader(GLMARK_DATA_PATH"/shaders/terrain.frag");
 
-    if (!Scene::load_shaders_from_strings(program_, vtx_shader.str(), frg_shader.str()))
+    std::stringstream frg_defines;
+    if (lod_bias_ != 0.0)
+        frg_defines << std::fixed << "#define LOD_BIAS " << lod_bias_ << std::endl;
+
+    if (!Scene::load_shaders_from_strings(program_, vtx_shader.str(),
+                                          frg_defines.str() + frg_shader.str()))
+    {
         return;
+    }
 
     program_.start();
     /* Fog */
@@ -163,9 +183,9 @@ TerrainRenderer::bind_textures()
 void
 TerrainRenderer::deinit_textures()
 {
-    glDeleteTextures(1, &diffuse1_tex_);
-    glDeleteTextures(1, &diffuse2_tex_);
-    glDeleteTextures(1, &detail_tex_);
+    GLMemory::delete_textures(1, &diffuse1_tex_);
+    GLMemory::delete_textures(1, &diffuse2_tex_);
+    GLMemory::delete_textures(1, &detail_tex_);
 }
 
 static void
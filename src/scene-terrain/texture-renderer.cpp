@@ -52,7 +52,7 @@ TextureRenderer::create_mesh()
 void
 TextureRenderer::render()
 {
-    make_current();
+    begin_pass();
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -65,5 +65,6 @@ TextureRenderer::render()
 
     program_.stop();
 
+    end_pass();
     update_mipmap();
 }
@@ -0,0 +1,476 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "log.h"
+#include "util.h"
+#include "shader-source.h"
+#include "gpu-timer.h"
+#include "gl-memory.h"
+#include "texture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using LibMatrix::vec2;
+using LibMatrix::vec3;
+using LibMatrix::vec4;
+
+namespace {
+
+struct TexcacheFormat
+{
+    const char *name;
+    GLenum format;
+    GLenum type;
+    unsigned int bytes;
+};
+
+const TexcacheFormat formats[] = {
+    {"rgba8", GL_RGBA, GL_UNSIGNED_BYTE, 4},
+    {"rgb8", GL_RGB, GL_UNSIGNED_BYTE, 3},
+    {"rgb565", GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 2},
+    {"rgba4", GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, 2}
+};
+
+}
+
+struct SceneTexcachePrivate
+{
+    Program program;
+    Mesh quad_mesh;
+
+    const TexcacheFormat *format;
+    bool mipmap;
+    unsigned int fetches;
+
+    /* The sizes in the sweep, and a texture of each size */
+    std::vector<unsigned int> widths;
+    std::vector<unsigned int> heights;
+    std::vector<GLuint> textures;
+    std::vector<bool> failed;
+
+    /* The measurements of each size, in batches of frames */
+    unsigned int frames_per_batch;
+    SweepTimer sweep;
+
+    SceneTexcachePrivate() :
+        format(0), mipmap(false), fetches(1),
+        frames_per_batch(1) {}
+};
+
+SceneTexcache::SceneTexcache(Canvas &canvas) :
+    Scene(canvas, "texcache")
+{
+    priv_ = new SceneTexcachePrivate();
+
+    options_["size-min"] = Scene::Option("size-min", "16",
+                                         "The size of the smallest texture in KiB");
+    options_["size-max"] = Scene::Option("size-max", "262144",
+                                         "The size of the largest texture in KiB");
+    options_["size-factor"] = Scene::Option("size-factor", "4",
+                                            "The factor between consecutive texture sizes");
+    options_["format"] = Scene::Option("format", "rgba8",
+                                       "The texture format",
+                                       "rgba8,rgb8,rgb565,rgba4");
+    options_["pattern"] = Scene::Option("pattern", "coherent",
+                                        "The texture access pattern",
+                                        "coherent,strided,rotated,random,dependent");
+    options_["stride"] = Scene::Option("stride", "16",
+                                       "The horizontal distance in texels between neighbouring pixels for the strided pattern");
+    options_["angle"] = Scene::Option("angle", "90",
+                                      "The rotation in degrees of the texture for the rotated pattern");
+    options_["lod"] = Scene::Option("lod", "0",
+                                    "The log2 of the texels covered by a pixel, which selects the mip level when mipmapping");
+    options_["filter"] = Scene::Option("filter", "linear",
+                                       "The texture filter",
+                                       "nearest,linear,mipmap");
+    options_["anisotropy"] = Scene::Option("anisotropy", "1",
+                                           "The maximum degree of anisotropic filtering");
+    options_["fetches"] = Scene::Option("fetches", "4",
+                                        "The number of texture fetches per pixel");
+    options_["batch"] = Scene::Option("batch", "10",
+                                      "The number of frames measured with a texture size before moving to the next");
+}
+
+SceneTexcache::~SceneTexcache()
+{
+    delete priv_;
+}
+
+bool
+SceneTexcache::supported(bool show_errors)
+{
+    if (Util::fromString<float>(options_["anisotropy"].value) > 1.0)
+        return require_capability(GLExtensions::AnisotropicFiltering, show_errors);
+
+    return true;
+}
+
+bool
+SceneTexcache::load()
+{
+    running_ = false;
+
+    return true;
+}
+
+void
+SceneTexcache::unload()
+{
+}
+
+/**
+ * Fills a buffer with pseudo-random bytes.
+ *
+ * The contents must be random so that the dependent pattern reads
+ * unpredictable addresses, but need not be of high quality.
+ */
+static void
+fill_random(std::vector<unsigned char> &data)
+{
+    unsigned int state = 2463534242u;
+
+    for (size_t i = 0; i < data.size(); i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        data[i] = state >> 24;
+    }
+}
+
+/**
+ * Gets a short label for a size in bytes, e.g. 16K or 64M.
+ */
+static std::string
+size_label(size_t bytes)
+{
+    std::stringstream ss;
+
+    if (bytes < 1024 * 1024)
+        ss << bytes / 1024 << "K";
+    else
+        ss << bytes / (1024 * 1024) << "M";
+
+    return ss.str();
+}
+
+/**
+ * Uploads random contents to the texture of one of the sizes in the sweep.
+ *
+ * @param data scratch space for the contents
+ *
+ * @return whether the texture could be allocated
+ */
+static bool
+upload_texture(SceneTexcachePrivate &p, unsigned int index,
+               std::vector<unsigned char> &data)
+{
+    const TexcacheFormat &format(*p.format);
+    data.resize(static_cast<size_t>(p.widths[index]) * p.heights[index] *
+                format.bytes);
+    fill_random(data);
+
+    while (glGetError() != GL_NO_ERROR);
+
+    glBindTexture(GL_TEXTURE_2D, p.textures[index]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, format.format,
+                           p.widths[index], p.heights[index], 0,
+                           format.format, format.type, &data[0]);
+    if (p.mipmap)
+        GLMemory::generate_mipmap(GL_TEXTURE_2D);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    return glGetError() == GL_NO_ERROR;
+}
+
+bool
+SceneTexcache::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    SceneTexcachePrivate &p(*priv_);
+
+    unsigned int size_min = Util::fromString<unsigned int>(options_["size-min"].value);
+    unsigned int size_max = Util::fromString<unsigned int>(options_["size-max"].value);
+    unsigned int size_factor = Util::fromString<unsigned int>(options_["size-factor"].value);
+    const std::string &pattern(options_["pattern"].value);
+    const std::string &filter(options_["filter"].value);
+    float lod_scale = std::pow(2.0f, Util::fromString<float>(options_["lod"].value));
+
+    p.fetches = Util::fromString<unsigned int>(options_["fetches"].value);
+    p.frames_per_batch = Util::fromString<unsigned int>(options_["batch"].value);
+    p.mipmap = filter == "mipmap";
+
+    if (size_min == 0 || size_factor < 2 || size_max < size_min) {
+        Log::error("SceneTexcache: the texture sizes must satisfy 0 < size-min <= size-max and size-factor >= 2\n");
+        return false;
+    }
+
+    if (p.fetches == 0 || p.frames_per_batch == 0) {
+        Log::error("SceneTexcache: fetches and batch must be at least 1\n");
+        return false;
+    }
+
+    p.format = &formats[0];
+    for (unsigned int i = 0; i < sizeof(formats) / sizeof(*formats); i++) {
+        if (options_["format"].value == formats[i].name)
+            p.format = &formats[i];
+    }
+
+    /*
+     * Each texture has a power of two number of texels, as close to square
+     * as possible, so that it can repeat and be mipmapped on GLES2.  Sizes
+     * that are not a whole number of texels are rounded down.
+     */
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+
+    for (unsigned long long kib = size_min; kib <= size_max; kib *= size_factor) {
+        unsigned long long texels = 1;
+        while (texels * 2 <= kib * 1024 / p.format->bytes)
+            texels *= 2;
+
+        unsigned int width = 1;
+        while (static_cast<unsigned long long>(width) * width < texels)
+            width *= 2;
+        unsigned int height = std::max<unsigned long long>(texels / width, 1);
+
+        if (width > static_cast<unsigned int>(max_size)) {
+            Log::info("SceneTexcache: skipping %ux%u textures, larger than the maximum texture size\n",
+                      width, height);
+            break;
+        }
+
+        p.widths.push_back(width);
+        p.heights.push_back(height);
+    }
+
+    /*
+     * The coherent, strided and rotated patterns map pixels to texels with
+     * a linear transform; further fetches read the windows of the texture
+     * above the first one, so a frame touches fetches times a screen of
+     * texels.  The random pattern hashes the pixel position and fetch index
+     * to its coordinates, so that every fetch of every pixel can touch any
+     * texel, and the dependent one reads them from the previous fetch.
+     */
+    std::stringstream defines;
+    defines << "#define FETCHES " << p.fetches << std::endl;
+    if (pattern == "random")
+        defines << "#define PATTERN_RANDOM" << std::endl;
+    else if (pattern == "dependent")
+        defines << "#define PATTERN_DEPENDENT" << std::endl;
+
+    /* Coordinates in large textures need more than mediump precision */
+    ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/texcache.vert");
+    ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/texcache.frag");
+    ShaderSource::Precision precision(ShaderSource::default_precision(ShaderSource::ShaderTypeFragment));
+    precision.float_precision = ShaderSource::PrecisionValueHigh;
+    frg_source.precision(precision);
+
+    if (!Scene::load_shaders_from_strings(p.program, vtx_source.str(),
+                                          defines.str() + frg_source.str()))
+    {
+        return false;
+    }
+
+    float angle = pattern == "rotated" ?
+        Util::fromString<float>(options_["angle"].value) * M_PI / 180.0 : 0.0;
+    float stride = pattern == "strided" ?
+        Util::fromString<float>(options_["stride"].value) : 1.0;
+
+    p.program.start();
+    p.program["Texture"] = 0;
+    p.program["Viewport"] = vec2(canvas_.width(), canvas_.height());
+    p.program["Transform"] = vec4(lod_scale * stride * std::cos(angle),
+                                  lod_scale * std::sin(angle),
+                                  -lod_scale * std::sin(angle),
+                                  lod_scale * std::cos(angle));
+    p.program["WindowOffset"] = vec2(0.0, canvas_.height() * lod_scale);
+    p.program.stop();
+
+    /* A single quad covering the screen */
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    p.quad_mesh.set_vertex_format(vertex_format);
+    p.quad_mesh.make_grid(1, 1, 2.0, 2.0, 0.0);
+    p.quad_mesh.build_vbo();
+    p.quad_mesh.set_attrib_locations(std::vector<GLint>(1, p.program["position"].location()));
+
+    unsigned int count = p.widths.size();
+    if (count == 0) {
+        Log::error("SceneTexcache: no texture size fits in the maximum texture size\n");
+        return false;
+    }
+
+    /*
+     * Upload a texture of each size now, so that moving to the next size
+     * while drawing only binds another texture.  Sizes that fail to
+     * allocate are skipped.
+     */
+    float anisotropy = Util::fromString<float>(options_["anisotropy"].value);
+    std::vector<unsigned char> data;
+    unsigned int uploaded = 0;
+
+    p.textures.assign(count, 0);
+    p.failed.assign(count, false);
+    glGenTextures(count, &p.textures[0]);
+
+    for (unsigned int i = 0; i < count; i++) {
+        glBindTexture(GL_TEXTURE_2D, p.textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                        p.mipmap ? GL_LINEAR_MIPMAP_LINEAR :
+                        filter == "nearest" ? GL_NEAREST : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+                        filter == "nearest" ? GL_NEAREST : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        if (anisotropy > 1.0)
+            Texture::set_anisotropy(p.textures[i], anisotropy);
+
+        if (upload_texture(p, i, data)) {
+            uploaded++;
+        }
+        else {
+            Log::info("SceneTexcache: failed to allocate a %ux%u texture\n",
+                      p.widths[i], p.heights[i]);
+            p.failed[i] = true;
+        }
+    }
+
+    if (uploaded == 0) {
+        Log::error("SceneTexcache: no texture could be allocated\n");
+        return false;
+    }
+
+    /* Keep the uploads out of the measurements */
+    glFinish();
+
+    /* Set up the measurements */
+    p.sweep.init(count, p.frames_per_batch, gpu_timing());
+    while (p.failed[p.sweep.current()])
+        p.sweep.start_batch(p.sweep.current() + 1);
+
+    currentFrame_ = 0;
+    running_ = true;
+    startTime_ = Util::get_timestamp_us() / 1000000.0;
+    lastUpdateTime_ = startTime_;
+
+    return true;
+}
+
+void
+SceneTexcache::teardown()
+{
+    SceneTexcachePrivate &p(*priv_);
+
+    p.program.release();
+    p.quad_mesh.reset();
+
+    p.sweep.release();
+
+    if (!p.textures.empty())
+        GLMemory::delete_textures(p.textures.size(), &p.textures[0]);
+
+    p.widths.clear();
+    p.heights.clear();
+    p.textures.clear();
+    p.failed.clear();
+
+    Scene::teardown();
+}
+
+void
+SceneTexcache::update()
+{
+    Scene::update();
+}
+
+void
+SceneTexcache::draw()
+{
+    SceneTexcachePrivate &p(*priv_);
+
+    /*
+     * Measure each size for a batch of frames and then move to the next
+     * one, skipping the sizes that failed to allocate.
+     */
+    if (p.sweep.batch_done()) {
+        unsigned int count = p.widths.size();
+        unsigned int next = p.sweep.current();
+
+        p.sweep.end_batch();
+
+        do {
+            next = (next + 1) % count;
+        } while (p.failed[next]);
+
+        p.sweep.start_batch(next);
+    }
+
+    unsigned int current = p.sweep.current();
+
+    glBindTexture(GL_TEXTURE_2D, p.textures[current]);
+    glDisable(GL_DEPTH_TEST);
+
+    p.sweep.begin();
+    p.program.start();
+    p.program["TextureSize"] = vec2(p.widths[current], p.heights[current]);
+    p.quad_mesh.render_vbo();
+    p.program.stop();
+    p.sweep.end();
+
+    glEnable(GL_DEPTH_TEST);
+}
+
+std::string
+SceneTexcache::result_extras()
+{
+    SceneTexcachePrivate &p(*priv_);
+    double fetches = static_cast<double>(canvas_.width()) * canvas_.height() *
+                     p.fetches;
+
+    /*
+     * The throughput counts each texture fetch as one texel, whatever the
+     * filter.  It stays flat while the texture fits in a cache level and
+     * drops where it stops fitting; the drop after the last level is the
+     * miss penalty of memory.
+     */
+    std::stringstream ss;
+    ss.precision(2);
+    ss << std::fixed;
+    ss << " Gtexels/s by size:";
+
+    for (unsigned int i = 0; i < p.widths.size(); i++) {
+        if (p.failed[i])
+            continue;
+
+        double seconds = p.sweep.seconds(i);
+        if (seconds <= 0.0)
+            continue;
+
+        size_t bytes = static_cast<size_t>(p.widths[i]) * p.heights[i] *
+                       p.format->bytes;
+        ss << " " << size_label(bytes) << "=" << fetches / seconds / 1.0e9;
+    }
+
+    return ss.str();
+}
@@ -0,0 +1,655 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "log.h"
+#include "util.h"
+#include "texture.h"
+#include "image-reader.h"
+#include "gl-memory.h"
+#include "gl-state.h"
+#include "gpu-timer.h"
+#include "shader-source.h"
+
+#include <pthread.h>
+#include <algorithm>
+#include <memory>
+#include <sstream>
+
+/* An image decoded to RGBA, with the rows in reverse Y order */
+struct TextureStreamImage
+{
+    std::vector<unsigned char> pixels;
+    unsigned int width;
+    unsigned int height;
+
+    TextureStreamImage() : width(0), height(0) {}
+};
+
+/*
+ * A texture of the pool.  A slot goes from Free to Uploading in the producer
+ * thread, to Ready when its upload fence has been flushed, to InUse when the
+ * render thread samples it and back to Free when the render thread moves to
+ * a newer slot.  The release fence keeps the producer from overwriting the
+ * texture before the draws that sample it are done.
+ */
+struct TextureStreamSlot
+{
+    enum State {
+        StateFree,
+        StateUploading,
+        StateReady,
+        StateInUse
+    };
+
+    GLuint texture;
+    State state;
+    GLsync upload_fence;
+    GLsync release_fence;
+    unsigned int width;
+    unsigned int height;
+    uint64_t publish_time;
+
+    TextureStreamSlot() :
+        texture(0), state(StateFree), upload_fence(0), release_fence(0),
+        width(0), height(0), publish_time(0) {}
+};
+
+struct SceneTextureStreamPrivate
+{
+    Program program;
+    Mesh mesh;
+
+    std::vector<const TextureDescriptor *> descriptors;
+    std::vector<TextureStreamImage> images;
+    unsigned int max_width;
+    unsigned int max_height;
+    bool decode;
+    bool gpu_wait;
+
+    /*
+     * The slots and the indices below are protected by the mutex, except
+     * for the textures, which do not change while the producer runs.
+     */
+    std::vector<TextureStreamSlot> slots;
+    int current;
+    int ready;
+
+    GLSharedContext *shared_context;
+    pthread_t producer;
+    bool producer_started;
+    pthread_mutex_t mutex;
+    pthread_cond_t slot_freed;
+    bool stop;
+    bool producer_failed;
+
+    /* Producer statistics, protected by the mutex */
+    uint64_t uploads;
+    uint64_t upload_bytes;
+    uint64_t dropped;
+
+    /* Render thread statistics */
+    uint64_t handoffs;
+    uint64_t handoff_us;
+    uint64_t stall_us;
+    /* Times the GPU-side wait for an upload, which glWaitSync only queues */
+    GPUTimer wait_timer;
+    bool time_wait;
+    unsigned int frames;
+    uint64_t start_time;
+    uint64_t end_time;
+
+    SceneTextureStreamPrivate() :
+        max_width(0), max_height(0), decode(true), gpu_wait(true),
+        current(-1), ready(-1), shared_context(0), producer_started(false),
+        stop(false), producer_failed(false), uploads(0), upload_bytes(0),
+        dropped(0), handoffs(0), handoff_us(0), stall_us(0), time_wait(false),
+        frames(0),
+        start_time(0), end_time(0)
+    {
+        pthread_mutex_init(&mutex, 0);
+        pthread_cond_init(&slot_freed, 0);
+    }
+
+    ~SceneTextureStreamPrivate()
+    {
+        pthread_cond_destroy(&slot_freed);
+        pthread_mutex_destroy(&mutex);
+    }
+};
+
+SceneTextureStream::SceneTextureStream(Canvas &canvas) :
+    Scene(canvas, "texture-stream")
+{
+    priv_ = new SceneTextureStreamPrivate();
+
+    options_["textures"] = Scene::Option("textures",
+                                         "crate-base,nasa1,terrain-grasslight-512",
+                                         "A comma separated list of the textures that the producer uploads in turn");
+    options_["pool-size"] = Scene::Option("pool-size", "3",
+                                          "The number of textures in the pool");
+    options_["wait"] = Scene::Option("wait", "gpu",
+                                     "How the render thread waits for an upload (gpu: glWaitSync, cpu: glClientWaitSync)",
+                                     "gpu,cpu");
+    options_["decode"] = Scene::Option("decode", "true",
+                                       "Whether the producer decodes the image before each upload, or reuses images decoded at setup",
+                                       "false,true");
+}
+
+SceneTextureStream::~SceneTextureStream()
+{
+    delete priv_;
+}
+
+bool
+SceneTextureStream::supported(bool show_errors)
+{
+    return require_capability(GLExtensions::SyncObjects, show_errors) &&
+           require_no_capture("sync objects", show_errors);
+}
+
+bool
+SceneTextureStream::load()
+{
+    running_ = false;
+
+    return true;
+}
+
+void
+SceneTextureStream::unload()
+{
+}
+
+/**
+ * Decodes an image to RGBA.
+ *
+ * The storage of the image and of the row buffer is reused when it is large
+ * enough, so that decoding into buffers sized for the largest image does not
+ * allocate.
+ */
+static bool
+decode_image(const TextureDescriptor &desc, TextureStreamImage &image,
+             std::vector<unsigned char> &row)
+{
+    std::unique_ptr<ImageReader> reader;
+
+    if (desc.filetype() == TextureDescriptor::FileTypePNG)
+        reader.reset(new PNGReader(desc.pathname()));
+    else if (desc.filetype() == TextureDescriptor::FileTypeJPEG)
+        reader.reset(new JPEGReader(desc.pathname()));
+    else
+        return false;
+
+    if (reader->error())
+        return false;
+
+    unsigned int width = reader->width();
+    unsigned int height = reader->height();
+    unsigned int bpp = reader->pixelBytes();
+
+    if (image.pixels.size() < width * height * 4)
+        image.pixels.resize(width * height * 4);
+    if (row.size() < width * bpp)
+        row.resize(width * bpp);
+
+    image.width = width;
+    image.height = height;
+
+    for (unsigned int y = height; y > 0; y--) {
+        if (!reader->nextRow(&row[0]))
+            return false;
+
+        unsigned char *dst = &image.pixels[(y - 1) * width * 4];
+        const unsigned char *src = &row[0];
+
+        for (unsigned int x = 0; x < width; x++, src += bpp, dst += 4) {
+            if (bpp >= 3) {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = bpp == 4 ? src[3] : 255;
+            }
+            else {
+                dst[0] = dst[1] = dst[2] = src[0];
+                dst[3] = bpp == 2 ? src[1] : 255;
+            }
+        }
+    }
+
+    return !reader->error();
+}
+
+static int
+find_free_slot(const std::vector<TextureStreamSlot> &slots)
+{
+    for (unsigned int i = 0; i < slots.size(); i++) {
+        if (slots[i].state == TextureStreamSlot::StateFree)
+            return i;
+    }
+
+    return -1;
+}
+
+/**
+ * The producer thread, which decodes and uploads the textures in turn with
+ * the shared context, and publishes each one with a fence.
+ *
+ * A ready slot that the render thread has not picked up when the next one is
+ * published goes back to the pool and is counted as dropped.
+ */
+static void *
+produce_textures(void *arg)
+{
+    SceneTextureStreamPrivate &p(*static_cast<SceneTextureStreamPrivate *>(arg));
+
+    if (!p.shared_context->make_current()) {
+        pthread_mutex_lock(&p.mutex);
+        p.producer_failed = true;
+        pthread_mutex_unlock(&p.mutex);
+        return 0;
+    }
+
+    TextureStreamImage decoded;
+    std::vector<unsigned char> row;
+    decoded.pixels.resize(p.max_width * p.max_height * 4);
+    row.resize(p.max_width * 4);
+    unsigned int next_image = 0;
+
+    pthread_mutex_lock(&p.mutex);
+
+    while (!p.stop) {
+        int index = find_free_slot(p.slots);
+        if (index < 0) {
+            pthread_cond_wait(&p.slot_freed, &p.mutex);
+            continue;
+        }
+
+        TextureStreamSlot &slot(p.slots[index]);
+        GLsync release_fence = slot.release_fence;
+        slot.release_fence = 0;
+        slot.state = TextureStreamSlot::StateUploading;
+
+        pthread_mutex_unlock(&p.mutex);
+
+        /* Queue the upload behind the draws that sampled the texture last */
+        if (release_fence) {
+            GLExtensions::WaitSync(release_fence, 0, GL_TIMEOUT_IGNORED);
+            GLExtensions::DeleteSync(release_fence);
+        }
+
+        const TextureStreamImage *image = &p.images[next_image];
+        bool decoded_ok = true;
+
+        if (p.decode) {
+            decoded_ok = decode_image(*p.descriptors[next_image], decoded, row);
+            image = &decoded;
+        }
+
+        next_image = (next_image + 1) % p.images.size();
+
+        GLsync upload_fence = 0;
+
+        if (decoded_ok) {
+            glBindTexture(GL_TEXTURE_2D, slot.texture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image->width, image->height,
+                            GL_RGBA, GL_UNSIGNED_BYTE, &image->pixels[0]);
+            upload_fence = GLExtensions::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            /* The fence must reach the GPU, since another context waits on it */
+            glFlush();
+        }
+
+        pthread_mutex_lock(&p.mutex);
+
+        if (!decoded_ok) {
+            slot.state = TextureStreamSlot::StateFree;
+            p.producer_failed = true;
+            break;
+        }
+
+        slot.upload_fence = upload_fence;
+        slot.width = image->width;
+        slot.height = image->height;
+        slot.publish_time = Util::get_timestamp_us();
+        slot.state = TextureStreamSlot::StateReady;
+
+        if (p.ready >= 0) {
+            TextureStreamSlot &stale(p.slots[p.ready]);
+            GLExtensions::DeleteSync(stale.upload_fence);
+            stale.upload_fence = 0;
+            stale.state = TextureStreamSlot::StateFree;
+            p.dropped++;
+        }
+
+        p.ready = index;
+        p.uploads++;
+        p.upload_bytes += image->width * image->height * 4;
+    }
+
+    pthread_mutex_unlock(&p.mutex);
+
+    p.shared_context->release_current();
+
+    return 0;
+}
+
+bool
+SceneTextureStream::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    SceneTextureStreamPrivate &p(*priv_);
+
+    unsigned int pool_size = Util::fromString<unsigned int>(options_["pool-size"].value);
+    if (pool_size < 2) {
+        Log::error("SceneTextureStream: the pool needs at least 2 textures\n");
+        return false;
+    }
+
+    /* Decode the images once, to size the pool and for decode=false */
+    std::vector<std::string> names;
+    Util::split(options_["textures"].value, ',', names, Util::SplitModeNormal);
+
+    const TextureMap &textures = Texture::find_textures();
+    std::vector<unsigned char> row;
+
+    p.descriptors.clear();
+    p.images.clear();
+    p.max_width = 0;
+    p.max_height = 0;
+
+    for (std::vector<std::string>::const_iterator iter = names.begin();
+         iter != names.end();
+         iter++)
+    {
+        TextureMap::const_iterator desc = textures.find(*iter);
+        if (desc == textures.end()) {
+            Log::error("SceneTextureStream: unknown texture '%s'\n", iter->c_str());
+            return false;
+        }
+
+        p.descriptors.push_back(desc->second);
+        p.images.push_back(TextureStreamImage());
+
+        if (!decode_image(*desc->second, p.images.back(), row)) {
+            Log::error("SceneTextureStream: failed to decode texture '%s'\n",
+                       iter->c_str());
+            return false;
+        }
+
+        p.max_width = std::max(p.max_width, p.images.back().width);
+        p.max_height = std::max(p.max_height, p.images.back().height);
+    }
+
+    if (p.images.empty()) {
+        Log::error("SceneTextureStream: no textures to stream\n");
+        return false;
+    }
+
+    ShaderSource vtx_source(GLMARK_DATA_PATH"/shaders/texture-stream.vert");
+    ShaderSource frg_source(GLMARK_DATA_PATH"/shaders/texture-stream.frag");
+
+    if (!Scene::load_shaders_from_strings(p.program, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);
+    p.mesh.set_vertex_format(vertex_format);
+    p.mesh.make_grid(1, 1, 2.0, 2.0, 0.0);
+    p.mesh.build_vbo();
+    p.mesh.set_attrib_locations(std::vector<GLint>(1, p.program["position"].location()));
+
+    /* All the textures of the pool fit the largest image */
+    p.slots.assign(pool_size, TextureStreamSlot());
+    for (unsigned int i = 0; i < pool_size; i++) {
+        glGenTextures(1, &p.slots[i].texture);
+        glBindTexture(GL_TEXTURE_2D, p.slots[i].texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, GL_RGBA, p.max_width, p.max_height,
+                               0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    }
+
+    /* The shared context must see the storage of the textures */
+    glFinish();
+
+    p.shared_context = canvas_.create_shared_context();
+    if (!p.shared_context) {
+        Log::error("SceneTextureStream: failed to create a shared context\n");
+        return false;
+    }
+
+    p.decode = options_["decode"].value == "true";
+    p.gpu_wait = options_["wait"].value == "gpu";
+    p.current = -1;
+    p.ready = -1;
+    p.stop = false;
+    p.producer_failed = false;
+    p.uploads = 0;
+    p.upload_bytes = 0;
+    p.dropped = 0;
+    p.handoffs = 0;
+    p.handoff_us = 0;
+    p.stall_us = 0;
+    p.time_wait = p.gpu_wait && gpu_timing() && p.wait_timer.init();
+    p.frames = 0;
+
+    p.producer_started = pthread_create(&p.producer, 0, produce_textures, &p) == 0;
+    if (!p.producer_started) {
+        Log::error("SceneTextureStream: failed to start the producer thread\n");
+        return false;
+    }
+
+    p.start_time = Util::get_timestamp_us();
+    p.end_time = p.start_time;
+
+    currentFrame_ = 0;
+    running_ = true;
+    startTime_ = Util::get_timestamp_us() / 1000000.0;
+    lastUpdateTime_ = startTime_;
+
+    return true;
+}
+
+void
+SceneTextureStream::teardown()
+{
+    SceneTextureStreamPrivate &p(*priv_);
+
+    if (p.producer_started) {
+        pthread_mutex_lock(&p.mutex);
+        p.stop = true;
+        pthread_cond_broadcast(&p.slot_freed);
+        pthread_mutex_unlock(&p.mutex);
+
+        pthread_join(p.producer, 0);
+        p.producer_started = false;
+    }
+
+    if (p.producer_failed)
+        Log::error("SceneTextureStream: the producer thread failed\n");
+
+    delete p.shared_context;
+    p.shared_context = 0;
+
+    for (std::vector<TextureStreamSlot>::iterator iter = p.slots.begin();
+         iter != p.slots.end();
+         iter++)
+    {
+        if (iter->upload_fence)
+            GLExtensions::DeleteSync(iter->upload_fence);
+        if (iter->release_fence)
+            GLExtensions::DeleteSync(iter->release_fence);
+        if (iter->texture)
+            GLMemory::delete_textures(1, &iter->texture);
+    }
+
+    p.wait_timer.release();
+    p.time_wait = false;
+
+    p.slots.clear();
+    p.images.clear();
+    p.descriptors.clear();
+    p.program.release();
+    p.mesh.reset();
+
+    Scene::teardown();
+}
+
+void
+SceneTextureStream::update()
+{
+    Scene::update();
+}
+
+void
+SceneTextureStream::draw()
+{
+    SceneTextureStreamPrivate &p(*priv_);
+    int previous = -1;
+    GLsync upload_fence = 0;
+    uint64_t publish_time = 0;
+
+    /* Pick up the newest upload, if there is one */
+    pthread_mutex_lock(&p.mutex);
+    if (p.ready >= 0) {
+        TextureStreamSlot &slot(p.slots[p.ready]);
+        previous = p.current;
+        p.current = p.ready;
+        p.ready = -1;
+        slot.state = TextureStreamSlot::StateInUse;
+        upload_fence = slot.upload_fence;
+        slot.upload_fence = 0;
+        publish_time = slot.publish_time;
+    }
+    pthread_mutex_unlock(&p.mutex);
+
+    /*
+     * The handoff latency runs from the publication of the fence to the
+     * end of the wait, which for glWaitSync only queues the wait on the GPU.
+     * The GPU-side wait is timed together with the first draw after it.
+     */
+    bool time_wait = upload_fence && p.time_wait;
+
+    if (upload_fence) {
+        uint64_t before = Util::get_timestamp_us();
+
+        if (p.gpu_wait) {
+            if (time_wait)
+                p.wait_timer.begin();
+            GLExtensions::WaitSync(upload_fence, 0, GL_TIMEOUT_IGNORED);
+        }
+        else {
+            GLenum status;
+            do {
+                status = GLExtensions::ClientWaitSync(upload_fence, 0, 1000000000ull);
+            } while (status == GL_TIMEOUT_EXPIRED);
+        }
+
+        uint64_t after = Util::get_timestamp_us();
+        GLExtensions::DeleteSync(upload_fence);
+
+        p.stall_us += after - before;
+        p.handoff_us += after - publish_time;
+        p.handoffs++;
+    }
+
+    glDisable(GL_DEPTH_TEST);
+
+    if (p.current >= 0) {
+        const TextureStreamSlot &slot(p.slots[p.current]);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, slot.texture);
+
+        p.program.start();
+        p.program["Texture"] = 0;
+        p.program["TexScale"] = LibMatrix::vec2(static_cast<float>(slot.width) / p.max_width,
+                                                static_cast<float>(slot.height) / p.max_height);
+        p.mesh.render_vbo();
+        p.program.stop();
+    }
+
+    if (time_wait)
+        p.wait_timer.end();
+
+    glEnable(GL_DEPTH_TEST);
+
+    /* Hand the previous texture back once the draws that sampled it are done */
+    if (previous >= 0) {
+        GLsync release_fence = GLExtensions::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        pthread_mutex_lock(&p.mutex);
+        p.slots[previous].release_fence = release_fence;
+        p.slots[previous].state = TextureStreamSlot::StateFree;
+        pthread_cond_signal(&p.slot_freed);
+        pthread_mutex_unlock(&p.mutex);
+    }
+
+    p.frames++;
+    p.end_time = Util::get_timestamp_us();
+}
+
+std::string
+SceneTextureStream::result_extras()
+{
+    SceneTextureStreamPrivate &p(*priv_);
+    double seconds = (p.end_time - p.start_time) / 1000000.0;
+
+    if (seconds <= 0.0 || p.frames == 0)
+        return "";
+
+    pthread_mutex_lock(&p.mutex);
+    uint64_t uploads = p.uploads;
+    uint64_t upload_bytes = p.upload_bytes;
+    uint64_t dropped = p.dropped;
+    pthread_mutex_unlock(&p.mutex);
+
+    std::stringstream ss;
+    ss.precision(2);
+    ss << std::fixed;
+    ss << " Upload: " << upload_bytes / seconds / (1024.0 * 1024.0) << " MiB/s ("
+       << uploads / seconds << " textures/s)";
+
+    if (p.handoffs > 0) {
+        ss << " Handoff: " << p.handoff_us / 1000.0 / p.handoffs << " ms";
+    }
+
+    /*
+     * With glWaitSync the CPU only queues the wait, so the stall is the GPU
+     * time of the wait and the draw after it, or the CPU-side queueing time
+     * when there are no timer queries.
+     */
+    if (!p.gpu_wait)
+        ss << " Stall: " << p.stall_us / 1000.0 / p.frames << " ms/frame";
+    else if (p.time_wait && p.wait_timer.average_ms() >= 0.0)
+        ss << " Stall (GPU wait + draw): " << p.wait_timer.average_ms() << " ms/handoff";
+    else
+        ss << " Wait queueing (CPU): " << p.stall_us / 1000.0 / p.frames << " ms/frame";
+
+    ss << " Dropped: " << dropped;
+
+    return ss.str();
+}
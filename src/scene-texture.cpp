@@ -30,9 +30,13 @@
 #include "program.h"
 #include "shader-source.h"
 #include "texture.h"
+#include "gl-memory.h"
 #include "model.h"
 #include "util.h"
+#include <cerrno>
 #include <cmath>
+#include <cstdlib>
+#include <sstream>
 
 using LibMatrix::vec3;
 using std::string;
@@ -81,12 +85,29 @@ SceneTexture::SceneTexture(Canvas &pCanvas) :
     options_["texgen"] = Scene::Option("texgen", "false",
                                        "Whether to generate texcoords in the shader",
                                        "false,true");
+    options_["anisotropy"] = Scene::Option("anisotropy", "1",
+                                           "The maximum degree of anisotropic filtering (1-16), "
+                                           "or sweep to compare the cost of each degree");
+    options_["lod-bias"] = Scene::Option("lod-bias", "0.0",
+                                         "The bias added to the texture level of detail");
 }
 
 SceneTexture::~SceneTexture()
 {
 }
 
+/* The frames measured with each degree of anisotropy before the next one */
+static const unsigned int anisotropy_batch = 10;
+
+bool
+SceneTexture::supported(bool show_errors)
+{
+    if (options_["anisotropy"].value != "1")
+        return require_capability(GLExtensions::AnisotropicFiltering, show_errors);
+
+    return true;
+}
+
 bool
 SceneTexture::load()
 {
@@ -142,6 +163,38 @@ SceneTexture::setup()
     if (!Texture::load(whichTexture, &texture_, min_filter, mag_filter, 0))
         return false;
 
+    /*
+     * With anisotropy=sweep, each degree up to the maximum supported one is
+     * used in turn for a batch of frames.
+     */
+    const std::string &anisotropy(options_["anisotropy"].value);
+    anisotropyLevels_.clear();
+
+    if (anisotropy != "sweep") {
+        char *end = 0;
+        errno = 0;
+        float degree = std::strtof(anisotropy.c_str(), &end);
+
+        if (errno || end == anisotropy.c_str() || *end != '\0' ||
+            !(degree >= 1.0 && degree <= 16.0))
+        {
+            Log::error("SceneTexture: anisotropy must be sweep or a degree from 1 to 16\n");
+            return false;
+        }
+    }
+
+    if (anisotropy == "sweep") {
+        for (float level = 1.0; level <= 16.0; level *= 2.0) {
+            if (Texture::set_anisotropy(texture_, level) < level)
+                break;
+            anisotropyLevels_.push_back(level);
+        }
+        Texture::set_anisotropy(texture_, anisotropyLevels_[0]);
+    }
+    else if (anisotropy != "1") {
+        Texture::set_anisotropy(texture_, Util::fromString<float>(anisotropy));
+    }
+
     // Load shaders
     bool doTexGen(options_["texgen"].value == "true");
     ShaderSource vtx_source;
@@ -162,12 +215,18 @@ SceneTexture::setup()
         frg_source.append_file(frg_shader_filename);
     }
 
+    /* The bias is applied in the shader, since GLES has no LOD bias state */
+    std::stringstream frg_defines;
+    float lod_bias = Util::fromString<float>(options_["lod-bias"].value);
+    if (lod_bias != 0.0)
+        frg_defines << std::fixed << "#define LOD_BIAS " << lod_bias << std::endl;
+
     // Add constants to shaders
     vtx_source.add_const("LightSourcePosition", lightPosition);
     vtx_source.add_const("MaterialDiffuse", materialDiffuse);
 
     if (!Scene::load_shaders_from_strings(program_, vtx_source.str(),
-                                          frg_source.str()))
+                                          frg_defines.str() + frg_source.str()))
     {
         return false;
     }
@@ -249,6 +308,9 @@ SceneTexture::setup()
     }
     mesh_.set_attrib_locations(attrib_locations);
 
+    /* Set up the measurements of the anisotropy sweep */
+    anisotropySweep_.init(anisotropyLevels_.size(), anisotropy_batch, gpu_timing());
+
     currentFrame_ = 0;
     rotation_ = LibMatrix::vec3();
     running_ = true;
@@ -264,7 +326,9 @@ SceneTexture::teardown()
     program_.stop();
     program_.release();
 
-    glDeleteTextures(1, &texture_);
+    GLMemory::delete_textures(1, &texture_);
+
+    anisotropySweep_.release();
 
     Scene::teardown();
 }
@@ -306,7 +370,51 @@ SceneTexture::draw()
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, texture_);
 
+    if (anisotropyLevels_.empty()) {
+        mesh_.render_vbo();
+        return;
+    }
+
+    if (anisotropySweep_.batch_done()) {
+        unsigned int next = (anisotropySweep_.current() + 1) % anisotropyLevels_.size();
+
+        anisotropySweep_.end_batch();
+        Texture::set_anisotropy(texture_, anisotropyLevels_[next]);
+        anisotropySweep_.start_batch(next);
+    }
+
+    anisotropySweep_.begin();
     mesh_.render_vbo();
+    anisotropySweep_.end();
+}
+
+std::string
+SceneTexture::result_extras()
+{
+    std::vector<double> frame_time;
+
+    for (unsigned int i = 0; i < anisotropyLevels_.size(); i++) {
+        double seconds = anisotropySweep_.seconds(i);
+        if (seconds <= 0.0)
+            break;
+        frame_time.push_back(seconds);
+    }
+
+    if (frame_time.empty())
+        return "";
+
+    /* The cost of each degree relative to no anisotropic filtering */
+    std::stringstream ss;
+    ss.precision(2);
+    ss << std::fixed;
+    ss << " Relative cost by anisotropy:";
+
+    for (unsigned int i = 0; i < frame_time.size(); i++) {
+        ss << " " << static_cast<unsigned int>(anisotropyLevels_[i]) << "x="
+           << frame_time[i] / frame_time[0];
+    }
+
+    return ss.str();
 }
 
 Scene::ValidationResult
@@ -317,6 +425,12 @@ SceneTexture::validate()
     if (rotation_.x() != 0 || rotation_.y() != 0 || rotation_.z() != 0)
         return Scene::ValidationUnknown;
 
+    if (options_["anisotropy"].value != "1" ||
+        Util::fromString<float>(options_["lod-bias"].value) != 0.0)
+    {
+        return Scene::ValidationUnknown;
+    }
+
     Canvas::Pixel ref;
 
     Canvas::Pixel pixel = canvas_.read_pixel(canvas_.width() / 2 + 3,
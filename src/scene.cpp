@@ -28,6 +28,9 @@
 #include "util.h"
 #include <sstream>
 #include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 
 using std::stringstream;
 using std::string;
@@ -40,10 +43,89 @@ name(nam), value(val), default_value(val), description(desc), set(false)
     Util::split(values, ',', acceptable_values, Util::SplitModeNormal);
 }
 
+/**
+ * Reports a lookup of an option while linting, or an iteration over the
+ * options if the name is empty.
+ */
+void
+Scene::OptionMap::report(const std::string &name) const
+{
+    if (!lint_ || !reported_.insert(name).second)
+        return;
+
+    if (name.empty()) {
+        Log::debug("Scene '%s' iterated over its options after setup; "
+                   "bind them to members instead\n",
+                   scene_name_.c_str());
+    }
+    else {
+        Log::debug("Scene '%s' looked up option '%s' after setup; "
+                   "bind it to a member instead\n",
+                   scene_name_.c_str(), name.c_str());
+    }
+}
+
+Scene::Option &
+Scene::OptionMap::operator[](const std::string &name)
+{
+    report(name);
+    return std::map<std::string, Option>::operator[](name);
+}
+
+Scene::OptionMap::iterator
+Scene::OptionMap::find(const std::string &name)
+{
+    report(name);
+    return std::map<std::string, Option>::find(name);
+}
+
+Scene::OptionMap::const_iterator
+Scene::OptionMap::find(const std::string &name) const
+{
+    report(name);
+    return std::map<std::string, Option>::find(name);
+}
+
+Scene::Option &
+Scene::OptionMap::at(const std::string &name)
+{
+    report(name);
+    return std::map<std::string, Option>::at(name);
+}
+
+const Scene::Option &
+Scene::OptionMap::at(const std::string &name) const
+{
+    report(name);
+    return std::map<std::string, Option>::at(name);
+}
+
+Scene::OptionMap::size_type
+Scene::OptionMap::count(const std::string &name) const
+{
+    report(name);
+    return std::map<std::string, Option>::count(name);
+}
+
+Scene::OptionMap::iterator
+Scene::OptionMap::begin()
+{
+    report("");
+    return std::map<std::string, Option>::begin();
+}
+
+Scene::OptionMap::const_iterator
+Scene::OptionMap::begin() const
+{
+    report("");
+    return std::map<std::string, Option>::begin();
+}
+
 Scene::Scene(Canvas &pCanvas, const string &name) :
     canvas_(pCanvas), name_(name),
     startTime_(0), lastUpdateTime_(0), currentFrame_(0),
-    running_(0), duration_(0), nframes_(0)
+    running_(0), duration_(0), nframes_(0),
+    frameTimeSum_(0), frameTimeSumSq_(0)
 {
     options_["duration"] = Scene::Option("duration", "10.0",
                                          "The duration of each benchmark in seconds");
@@ -63,6 +145,14 @@ Scene::Scene(Canvas &pCanvas, const string &name) :
                                          "The position on screen where to show FPS");
     options_["fps-size"] = Scene::Option("fps-size", "0.03",
                                          "The width of each glyph for the FPS");
+    /* HUD options */
+    options_["show-hud"] = Scene::Option("show-hud", "false",
+                                         "Show live frame-time graph and statistics",
+                                         "false,true");
+    options_["hud-pos"] = Scene::Option("hud-pos", "-0.98,0.3",
+                                        "The position on screen of the lower left corner of the HUD graph");
+    options_["hud-size"] = Scene::Option("hud-size", "0.8,0.4",
+                                         "The width and height of the HUD graph");
     /* Title options */
     options_["title"] = Scene::Option("title", "",
                                       "The scene title to show");
@@ -83,6 +173,42 @@ Scene::supported(bool show_errors)
     return true;
 }
 
+bool
+Scene::require_capability(GLExtensions::Capability cap, bool show_errors)
+{
+    if (GLExtensions::support(cap))
+        return true;
+
+    if (show_errors) {
+        Log::error("Scene '%s' requires %s, which the current context"
+                   " (version %u.%u) doesn't support\n",
+                   name_.c_str(), GLExtensions::capability_name(cap),
+                   GLExtensions::major_version, GLExtensions::minor_version);
+    }
+
+    return false;
+}
+
+bool
+Scene::require_no_capture(const char *feature, bool show_errors)
+{
+    if (!GLCapture::active())
+        return true;
+
+    if (show_errors) {
+        Log::error("Scene '%s' cannot be recorded, the capture doesn't"
+                   " support %s\n", name_.c_str(), feature);
+    }
+
+    return false;
+}
+
+bool
+Scene::gpu_timing()
+{
+    return options_["show-hud"].value != "true" && GPUTimer::supported();
+}
+
 bool
 Scene::load()
 {
@@ -110,7 +236,12 @@ Scene::setup()
             ShaderSource::ShaderTypeFragment
             );
 
+    if (!parse_option_bindings())
+        return false;
+
     currentFrame_ = 0;
+    frameTimeSum_ = 0;
+    frameTimeSumSq_ = 0;
     running_ = false;
     startTime_ = Util::get_timestamp_us() / 1000000.0;
     lastUpdateTime_ = startTime_;
@@ -129,7 +260,11 @@ Scene::update()
     double current_time = Util::get_timestamp_us() / 1000000.0;
     double elapsed_time = current_time - startTime_;
 
+    double frame_time = current_time - lastUpdateTime_;
+
     currentFrame_++;
+    frameTimeSum_ += frame_time;
+    frameTimeSumSq_ += frame_time * frame_time;
 
     lastUpdateTime_ = current_time;
 
@@ -184,6 +319,124 @@ Scene::set_option(const string &opt, const string &val)
     return true;
 }
 
+void
+Scene::bind_option(const string &name, bool &member)
+{
+    add_option_binding(name, OptionBinding::TypeBool, &member);
+}
+
+void
+Scene::bind_option(const string &name, int &member)
+{
+    add_option_binding(name, OptionBinding::TypeInt, &member);
+}
+
+void
+Scene::bind_option(const string &name, unsigned int &member)
+{
+    add_option_binding(name, OptionBinding::TypeUInt, &member);
+}
+
+void
+Scene::bind_option(const string &name, float &member)
+{
+    add_option_binding(name, OptionBinding::TypeFloat, &member);
+}
+
+void
+Scene::bind_enum_option(const string &name, unsigned int &member)
+{
+    add_option_binding(name, OptionBinding::TypeEnum, &member);
+}
+
+void
+Scene::add_option_binding(const string &name, OptionBinding::Type type,
+                          void *member)
+{
+    OptionBinding binding;
+
+    binding.name = name;
+    binding.type = type;
+    binding.member = member;
+
+    optionBindings_.push_back(binding);
+}
+
+bool
+Scene::parse_option_bindings()
+{
+    for (std::vector<OptionBinding>::const_iterator iter = optionBindings_.begin();
+         iter != optionBindings_.end();
+         iter++)
+    {
+        map<string, Option>::const_iterator opt_iter = options_.find(iter->name);
+        if (opt_iter == options_.end()) {
+            Log::error("Scene '%s' binds unknown option '%s'\n",
+                       name_.c_str(), iter->name.c_str());
+            return false;
+        }
+
+        const Option &opt(opt_iter->second);
+        const char *str = opt.value.c_str();
+        char *end = 0;
+        bool valid = !opt.value.empty();
+
+        errno = 0;
+
+        switch (iter->type) {
+            case OptionBinding::TypeBool:
+                valid = opt.value == "true" || opt.value == "false";
+                *static_cast<bool *>(iter->member) = opt.value == "true";
+                break;
+            case OptionBinding::TypeInt: {
+                long value = strtol(str, &end, 10);
+                if (value < INT_MIN || value > INT_MAX)
+                    errno = ERANGE;
+                else
+                    *static_cast<int *>(iter->member) = value;
+                break;
+            }
+            case OptionBinding::TypeUInt: {
+                valid = valid && opt.value[0] != '-';
+                unsigned long value = strtoul(str, &end, 10);
+                if (value > UINT_MAX)
+                    errno = ERANGE;
+                else
+                    *static_cast<unsigned int *>(iter->member) = value;
+                break;
+            }
+            case OptionBinding::TypeFloat:
+                *static_cast<float *>(iter->member) = strtof(str, &end);
+                break;
+            case OptionBinding::TypeEnum: {
+                const std::vector<string> &values(opt.acceptable_values);
+                std::vector<string>::const_iterator value_iter =
+                    std::find(values.begin(), values.end(), opt.value);
+                valid = value_iter != values.end();
+                *static_cast<unsigned int *>(iter->member) = value_iter - values.begin();
+                break;
+            }
+        }
+
+        /* The numeric types must consume the whole value and fit the member */
+        if (end && errno == ERANGE) {
+            Log::error("Scene '%s' has an out of range value '%s' for option '%s'\n",
+                       name_.c_str(), opt.value.c_str(), iter->name.c_str());
+            return false;
+        }
+        if (end && (*end != '\0' || errno != 0))
+            valid = false;
+
+        if (!valid) {
+            Log::error("Scene '%s' has an invalid value '%s' for option '%s'\n",
+                       name_.c_str(), opt.value.c_str(), iter->name.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void
 Scene::reset_options()
 {
@@ -253,12 +506,21 @@ Scene::load_shaders_from_strings(Program &program,
                                  const std::string &vtx_shader_filename,
                                  const std::string &frg_shader_filename)
 {
+    std::string vtx(vtx_shader);
+    std::string frg(frg_shader);
+
+    /* Core profile contexts reject the GLSL 1.10 that the shaders use */
+    if (GLExtensions::core_profile) {
+        vtx = ShaderSource::to_version(vtx, ShaderSource::ShaderTypeVertex, "150");
+        frg = ShaderSource::to_version(frg, ShaderSource::ShaderTypeFragment, "150");
+    }
+
     program.init();
 
     Log::debug("Loading vertex shader from file %s:\n%s",
-               vtx_shader_filename.c_str(), vtx_shader.c_str());
+               vtx_shader_filename.c_str(), vtx.c_str());
 
-    program.addShader(GL_VERTEX_SHADER, vtx_shader);
+    program.addShader(GL_VERTEX_SHADER, vtx);
     if (!program.valid()) {
         Log::error("Failed to add vertex shader from file %s:\n  %s\n",
                    vtx_shader_filename.c_str(),
@@ -268,9 +530,9 @@ Scene::load_shaders_from_strings(Program &program,
     }
 
     Log::debug("Loading fragment shader from file %s:\n%s",
-               frg_shader_filename.c_str(), frg_shader.c_str());
+               frg_shader_filename.c_str(), frg.c_str());
 
-    program.addShader(GL_FRAGMENT_SHADER, frg_shader);
+    program.addShader(GL_FRAGMENT_SHADER, frg);
     if (!program.valid()) {
         Log::error("Failed to add fragment shader from file %s:\n  %s\n",
                    frg_shader_filename.c_str(),
@@ -31,12 +31,16 @@
 #include "mesh.h"
 #include "vec.h"
 #include "program.h"
+#include "uniform-buffer.h"
+#include "light-grid.h"
+#include "gpu-timer.h"
 
 #include <math.h>
 
 #include <string>
 #include <map>
 #include <list>
+#include <set>
 #include <vector>
 #include "canvas.h"
 
@@ -64,6 +68,47 @@ public:
         bool set;
     };
 
+    /**
+     * The options of a scene, by name.
+     *
+     * Looking an option up by name is too slow for per-frame code, which
+     * should use members bound with ::bind_option() instead.  While linting
+     * is enabled, each option looked up with operator[], find(), at() or
+     * count(), and iterating over the options, is reported once (at debug
+     * level).
+     */
+    class OptionMap : public std::map<std::string, Option>
+    {
+    public:
+        OptionMap() : lint_(false) {}
+
+        Option &operator[](const std::string &name);
+        iterator find(const std::string &name);
+        const_iterator find(const std::string &name) const;
+        Option &at(const std::string &name);
+        const Option &at(const std::string &name) const;
+        size_type count(const std::string &name) const;
+        iterator begin();
+        const_iterator begin() const;
+
+        /**
+         * Sets whether lookups are reported, and the scene name to report
+         * them for.
+         */
+        void lint(const std::string &scene_name, bool enable)
+        {
+            scene_name_ = scene_name;
+            lint_ = enable;
+        }
+
+    private:
+        void report(const std::string &name) const;
+
+        std::string scene_name_;
+        bool lint_;
+        mutable std::set<std::string> reported_;
+    };
+
     /**
      * The result of a validation check.
      */
@@ -137,6 +182,14 @@ public:
      */
     virtual std::string info_string(const std::string &title = "");
 
+    /**
+     * Gets scene specific statistics about the current run, to append to
+     * the result of the scene.
+     *
+     * @return the statistics, starting with a space, or an empty string
+     */
+    virtual std::string result_extras() { return ""; }
+
     /**
      * Sets the value of an option for this scene.
      *
@@ -177,6 +230,23 @@ public:
      */
     unsigned average_fps();
 
+    /**
+     * Gets the number of frames rendered in the current run.
+     *
+     * @return the number of frames
+     */
+    unsigned frames() { return currentFrame_; }
+
+    /**
+     * Gets the sum and the sum of squares of the frame times (in seconds)
+     * of the current run, for calculating frame time statistics.
+     */
+    void frame_time_sums(double &sum, double &sum_sq)
+    {
+        sum = frameTimeSum_;
+        sum_sq = frameTimeSumSq_;
+    }
+
     /**
      * Gets the name of the scene.
      * @return the name of the scene
@@ -198,7 +268,15 @@ public:
      *
      * @return the scene options
      */
-    const std::map<std::string, Option> &options() { return options_; }
+    const OptionMap &options() { return options_; }
+
+    /**
+     * Sets whether option lookups by name are reported.
+     *
+     * This is enabled around the per-frame methods (::draw() and
+     * ::update()), to find lookups that should use bound members.
+     */
+    void lint_options(bool enable) { options_.lint(name_, enable); }
 
     /**
      * Gets a dummy scene object reference.
@@ -226,15 +304,94 @@ protected:
     Scene(Canvas &pCanvas, const std::string &name);
     std::string construct_title(const std::string &title);
 
+    /**
+     * Checks whether the current context supports a capability, for use
+     * in ::supported().
+     *
+     * @param cap the capability to check
+     * @param show_errors whether to log an error if it is not supported
+     *
+     * @return whether the capability is supported
+     */
+    bool require_capability(GLExtensions::Capability cap, bool show_errors);
+
+    /**
+     * Checks that no GL command capture is active, for use in ::supported()
+     * by scenes using GL calls that GLCapture doesn't record, so that a
+     * recording never differs from what was benchmarked.
+     *
+     * @param feature a description of what the scene can't record
+     * @param show_errors whether to log an error if a capture is active
+     *
+     * @return whether no capture is active
+     */
+    bool require_no_capture(const char *feature, bool show_errors);
+
+    /**
+     * Whether the scene may time its own draws with GPU timers, for use
+     * at setup.  Timer queries can't be nested, so this is not the case
+     * while the HUD times the whole frame.
+     */
+    bool gpu_timing();
+
+    /**
+     * Binds a member to an option.
+     *
+     * The base ::setup() parses the option value into the member, and fails
+     * if the value is not valid for the member type, so the member can be
+     * used afterwards instead of looking the option up.  Options should be
+     * bound in the constructor, after they are added.
+     *
+     * @param name the name of the option
+     * @param member the member that receives the value
+     */
+    void bind_option(const std::string &name, bool &member);
+    void bind_option(const std::string &name, int &member);
+    void bind_option(const std::string &name, unsigned int &member);
+    void bind_option(const std::string &name, float &member);
+
+    /**
+     * Binds a member to an option with a list of acceptable values.
+     *
+     * The member receives the index of the option value in the list.
+     *
+     * @param name the name of the option
+     * @param member the member that receives the index
+     */
+    void bind_enum_option(const std::string &name, unsigned int &member);
+
     Canvas &canvas_;
     std::string name_;
-    std::map<std::string, Option> options_;
+    OptionMap options_;
     double startTime_;
     double lastUpdateTime_;
     unsigned currentFrame_;
     bool running_;
     double duration_;      // Duration of run in seconds
     unsigned nframes_;
+    double frameTimeSum_;
+    double frameTimeSumSq_;
+
+private:
+    struct OptionBinding {
+        enum Type {
+            TypeBool,
+            TypeInt,
+            TypeUInt,
+            TypeFloat,
+            TypeEnum
+        };
+
+        std::string name;
+        Type type;
+        void *member;
+    };
+
+    void add_option_binding(const std::string &name, OptionBinding::Type type,
+                            void *member);
+    bool parse_option_bindings();
+
+    std::vector<OptionBinding> optionBindings_;
 };
 
 /*
@@ -255,6 +412,7 @@ class SceneBuild : public Scene
 {
 public:
     SceneBuild(Canvas &pCanvas);
+    bool supported(bool show_errors);
     bool load();
     void unload();
     bool setup();
@@ -283,6 +441,7 @@ class SceneTexture : public Scene
 {
 public:
     SceneTexture(Canvas &pCanvas);
+    bool supported(bool show_errors);
     bool load();
     void unload();
     bool setup();
@@ -290,6 +449,7 @@ public:
     void update();
     void draw();
     ValidationResult validate();
+    std::string result_extras();
 
     ~SceneTexture();
 
@@ -305,12 +465,17 @@ protected:
     LibMatrix::vec3 centerVec_;
     LibMatrix::vec3 rotation_;
     LibMatrix::vec3 rotationSpeed_;
+
+    /* The degrees of anisotropic filtering measured with anisotropy=sweep */
+    std::vector<float> anisotropyLevels_;
+    SweepTimer anisotropySweep_;
 };
 
 class SceneShading : public Scene
 {
 public:
     SceneShading(Canvas &pCanvas);
+    bool supported(bool show_errors);
     bool load();
     void unload();
     bool setup();
@@ -318,6 +483,7 @@ public:
     void update();
     void draw();
     ValidationResult validate();
+    std::string result_extras();
 
     ~SceneShading();
 
@@ -332,6 +498,32 @@ protected:
     Mesh mesh_;
     float rotation_;
     float rotationSpeed_;
+    bool use_ubo_;
+    UniformBlock transform_block_;
+    UniformBufferRing ubo_ring_;
+
+    /* State of shading=clustered */
+    bool clustered_;
+    unsigned int light_threads_;
+    LightGrid light_grid_;
+    std::vector<LibMatrix::vec4> light_orbits_;
+    std::vector<float> light_x_;
+    std::vector<float> light_y_;
+    std::vector<float> light_z_;
+    std::vector<float> light_radius_;
+    std::vector<float> light_texels_;
+    GLuint light_textures_[3];
+    unsigned int index_rows_;
+    GPUTimer gpu_timer_;
+    bool time_gpu_;
+    uint64_t culling_us_;
+    uint64_t culling_entries_;
+    unsigned int culling_frames_;
+
+private:
+    bool setup_clustered();
+    void update_clustered();
+    void teardown_clustered();
 };
 
 class SceneGrid : public Scene
@@ -437,6 +629,7 @@ class ScenePulsar : public Scene
 {
 public:
     ScenePulsar(Canvas &pCanvas);
+    bool supported(bool show_errors);
     bool load();
     void unload();
     bool setup();
@@ -455,6 +648,12 @@ protected:
     std::vector<LibMatrix::vec3> rotations_;
     std::vector<LibMatrix::vec3> rotationSpeeds_;
     GLuint texture_;
+    bool use_texture_;
+    bool use_light_;
+    bool use_random_;
+    bool use_ubo_;
+    UniformBlock transform_block_;
+    UniformBufferRing ubo_ring_;
 
 private:
     void create_and_setup_mesh();
@@ -466,6 +665,7 @@ class SceneDesktop : public Scene
 {
 public:
     SceneDesktop(Canvas &canvas);
+    bool supported(bool show_errors);
     bool load();
     void unload();
     bool setup();
@@ -473,6 +673,7 @@ public:
     void update();
     void draw();
     ValidationResult validate();
+    std::string result_extras();
 
     ~SceneDesktop();
 
@@ -480,6 +681,220 @@ private:
     SceneDesktopPrivate *priv_;
 };
 
+struct SceneDeferredPrivate;
+
+class SceneDeferred : public Scene
+{
+public:
+    SceneDeferred(Canvas &canvas);
+    bool supported(bool show_errors);
+    bool load();
+    void unload();
+    bool setup();
+    void teardown();
+    void update();
+    void draw();
+    std::string result_extras();
+
+    ~SceneDeferred();
+
+private:
+    bool setup_gbuffer();
+
+    SceneDeferredPrivate *priv_;
+};
+
+struct SceneLoadStorePrivate;
+
+class SceneLoadStore : public Scene
+{
+public:
+    SceneLoadStore(Canvas &canvas);
+    bool supported(bool show_errors);
+    bool load();
+    void unload();
+    bool setup();
+    void teardown();
+    void update();
+    void draw();
+    std::string result_extras();
+
+    ~SceneLoadStore();
+
+private:
+    bool setup_targets(unsigned int count, bool has_depth);
+
+    SceneLoadStorePrivate *priv_;
+};
+
+struct SceneFboSwitchPrivate;
+
+class SceneFboSwitch : public Scene
+{
+public:
+    SceneFboSwitch(Canvas &canvas);
+    bool supported(bool show_errors);
+    bool load();
+    void unload();
+    bool setup();
+    void teardown();
+    void update();
+    void draw();
+    std::string result_extras();
+
+    ~SceneFboSwitch();
+
+private:
+    bool setup_targets(unsigned int count);
+
+    SceneFboSwitchPrivate *priv_;
+};
+
+struct SceneOcclusionPrivate;
+
+class SceneOcclusion : public Scene
+{
+public:
+    SceneOcclusion(Canvas &canvas);
+    bool supported(bool show_errors);
+    bool load();
+    void unload();
+    bool setup();
+    void teardown();
+    void update();
+    void draw();
+    std::string result_extras();
+
+    ~SceneOcclusion();
+
+private:
+    SceneOcclusionPrivate *priv_;
+};
+
+struct SceneOverdrawPrivate;
+
+class SceneOverdraw : public Scene
+{
+public:
+    SceneOverdraw(Canvas &canvas);
+    bool supported(bool show_errors);
+    bool load();
+    void unload();
+    bool setup();
+    void teardown();
+    void update();
+    void draw();
+    std::string result_extras();
+
+    ~SceneOverdraw();
+
+private:
+    SceneOverdrawPrivate *priv_;
+};
+
+struct SceneRegistersPrivate;
+
+class SceneRegisters : public Scene
+{
+public:
+    SceneRegisters(Canvas &canvas);
+    bool load();
+    void unload();
+    bool setup();
+    void teardown();
+    void update();
+    void draw();
+    std::string result_extras();
+
+    ~SceneRegisters();
+
+private:
+    SceneRegistersPrivate *priv_;
+};
+
+struct SceneAluPrivate;
+
+class SceneAlu : public Scene
+{
+public:
+    SceneAlu(Canvas &canvas);
+    bool load();
+    void unload();
+    bool setup();
+    void teardown();
+    void update();
+    void draw();
+    std::string result_extras();
+
+    ~SceneAlu();
+
+private:
+    SceneAluPrivate *priv_;
+};
+
+struct SceneTexcachePrivate;
+
+class SceneTexcache : public Scene
+{
+public:
+    SceneTexcache(Canvas &canvas);
+    bool supported(bool show_errors);
+    bool load();
+    void unload();
+    bool setup();
+    void teardown();
+    void update();
+    void draw();
+    std::string result_extras();
+
+    ~SceneTexcache();
+
+private:
+    SceneTexcachePrivate *priv_;
+};
+
+struct SceneTextureStreamPrivate;
+
+class SceneTextureStream : public Scene
+{
+public:
+    SceneTextureStream(Canvas &canvas);
+    bool supported(bool show_errors);
+    bool load();
+    void unload();
+    bool setup();
+    void teardown();
+    void update();
+    void draw();
+    std::string result_extras();
+
+    ~SceneTextureStream();
+
+private:
+    SceneTextureStreamPrivate *priv_;
+};
+
+struct SceneDmabufStreamPrivate;
+
+class SceneDmabufStream : public Scene
+{
+public:
+    SceneDmabufStream(Canvas &canvas);
+    bool supported(bool show_errors);
+    bool load();
+    void unload();
+    bool setup();
+    void teardown();
+    void update();
+    void draw();
+    std::string result_extras();
+
+    ~SceneDmabufStream();
+
+private:
+    SceneDmabufStreamPrivate *priv_;
+};
+
 struct SceneBufferPrivate;
 
 class SceneBuffer : public Scene
@@ -535,6 +950,7 @@ public:
     void update();
     void draw();
     ValidationResult validate();
+    std::string result_extras();
 
     ~SceneTerrain();
 
@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scratch-arena.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+/*
+ * The memory is handed out from the current block.  When it runs out, a
+ * larger block becomes current and the full one is kept until the next
+ * reset, since the memory it handed out is still in use.
+ */
+static const size_t min_block_size = 4096;
+
+static unsigned char *block = 0;
+static size_t block_size = 0;
+static size_t block_used = 0;
+static std::vector<unsigned char *> retired;
+
+void *
+ScratchArena::allocate(size_t bytes, size_t alignment)
+{
+    uintptr_t start = reinterpret_cast<uintptr_t>(block) + block_used;
+    size_t padding = (alignment - start % alignment) % alignment;
+
+    if (!block || block_used + padding + bytes > block_size) {
+        if (block)
+            retired.push_back(block);
+
+        block_size = std::max(std::max(2 * block_size, min_block_size), bytes);
+        block = new unsigned char[block_size];
+        block_used = 0;
+        padding = 0;
+    }
+
+    void *ptr = block + block_used + padding;
+    block_used += padding + bytes;
+
+    return ptr;
+}
+
+void
+ScratchArena::reset()
+{
+    for (std::vector<unsigned char *>::iterator iter = retired.begin();
+         iter != retired.end();
+         iter++)
+    {
+        delete [] *iter;
+    }
+    retired.clear();
+
+    block_used = 0;
+}
+
+void
+ScratchArena::release()
+{
+    reset();
+
+    delete [] block;
+    block = 0;
+    block_size = 0;
+}
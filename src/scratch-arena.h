@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_SCRATCH_ARENA_H_
+#define GLMARK2_SCRATCH_ARENA_H_
+
+#include <stddef.h>
+#include <type_traits>
+
+/**
+ * Scratch memory that lasts for a single frame.
+ *
+ * Scenes that need temporary arrays while drawing take them from the arena
+ * instead of the heap.  The main loop calls ::reset() before each frame,
+ * which makes all the memory handed out available again.  When a frame
+ * needs more memory than the arena holds, the arena grows, so after the
+ * first frames it serves every frame without allocating.
+ */
+class ScratchArena
+{
+public:
+    /**
+     * Gets uninitialized memory for a number of objects.
+     *
+     * The objects are not destroyed, so only types with trivial destructors
+     * are allowed.
+     */
+    template<typename T> static T *allocate(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "scratch objects are never destroyed");
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * Gets uninitialized memory.
+     *
+     * @param bytes the size of the memory
+     * @param alignment the alignment of the memory, up to that of
+     *        max_align_t
+     */
+    static void *allocate(size_t bytes, size_t alignment);
+
+    /**
+     * Makes all the memory available for the next frame.
+     */
+    static void reset();
+
+    /**
+     * Releases all the memory.
+     */
+    static void release();
+};
+
+#endif
@@ -26,6 +26,7 @@
 #include "vec.h"
 #include "mat.h"
 #include "texture.h"
+#include "gl-memory.h"
 
 using LibMatrix::vec2;
 using LibMatrix::mat4;
@@ -44,7 +45,7 @@ static const vec2 glyph_size(glyph_size_pixels/texture_size);
  */
 TextRenderer::TextRenderer(Canvas& canvas) :
     canvas_(canvas), dirty_(false), position_(-1.0, -1.0),
-    texture_(0)
+    vbo_capacity_(0), texture_(0)
 {
     size(0.03);
 
@@ -74,8 +75,8 @@ TextRenderer::TextRenderer(Canvas& canvas) :
 
 TextRenderer::~TextRenderer()
 {
-    glDeleteBuffers(2, vbo_);
-    glDeleteTextures(1, &texture_);
+    GLMemory::delete_buffers(2, vbo_);
+    GLMemory::delete_textures(1, &texture_);
 }
 
 /**
@@ -207,10 +208,15 @@ TextRenderer::render()
 void
 TextRenderer::create_geometry()
 {
-    std::vector<float> array;
-    std::vector<GLushort> elem_array;
+    std::vector<float> &array(array_);
+    std::vector<GLushort> &elem_array(elem_array_);
     vec2 pos(position_);
 
+    array.clear();
+    elem_array.clear();
+    array.reserve(16 * text_.size());
+    elem_array.reserve(6 * text_.size());
+
     for (size_t i = 0; i < text_.size(); i++) {
         vec2 texcoord = get_glyph_coords(text_[i]);
 
@@ -259,12 +265,26 @@ TextRenderer::create_geometry()
         elem_array.push_back(4 * i + 3);
     }
 
-    /* Load the data into the corresponding VBOs */
-    glBufferData(GL_ARRAY_BUFFER, array.size() * sizeof(float),
-                 &array[0], GL_DYNAMIC_DRAW);
+    if (text_.empty())
+        return;
 
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, elem_array.size() * sizeof(GLushort),
-                 &elem_array[0], GL_DYNAMIC_DRAW);
+    /*
+     * Load the data into the corresponding VBOs, reusing the existing
+     * storage if the new text fits in it.
+     */
+    if (text_.size() > vbo_capacity_) {
+        GLMemory::buffer_data(GL_ARRAY_BUFFER, array.size() * sizeof(float),
+                              &array[0], GL_DYNAMIC_DRAW);
+        GLMemory::buffer_data(GL_ELEMENT_ARRAY_BUFFER, elem_array.size() * sizeof(GLushort),
+                              &elem_array[0], GL_DYNAMIC_DRAW);
+        vbo_capacity_ = text_.size();
+    }
+    else {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, array.size() * sizeof(float),
+                        &array[0]);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0,
+                        elem_array.size() * sizeof(GLushort), &elem_array[0]);
+    }
 }
 
 /**
@@ -290,3 +310,14 @@ TextRenderer::get_glyph_coords(char c)
     return vec2(col * glyph_size.x(), 1.0 - (row + 1) * glyph_size.y());
 }
 
+/**
+ * Gets the size of a glyph in the glyph texture atlas.
+ *
+ * @return the glyph size in texcoords
+ */
+vec2
+TextRenderer::get_glyph_size()
+{
+    return glyph_size;
+}
+
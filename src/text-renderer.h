@@ -23,6 +23,7 @@
 #define GLMARK2_TEXT_RENDERER_H_
 
 #include <string>
+#include <vector>
 #include "gl-headers.h"
 #include "vec.h"
 #include "program.h"
@@ -43,9 +44,11 @@ public:
 
     void render();
 
+    static LibMatrix::vec2 get_glyph_coords(char c);
+    static LibMatrix::vec2 get_glyph_size();
+
 private:
     void create_geometry();
-    LibMatrix::vec2 get_glyph_coords(char c);
 
     Canvas& canvas_;
     bool dirty_;
@@ -54,6 +57,9 @@ private:
     LibMatrix::vec2 size_;
     Program program_;
     GLuint vbo_[2];
+    size_t vbo_capacity_;
+    std::vector<float> array_;
+    std::vector<GLushort> elem_array_;
     GLuint texture_;
 };
 
@@ -25,6 +25,7 @@
 #include "log.h"
 #include "util.h"
 #include "image-reader.h"
+#include "gl-memory.h"
 
 #include <cstdarg>
 #include <vector>
@@ -83,13 +84,13 @@ setup_texture(GLuint *tex, ImageData &image, GLint min_filter, GLint mag_filter)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mag_filter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0,
-                 format, GL_UNSIGNED_BYTE, image.pixels);
+    GLMemory::tex_image_2d(GL_TEXTURE_2D, 0, format, image.width, image.height, 0,
+                           format, GL_UNSIGNED_BYTE, image.pixels);
 
     if ((min_filter != GL_NEAREST && min_filter != GL_LINEAR) ||
         (mag_filter != GL_NEAREST && mag_filter != GL_LINEAR))
     {
-        glGenerateMipmap(GL_TEXTURE_2D);
+        GLMemory::generate_mipmap(GL_TEXTURE_2D);
     }
 }
 
@@ -139,6 +140,23 @@ Texture::load(const std::string &textureName, GLuint *pTexture, ...)
     return true;
 }
 
+float
+Texture::set_anisotropy(GLuint texture, float anisotropy)
+{
+    if (GLExtensions::max_anisotropy <= 1.0)
+        return 1.0;
+
+    if (anisotropy > GLExtensions::max_anisotropy)
+        anisotropy = GLExtensions::max_anisotropy;
+    if (anisotropy < 1.0)
+        anisotropy = 1.0;
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+
+    return anisotropy;
+}
+
 const TextureMap&
 Texture::find_textures()
 {
@@ -72,6 +72,19 @@ public:
      * @return:      true if the operation succeeded, false otherwise
      */
     static bool load(const std::string &name, GLuint *pTexture, ...);
+    /**
+     * Sets the maximum degree of anisotropic filtering of a texture.
+     *
+     * The degree is clamped to the maximum supported one.  The texture is
+     * left bound to GL_TEXTURE_2D.
+     *
+     * @texture:     the texture
+     * @anisotropy:  the requested degree, 1 to disable anisotropic filtering
+     *
+     * @return:      the degree set, which is 1 if EXT_texture_filter_anisotropic
+     *               is not supported
+     */
+    static float set_anisotropy(GLuint texture, float anisotropy);
     /**
      * Locate all available textures.
      *
@@ -0,0 +1,283 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "uniform-buffer.h"
+#include "gl-memory.h"
+#include "log.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+
+const char *glsl_type_names[] = {"float", "vec2", "vec3", "vec4", "mat4"};
+
+/* The std140 base alignment and size of each type, in bytes */
+const size_t std140_alignment[] = {4, 8, 16, 16, 16};
+const size_t std140_size[] = {4, 8, 12, 16, 64};
+
+size_t
+round_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+/****************
+ * UniformBlock *
+ ****************/
+
+UniformBlock::UniformBlock(const std::string &name, GLuint binding) :
+    name_(name), binding_(binding), end_(0)
+{
+}
+
+unsigned int
+UniformBlock::add(const std::string &name, Type type, unsigned int count)
+{
+    Member member;
+
+    /* Array elements are aligned to vec4 in the std140 layout */
+    size_t alignment = count > 1 ? 16 : std140_alignment[type];
+
+    member.name = name;
+    member.type = type;
+    member.count = count;
+    member.offset = round_up(end_, alignment);
+    member.stride = count > 1 ? round_up(std140_size[type], 16) : std140_size[type];
+
+    members_.push_back(member);
+
+    end_ = member.offset + member.stride * count;
+
+    /* The size of a block is rounded up to the alignment of a vec4 */
+    data_.resize(round_up(end_, 16), 0);
+
+    return members_.size() - 1;
+}
+
+void
+UniformBlock::declare(ShaderSource &source) const
+{
+    std::stringstream ss;
+
+    ss << "layout(std140) uniform " << name_ << " {" << std::endl;
+
+    for (std::vector<Member>::const_iterator iter = members_.begin();
+         iter != members_.end();
+         iter++)
+    {
+        std::stringstream decl;
+        decl << glsl_type_names[iter->type] << " " << iter->name;
+        if (iter->count > 1)
+            decl << "[" << iter->count << "]";
+        decl << ";";
+
+        source.replace("uniform " + decl.str(), "");
+        ss << "    " << decl.str() << std::endl;
+    }
+
+    ss << "};" << std::endl;
+
+    source.add(ss.str());
+}
+
+bool
+UniformBlock::bind(Program &program) const
+{
+    GLuint index = GLExtensions::GetUniformBlockIndex(program.handle(),
+                                                      name_.c_str());
+    if (index == GL_INVALID_INDEX)
+        return false;
+
+    GLExtensions::UniformBlockBinding(program.handle(), index, binding_);
+
+    return true;
+}
+
+void
+UniformBlock::write(unsigned int member, unsigned int element,
+                    const float *f, size_t n)
+{
+    const Member &m(members_[member]);
+    std::memcpy(&data_[m.offset + m.stride * element], f, n * sizeof(float));
+}
+
+void
+UniformBlock::set(unsigned int member, const LibMatrix::mat4 &m, unsigned int element)
+{
+    /* The matrix data is column-major, as std140 expects */
+    write(member, element, m, 16);
+}
+
+void
+UniformBlock::set(unsigned int member, const LibMatrix::vec4 &v, unsigned int element)
+{
+    float f[4] = {v.x(), v.y(), v.z(), v.w()};
+    write(member, element, f, 4);
+}
+
+void
+UniformBlock::set(unsigned int member, const LibMatrix::vec3 &v, unsigned int element)
+{
+    float f[3] = {v.x(), v.y(), v.z()};
+    write(member, element, f, 3);
+}
+
+void
+UniformBlock::set(unsigned int member, const LibMatrix::vec2 &v, unsigned int element)
+{
+    float f[2] = {v.x(), v.y()};
+    write(member, element, f, 2);
+}
+
+void
+UniformBlock::set(unsigned int member, float f, unsigned int element)
+{
+    write(member, element, &f, 1);
+}
+
+std::string
+UniformBlock::shader_header(ShaderSource::ShaderType type, unsigned int outputs)
+{
+#if GLMARK2_USE_GLESv2
+    return ShaderSource::version_header(type, "300 es", outputs);
+#else
+    return ShaderSource::version_header(type, "140", outputs);
+#endif
+}
+
+/*********************
+ * UniformBufferRing *
+ *********************/
+
+UniformBufferRing::UniformBufferRing() :
+    buffer_(0), capacity_(0), frame_size_(0), alignment_(256),
+    used_(0), flushed_(0)
+{
+}
+
+UniformBufferRing::~UniformBufferRing()
+{
+    release();
+}
+
+bool
+UniformBufferRing::init(const UniformBlock &block, unsigned int blocks_per_frame,
+                        unsigned int frames)
+{
+    GLint alignment = 0;
+
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment > 0)
+        alignment_ = alignment;
+
+    frame_size_ = align(block.size()) * blocks_per_frame;
+    capacity_ = frame_size_ * frames;
+    staging_.resize(capacity_);
+    used_ = 0;
+    flushed_ = 0;
+
+    glGenBuffers(1, &buffer_);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+    GLMemory::buffer_data(GL_UNIFORM_BUFFER, capacity_, 0, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    return glGetError() == GL_NO_ERROR;
+}
+
+void
+UniformBufferRing::release()
+{
+    if (buffer_) {
+        GLMemory::delete_buffers(1, &buffer_);
+        buffer_ = 0;
+    }
+
+    std::vector<unsigned char>().swap(staging_);
+    capacity_ = 0;
+}
+
+void
+UniformBufferRing::begin_frame()
+{
+    flush();
+
+    if (capacity_ - used_ < frame_size_)
+        orphan();
+}
+
+GLintptr
+UniformBufferRing::push(const UniformBlock &block)
+{
+    size_t size = align(block.size());
+
+    /*
+     * The frame pushed more data than it declared.  Start over in a new
+     * buffer store, which invalidates any offsets pushed but not yet bound.
+     */
+    if (used_ + size > capacity_) {
+        Log::debug("UniformBufferRing: frame data exceeds %zu bytes\n",
+                   frame_size_);
+        flush();
+        orphan();
+    }
+
+    GLintptr offset = used_;
+
+    std::memcpy(&staging_[used_], block.data(), block.size());
+    used_ += size;
+
+    return offset;
+}
+
+void
+UniformBufferRing::flush()
+{
+    if (used_ == flushed_)
+        return;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+    glBufferSubData(GL_UNIFORM_BUFFER, flushed_, used_ - flushed_,
+                    &staging_[flushed_]);
+    flushed_ = used_;
+}
+
+void
+UniformBufferRing::bind(const UniformBlock &block, GLintptr offset)
+{
+    GLExtensions::BindBufferRange(GL_UNIFORM_BUFFER, block.binding(), buffer_,
+                                  offset, block.size());
+}
+
+void
+UniformBufferRing::orphan()
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+    GLMemory::buffer_data(GL_UNIFORM_BUFFER, capacity_, 0, GL_STREAM_DRAW);
+    used_ = 0;
+    flushed_ = 0;
+}
+
+size_t
+UniformBufferRing::align(size_t size) const
+{
+    return round_up(size, alignment_);
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_UNIFORM_BUFFER_H_
+#define GLMARK2_UNIFORM_BUFFER_H_
+
+#include "gl-headers.h"
+#include "shader-source.h"
+#include "program.h"
+#include "mat.h"
+#include "vec.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * A uniform block with std140 layout.
+ *
+ * The block replaces a set of plain uniform declarations in a shader.  Since
+ * the block has no instance name, the shader code accessing the uniforms
+ * remains unchanged.  The values are set in a CPU-side copy of the block,
+ * which is then uploaded with a UniformBufferRing.
+ */
+class UniformBlock
+{
+public:
+    enum Type {
+        TypeFloat,
+        TypeVec2,
+        TypeVec3,
+        TypeVec4,
+        TypeMat4
+    };
+
+    /**
+     * Creates a uniform block.
+     *
+     * @param name the name of the block in the shaders
+     * @param binding the uniform buffer binding point to use for the block
+     */
+    UniformBlock(const std::string &name, GLuint binding);
+
+    /**
+     * Adds a member to the block.
+     *
+     * @param name the name of the member (the name of the uniform it replaces)
+     * @param type the type of the member
+     * @param count the array size, or 1 for non-array members
+     *
+     * @return the index of the member, for use with ::set()
+     */
+    unsigned int add(const std::string &name, Type type, unsigned int count = 1);
+
+    /**
+     * Replaces the declarations of the uniforms that are members of this
+     * block in a shader with the block declaration.
+     */
+    void declare(ShaderSource &source) const;
+
+    /**
+     * Binds the block of a linked program to the binding point of this block.
+     *
+     * @return whether the program uses the block
+     */
+    bool bind(Program &program) const;
+
+    void set(unsigned int member, const LibMatrix::mat4 &m, unsigned int element = 0);
+    void set(unsigned int member, const LibMatrix::vec4 &v, unsigned int element = 0);
+    void set(unsigned int member, const LibMatrix::vec3 &v, unsigned int element = 0);
+    void set(unsigned int member, const LibMatrix::vec2 &v, unsigned int element = 0);
+    void set(unsigned int member, float f, unsigned int element = 0);
+
+    const std::string &name() const { return name_; }
+    GLuint binding() const { return binding_; }
+    const unsigned char *data() const { return data_.empty() ? 0 : &data_[0]; }
+    size_t size() const { return data_.size(); }
+
+    /**
+     * Gets the header to prepend to a GLSL ES 1.00 style shader so that it
+     * compiles as GLSL ES 3.00 (or GLSL 1.40 on desktop GL), which is
+     * required for uniform blocks.
+     *
+     * @param type the type of the shader
+     * @param outputs the number of render targets a fragment shader writes
+     *        to; with more than one, the shader writes to gl_FragData[]
+     */
+    static std::string shader_header(ShaderSource::ShaderType type,
+                                     unsigned int outputs = 1);
+
+private:
+    struct Member {
+        std::string name;
+        Type type;
+        unsigned int count;
+        size_t offset;
+        size_t stride;
+    };
+
+    void write(unsigned int member, unsigned int element, const float *f, size_t n);
+
+    std::string name_;
+    GLuint binding_;
+    std::vector<Member> members_;
+    size_t end_;
+    std::vector<unsigned char> data_;
+};
+
+/**
+ * A ring of uniform block data in a single buffer object.
+ *
+ * Blocks are pushed into a CPU-side staging area and uploaded together with
+ * ::flush(), so that the per-draw uniform updates of a whole frame cost a
+ * single buffer upload.  Each draw then binds its range of the buffer with
+ * ::bind().  When the buffer is full it is orphaned, so that the data of
+ * frames still in flight is not overwritten.
+ */
+class UniformBufferRing
+{
+public:
+    UniformBufferRing();
+    ~UniformBufferRing();
+
+    /**
+     * Creates the buffer object.
+     *
+     * @param block the block that will be pushed
+     * @param blocks_per_frame the maximum number of blocks pushed in a frame
+     * @param frames the number of frames of data to keep in the buffer
+     *
+     * @return whether the buffer was created successfully
+     */
+    bool init(const UniformBlock &block, unsigned int blocks_per_frame,
+              unsigned int frames = 3);
+
+    /**
+     * Releases the buffer object.
+     */
+    void release();
+
+    /**
+     * Starts a new frame, orphaning the buffer if there is no room for it.
+     */
+    void begin_frame();
+
+    /**
+     * Copies the current contents of a block into the staging area.
+     *
+     * @return the offset of the data in the buffer, for use with ::bind()
+     */
+    GLintptr push(const UniformBlock &block);
+
+    /**
+     * Uploads all the blocks pushed since the last flush.
+     */
+    void flush();
+
+    /**
+     * Binds a pushed block to the binding point of the block.
+     *
+     * @param block the block
+     * @param offset the offset returned by ::push()
+     */
+    void bind(const UniformBlock &block, GLintptr offset);
+
+private:
+    void orphan();
+    size_t align(size_t size) const;
+
+    GLuint buffer_;
+    size_t capacity_;
+    size_t frame_size_;
+    size_t alignment_;
+    size_t used_;
+    size_t flushed_;
+    std::vector<unsigned char> staging_;
+};
+
+#endif